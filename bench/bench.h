@@ -0,0 +1,66 @@
+/* 
+ * Copyright © 2015 Sergei Khairulin <sergei.khairulin@gmail.com>. 
+ * All rights reserved.
+ *
+ * This file is part of Bloom++.
+ *
+ * Bloom++ is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Bloom++ is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Bloom++.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#pragma once
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <bloom++/clock.h>
+
+/*
+ * Helpers of the benchmarks: timing and printing of results.
+ */
+namespace bench
+{
+
+inline unsigned long long now_ns()
+{
+    return bloom::clock::now_ns();
+}
+
+/*
+ * Keeps the result alive, so the measured code isn't optimized out.
+ */
+template<class T>
+inline void keep(const T &value)
+{
+    __asm__ __volatile__("" : : "g"(&value) : "memory");
+}
+
+inline void header(const char *title)
+{
+    printf("\n%s\n", title);
+}
+
+inline void row(const char *name, double value, const char *unit)
+{
+    printf("  %-44s %12.2f %s\n", name, value, unit);
+}
+
+/*
+ * Integer argument of the program or the default value.
+ */
+inline long arg(int argc, char **argv, int index, long def)
+{
+    return argc > index ? atol(argv[index]) : def;
+}
+
+} //namespace bench
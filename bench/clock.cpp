@@ -0,0 +1,94 @@
+/* 
+ * Copyright © 2015 Sergei Khairulin <sergei.khairulin@gmail.com>. 
+ * All rights reserved.
+ *
+ * This file is part of Bloom++.
+ *
+ * Bloom++ is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Bloom++ is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Bloom++.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+/*
+ * Cost per call of the clock sources: clock::now_ns, coarse_ns,
+ * cycles, cached_ns (with the ticker running) against gettimeofday
+ * and get_milli_sec.
+ * 
+ * usage: clock [calls]
+ */
+
+#include <sys/time.h>
+#include <time.h>
+#include <bloom++/clock.h>
+#include <bloom++/time.h>
+#include "bench.h"
+
+using namespace bloom;
+
+namespace
+{
+
+unsigned long long call_now_ns(){ return clock::now_ns(); }
+unsigned long long call_coarse_ns(){ return clock::coarse_ns(); }
+unsigned long long call_cycles(){ return clock::cycles(); }
+unsigned long long call_cached_ns(){ return clock::cached_ns(); }
+unsigned long long call_get_milli_sec(){ return get_milli_sec(); }
+
+unsigned long long call_gettimeofday()
+{
+    timeval tv;
+    gettimeofday(&tv, 0);
+    return (unsigned long long)tv.tv_sec * 1000000ULL + tv.tv_usec;
+}
+
+unsigned long long call_time()
+{
+    return time(0);
+}
+
+/*
+ * The function is inlined into the loop, the sum keeps every call.
+ */
+template<unsigned long long (*F)()>
+double call_ns(size_t calls)
+{
+    unsigned long long sum = 0;
+    const unsigned long long t = bench::now_ns();
+    for(size_t i = 0; i < calls; ++i)
+        sum += F();
+    bench::keep(sum);
+    return double(bench::now_ns() - t) / calls;
+}
+
+} //namespace
+
+int main(int argc, char **argv)
+{
+    const size_t calls = bench::arg(argc, argv, 1, 10000000);
+    
+    printf("ns per call, %lu calls, invariant tsc: %s, %.3f ns per cycle\n",
+           (unsigned long)calls, clock::invariant_tsc() ? "yes" : "no",
+           clock::ns_per_cycle());
+    bench::row("clock::now_ns", call_ns<call_now_ns>(calls), "ns");
+    bench::row("clock::coarse_ns", call_ns<call_coarse_ns>(calls), "ns");
+    bench::row("clock::cycles", call_ns<call_cycles>(calls), "ns");
+    bench::row("clock::cached_ns (no ticker)", call_ns<call_cached_ns>(calls), "ns");
+    if(clock::start_ticker()){
+        bench::row("clock::cached_ns (ticker)", call_ns<call_cached_ns>(calls), "ns");
+        clock::stop_ticker();
+    }
+    bench::row("gettimeofday", call_ns<call_gettimeofday>(calls), "ns");
+    bench::row("time", call_ns<call_time>(calls), "ns");
+    bench::row("get_milli_sec", call_ns<call_get_milli_sec>(calls), "ns");
+    return 0;
+}
@@ -0,0 +1,114 @@
+/* 
+ * Copyright © 2015 Sergei Khairulin <sergei.khairulin@gmail.com>. 
+ * All rights reserved.
+ *
+ * This file is part of Bloom++.
+ *
+ * Bloom++ is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Bloom++ is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Bloom++.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+/*
+ * Lock/unlock cost of spinlock, ticket_lock and the mutex types from
+ * 1 to N threads hammering one lock around a short critical section.
+ * 
+ * usage: locks [max_threads] [operations per thread]
+ */
+
+#include <bloom++/spinlock.h>
+#include <bloom++/mutex.h>
+#include <bloom++/thread.h>
+#include <bloom++/vector.h>
+#include "bench.h"
+
+using namespace bloom;
+
+namespace
+{
+
+template<class L>
+struct worker
+{
+    L *lock;
+    volatile size_t *counter;
+    size_t operations;
+    volatile int *go;
+    
+    void run()
+    {
+        while(!__atomic_load_n(go, __ATOMIC_ACQUIRE))
+            cpu_relax();
+        for(size_t i = 0; i < operations; ++i){
+            lock->lock();
+            *counter = *counter + 1;
+            lock->unlock();
+        }
+    }
+};
+
+/*
+ * ns per lock/unlock pair, wall time of all threads divided by the total
+ * number of pairs.
+ */
+template<class L>
+double pair_ns(L &lock, size_t threads, size_t operations)
+{
+    volatile size_t counter = 0;
+    volatile int go = 0;
+    vector<worker<L> > workers;
+    workers.resize(threads);
+    vector<thread<worker<L> >*> pool;
+    for(size_t i = 0; i < threads; ++i){
+        worker<L> w = {&lock, &counter, operations, &go};
+        workers[i] = w;
+        pool.push_back(new thread<worker<L> >(&worker<L>::run, &workers[i]));
+        pool[i]->start();
+    }
+    const unsigned long long t = bench::now_ns();
+    __atomic_store_n(&go, 1, __ATOMIC_RELEASE);
+    for(size_t i = 0; i < threads; ++i){
+        pool[i]->wait();
+        delete pool[i];
+    }
+    const double ns = double(bench::now_ns() - t) / (threads * operations);
+    if(counter != threads * operations)
+        printf("  lost updates: %lu\n", (unsigned long)(threads * operations - counter));
+    return ns;
+}
+
+} //namespace
+
+int main(int argc, char **argv)
+{
+    const size_t max_threads = bench::arg(argc, argv, 1, 8);
+    const size_t operations = bench::arg(argc, argv, 2, 1000000);
+    
+    spinlock spin;
+    ticket_lock ticket;
+    mutex normal;
+    mutex adaptive(mutex::adaptive);
+    
+    printf("ns per lock/unlock pair, %lu operations per thread\n",
+           (unsigned long)operations);
+    printf("  %-8s %14s %14s %14s %14s\n", "threads",
+           "spinlock", "ticket_lock", "mutex", "adaptive");
+    for(size_t threads = 1; threads <= max_threads; threads <<= 1){
+        printf("  %-8lu %14.2f %14.2f %14.2f %14.2f\n", (unsigned long)threads,
+               pair_ns(spin, threads, operations),
+               pair_ns(ticket, threads, operations),
+               pair_ns(normal, threads, operations),
+               pair_ns(adaptive, threads, operations));
+    }
+    return 0;
+}
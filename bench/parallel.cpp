@@ -0,0 +1,121 @@
+/* 
+ * Copyright © 2015 Sergei Khairulin <sergei.khairulin@gmail.com>. 
+ * All rights reserved.
+ *
+ * This file is part of Bloom++.
+ *
+ * Bloom++ is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Bloom++ is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Bloom++.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+/*
+ * Speedup of parallel algorithms from 1 to N threads.
+ * 
+ * usage: parallel [max_threads] [elements]
+ * max_threads defaults to the number of online processors.
+ */
+
+#include <unistd.h>
+#include <math.h>
+#include <algorithm>
+#include <bloom++/parallel.h>
+#include <bloom++/vector.h>
+#include "bench.h"
+
+using namespace bloom;
+
+namespace
+{
+
+struct heavy
+{
+    double *data;
+    
+    void operator()(size_t i) const {
+        data[i] = sqrt(data[i] * 1.5 + 1.0) + sin(data[i]);
+    }
+};
+
+struct square
+{
+    double operator()(double v) const {
+        return v * v;
+    }
+};
+
+struct plus
+{
+    double operator()(double a, double b) const {
+        return a + b;
+    }
+};
+
+void fill(vector<double> &v, size_t n)
+{
+    v.clear();
+    unsigned int seed = 12345;
+    for(size_t i = 0; i < n; ++i){
+        seed = seed * 1103515245u + 12345u;
+        v.push_back((seed >> 8) % 1000000);
+    }
+}
+
+} //namespace
+
+int main(int argc, char **argv)
+{
+    long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    const size_t max_threads = bench::arg(argc, argv, 1, cpus > 0 ? cpus : 1);
+    const size_t n = bench::arg(argc, argv, 2, 4000000);
+    
+    vector<double> v, out;
+    out.resize(n);
+    double base[4] = {0, 0, 0, 0};
+    
+    printf("%lu elements, %ld online processors, ms (speedup)\n", (unsigned long)n, cpus);
+    printf("  %-8s %18s %18s %18s %18s\n", "threads", "for", "transform", "reduce", "sort");
+    for(size_t threads = 1; threads <= max_threads; ++threads){
+        set_parallel_concurrency(threads);
+        double ms[4];
+        
+        fill(v, n);
+        unsigned long long t = bench::now_ns();
+        heavy h = {v.begin()};
+        parallel_for((size_t)0, n, h);
+        ms[0] = (bench::now_ns() - t) / 1e6;
+        
+        t = bench::now_ns();
+        parallel_transform(v, out, square());
+        ms[1] = (bench::now_ns() - t) / 1e6;
+        
+        t = bench::now_ns();
+        double sum = parallel_reduce(out, 0.0, plus());
+        bench::keep(sum);
+        ms[2] = (bench::now_ns() - t) / 1e6;
+        
+        fill(v, n);
+        t = bench::now_ns();
+        parallel_sort(v, std::less<double>());
+        ms[3] = (bench::now_ns() - t) / 1e6;
+        
+        printf("  %-8lu", (unsigned long)threads);
+        for(int i = 0; i < 4; ++i){
+            if(threads == 1)
+                base[i] = ms[i];
+            printf(" %10.1f (%4.2fx)", ms[i], base[i] / ms[i]);
+        }
+        printf("\n");
+    }
+    return 0;
+}
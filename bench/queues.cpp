@@ -0,0 +1,266 @@
+/* 
+ * Copyright © 2015 Sergei Khairulin <sergei.khairulin@gmail.com>. 
+ * All rights reserved.
+ *
+ * This file is part of Bloom++.
+ *
+ * Bloom++ is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Bloom++ is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Bloom++.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+/*
+ * Queues between threads: throughput of mpmc_queue and spsc_queue in
+ * blocking_queue (park and yield waiting, single and batched) against
+ * mt_list with mutex + condition_variable, and the round trip latency
+ * of one item.
+ * 
+ * usage: queues [items] [round trips]
+ */
+
+#include <bloom++/blocking_queue.h>
+#include <bloom++/mpmc_queue.h>
+#include <bloom++/spsc_queue.h>
+#include <bloom++/mt_list.h>
+#include <bloom++/mutex.h>
+#include <bloom++/condition_variable.h>
+#include <bloom++/thread.h>
+#include <bloom++/vector.h>
+#include "bench.h"
+
+using namespace bloom;
+
+namespace
+{
+
+enum { capacity = 1024, batch = 32 };
+
+/*
+ * The usual queue before the ring queues, with the interface of
+ * blocking_queue.
+ */
+class list_queue
+{
+public:
+    typedef long value_type;
+    
+    list_queue(size_t){}
+    
+    void push(long v)
+    {
+        mutex::scoped_lock sl(m_);
+        list_.push_back(v);
+        cv_.notify_one();
+    }
+    
+    void pop(long &v)
+    {
+        mutex::scoped_lock sl(m_);
+        while(!list_.size())
+            cv_.wait(sl);
+        {
+            mt_list<long>::iterator it = list_.begin();
+            v = *it;
+        }
+        list_.pop_front();
+    }
+    
+    void push_n(const long *v, size_t n)
+    {
+        mutex::scoped_lock sl(m_);
+        for(size_t i = 0; i < n; ++i)
+            list_.push_back(v[i]);
+        cv_.notify_all();
+    }
+    
+    size_t pop_n(long *v, size_t n)
+    {
+        mutex::scoped_lock sl(m_);
+        while(!list_.size())
+            cv_.wait(sl);
+        size_t k = 0;
+        for(; k < n && list_.size(); ++k){
+            {
+                mt_list<long>::iterator it = list_.begin();
+                v[k] = *it;
+            }
+            list_.pop_front();
+        }
+        return k;
+    }
+    
+private:
+    mt_list<long> list_;
+    mutex m_;
+    condition_variable cv_;
+};
+
+template<class Q>
+struct context
+{
+    enum { batch_max = 64 };
+    
+    Q *q;
+    size_t produced; // per producer
+    size_t consumed; // per consumer
+    size_t batch;
+    volatile long long sum;
+    
+    void produce()
+    {
+        long v[batch_max];
+        for(size_t i = 1; i <= produced; ){
+            size_t n = 0;
+            for(; n < batch && i <= produced; ++n, ++i)
+                v[n] = i;
+            if(n == 1)
+                q->push(v[0]);
+            else
+                q->push_n(v, n);
+        }
+    }
+    
+    void consume()
+    {
+        long v[batch_max];
+        long long s = 0;
+        for(size_t left = consumed; left; ){
+            size_t n;
+            if(batch == 1){
+                q->pop(v[0]);
+                n = 1;
+            }
+            else
+                n = q->pop_n(v, batch < left ? batch : left);
+            for(size_t i = 0; i < n; ++i)
+                s += v[i];
+            left -= n;
+        }
+        __sync_fetch_and_add(&sum, s);
+    }
+};
+
+/*
+ * ns per item with p producers and p consumers.
+ */
+template<class Q>
+double throughput_ns(size_t pairs, size_t items, size_t batch)
+{
+    Q q(capacity);
+    context<Q> c;
+    c.q = &q;
+    c.produced = c.consumed = items / pairs;
+    c.batch = batch;
+    c.sum = 0;
+    typedef thread<context<Q> > thread_type;
+    vector<thread_type*> threads;
+    const unsigned long long t = bench::now_ns();
+    for(size_t i = 0; i < pairs; ++i){
+        threads.push_back(new thread_type(&context<Q>::produce, &c));
+        threads.push_back(new thread_type(&context<Q>::consume, &c));
+    }
+    for(size_t i = 0; i < threads.size(); ++i)
+        threads[i]->start();
+    for(size_t i = 0; i < threads.size(); ++i){
+        threads[i]->wait();
+        delete threads[i];
+    }
+    const double ns = double(bench::now_ns() - t) / (c.produced * pairs);
+    const long long n = c.produced;
+    if(c.sum != (long long)pairs * n * (n + 1) / 2)
+        printf("  wrong sum\n");
+    return ns;
+}
+
+template<class Q>
+struct echo
+{
+    Q *ping, *pong;
+    size_t rounds;
+    
+    void run()
+    {
+        long v;
+        for(size_t i = 0; i < rounds; ++i){
+            ping->pop(v);
+            pong->push(v);
+        }
+    }
+};
+
+/*
+ * ns per round trip of one item through two queues.
+ */
+template<class Q>
+double round_trip_ns(size_t rounds)
+{
+    Q ping(capacity), pong(capacity);
+    echo<Q> e = {&ping, &pong, rounds};
+    thread<echo<Q> > t(&echo<Q>::run, &e);
+    t.start();
+    long v;
+    const unsigned long long start = bench::now_ns();
+    for(size_t i = 0; i < rounds; ++i){
+        ping.push(i);
+        pong.pop(v);
+    }
+    const double ns = double(bench::now_ns() - start) / rounds;
+    t.wait();
+    return ns;
+}
+
+typedef blocking_queue<mpmc_queue<long> > mpmc_park;
+typedef blocking_queue<mpmc_queue<long>, yield_wait> mpmc_yield;
+typedef blocking_queue<spsc_queue<long> > spsc_park;
+typedef blocking_queue<spsc_queue<long>, yield_wait> spsc_yield;
+
+} //namespace
+
+int main(int argc, char **argv)
+{
+    const size_t items = bench::arg(argc, argv, 1, 400000);
+    const size_t rounds = bench::arg(argc, argv, 2, 20000);
+    
+    printf("ns per item, %lu items, capacity %d, batch %d\n",
+           (unsigned long)items, capacity, batch);
+    printf("  %-36s %10s %10s %10s\n", "queue", "1p1c", "2p2c", "4p4c");
+    printf("  %-36s %10.2f %10.2f %10.2f\n", "mt_list + mutex + cv",
+           throughput_ns<list_queue>(1, items, 1),
+           throughput_ns<list_queue>(2, items, 1),
+           throughput_ns<list_queue>(4, items, 1));
+    printf("  %-36s %10.2f %10.2f %10.2f\n", "mpmc park",
+           throughput_ns<mpmc_park>(1, items, 1),
+           throughput_ns<mpmc_park>(2, items, 1),
+           throughput_ns<mpmc_park>(4, items, 1));
+    printf("  %-36s %10.2f %10.2f %10.2f\n", "mpmc park, batch",
+           throughput_ns<mpmc_park>(1, items, batch),
+           throughput_ns<mpmc_park>(2, items, batch),
+           throughput_ns<mpmc_park>(4, items, batch));
+    printf("  %-36s %10.2f %10.2f %10.2f\n", "mpmc yield",
+           throughput_ns<mpmc_yield>(1, items, 1),
+           throughput_ns<mpmc_yield>(2, items, 1),
+           throughput_ns<mpmc_yield>(4, items, 1));
+    printf("  %-36s %10.2f\n", "spsc park",
+           throughput_ns<spsc_park>(1, items, 1));
+    printf("  %-36s %10.2f\n", "spsc park, batch",
+           throughput_ns<spsc_park>(1, items, batch));
+    printf("  %-36s %10.2f\n", "spsc yield",
+           throughput_ns<spsc_yield>(1, items, 1));
+    
+    printf("\nns per round trip of one item, %lu round trips\n", (unsigned long)rounds);
+    bench::row("mt_list + mutex + cv", round_trip_ns<list_queue>(rounds), "ns");
+    bench::row("mpmc park", round_trip_ns<mpmc_park>(rounds), "ns");
+    bench::row("spsc park", round_trip_ns<spsc_park>(rounds), "ns");
+    bench::row("spsc yield", round_trip_ns<spsc_yield>(rounds), "ns");
+    return 0;
+}
@@ -0,0 +1,153 @@
+/* 
+ * Copyright © 2015 Sergei Khairulin <sergei.khairulin@gmail.com>. 
+ * All rights reserved.
+ *
+ * This file is part of Bloom++.
+ *
+ * Bloom++ is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Bloom++ is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Bloom++.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+/*
+ * radix_sort against std::sort: 32/64-bit keys, key/value pairs and
+ * short strings.
+ * 
+ * usage: radix_sort [elements]
+ */
+
+#include <stdint.h>
+#include <algorithm>
+#include <bloom++/radix_sort.h>
+#include <bloom++/vector.h>
+#include <bloom++/string.h>
+#include "bench.h"
+
+using namespace bloom;
+
+namespace
+{
+
+uint64_t next_random(uint64_t &seed)
+{
+    seed ^= seed << 13;
+    seed ^= seed >> 7;
+    seed ^= seed << 17;
+    return seed;
+}
+
+template<class kT>
+void fill(vector<kT> &v, size_t n)
+{
+    uint64_t seed = 88172645463325252ull;
+    v.clear();
+    for(size_t i = 0; i < n; ++i)
+        v.push_back((kT)next_random(seed));
+}
+
+template<class kT>
+struct pair_less
+{
+    bool operator()(const std::pair<kT, uint32_t> &a, const std::pair<kT, uint32_t> &b) const {
+        return a.first < b.first;
+    }
+};
+
+struct string_less
+{
+    bool operator()(const string &a, const string &b) const {
+        return string_ref(a) < string_ref(b);
+    }
+};
+
+void print(const char *name, double radix_ms, double std_ms)
+{
+    printf("  %-28s %12.1f %12.1f %8.2fx\n", name, radix_ms, std_ms, std_ms / radix_ms);
+}
+
+template<class kT>
+void keys(const char *name, size_t n)
+{
+    vector<kT> v, scratch;
+    scratch.resize(n);
+    fill(v, n);
+    unsigned long long t = bench::now_ns();
+    radix_sort(v, scratch);
+    const double radix_ms = (bench::now_ns() - t) / 1e6;
+    fill(v, n);
+    t = bench::now_ns();
+    std::sort(v.begin(), v.end());
+    print(name, radix_ms, (bench::now_ns() - t) / 1e6);
+}
+
+template<class kT>
+void pairs(const char *name, size_t n)
+{
+    vector<kT> k, kscratch;
+    vector<uint32_t> values, vscratch;
+    fill(k, n);
+    for(size_t i = 0; i < n; ++i)
+        values.push_back(i);
+    kscratch.resize(n);
+    vscratch.resize(n);
+    unsigned long long t = bench::now_ns();
+    radix_sort(k.begin(), values.begin(), n, kscratch.begin(), vscratch.begin());
+    const double radix_ms = (bench::now_ns() - t) / 1e6;
+    
+    fill(k, n);
+    vector<std::pair<kT, uint32_t> > p;
+    for(size_t i = 0; i < n; ++i)
+        p.push_back(std::make_pair(k[i], (uint32_t)i));
+    t = bench::now_ns();
+    std::sort(p.begin(), p.end(), pair_less<kT>());
+    print(name, radix_ms, (bench::now_ns() - t) / 1e6);
+}
+
+void strings(const char *name, size_t n)
+{
+    static const char alphabet[] = "abcdefghijklmnopqrstuvwxyz0123456789";
+    uint64_t seed = 2463534242ull;
+    vector<string> v, v2;
+    for(size_t i = 0; i < n; ++i){
+        char buf[16];
+        const size_t len = 4 + next_random(seed) % 9;
+        for(size_t j = 0; j < len; ++j)
+            buf[j] = alphabet[next_random(seed) % (sizeof(alphabet) - 1)];
+        v.push_back(string(string_ref(buf, len)));
+    }
+    v2 = v;
+    v2.begin(); // unsharing
+    unsigned long long t = bench::now_ns();
+    radix_sort(v);
+    const double radix_ms = (bench::now_ns() - t) / 1e6;
+    t = bench::now_ns();
+    std::sort(v2.begin(), v2.end(), string_less());
+    print(name, radix_ms, (bench::now_ns() - t) / 1e6);
+}
+
+} //namespace
+
+int main(int argc, char **argv)
+{
+    const size_t n = bench::arg(argc, argv, 1, 2000000);
+    
+    printf("%lu elements, ms\n", (unsigned long)n);
+    printf("  %-28s %12s %12s %9s\n", "keys", "radix_sort", "std::sort", "speedup");
+    keys<uint32_t>("uint32_t", n);
+    keys<uint64_t>("uint64_t", n);
+    keys<int32_t>("int32_t", n);
+    pairs<uint32_t>("uint32_t / uint32_t pairs", n);
+    pairs<uint64_t>("uint64_t / uint32_t pairs", n);
+    strings("string (4..12 chars)", n / 4);
+    return 0;
+}
@@ -0,0 +1,151 @@
+/* 
+ * Copyright © 2015 Sergei Khairulin <sergei.khairulin@gmail.com>. 
+ * All rights reserved.
+ *
+ * This file is part of Bloom++.
+ *
+ * Bloom++ is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Bloom++ is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Bloom++.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+/*
+ * Cost of emit: the virtual slot (mem_fun) against delegates
+ * (runtime member pointer, from_method, free function) in signal1,
+ * and mt_signal1 with 1 and 4 slots. Also the cost of connect().
+ * 
+ * usage: signal [calls]
+ */
+
+#include <bloom++/signal.h>
+#include <bloom++/mt_signal.h>
+#include <bloom++/delegate.h>
+#include "bench.h"
+
+using namespace bloom;
+
+namespace
+{
+
+struct receiver
+{
+    long sum;
+    
+    receiver():sum(0){}
+    
+    void on(int v)
+    {
+        sum += v;
+    }
+};
+
+long free_sum = 0;
+
+void on_free(int v)
+{
+    free_sum += v;
+}
+
+typedef signal1<void, int> signal_type;
+typedef mt_signal1<void, int> mt_signal_type;
+typedef delegate1<void, int> delegate_type;
+
+template<class S>
+double emit_ns(S &s, size_t calls)
+{
+    const unsigned long long t = bench::now_ns();
+    for(size_t i = 0; i < calls; ++i)
+        s.emit((int)i);
+    return double(bench::now_ns() - t) / calls;
+}
+
+/*
+ * The slot called directly through its base, as signals did before
+ * delegates. The volatile pointer keeps the call virtual.
+ */
+double virtual_ns(slot_base1<void, int> *base, size_t calls)
+{
+    slot_base1<void, int> *volatile slot = base;
+    const unsigned long long t = bench::now_ns();
+    for(size_t i = 0; i < calls; ++i)
+        slot->emit((int)i);
+    return double(bench::now_ns() - t) / calls;
+}
+
+double connect_mem_fun_ns(receiver &r, size_t calls)
+{
+    signal_type s;
+    const unsigned long long t = bench::now_ns();
+    for(size_t i = 0; i < calls; ++i)
+        s.connect(mem_fun(&r, &receiver::on));
+    bench::keep(s);
+    return double(bench::now_ns() - t) / calls;
+}
+
+double connect_delegate_ns(receiver &r, size_t calls)
+{
+    signal_type s;
+    const unsigned long long t = bench::now_ns();
+    for(size_t i = 0; i < calls; ++i)
+        s.connect(&r, &receiver::on);
+    bench::keep(s);
+    return double(bench::now_ns() - t) / calls;
+}
+
+} //namespace
+
+int main(int argc, char **argv)
+{
+    const size_t calls = bench::arg(argc, argv, 1, 20000000);
+    receiver r;
+    
+    printf("ns per emit, %lu calls\n", (unsigned long)calls);
+    {
+        shared_ptr<slot_base1<void, int> > slot = mem_fun(&r, &receiver::on);
+        bench::row("virtual slot (mem_fun)", virtual_ns(slot.get(), calls), "ns");
+        signal_type s;
+        s.connect(slot);
+        bench::row("signal1, slot through delegate", emit_ns(s, calls), "ns");
+    }
+    {
+        signal_type s;
+        s.connect(&r, &receiver::on);
+        bench::row("signal1, delegate", emit_ns(s, calls), "ns");
+    }
+    {
+        signal_type s;
+        s.connect(delegate_type::from_method<receiver, &receiver::on>(&r));
+        bench::row("signal1, from_method delegate", emit_ns(s, calls), "ns");
+    }
+    {
+        signal_type s;
+        s.connect(on_free);
+        bench::row("signal1, free function", emit_ns(s, calls), "ns");
+    }
+    {
+        mt_signal_type s;
+        s.connect(&r, &receiver::on);
+        bench::row("mt_signal1, 1 slot", emit_ns(s, calls), "ns");
+        for(int i = 0; i < 3; ++i)
+            s.connect(&r, &receiver::on);
+        bench::row("mt_signal1, 4 slots", emit_ns(s, calls), "ns");
+    }
+    bench::keep(r.sum);
+    bench::keep(free_sum);
+    
+    const size_t connects = calls / 10;
+    printf("\nns per connect, %lu calls\n", (unsigned long)connects);
+    bench::row("connect(mem_fun(obj, fn))", connect_mem_fun_ns(r, connects), "ns");
+    bench::row("connect(obj, fn)", connect_delegate_ns(r, connects), "ns");
+    return 0;
+}
@@ -0,0 +1,82 @@
+/* 
+ * Copyright © 2015 Sergei Khairulin <sergei.khairulin@gmail.com>. 
+ * All rights reserved.
+ *
+ * This file is part of Bloom++.
+ *
+ * Bloom++ is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Bloom++ is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Bloom++.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+/*
+ * Short-lived collections of typical sizes: small_vector<T, 8> against
+ * vector and std::vector (create, fill, iterate, destroy).
+ * 
+ * usage: small_vector [iterations]
+ */
+
+#include <vector>
+#include <bloom++/small_vector.h>
+#include <bloom++/vector.h>
+#include <bloom++/string.h>
+#include "bench.h"
+
+using namespace bloom;
+
+namespace
+{
+
+template<class V, class T>
+double cycle_ns(size_t iterations, size_t size, const T &value)
+{
+    size_t sum = 0;
+    const unsigned long long t = bench::now_ns();
+    for(size_t i = 0; i < iterations; ++i){
+        V v;
+        for(size_t j = 0; j < size; ++j)
+            v.push_back(value);
+        sum += v.size();
+        bench::keep(v);
+    }
+    bench::keep(sum);
+    return double(bench::now_ns() - t) / iterations;
+}
+
+template<class T>
+void compare(const char *name, size_t iterations, const T &value)
+{
+    static const size_t sizes[] = {0, 1, 4, 8, 16};
+    for(size_t i = 0; i < sizeof(sizes) / sizeof(sizes[0]); ++i){
+        char label[64];
+        snprintf(label, sizeof(label), "%s x %lu", name, (unsigned long)sizes[i]);
+        printf("  %-24s %14.2f %14.2f %14.2f\n", label,
+               cycle_ns<small_vector<T, 8> >(iterations, sizes[i], value),
+               cycle_ns<vector<T> >(iterations, sizes[i], value),
+               cycle_ns<std::vector<T> >(iterations, sizes[i], value));
+    }
+}
+
+} //namespace
+
+int main(int argc, char **argv)
+{
+    const size_t iterations = bench::arg(argc, argv, 1, 1000000);
+    
+    printf("ns per collection (inline capacity 8)\n");
+    printf("  %-24s %14s %14s %14s\n", "elements",
+           "small_vector", "vector", "std::vector");
+    compare("int", iterations, 1);
+    compare("string", iterations, string("header"));
+    return 0;
+}
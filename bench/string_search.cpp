@@ -0,0 +1,158 @@
+/* 
+ * Copyright © 2015 Sergei Khairulin <sergei.khairulin@gmail.com>. 
+ * All rights reserved.
+ *
+ * This file is part of Bloom++.
+ *
+ * Bloom++ is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Bloom++ is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Bloom++.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+/*
+ * string_t search family against std::string.
+ * 
+ * usage: string_search [haystack_MB]
+ */
+
+#include <string>
+#include <bloom++/string.h>
+#include "bench.h"
+
+using namespace bloom;
+
+namespace
+{
+
+const int rounds = 10;
+
+template<class F>
+double ns_per_byte(F f, size_t bytes)
+{
+    const unsigned long long t = bench::now_ns();
+    size_t r = 0;
+    for(int i = 0; i < rounds; ++i)
+        r += f();
+    bench::keep(r);
+    return double(bench::now_ns() - t) / (double(bytes) * rounds);
+}
+
+struct bloom_find
+{
+    const string *s;
+    string_ref needle;
+    size_t operator()() const { return s->find(needle); }
+};
+
+struct std_find
+{
+    const std::string *s;
+    const std::string *needle;
+    size_t operator()() const { return s->find(*needle); }
+};
+
+struct bloom_find_char
+{
+    const string *s;
+    char c;
+    size_t operator()() const { return s->find(c); }
+};
+
+struct std_find_char
+{
+    const std::string *s;
+    char c;
+    size_t operator()() const { return s->find(c); }
+};
+
+struct bloom_rfind_char
+{
+    const string *s;
+    char c;
+    size_t operator()() const { return s->rfind(c); }
+};
+
+struct std_rfind_char
+{
+    const std::string *s;
+    char c;
+    size_t operator()() const { return s->rfind(c); }
+};
+
+struct bloom_find_of
+{
+    const string *s;
+    string_ref set;
+    size_t operator()() const { return s->find_first_of(set); }
+};
+
+struct std_find_of
+{
+    const std::string *s;
+    const std::string *set;
+    size_t operator()() const { return s->find_first_of(*set); }
+};
+
+} //namespace
+
+int main(int argc, char **argv)
+{
+    const size_t size = bench::arg(argc, argv, 1, 16) << 20;
+    
+    // the text is a repeated pattern with the match at the end
+    std::string text;
+    const char *words = "the quick brown fox jumps over the lazy dog ";
+    while(text.size() < size)
+        text += words;
+    const std::string needles[] = {
+        "ZZ",
+        "needle_x",
+        "needle_needle_needle_needle_needle_x",
+    };
+    text += needles[2];
+    const string btext(string_ref(text.data(), text.size()));
+    
+    printf("isa: %s, haystack %lu bytes\n", search::isa(), (unsigned long)text.size());
+    bench::header("ns/byte                                         bloom::string  std::string");
+    
+    for(size_t i = 0; i < sizeof(needles) / sizeof(needles[0]); ++i){
+        const std::string &n = needles[i];
+        bloom_find bf = {&btext, string_ref(n.data(), n.size())};
+        std_find sf = {&text, &n};
+        char name[64];
+        snprintf(name, sizeof(name), "find, needle %lu bytes", (unsigned long)n.size());
+        printf("  %-44s %12.4f %12.4f\n", name,
+               ns_per_byte(bf, text.size()), ns_per_byte(sf, text.size()));
+    }
+    
+    {
+        bloom_find_char bf = {&btext, 'X'};
+        std_find_char sf = {&text, 'X'};
+        printf("  %-44s %12.4f %12.4f\n", "find(char), absent",
+               ns_per_byte(bf, text.size()), ns_per_byte(sf, text.size()));
+    }
+    {
+        bloom_rfind_char bf = {&btext, 'X'};
+        std_rfind_char sf = {&text, 'X'};
+        printf("  %-44s %12.4f %12.4f\n", "rfind(char), absent",
+               ns_per_byte(bf, text.size()), ns_per_byte(sf, text.size()));
+    }
+    {
+        const std::string set("XYZ_");
+        bloom_find_of bf = {&btext, string_ref(set.data(), set.size())};
+        std_find_of sf = {&text, &set};
+        printf("  %-44s %12.4f %12.4f\n", "find_first_of, 4 chars",
+               ns_per_byte(bf, text.size()), ns_per_byte(sf, text.size()));
+    }
+    return 0;
+}
@@ -0,0 +1,253 @@
+/* 
+ * Copyright © 2015 Sergei Khairulin <sergei.khairulin@gmail.com>. 
+ * All rights reserved.
+ *
+ * This file is part of Bloom++.
+ *
+ * Bloom++ is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Bloom++ is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Bloom++.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+/*
+ * tcp::server with many idle connections: time to connect them, round
+ * trip of a few active connections among them, CPU time of the server
+ * while they stay idle and resident memory per connection.
+ * 
+ * The client is a forked process. Source addresses rotate over
+ * 127.0.0.x, so the count isn't limited by the ephemeral ports.
+ * Counts above the descriptor limit (RLIMIT_NOFILE) are skipped.
+ * 
+ * usage: tcp_idle [max_connections] [round trips]
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/resource.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <bloom++/net/tcp/server.h>
+#include "bench.h"
+
+using namespace bloom;
+using namespace bloom::net;
+
+namespace
+{
+
+enum { active = 4, per_source = 20000 };
+
+struct handlers
+{
+    volatile long disconnected;
+    
+    handlers():disconnected(0){}
+    
+    bool accept(tcp::connection &)
+    {
+        return true;
+    }
+    
+    bool execute(tcp::receiver &r, tcp::connection &c)
+    {
+        char buf[64];
+        const long n = (long)r.recv(buf, sizeof(buf));
+        if(n <= 0)
+            return false;
+        c.send(buf, n);
+        return true;
+    }
+    
+    void disconnect(tcp::connection &)
+    {
+        __sync_fetch_and_add(&disconnected, 1);
+    }
+};
+
+struct result
+{
+    double connect_s;
+    double round_trip_us;
+};
+
+int connect_to(int port, long index)
+{
+    const int s = ::socket(AF_INET, SOCK_STREAM, 0);
+    if(s < 0)
+        return -1;
+    sockaddr_in a;
+    memset(&a, 0, sizeof(a));
+    a.sin_family = AF_INET;
+    a.sin_addr.s_addr = htonl(0x7f000001 + index / per_source);
+#ifdef IP_BIND_ADDRESS_NO_PORT
+    int one = 1;
+    setsockopt(s, IPPROTO_IP, IP_BIND_ADDRESS_NO_PORT, &one, sizeof(one));
+#endif
+    if(::bind(s, (sockaddr*)&a, sizeof(a)) < 0){
+        ::close(s);
+        return -1;
+    }
+    a.sin_port = htons(port);
+    a.sin_addr.s_addr = htonl(0x7f000001);
+    if(::connect(s, (sockaddr*)&a, sizeof(a)) < 0){
+        ::close(s);
+        return -1;
+    }
+    int nodelay = 1;
+    setsockopt(s, IPPROTO_TCP, TCP_NODELAY, &nodelay, sizeof(nodelay));
+    return s;
+}
+
+/*
+ * Child: connects, reports 'c' and waits while the server is measured,
+ * then pings over the active connections and writes the result.
+ */
+void run_client(int port, long idle, long round_trips, int report, int go)
+{
+    result res = {0, 0};
+    vector<int> sockets;
+    const unsigned long long t = bench::now_ns();
+    for(long i = 0; i < idle + active; ++i){
+        const int s = connect_to(port, i);
+        if(s < 0)
+            _exit(1);
+        sockets.push_back(s);
+    }
+    res.connect_s = (bench::now_ns() - t) / 1e9;
+    char c = 'c';
+    if(::write(report, &c, 1) != 1 || ::read(go, &c, 1) != 1)
+        _exit(1);
+    
+    const unsigned long long t1 = bench::now_ns();
+    for(long m = 0; m < round_trips; ++m)
+        for(int i = 0; i < active; ++i){
+            const int s = sockets[idle + i];
+            char buf[4];
+            if(::send(s, "ping", 4, 0) != 4)
+                _exit(1);
+            for(int k = 0; k < 4; ){
+                const int r = ::recv(s, buf + k, 4 - k, 0);
+                if(r <= 0)
+                    _exit(1);
+                k += r;
+            }
+        }
+    res.round_trip_us = (bench::now_ns() - t1) / 1e3 / (round_trips * active);
+    if(::write(report, &res, sizeof(res)) != sizeof(res))
+        _exit(1);
+    for(size_t i = 0; i < sockets.size(); ++i)
+        ::close(sockets[i]);
+    _exit(0);
+}
+
+double cpu_ms()
+{
+    rusage ru;
+    getrusage(RUSAGE_SELF, &ru);
+    return (ru.ru_utime.tv_sec + ru.ru_stime.tv_sec) * 1e3 +
+           (ru.ru_utime.tv_usec + ru.ru_stime.tv_usec) / 1e3;
+}
+
+long resident_kb()
+{
+    long pages = 0, resident = 0;
+    FILE *f = fopen("/proc/self/statm", "r");
+    if(f){
+        if(fscanf(f, "%ld %ld", &pages, &resident) != 2)
+            resident = 0;
+        fclose(f);
+    }
+    return resident * (sysconf(_SC_PAGESIZE) / 1024);
+}
+
+bool measure(long idle, long round_trips, int port)
+{
+    handlers h;
+    tcp::server srv(1, 2, 0, 100000);
+    srv.acceptor().connect(&h, &handlers::accept);
+    srv.executor().connect(&h, &handlers::execute);
+    srv.disconnector().connect(&h, &handlers::disconnect);
+    if(srv.bind(addr_ipv4("127.0.0.1", port))){
+        printf("  bind to port %d failed\n", port);
+        return false;
+    }
+    
+    int report[2], go[2];
+    if(pipe(report) || pipe(go))
+        return false;
+    const long rss = resident_kb();
+    const pid_t pid = fork();
+    if(!pid)
+        run_client(port, idle, round_trips, report[1], go[0]);
+    
+    char c;
+    bool ok = ::read(report[0], &c, 1) == 1;
+    double idle_cpu = 0;
+    long rss_per_conn = 0;
+    if(ok){
+        // let the acceptor add the last connections
+        usleep(200000);
+        rss_per_conn = (resident_kb() - rss) * 1024 / (idle + active);
+        const double cpu = cpu_ms();
+        sleep(1);
+        idle_cpu = cpu_ms() - cpu;
+        ok = ::write(go[1], &c, 1) == 1;
+    }
+    result res;
+    ok = ok && ::read(report[0], &res, sizeof(res)) == sizeof(res);
+    int status = 0;
+    waitpid(pid, &status, 0);
+    ::close(report[0]); ::close(report[1]);
+    ::close(go[0]); ::close(go[1]);
+    if(!ok || status){
+        printf("  %-10ld client failed\n", idle);
+        return false;
+    }
+    for(int i = 0; i < 500 && h.disconnected < idle + active; ++i)
+        usleep(10000);
+    printf("  %-10ld %12.3f %14.2f %16.2f %14ld\n", idle, res.connect_s,
+           res.round_trip_us, idle_cpu, rss_per_conn);
+    return true;
+}
+
+} //namespace
+
+int main(int argc, char **argv)
+{
+    const long max_connections = bench::arg(argc, argv, 1, 100000);
+    const long round_trips = bench::arg(argc, argv, 2, 5000);
+    
+    rlimit rl;
+    getrlimit(RLIMIT_NOFILE, &rl);
+    rl.rlim_cur = rl.rlim_max;
+    setrlimit(RLIMIT_NOFILE, &rl);
+    // descriptors besides the connections
+    const long limit = (long)rl.rlim_cur - 64 - active;
+    
+    printf("%d active connections, %ld round trips each, descriptor limit %ld\n",
+           active, round_trips, (long)rl.rlim_cur);
+    printf("  %-10s %12s %14s %16s %14s\n", "idle", "connect s",
+           "round trip us", "idle cpu ms/s", "bytes/conn");
+    int port = 20000 + getpid() % 10000;
+    for(long idle = 100; idle <= max_connections; idle *= 10, ++port){
+        if(idle > limit){
+            printf("  %-10ld skipped, raise RLIMIT_NOFILE\n", idle);
+            continue;
+        }
+        measure(idle, round_trips, port);
+    }
+    return 0;
+}
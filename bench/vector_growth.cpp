@@ -0,0 +1,117 @@
+/* 
+ * Copyright © 2015 Sergei Khairulin <sergei.khairulin@gmail.com>. 
+ * All rights reserved.
+ *
+ * This file is part of Bloom++.
+ *
+ * Bloom++ is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Bloom++ is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Bloom++.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+/*
+ * vector_t growth (push_back) and erase of relocatable and
+ * non-relocatable elements against std::vector.
+ * 
+ * usage: vector_growth [elements]
+ */
+
+#include <vector>
+#include <bloom++/vector.h>
+#include <bloom++/string.h>
+#include <bloom++/shared_ptr.h>
+#include "bench.h"
+
+using namespace bloom;
+
+namespace
+{
+
+const int rounds = 20;
+
+/*
+ * Same layout as string, but not declared relocatable: growth
+ * copy-constructs every element.
+ */
+struct boxed
+{
+    string s;
+    boxed(const string &str):s(str){}
+};
+
+template<class V, class T>
+double push_ns(size_t n, const T &value)
+{
+    const unsigned long long t = bench::now_ns();
+    for(int r = 0; r < rounds; ++r){
+        V v;
+        for(size_t i = 0; i < n; ++i)
+            v.push_back(value);
+        bench::keep(v);
+    }
+    return double(bench::now_ns() - t) / (double(n) * rounds);
+}
+
+template<class T>
+void erase_front(vector<T> &v)
+{
+    v.erase(0);
+}
+
+template<class T>
+void erase_front(std::vector<T> &v)
+{
+    v.erase(v.begin());
+}
+
+template<class V, class T>
+double erase_front_ns(size_t n, const T &value)
+{
+    V v;
+    for(size_t i = 0; i < n; ++i)
+        v.push_back(value);
+    const size_t erased = n / 2 < 1000 ? n / 2 : 1000;
+    const unsigned long long t = bench::now_ns();
+    for(size_t i = 0; i < erased; ++i)
+        erase_front(v);
+    bench::keep(v);
+    return double(bench::now_ns() - t) / erased;
+}
+
+template<class T>
+void compare(const char *name, size_t n, const T &value)
+{
+    printf("  %-20s %14.2f %14.2f %14.2f %14.2f\n", name,
+           push_ns<vector<T> >(n, value),
+           push_ns<std::vector<T> >(n, value),
+           erase_front_ns<vector<T> >(n, value),
+           erase_front_ns<std::vector<T> >(n, value));
+}
+
+} //namespace
+
+int main(int argc, char **argv)
+{
+    const size_t n = bench::arg(argc, argv, 1, 100000);
+    const string str("relocatable string");
+    
+    printf("%lu elements, ns per element\n", (unsigned long)n);
+    printf("  %-20s %14s %14s %14s %14s\n", "element",
+           "push vector", "push std", "erase vector", "erase std");
+    compare("int", n, 1);
+    compare("void*", n, (void*)0);
+    compare("string", n, str);
+    compare("shared_ptr<int>", n, shared_ptr<int>(new int(1)));
+    compare("boxed (copied)", n, boxed(str));
+    return 0;
+}
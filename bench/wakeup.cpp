@@ -0,0 +1,218 @@
+/* 
+ * Copyright © 2015 Sergei Khairulin <sergei.khairulin@gmail.com>. 
+ * All rights reserved.
+ *
+ * This file is part of Bloom++.
+ *
+ * Bloom++ is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Bloom++ is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Bloom++.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+/*
+ * Wakeup latency: ping-pong between two threads through semaphore,
+ * event_count, latch and mutex + condition_variable, and phases of
+ * a two-thread barrier.
+ * 
+ * usage: wakeup [round trips]
+ */
+
+#include <bloom++/semaphore.h>
+#include <bloom++/event_count.h>
+#include <bloom++/latch.h>
+#include <bloom++/barrier.h>
+#include <bloom++/mutex.h>
+#include <bloom++/condition_variable.h>
+#include <bloom++/thread.h>
+#include <bloom++/vector.h>
+#include "bench.h"
+
+using namespace bloom;
+
+namespace
+{
+
+struct sem_channel
+{
+    semaphore s;
+    
+    void post(){ s.post(); }
+    void wait(){ s.wait(); }
+};
+
+struct ec_channel
+{
+    volatile int flag;
+    event_count ec;
+    
+    ec_channel():flag(0){}
+    
+    void post()
+    {
+        __atomic_store_n(&flag, 1, __ATOMIC_RELEASE);
+        ec.notify_one();
+    }
+    
+    void wait()
+    {
+        for(;;){
+            if(__sync_lock_test_and_set(&flag, 0))
+                return;
+            event_count::key k = ec.prepare_wait();
+            if(__atomic_load_n(&flag, __ATOMIC_ACQUIRE)){
+                ec.cancel_wait();
+                continue;
+            }
+            ec.wait(k);
+        }
+    }
+};
+
+struct cv_channel
+{
+    mutex m;
+    condition_variable cv;
+    bool flag;
+    
+    cv_channel():flag(false){}
+    
+    void post()
+    {
+        mutex::scoped_lock sl(m);
+        flag = true;
+        cv.notify_one();
+    }
+    
+    void wait()
+    {
+        mutex::scoped_lock sl(m);
+        while(!flag)
+            cv.wait(sl);
+        flag = false;
+    }
+};
+
+/*
+ * Latches are single-use: one per hop.
+ */
+struct latch_channel
+{
+    vector<latch*> latches;
+    size_t posted, waited;
+    
+    latch_channel(size_t n):posted(0), waited(0)
+    {
+        for(size_t i = 0; i < n; ++i)
+            latches.push_back(new latch(1));
+    }
+    
+    ~latch_channel()
+    {
+        for(size_t i = 0; i < latches.size(); ++i)
+            delete latches[i];
+    }
+    
+    void post(){ latches[posted++]->count_down(); }
+    void wait(){ latches[waited++]->wait(); }
+};
+
+template<class C>
+struct partner
+{
+    C *ping, *pong;
+    size_t rounds;
+    
+    void run()
+    {
+        for(size_t i = 0; i < rounds; ++i){
+            ping->wait();
+            pong->post();
+        }
+    }
+};
+
+/*
+ * ns per wakeup: a round trip wakes each thread once.
+ */
+template<class C>
+double pingpong_ns(C &ping, C &pong, size_t rounds)
+{
+    partner<C> p = {&ping, &pong, rounds};
+    thread<partner<C> > t(&partner<C>::run, &p);
+    t.start();
+    const unsigned long long start = bench::now_ns();
+    for(size_t i = 0; i < rounds; ++i){
+        ping.post();
+        pong.wait();
+    }
+    const double ns = double(bench::now_ns() - start) / (2 * rounds);
+    t.wait();
+    return ns;
+}
+
+struct barrier_partner
+{
+    barrier *b;
+    size_t phases;
+    
+    void run()
+    {
+        for(size_t i = 0; i < phases; ++i)
+            b->arrive_and_wait();
+    }
+};
+
+/*
+ * ns per wakeup: the last thread to arrive doesn't wait, so a phase of
+ * two threads wakes one.
+ */
+double barrier_ns(size_t phases)
+{
+    barrier b(2);
+    barrier_partner p = {&b, phases};
+    thread<barrier_partner> t(&barrier_partner::run, &p);
+    t.start();
+    const unsigned long long start = bench::now_ns();
+    for(size_t i = 0; i < phases; ++i)
+        b.arrive_and_wait();
+    const double ns = double(bench::now_ns() - start) / phases;
+    t.wait();
+    return ns;
+}
+
+} //namespace
+
+int main(int argc, char **argv)
+{
+    const size_t rounds = bench::arg(argc, argv, 1, 20000);
+    
+    printf("ns per wakeup, %lu round trips\n", (unsigned long)rounds);
+    {
+        sem_channel a, b;
+        bench::row("semaphore", pingpong_ns(a, b, rounds), "ns");
+    }
+    {
+        ec_channel a, b;
+        bench::row("event_count", pingpong_ns(a, b, rounds), "ns");
+    }
+    {
+        latch_channel a(rounds), b(rounds);
+        bench::row("latch (one per hop)", pingpong_ns(a, b, rounds), "ns");
+    }
+    bench::row("barrier (two threads)", barrier_ns(rounds), "ns");
+    {
+        cv_channel a, b;
+        bench::row("mutex + condition_variable", pingpong_ns(a, b, rounds), "ns");
+    }
+    return 0;
+}
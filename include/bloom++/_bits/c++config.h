@@ -21,6 +21,12 @@
 
 #pragma once
 
+#if __cplusplus >= 201103L
+/// Move semantics and variadic templates are available
+#define BLOOM_CXX11
+#include <utility>
+#endif
+
 namespace bloom {
 
 #ifdef LINUX
@@ -29,4 +35,7 @@ namespace bloom {
 #define FORCE_INLINE
 #endif
 
+/// Size of CPU cache line for padding of shared data
+#define BLOOM_CACHE_LINE 64
+
 } //namespace bloom
\ No newline at end of file
@@ -24,6 +24,7 @@
 #include <string.h>
 #include <stdint.h>
 #include <bloom++/_bits/c++config.h>
+#include <bloom++/_bits/string_search.h>
 
 #ifdef AUX_DEBUG
 #define __BLOOM_WITH_DEBUG
@@ -41,6 +42,11 @@ struct char_traits
     inline static int          compare(const char_type *s1, const char_type *s2, size_t n) FORCE_INLINE;
     inline static size_t       length(const char_type *s) FORCE_INLINE;
     inline static char_type *  find(const char_type *s1, size_t n, const char_type &a) FORCE_INLINE;
+    inline static char_type *  rfind(const char_type *s1, size_t n, const char_type &a) FORCE_INLINE;
+    inline static char_type *  find_seq(const char_type *s1, size_t n, const char_type *s2, size_t m) FORCE_INLINE;
+    inline static char_type *  rfind_seq(const char_type *s1, size_t n, const char_type *s2, size_t m) FORCE_INLINE;
+    inline static char_type *  find_of(const char_type *s1, size_t n, const char_type *s2, size_t m) FORCE_INLINE;
+    inline static char_type *  rfind_of(const char_type *s1, size_t n, const char_type *s2, size_t m) FORCE_INLINE;
     inline static char_type *  move(const char_type *s1, const char_type *s2, size_t n) FORCE_INLINE;
     inline static char_type *  copy(const char_type *s1, const char_type *s2, size_t n) FORCE_INLINE;
     inline static char_type *  assign(const char_type *s, size_t n, char_type a) FORCE_INLINE;
@@ -67,6 +73,26 @@ struct char_traits<char>
         return static_cast<const char_type*>(memchr(s, a, n));
     }
     
+    inline static const char_type *  rfind(const char_type *s, size_t n, const char_type &a) FORCE_INLINE{
+        return search::rfind(s, n, a);
+    }
+    
+    inline static const char_type *  find_seq(const char_type *s1, size_t n, const char_type *s2, size_t m) FORCE_INLINE{
+        return search::find(s1, n, s2, m);
+    }
+    
+    inline static const char_type *  rfind_seq(const char_type *s1, size_t n, const char_type *s2, size_t m) FORCE_INLINE{
+        return search::rfind(s1, n, s2, m);
+    }
+    
+    inline static const char_type *  find_of(const char_type *s1, size_t n, const char_type *s2, size_t m) FORCE_INLINE{
+        return search::find_first_of(s1, n, s2, m);
+    }
+    
+    inline static const char_type *  rfind_of(const char_type *s1, size_t n, const char_type *s2, size_t m) FORCE_INLINE{
+        return search::find_last_of(s1, n, s2, m);
+    }
+    
     inline static char_type *  move(char_type *s1, const char_type *s2, size_t n) FORCE_INLINE{
         if(!n)return s1;
         if(n == 1){
@@ -0,0 +1,57 @@
+/* 
+ * Copyright © 2015 Sergei Khairulin <sergei.khairulin@gmail.com>. 
+ * All rights reserved.
+ *
+ * This file is part of Bloom++.
+ *
+ * Bloom++ is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Bloom++ is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Bloom++.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#pragma once
+
+#include <time.h>
+
+namespace bloom
+{
+
+/**
+ * @brief Absolute CLOCK_MONOTONIC deadline after ms milliseconds.
+ * @param ts Deadline (normalized).
+ * @param ms Timeout in milliseconds.
+ */
+void monotonic_deadline(timespec &ts, long ms);
+
+/**
+ * @brief Sleep while *addr == val.
+ * 
+ * May return spuriously, callers must recheck their condition.
+ * @param addr Futex word.
+ * @param val Expected value.
+ * @param deadline Absolute CLOCK_MONOTONIC deadline or 0 for infinite.
+ * @return false if the deadline has passed.
+ */
+bool futex_wait(volatile int *addr, int val, const timespec *deadline = 0);
+
+/**
+ * @brief Wake up to n threads sleeping on addr.
+ */
+void futex_wake(volatile int *addr, int n);
+
+/**
+ * @brief Wake all threads sleeping on addr.
+ */
+void futex_wake_all(volatile int *addr);
+
+} //namespace bloom
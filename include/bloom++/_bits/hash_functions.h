@@ -61,17 +61,19 @@ public:
 };
 
 template <>
-struct hash<string>
+struct hash<string_ref>
 {
 public:
 
-    size_t operator()(const string &key)
+    size_t operator()(const string_ref &key)
     {
         size_t hash = 0;
         size_t x = 0;
-        for (size_t i = 0; i < key.length(); i++)
+        const char *p = key.data();
+        const char *endp = p + key.size();
+        for (; p != endp; ++p)
         {
-            hash = (hash << 4) + key[i];
+            hash = (hash << 4) + *p;
             if ((x = hash & 0xF0000000L) != 0)
             {
                 hash ^= (x >> 24);
@@ -82,6 +84,21 @@ public:
     }
 };
 
+/**
+ * @brief Same value as hash<string_ref> for the same characters
+ * (so string_ref can be used for lookup in tables with string keys).
+ */
+template <>
+struct hash<string>
+{
+public:
+
+    size_t operator()(const string &key)
+    {
+        return hash<string_ref>()(key);
+    }
+};
+
 template<> struct hash<char>
 {
 public:
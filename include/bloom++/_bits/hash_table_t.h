@@ -103,6 +103,22 @@ protected:
         /// @endcond
     }
     
+    template<class oT>
+    list_iterable_base *find_iterable(const size_t index, const oT &key) const {
+        /// @cond
+        list_iterable_base *obj = hash_array_[index].pointer_;
+        if (!obj)
+            return base_list::end_iterable();
+
+        for(size_t i = 0; i < hash_array_[index].size_; i++){
+            if (static_cast<iterable*>(obj)->value_.first == key)
+                return obj;
+            obj = obj->pNext_;
+        }
+        return base_list::end_iterable();
+        /// @endcond
+    }
+    
     iterable* erase_iterable(const size_t index, list_iterable_base *obj){
         /// @cond        
         hash_array_[index].size_--;
@@ -158,6 +174,11 @@ protected:
     inline const size_t hash_index(const key_type &key) const FORCE_INLINE {
         return hashT()(key) % hash_size_;
     }
+    
+    template<class oT>
+    inline const size_t hash_index_as(const oT &key) const {
+        return hash<oT>()(key) % hash_size_;
+    }
 
 public:
 
@@ -170,6 +191,18 @@ public:
         /// @endcond
     }
 
+#ifdef BLOOM_CXX11
+    hash_table_t(Self &&ht):
+    hash_size_(ht.hash_size_),
+    collisions_limit_(ht.collisions_limit_)
+    {
+        /// @cond
+        hash_array_ = new hash_pointer[hash_size_];
+        swap(ht);
+        /// @endcond
+    }
+#endif
+
     ~hash_table_t()
     {
         /// @cond
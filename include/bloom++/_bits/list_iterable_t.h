@@ -22,6 +22,7 @@
 #pragma once
 
 #include <stddef.h>
+#include <bloom++/_bits/c++config.h>
 
 #ifdef AUX_DEBUG
 #define __BLOOM_WITH_DEBUG
@@ -47,6 +48,11 @@ struct list_iterable_t: public list_iterable_base
 {  
     list_iterable_t<vT>(){}
     
+#ifdef BLOOM_CXX11
+    template<class P1, class... Args>
+    list_iterable_t<vT>(P1 &&p1, Args&&... args):
+        value_(std::forward<P1>(p1), std::forward<Args>(args)...){}
+#else
     template<class P1>
     list_iterable_t<vT>(P1 p1): value_(p1){}
     
@@ -66,6 +72,7 @@ struct list_iterable_t: public list_iterable_base
     template<class P1, class P2, class P3, class P4, class P5, class P6>
     list_iterable_t<vT>(P1 p1, P2 p2, P3 p3, P4 p4, P5 p5, P6 p6): 
         value_(p1, p2, p3, p4, p5, p6){}
+#endif
     
     vT value_;
 };
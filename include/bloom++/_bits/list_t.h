@@ -54,6 +54,15 @@ protected:
         const_cast<list_iterable_base*>(end_iterable_)->pPrev_ = const_cast<list_iterable_base *>(end_iterable_);
         return 0;
     }
+    
+    inline void relink_end() FORCE_INLINE {
+        if(!size_){
+            init_empty();
+            return;
+        }
+        end_iterable_->pNext_->pPrev_ = end_iterable_;
+        end_iterable_->pPrev_->pNext_ = end_iterable_;
+    }
     /// @endcond
     
     inline list_iterable_base *end_iterable() const FORCE_INLINE {
@@ -86,6 +95,7 @@ protected:
     
     inline void transmit(list_iterable_base *i, list_t &c) FORCE_INLINE {
         /// @cond
+        if(!c.size_)return;
         list_iterable_base *cl = c.end_iterable_;
         cl->pPrev_->pNext_ = i->pNext_;
         i->pNext_->pPrev_ = cl->pPrev_;
@@ -103,11 +113,9 @@ protected:
         /// @cond
         if (&c == this)return;
         std::swap(c.end_iterable_[0], end_iterable_[0]);
-        c.end_iterable_[0].pNext_->pPrev_ = c.end_iterable_;
-        c.end_iterable_[0].pPrev_->pNext_ = c.end_iterable_;
-        end_iterable_[0].pNext_->pPrev_ = end_iterable_;
-        end_iterable_[0].pPrev_->pNext_ = end_iterable_;
         std::swap(c.size_, size_);
+        c.relink_end();
+        relink_end();
         /// @endcond
     }
     
@@ -37,7 +37,7 @@ private:
     mutable unsigned int it_count_;
     
 public:
-    mt_store():m_(mutex::errorcheck), it_count_(0){}
+    mt_store():m_("mt_store", mutex::errorcheck), it_count_(0){}
     void incIterator() const{
         ++it_count_;
         //std::cout<<"mt_store "<<(unsigned long)this<<": incIterator, count "<<it_count_<<"\n";
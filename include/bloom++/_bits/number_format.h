@@ -0,0 +1,67 @@
+/* 
+ * Copyright © 2015 Sergei Khairulin <sergei.khairulin@gmail.com>. 
+ * All rights reserved.
+ *
+ * This file is part of Bloom++.
+ *
+ * Bloom++ is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Bloom++ is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Bloom++.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#pragma once
+
+#include <stddef.h>
+
+namespace bloom
+{
+
+/**
+ * @brief Numbers to characters conversion.
+ * 
+ * Functions write characters (not null-terminated) to the buffer
+ * (at least buffer_size characters) and return the count of them.
+ */
+namespace number
+{
+
+/// Enough for any number.
+const size_t buffer_size = 32;
+
+/**
+ * @brief Unsigned integer (two digits per step).
+ */
+size_t utoa(unsigned long long value, char *buf);
+
+/**
+ * @brief Signed integer.
+ */
+size_t itoa(long long value, char *buf);
+
+/**
+ * @brief Shortest representation which is read back to the same double.
+ * 
+ * Grisu3 algorithm. About 0.5% of values it can't prove shortest are
+ * converted by the correctly rounded snprintf() and strtod() of the C
+ * library (slower). Output is like "12.5", "1e+30", "1.5e-7", "nan", "inf".
+ */
+size_t dtoa(double value, char *buf);
+
+/**
+ * @brief Shortest representation which is read back to the same float.
+ */
+size_t ftoa(float value, char *buf);
+
+} //namespace number
+
+} //namespace bloom
@@ -0,0 +1,70 @@
+/* 
+ * Copyright © 2015 Sergei Khairulin <sergei.khairulin@gmail.com>. 
+ * All rights reserved.
+ *
+ * This file is part of Bloom++.
+ *
+ * Bloom++ is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Bloom++ is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Bloom++.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#pragma once
+
+#include <stddef.h>
+
+namespace bloom
+{
+
+namespace number
+{
+
+/**
+ * @brief Result of parsing.
+ */
+enum parse_status
+{
+    parse_ok = 0,       //< Successful
+    parse_invalid,      //< There is no number
+    parse_overflow,     //< Value is out of range (it's clamped)
+    parse_underflow     //< Non-zero floating point value is rounded to zero
+};
+
+/**
+ * @brief Parse number from characters.
+ * 
+ * Integers: [+-]digits ('-' only for signed types).
+ * Floating point: [+-]digits[.digits][(e|E)[+-]digits], correctly rounded.
+ * Value isn't changed if there is no number.
+ * @param s Characters (not null-terminated).
+ * @param n Count of characters.
+ * @param value Parsed value.
+ * @param status Result of parsing (optional).
+ * @return Count of consumed characters (0 if there is no number).
+ */
+size_t parse(const char *s, size_t n, char &value, parse_status *status = 0);
+size_t parse(const char *s, size_t n, unsigned char &value, parse_status *status = 0);
+size_t parse(const char *s, size_t n, short &value, parse_status *status = 0);
+size_t parse(const char *s, size_t n, unsigned short &value, parse_status *status = 0);
+size_t parse(const char *s, size_t n, int &value, parse_status *status = 0);
+size_t parse(const char *s, size_t n, unsigned int &value, parse_status *status = 0);
+size_t parse(const char *s, size_t n, long &value, parse_status *status = 0);
+size_t parse(const char *s, size_t n, unsigned long &value, parse_status *status = 0);
+size_t parse(const char *s, size_t n, long long &value, parse_status *status = 0);
+size_t parse(const char *s, size_t n, unsigned long long &value, parse_status *status = 0);
+size_t parse(const char *s, size_t n, float &value, parse_status *status = 0);
+size_t parse(const char *s, size_t n, double &value, parse_status *status = 0);
+
+} //namespace number
+
+} //namespace bloom
@@ -0,0 +1,366 @@
+/* 
+ * Copyright © 2015 Sergei Khairulin <sergei.khairulin@gmail.com>. 
+ * All rights reserved.
+ *
+ * This file is part of Bloom++.
+ *
+ * Bloom++ is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Bloom++ is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Bloom++.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include <bloom++/_bits/c++config.h>
+#include <bloom++/_bits/char_traits.h>
+
+#ifdef AUX_DEBUG
+#define __BLOOM_WITH_DEBUG
+#endif
+#include <bloom++/_bits/debug.h>
+
+namespace bloom
+{
+
+template<class vT>
+class string_t;
+
+/**
+ * @brief Non-owning reference to a characters sequence (pointer and length).
+ *
+ * Doesn't copy and doesn't allocate anything. The referenced data must
+ * outlive the object. The data isn't required to be null-terminated.
+ */
+template<class vT>
+class string_ref_t
+{
+public:
+    typedef class string_ref_t<vT>      Self;
+    typedef class char_traits<vT>       Traits;
+    typedef const vT *                  iterator;
+    typedef const vT *                  const_iterator;
+
+    static const size_t npos = static_cast<size_t>(-1);
+
+private:
+    /// @cond
+    const vT *data_;
+    size_t size_;
+
+    inline static bool is_space(vT c) {
+        return c == ' ' || c == '\t' || c == '\n' || c == '\r' ||
+               c == '\v' || c == '\f';
+    }
+    /// @endcond
+
+public:
+    string_ref_t():
+    data_(0), size_(0){
+    }
+
+    string_ref_t(const vT *str):
+    data_(str), size_(Traits::length(str)){
+    }
+
+    string_ref_t(const vT *str, size_t size):
+    data_(str), size_(size){
+    }
+
+    string_ref_t(const string_t<vT> &str):
+    data_(str.data()), size_(str.size()){
+    }
+
+    const vT *data() const {
+        return data_;
+    }
+
+    size_t size() const {
+        return size_;
+    }
+
+    size_t length() const {
+        return size_;
+    }
+
+    bool empty() const {
+        return !size_;
+    }
+
+    const_iterator begin() const {
+        return data_;
+    }
+
+    const_iterator end() const {
+        return data_ + size_;
+    }
+
+    /**
+     * @brief Character access without range checking.
+     */
+    const vT &operator[](size_t index) const {
+        return data_[index];
+    }
+
+    /**
+     * @brief Copy referenced data to the new string.
+     */
+    string_t<vT> str() const {
+        /// @cond
+        return string_t<vT>(*this);
+        /// @endcond
+    }
+
+    int compare(const Self &s) const {
+        /// @cond
+        const size_t sz = size_ < s.size_ ? size_ : s.size_;
+        if(sz){
+            int r = Traits::compare(data_, s.data_, sz);
+            if(r)return r;
+        }
+        if(size_ == s.size_)return 0;
+        return size_ < s.size_ ? -1 : 1;
+        /// @endcond
+    }
+
+    bool operator==(const Self &s) const {
+        /// @cond
+        if(size_ != s.size_)return false;
+        if(!size_ || data_ == s.data_)return true;
+        return Traits::compare(data_, s.data_, size_) == 0;
+        /// @endcond
+    }
+
+    bool operator!=(const Self &s) const {
+        return !operator==(s);
+    }
+
+    bool operator<(const Self &s) const {
+        return compare(s) < 0;
+    }
+
+    bool operator>(const Self &s) const {
+        return compare(s) > 0;
+    }
+
+    bool operator<=(const Self &s) const {
+        return compare(s) <= 0;
+    }
+
+    bool operator>=(const Self &s) const {
+        return compare(s) >= 0;
+    }
+
+    bool starts_with(const Self &s) const {
+        /// @cond
+        return s.size_ <= size_ &&
+               (!s.size_ || Traits::compare(data_, s.data_, s.size_) == 0);
+        /// @endcond
+    }
+
+    bool ends_with(const Self &s) const {
+        /// @cond
+        return s.size_ <= size_ &&
+               (!s.size_ || Traits::compare(data_ + size_ - s.size_, s.data_, s.size_) == 0);
+        /// @endcond
+    }
+
+    /**
+     * @brief Find first position of character.
+     * @param c Character.
+     * @param pos Start position.
+     * @return Position or npos.
+     */
+    size_t find(vT c, size_t pos = 0) const {
+        /// @cond
+        if(pos >= size_)return npos;
+        const vT *r = Traits::find(data_ + pos, size_ - pos, c);
+        return r ? r - data_ : npos;
+        /// @endcond
+    }
+
+    /**
+     * @brief Find first position of sub-sequence.
+     * @param s Sub-sequence.
+     * @param pos Start position.
+     * @return Position or npos.
+     */
+    size_t find(const Self &s, size_t pos = 0) const {
+        /// @cond
+        if(pos > size_ || s.size_ > size_ - pos)return npos;
+        const vT *r = Traits::find_seq(data_ + pos, size_ - pos, s.data_, s.size_);
+        return r ? r - data_ : npos;
+        /// @endcond
+    }
+
+    /**
+     * @brief Find last position of character.
+     * @param c Character.
+     * @param pos Position to search backward from.
+     * @return Position or npos.
+     */
+    size_t rfind(vT c, size_t pos = npos) const {
+        /// @cond
+        if(!size_)return npos;
+        if(pos >= size_)pos = size_ - 1;
+        const vT *r = Traits::rfind(data_, pos + 1, c);
+        return r ? r - data_ : npos;
+        /// @endcond
+    }
+
+    /**
+     * @brief Find last position of sub-sequence.
+     * @param s Sub-sequence.
+     * @param pos Last allowed start position.
+     * @return Position or npos.
+     */
+    size_t rfind(const Self &s, size_t pos = npos) const {
+        /// @cond
+        if(s.size_ > size_)return npos;
+        if(pos > size_ - s.size_)pos = size_ - s.size_;
+        const vT *r = Traits::rfind_seq(data_, pos + s.size_, s.data_, s.size_);
+        return r ? r - data_ : npos;
+        /// @endcond
+    }
+
+    /**
+     * @brief Find first position of any character from set.
+     * @param set Characters.
+     * @param pos Start position.
+     * @return Position or npos.
+     */
+    size_t find_first_of(const Self &set, size_t pos = 0) const {
+        /// @cond
+        if(pos >= size_)return npos;
+        const vT *r = Traits::find_of(data_ + pos, size_ - pos, set.data_, set.size_);
+        return r ? r - data_ : npos;
+        /// @endcond
+    }
+
+    /**
+     * @brief Find last position of any character from set.
+     * @param set Characters.
+     * @param pos Position to search backward from.
+     * @return Position or npos.
+     */
+    size_t find_last_of(const Self &set, size_t pos = npos) const {
+        /// @cond
+        if(!size_)return npos;
+        if(pos >= size_)pos = size_ - 1;
+        const vT *r = Traits::rfind_of(data_, pos + 1, set.data_, set.size_);
+        return r ? r - data_ : npos;
+        /// @endcond
+    }
+
+    /**
+     * @brief Sub-reference. Out of range arguments are clamped.
+     * @param pos Start position.
+     * @param n Size.
+     */
+    Self substr(size_t pos, size_t n = npos) const {
+        /// @cond
+        if(pos > size_)pos = size_;
+        if(n > size_ - pos)n = size_ - pos;
+        return Self(data_ + pos, n);
+        /// @endcond
+    }
+
+    void remove_prefix(size_t n) {
+        /// @cond
+        if(n > size_)n = size_;
+        data_ += n;
+        size_ -= n;
+        /// @endcond
+    }
+
+    void remove_suffix(size_t n) {
+        /// @cond
+        if(n > size_)n = size_;
+        size_ -= n;
+        /// @endcond
+    }
+
+    Self ltrim() const {
+        /// @cond
+        size_t i = 0;
+        while(i < size_ && is_space(data_[i]))++i;
+        return Self(data_ + i, size_ - i);
+        /// @endcond
+    }
+
+    Self rtrim() const {
+        /// @cond
+        size_t n = size_;
+        while(n && is_space(data_[n - 1]))--n;
+        return Self(data_, n);
+        /// @endcond
+    }
+
+    Self trim() const {
+        return ltrim().rtrim();
+    }
+
+    /**
+     * @brief Split by the first delimiter.
+     * @param delim Delimiter.
+     * @param head Part before delimiter (or all data if no delimiter).
+     * @param tail Part after delimiter (or empty if no delimiter).
+     * @return true if delimiter was found.
+     */
+    bool split(vT delim, Self &head, Self &tail) const {
+        /// @cond
+        const Self s(*this);
+        const size_t pos = s.find(delim);
+        if(pos == npos){
+            head = s;
+            tail = Self(s.data_ + s.size_, 0);
+            return false;
+        }
+        head = Self(s.data_, pos);
+        tail = Self(s.data_ + pos + 1, s.size_ - pos - 1);
+        return true;
+        /// @endcond
+    }
+
+    /**
+     * @brief Split to parts by delimiter.
+     *
+     * The last part contains the rest of data if there are
+     * more then max_parts parts.
+     * @param delim Delimiter.
+     * @param parts Array for parts.
+     * @param max_parts Size of array.
+     * @return Number of parts.
+     */
+    size_t split(vT delim, Self *parts, size_t max_parts) const {
+        /// @cond
+        if(!max_parts)return 0;
+        size_t n = 0;
+        Self rest(*this);
+        while(n + 1 < max_parts){
+            Self tail;
+            if(!rest.split(delim, parts[n], tail))
+                return n + 1;
+            rest = tail;
+            ++n;
+        }
+        parts[n] = rest;
+        return n + 1;
+        /// @endcond
+    }
+};
+
+template<class vT>
+const size_t string_ref_t<vT>::npos;
+
+} //namespace bloom
@@ -0,0 +1,73 @@
+/* 
+ * Copyright © 2015 Sergei Khairulin <sergei.khairulin@gmail.com>. 
+ * All rights reserved.
+ *
+ * This file is part of Bloom++.
+ *
+ * Bloom++ is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Bloom++ is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Bloom++.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#pragma once
+
+#include <stddef.h>
+
+namespace bloom
+{
+
+/**
+ * @brief Search in characters sequences.
+ * 
+ * SSE2 or AVX2 implementation is selected at runtime (CPUID).
+ * All functions return pointer to the found position or 0.
+ */
+namespace search
+{
+
+/**
+ * @brief Find last position of character.
+ */
+const char *rfind(const char *s, size_t n, char c);
+
+/**
+ * @brief Find first position of sub-sequence.
+ * 
+ * Long needles fall back to Two-Way algorithm (linear time)
+ * if there are too many candidates.
+ */
+const char *find(const char *s, size_t n, const char *needle, size_t m);
+
+/**
+ * @brief Find last position of sub-sequence.
+ */
+const char *rfind(const char *s, size_t n, const char *needle, size_t m);
+
+/**
+ * @brief Find first character which is in set.
+ */
+const char *find_first_of(const char *s, size_t n, const char *set, size_t k);
+
+/**
+ * @brief Find last character which is in set.
+ */
+const char *find_last_of(const char *s, size_t n, const char *set, size_t k);
+
+/**
+ * @brief Name of selected implementation ("avx2", "sse2" or "generic").
+ */
+const char *isa();
+
+} //namespace search
+
+} //namespace bloom
@@ -25,7 +25,9 @@
 #include <stdlib.h>
 #include <string.h>
 #include <bloom++/_bits/c++config.h>
+#include <bloom++/_bits/traits.h>
 #include <bloom++/_bits/char_traits.h>
+#include <bloom++/_bits/string_ref_t.h>
 #include <exception>
 
 #ifdef AUX_DEBUG
@@ -60,6 +62,7 @@ class string_t
 public:
     typedef class string_t<vT>          Self;
     typedef class char_traits<vT>       Traits;
+    typedef class string_ref_t<vT>      Ref;
     
 private: 
     /// @cond
@@ -157,7 +160,9 @@ private:
         inline rep *clone() FORCE_INLINE {
             rep *r = (rep *)malloc(this->capacity_ * sizeof(vT) + sizeof(rep));
             memcpy(reinterpret_cast<void*>(r), reinterpret_cast<void*>(this), 
-                   (this->size_ + 1) * sizeof(vT) + sizeof(rep));
+                   reinterpret_cast<char*>(this->data_ + this->size_ + 1) -
+                   reinterpret_cast<char*>(this));
+            r->refcount_ = 0;
             this->releaseRef();
             return r;
         }
@@ -279,6 +284,8 @@ public:
     typedef vT *                                iterator;
     typedef const vT *                          const_iterator;
     
+    static const size_t npos = static_cast<size_t>(-1);
+    
     string_t():
     rep_(rep::create(0, 0)){
     }
@@ -287,6 +294,15 @@ public:
     rep_(str.rep_->getRef()){
     }
     
+#ifdef BLOOM_CXX11
+    string_t(Self &&str):
+    rep_(str.rep_){
+        /// @cond
+        str.rep_ = rep::create(0, 0);
+        /// @endcond
+    }
+#endif
+    
     string_t(const vT *str):
     rep_(rep::create(str)){
     }
@@ -295,6 +311,13 @@ public:
     rep_(rep::create(ch)){
     }
     
+    explicit string_t(const Ref &str):
+    rep_(rep::create(str.size(), 0)){
+        /// @cond
+        Traits::copy(rep_->data_, str.data(), str.size());
+        /// @endcond
+    }
+    
     ~string_t(){
         /// @cond
         rep_->releaseRef();
@@ -303,12 +326,22 @@ public:
     
     Self &operator=(const Self &str){
         /// @cond
+        rep *r = str.rep_->getRef();
         rep_->releaseRef();
-        rep_ = str.rep_->getRef();
+        rep_ = r;
         return *this;
         /// @endcond
     }
     
+#ifdef BLOOM_CXX11
+    Self &operator=(Self &&str){
+        /// @cond
+        swap(str);
+        return *this;
+        /// @endcond
+    }
+#endif
+    
     Self &operator=(const vT *str){
         /// @cond
         rep_->releaseRef();
@@ -325,6 +358,36 @@ public:
         /// @endcond
     }
     
+    Self &operator=(const Ref &str){
+        return assign(str.data(), str.size());
+    }
+    
+    /**
+     * @brief Replace content by data.
+     * 
+     * Not shared buffer is reused if it has enough capacity.
+     */
+    Self& assign(const vT *str, size_t size){
+        /// @cond
+        if(!size){
+            rep_->releaseRef();
+            rep_ = rep::create(0, 0);
+            return *this;
+        }
+        if(rep_->refcount_ || size > rep_->capacity_){
+            rep *r = rep::create(size, 0);
+            Traits::copy(r->data_, str, size);
+            rep_->releaseRef();
+            rep_ = r;
+            return *this;
+        }
+        Traits::move(rep_->data_, str, size);
+        rep_->size_ = size;
+        rep_->data_[size] = 0;
+        return *this;
+        /// @endcond
+    }
+    
     Self& append(vT c){
         return append(&c, 1);
     }
@@ -343,6 +406,10 @@ public:
         /// @endcond
     }
     
+    Self& append(const Ref &str){
+        return append(str.data(), str.size());
+    }
+    
     Self& append(const Self &str){
         if(!str.rep_->size_)return *this;
         const size_t old_size = rep_->size_;
@@ -566,6 +633,13 @@ public:
         /// @endcond
     }
     
+    bool operator==(const Ref &str) const{
+        /// @cond
+        if(rep_->size_ != str.size())return false;
+        return Traits::compare(rep_->data_, str.data(), rep_->size_) == 0;
+        /// @endcond
+    }
+    
     bool operator!=(const Self &str) const{
         /// @cond
         if(&str == this)return false;
@@ -582,6 +656,10 @@ public:
         /// @endcond
     }
     
+    bool operator!=(const Ref &str) const{
+        return !operator==(str);
+    }
+    
     void swap(Self &str){
         /// @cond
         if(&str == this)return;
@@ -603,6 +681,66 @@ public:
         /// @endcond
     }
     
+    /**
+     * @brief Find first position of character.
+     * @param c Character.
+     * @param pos Start position.
+     * @return Position or npos.
+     */
+    size_t find(vT c, size_t pos = 0) const {
+        return Ref(*this).find(c, pos);
+    }
+    
+    /**
+     * @brief Find first position of substring.
+     * @param str Substring.
+     * @param pos Start position.
+     * @return Position or npos.
+     */
+    size_t find(const Ref &str, size_t pos = 0) const {
+        return Ref(*this).find(str, pos);
+    }
+    
+    /**
+     * @brief Find last position of character.
+     * @param c Character.
+     * @param pos Position to search backward from.
+     * @return Position or npos.
+     */
+    size_t rfind(vT c, size_t pos = npos) const {
+        return Ref(*this).rfind(c, pos);
+    }
+    
+    /**
+     * @brief Find last position of substring.
+     * @param str Substring.
+     * @param pos Last allowed start position.
+     * @return Position or npos.
+     */
+    size_t rfind(const Ref &str, size_t pos = npos) const {
+        return Ref(*this).rfind(str, pos);
+    }
+    
+    /**
+     * @brief Find first position of any character from set.
+     * @param set Characters.
+     * @param pos Start position.
+     * @return Position or npos.
+     */
+    size_t find_first_of(const Ref &set, size_t pos = 0) const {
+        return Ref(*this).find_first_of(set, pos);
+    }
+    
+    /**
+     * @brief Find last position of any character from set.
+     * @param set Characters.
+     * @param pos Position to search backward from.
+     * @return Position or npos.
+     */
+    size_t find_last_of(const Ref &set, size_t pos = npos) const {
+        return Ref(*this).find_last_of(set, pos);
+    }
+    
     iterator begin(){
         /// @cond
         if(rep_->refcount_)
@@ -632,4 +770,13 @@ public:
     }
 };
 
+template<class vT>
+const size_t string_t<vT>::npos;
+
+template<class vT>
+struct is_relocatable<string_t<vT> >
+{
+    static const bool value = true;
+};
+
 } //namespace bloom
@@ -31,9 +31,42 @@
 #endif
 #include <bloom++/_bits/debug.h>
 
+#ifdef BLOOM_CXX11
+#define BLOOM_MOVE_VALUE(v) std::move(const_cast<value_type&>(v))
+#else
+#define BLOOM_MOVE_VALUE(v) (v)
+#endif
+
+#if defined(__GNUC__) || defined(_MSC_VER)
+#define BLOOM_IS_POD(T) __is_pod(T)
+#else
+#define BLOOM_IS_POD(T) false
+#endif
+
 namespace bloom
 {
 
+/**
+ * @brief Trivially relocatable types.
+ * 
+ * Objects of such types can be moved to other memory by memcpy() or
+ * realloc() without calling of copy constructor and destructor (they
+ * don't keep pointers to themselves). Containers use it for growth
+ * and erase. POD types and pointers are relocatable, other types can be
+ * declared by BLOOM_DECLARE_RELOCATABLE().
+ */
+template<class vT>
+struct is_relocatable
+{
+    static const bool value = BLOOM_IS_POD(vT);
+};
+
+template<class vT>
+struct is_relocatable<vT*>
+{
+    static const bool value = true;
+};
+
 /**
  * @brief Traits of types
  */
@@ -63,21 +96,21 @@ struct traits
     inline static void          move_construct(value_type *p1, const value_type *s2, size_t n) FORCE_INLINE {
         if(!n)return;
         if(n == 1){
-            ::new ((void*)p1) value_type(*s2);
+            ::new ((void*)p1) value_type(BLOOM_MOVE_VALUE(*s2));
             s2->~value_type();
             return;
         }
         if(p1 > s2 && p1 < s2 + n){
             const value_type *endi = p1 - 1;
             for(p1 += n - 1, s2 += n - 1;p1 != endi; --p1, --s2){
-                ::new ((void*)p1) value_type(*s2);
+                ::new ((void*)p1) value_type(BLOOM_MOVE_VALUE(*s2));
                 s2->~value_type();
             }
         }
         else {
             const value_type *endi = p1 + n;
             for(;p1 != endi; ++p1, ++s2){
-                ::new ((void*)p1) value_type(*s2);
+                ::new ((void*)p1) value_type(BLOOM_MOVE_VALUE(*s2));
                 s2->~value_type();
             }
         }
@@ -93,18 +126,18 @@ struct traits
     inline static value_type *  move(value_type *s1, const value_type *s2, size_t n) FORCE_INLINE {
         if(!n)return s1;
         if(n == 1){
-            *s1 = *s2;
+            *s1 = BLOOM_MOVE_VALUE(*s2);
             return ++s1;
         }
         if(s1 > s2 && s1 < s2 + n){
             const value_type *endi = s1 - 1;
             for(s1 += n - 1, s2 += n - 1;s1 != endi; --s1, --s2)
-                *s1 = *s2;
+                *s1 = BLOOM_MOVE_VALUE(*s2);
         }
         else {
             const value_type *endi = s1 + n;
             for(;s1 != endi; ++s1, ++s2)
-                *s1 = *s2;
+                *s1 = BLOOM_MOVE_VALUE(*s2);
         }
         return s1;
     }
@@ -143,6 +176,7 @@ struct traits<vT*>
     typedef vT *                value_type;
     
     inline static void          construct(value_type *p, size_t n, const value_type &v) FORCE_INLINE {
+        assign(p, n, v);
     }
     
     inline static void          copy_construct(value_type *p1, const value_type *p2, size_t n) FORCE_INLINE {
@@ -193,6 +227,7 @@ struct traits<char>
     typedef char                value_type;
     
     inline static void          construct(value_type *p, size_t n, value_type v) FORCE_INLINE {
+        assign(p, n, v);
     }
     
     inline static void          copy_construct(value_type *p1, const value_type *p2, size_t n) FORCE_INLINE {
@@ -240,6 +275,7 @@ struct traits<unsigned char>
     typedef unsigned char       value_type;
     
     inline static void          construct(value_type *p, size_t n, value_type v) FORCE_INLINE {
+        assign(p, n, v);
     }
     
     inline static void          copy_construct(value_type *p1, const value_type *p2, size_t n) FORCE_INLINE {
@@ -287,6 +323,7 @@ struct traits<short>
     typedef short               value_type;
     
     inline static void          construct(value_type *p, size_t n, value_type v) FORCE_INLINE {
+        assign(p, n, v);
     }
     
     inline static void          copy_construct(value_type *p1, const value_type *p2, size_t n) FORCE_INLINE {
@@ -337,6 +374,7 @@ struct traits<unsigned short>
     typedef unsigned short      value_type;
     
     inline static void          construct(value_type *p, size_t n, value_type v) FORCE_INLINE {
+        assign(p, n, v);
     }
     
     inline static void          copy_construct(value_type *p1, const value_type *p2, size_t n) FORCE_INLINE {
@@ -387,6 +425,7 @@ struct traits<int>
     typedef int                 value_type;
     
     inline static void          construct(value_type *p, size_t n, const value_type &v) FORCE_INLINE {
+        assign(p, n, v);
     }
     
     inline static void          copy_construct(value_type *p1, const value_type *p2, size_t n) FORCE_INLINE {
@@ -437,6 +476,7 @@ struct traits<unsigned int>
     typedef unsigned int        value_type;
     
     inline static void          construct(value_type *p, size_t n, const value_type &v) FORCE_INLINE {
+        assign(p, n, v);
     }
     
     inline static void          copy_construct(value_type *p1, const value_type *p2, size_t n) FORCE_INLINE {
@@ -487,6 +527,7 @@ struct traits<long>
     typedef long                value_type;
     
     inline static void          construct(value_type *p, size_t n, const value_type &v) FORCE_INLINE {
+        assign(p, n, v);
     }
     
     inline static void          copy_construct(value_type *p1, const value_type *p2, size_t n) FORCE_INLINE {
@@ -537,6 +578,7 @@ struct traits<unsigned long>
     typedef unsigned long       value_type;
     
     inline static void          construct(value_type *p, size_t n, const value_type &v) FORCE_INLINE {
+        assign(p, n, v);
     }
     
     inline static void          copy_construct(value_type *p1, const value_type *p2, size_t n) FORCE_INLINE {
@@ -587,6 +629,7 @@ struct traits<long long>
     typedef long long           value_type;
     
     inline static void          construct(value_type *p, size_t n, const value_type &v) FORCE_INLINE {
+        assign(p, n, v);
     }
     
     inline static void          copy_construct(value_type *p1, const value_type *p2, size_t n) FORCE_INLINE {
@@ -637,6 +680,7 @@ struct traits<unsigned long long>
     typedef unsigned long long  value_type;
     
     inline static void          construct(value_type *p, size_t n, const value_type &v) FORCE_INLINE {
+        assign(p, n, v);
     }
     
     inline static void          copy_construct(value_type *p1, const value_type *p2, size_t n) FORCE_INLINE {
@@ -687,6 +731,7 @@ struct traits<double>
     typedef double              value_type;
     
     inline static void          construct(value_type *p, size_t n, const value_type &v) FORCE_INLINE {
+        assign(p, n, v);
     }
     
     inline static void          copy_construct(value_type *p1, const value_type *p2, size_t n) FORCE_INLINE {
@@ -737,6 +782,7 @@ struct traits<float>
     typedef float               value_type;
     
     inline static void          construct(value_type *p, size_t n, const value_type &v) FORCE_INLINE {
+        assign(p, n, v);
     }
     
     inline static void          copy_construct(value_type *p1, const value_type *p2, size_t n) FORCE_INLINE {
@@ -787,6 +833,7 @@ struct traits<long double>
     typedef long double         value_type;
     
     inline static void          construct(value_type *p, size_t n, const value_type &v) FORCE_INLINE {
+        assign(p, n, v);
     }
     
     inline static void          copy_construct(value_type *p1, const value_type *p2, size_t n) FORCE_INLINE {
@@ -837,6 +884,7 @@ struct traits<bool>
     typedef bool                value_type;
     
     inline static void          construct(value_type *p, size_t n, const value_type &v) FORCE_INLINE {
+        assign(p, n, v);
     }
     
     inline static void          copy_construct(value_type *p1, const value_type *p2, size_t n) FORCE_INLINE {
@@ -883,3 +931,16 @@ struct traits<bool>
 
 
 } //namespace bloom
+
+/**
+ * Declares type as trivially relocatable (see bloom::is_relocatable).
+ * Must be used in the global namespace.
+ */
+#define BLOOM_DECLARE_RELOCATABLE(T) \
+namespace bloom { \
+template<> \
+struct is_relocatable< T > \
+{ \
+    static const bool value = true; \
+}; \
+}
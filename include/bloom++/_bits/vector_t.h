@@ -131,9 +131,7 @@ private:
     {
         static rep_base rep_empty_;
         
-        inline static rep* create(size_t size, size_t old_capacity) FORCE_INLINE {
-            if(!size)return static_cast<rep*>(&rep_empty_);
-            
+        inline static size_t capacity_for(size_t size, size_t old_capacity) FORCE_INLINE {
             const size_t pagesize = 4096;
             const size_t malloc_header_size = 4 * sizeof(void*);
             
@@ -143,22 +141,45 @@ private:
             if ( capacity > old_capacity && capacity < 2 * old_capacity)
                 capacity = 2 * old_capacity;
             
-            size_t alloc_size = capacity * sizeof(vT) + sizeof(rep);
-
-            const size_t adj_size = alloc_size + malloc_header_size;
+            const size_t adj_size = capacity * sizeof(vT) + sizeof(rep) +
+                                    malloc_header_size;
             if (adj_size > pagesize) {
                 const size_t extra = pagesize - adj_size % pagesize;
                 capacity += extra / sizeof(vT);
-                alloc_size = capacity * sizeof(vT) + sizeof(rep);
             }
+            return capacity;
+        }
+        
+        inline static rep* create(size_t size, size_t old_capacity) FORCE_INLINE {
+            if(!size)return static_cast<rep*>(&rep_empty_);
+            
+            const size_t capacity = capacity_for(size, old_capacity);
             
-            rep *r = (rep *)malloc(alloc_size);
+            rep *r = (rep *)malloc(capacity * sizeof(vT) + sizeof(rep));
             r->size_ = size;
             r->capacity_ = capacity;
             r->refcount_ = 0;
             return r;
         }
         
+        /*
+         * Data can be moved by realloc (see is_relocatable).
+         */
+        inline bool relocatable() const FORCE_INLINE {
+            return is_relocatable<vT>::value && !this->refcount_;
+        }
+        
+        /*
+         * Only for relocatable(). Elements aren't constructed or destroyed.
+         */
+        inline rep* reallocate(size_t size) FORCE_INLINE {
+            const size_t capacity = capacity_for(size, this->capacity_);
+            rep *r = (rep *)realloc(this, capacity * sizeof(vT) + sizeof(rep));
+            r->size_ = size;
+            r->capacity_ = capacity;
+            return r;
+        }
+        
         inline static rep* create_and_construct(size_t size, size_t old_capacity, const vT &v = vT()){
             rep *r = create(size, old_capacity);
             Traits::construct(r->data(), size, v);
@@ -191,11 +212,22 @@ private:
             memcpy(reinterpret_cast<void*>(r), reinterpret_cast<void*>(this), 
                    sizeof(rep));
             Traits::copy_construct(r->data(), this->data(), this->size_);
+            r->refcount_ = 0;
             this->releaseRef();
             return r;
         }
         
         inline rep *clone_for_insert(size_t new_size, size_t insert_index, size_t insert_size) FORCE_INLINE {
+            if(relocatable()){
+                const size_t old_size = this->size_;
+                rep *r = reallocate(new_size);
+                if(insert_index < old_size)
+                    memmove(static_cast<void*>(r->data() + insert_index + insert_size),
+                            static_cast<void*>(r->data() + insert_index),
+                            (old_size - insert_index) * sizeof(vT));
+                return r;
+            }
+            
             rep *r = create(new_size, this->capacity_);
             
             if(insert_index >= this->size_){
@@ -213,7 +245,17 @@ private:
         }
         
         inline rep *clone_for_append(size_t new_size) FORCE_INLINE {
+            if(relocatable())
+                return reallocate(new_size);
+            
             rep *r = create(new_size, this->capacity_);
+#ifdef BLOOM_CXX11
+            if(!this->refcount_){
+                Traits::move_construct(r->data(), this->data(), this->size_);
+                free(this);
+                return r;
+            }
+#endif
 
             Traits::copy_construct(r->data(), this->data(), this->size_);
             
@@ -222,6 +264,11 @@ private:
         }
         
         inline rep *clone_and_pop_back(size_t new_size) FORCE_INLINE {
+            if(relocatable() && new_size){
+                Traits::destroy(this->data() + new_size, this->size_ - new_size);
+                return reallocate(new_size);
+            }
+            
             rep *r = create(new_size, this->capacity_);
 
             Traits::copy_construct(r->data(), this->data(), new_size);
@@ -231,6 +278,16 @@ private:
         }
         
         inline rep *clone_and_resize(size_t new_size, vT c) FORCE_INLINE {
+            if(relocatable() && new_size){
+                const size_t old_size = this->size_;
+                if(new_size < old_size)
+                    Traits::destroy(this->data() + new_size, old_size - new_size);
+                rep *r = reallocate(new_size);
+                if(new_size > old_size)
+                    Traits::construct(r->data() + old_size, new_size - old_size, c);
+                return r;
+            }
+            
             rep *r = create(new_size, this->capacity_);
 
             Traits::copy_construct(r->data(), this->data(), new_size < this->size_ ? new_size : this->size_);
@@ -256,6 +313,11 @@ private:
         }
         
         inline rep* clone_and_erase(const size_t new_size, const size_t erase_index, const size_t erase_size) FORCE_INLINE {
+            if(relocatable() && new_size){
+                erase_data(new_size, erase_index, erase_size);
+                return reallocate(new_size);
+            }
+            
             const size_t next = erase_index + erase_size;
             rep *r = create(new_size, this->capacity_);
             if(erase_index > 0)
@@ -268,8 +330,17 @@ private:
 
         inline void erase_data(const size_t new_size, const size_t erase_index, const size_t erase_size) FORCE_INLINE {
             const size_t next = erase_index + erase_size;
+            if(is_relocatable<vT>::value){
+                Traits::destroy(this->data() + erase_index, erase_size);
+                if(next < this->size_)
+                    memmove(static_cast<void*>(this->data() + erase_index),
+                            static_cast<void*>(this->data() + next),
+                            (this->size_ - next) * sizeof(vT));
+                this->size_ = new_size;
+                return;
+            }
             if(next < this->size_)
-                Traits::copy(this->data() + erase_index, this->data() + next,
+                Traits::move(this->data() + erase_index, this->data() + next,
                              this->size_ - next);
             Traits::destroy(this->data() + this->size_ - erase_size, erase_size);
             this->size_ = new_size;
@@ -297,6 +368,13 @@ private:
             if(index < rep_->size_){
                 //Move data to free space for insert
                 const size_t data_after = rep_->size_ - index;
+                if(is_relocatable<vT>::value){
+                    memmove(static_cast<void*>(rep_->data() + index + size),
+                            static_cast<void*>(rep_->data() + index),
+                            data_after * sizeof(vT));
+                    rep_->size_ = new_size;
+                    return true; // need construct on insert data
+                }
                 if(size < data_after){
                     Traits::copy_construct(rep_->data() + rep_->size_,
                                            rep_->data() + rep_->size_ - size,
@@ -340,6 +418,15 @@ protected:
     rep_(vec.rep_->getRef()){
     }
     
+#ifdef BLOOM_CXX11
+    vector_t(Self &&vec) throw():
+    rep_(vec.rep_){
+        /// @cond
+        vec.rep_ = rep::create(0, 0);
+        /// @endcond
+    }
+#endif
+    
     ~vector_t() throw(){
         /// @cond
         rep_->releaseRef();
@@ -348,10 +435,22 @@ protected:
     
     void assign(const Self &vec){
         /// @cond
+        rep *r = vec.rep_->getRef();
+        rep_->releaseRef();
+        rep_ = r;
+        /// @endcond
+    }
+    
+#ifdef BLOOM_CXX11
+    void assign(Self &&vec){
+        /// @cond
+        if(&vec == this)return;
         rep_->releaseRef();
-        rep_ = vec.rep_->getRef();
+        rep_ = vec.rep_;
+        vec.rep_ = rep::create(0, 0);
         /// @endcond
     }
+#endif
 
     void append(const vT *vec, size_t size) {
         /// @cond
@@ -428,7 +527,7 @@ protected:
         if(&vec == this){
             if(index)
                 throw bad_vector_replace("trying to replace self by self with offset"); // throw
-            return *this;
+            return;
         }
         replace(index, vec.rep_->data(), vec.rep_->size_);
         /// @endcond
@@ -493,6 +592,49 @@ protected:
         Traits::copy_construct(rep_->data() + rep_->size_ - 1, &c, 1);
     }
     
+#ifdef BLOOM_CXX11
+    void push_back(vT &&c){
+        /// @cond
+        emplace_back(std::move(c));
+        /// @endcond
+    }
+    
+    /**
+     * @brief Constructing element at the end from arguments.
+     */
+    template<class... Args>
+    void emplace_back(Args&&... args){
+        /// @cond
+        if(rep_->refcount_ || rep_->size_ == rep_->capacity_){
+            // arguments may refer to elements of this vector
+            vT v(std::forward<Args>(args)...);
+            rep_ = rep_->clone_for_append(rep_->size_ + 1);
+            ::new ((void*)(rep_->data() + rep_->size_ - 1)) vT(std::move(v));
+        }
+        else {
+            ::new ((void*)(rep_->data() + rep_->size_)) vT(std::forward<Args>(args)...);
+            ++rep_->size_;
+        }
+        /// @endcond
+    }
+    
+    /**
+     * @brief Constructing element at index from arguments.
+     */
+    template<class... Args>
+    void emplace(size_t index, Args&&... args){
+        /// @cond
+        if(index > rep_->size_)
+            throw bad_vector_insert("index > rep_->size_"); //throw
+        vT v(std::forward<Args>(args)...);
+        if(insert_prepare(index, 1))
+            ::new ((void*)(rep_->data() + index)) vT(std::move(v));
+        else
+            rep_->data()[index] = std::move(v);
+        /// @endcond
+    }
+#endif
+    
     void pop_back() {
         if(!rep_->size_)
             throw bad_vector_pop_back("vector is empty"); // need throw
@@ -530,7 +672,6 @@ protected:
             if(size < old_size)
                 Traits::destroy(rep_->data() + size, old_size - size);
             rep_->size_ = size;
-            rep_->data()[size] = 0;
         }
         /// @endcond
     }
@@ -570,7 +711,7 @@ protected:
         /// @endcond
     }
     
-    vT* const begin() const{
+    vT* begin() const{
         /// @cond
         return rep_->data();
         /// @endcond
@@ -584,7 +725,7 @@ protected:
         /// @endcond
     }
     
-    vT* const end() const{
+    vT* end() const{
         /// @cond
         return rep_->data() + rep_->size_;
         /// @endcond
@@ -0,0 +1,175 @@
+/* 
+ * Copyright © 2015 Sergei Khairulin <sergei.khairulin@gmail.com>. 
+ * All rights reserved.
+ *
+ * This file is part of Bloom++.
+ *
+ * Bloom++ is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Bloom++ is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Bloom++.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include <stdlib.h>
+
+namespace bloom
+{
+
+/**
+ * @brief Chase-Lev work-stealing deque of pointers.
+ * 
+ * The owner thread pushes and pops at the bottom, other threads steal
+ * from the top. The buffer grows by the owner, old buffers are freed
+ * by the destructor only (thieves may still read them).
+ * Memory orders follow "Correct and Efficient Work-Stealing for Weak
+ * Memory Models" (Le, Pop, Cohen, Zappa Nardelli).
+ */
+template<class T>
+class ws_deque
+{
+    /// @cond
+    struct buffer
+    {
+        long size;
+        buffer *prev;
+        T *data[1];
+        
+        static buffer *create(long size, buffer *prev){
+            buffer *b = static_cast<buffer*>(malloc(sizeof(buffer) + (size - 1) * sizeof(T*)));
+            b->size = size;
+            b->prev = prev;
+            return b;
+        }
+        
+        T *get(long i) const {
+            return __atomic_load_n(&data[i & (size - 1)], __ATOMIC_RELAXED);
+        }
+        
+        void put(long i, T *p){
+            __atomic_store_n(&data[i & (size - 1)], p, __ATOMIC_RELAXED);
+        }
+    };
+    
+    long top_;
+    long bottom_;
+    buffer *buffer_;
+    
+    ws_deque(const ws_deque &);
+    ws_deque &operator=(const ws_deque &);
+    
+    buffer *grow(buffer *b, long bottom, long top){
+        buffer *n = buffer::create(b->size * 2, b);
+        for(long i = top; i != bottom; ++i)
+            n->put(i, b->get(i));
+        __atomic_store_n(&buffer_, n, __ATOMIC_RELEASE);
+        return n;
+    }
+    /// @endcond
+    
+public:
+    /**
+     * @param capacity Initial capacity (power of 2).
+     */
+    explicit ws_deque(long capacity = 256):
+    top_(0), bottom_(0), buffer_(buffer::create(capacity, 0)){
+    }
+    
+    ~ws_deque(){
+        /// @cond
+        buffer *b = buffer_;
+        while(b){
+            buffer *prev = b->prev;
+            free(b);
+            b = prev;
+        }
+        /// @endcond
+    }
+    
+    /**
+     * @brief Push to the bottom (owner only).
+     */
+    void push(T *p){
+        /// @cond
+        const long b = __atomic_load_n(&bottom_, __ATOMIC_RELAXED);
+        const long t = __atomic_load_n(&top_, __ATOMIC_ACQUIRE);
+        buffer *a = __atomic_load_n(&buffer_, __ATOMIC_RELAXED);
+        if(b - t > a->size - 1)
+            a = grow(a, b, t);
+        a->put(b, p);
+        __atomic_store_n(&bottom_, b + 1, __ATOMIC_RELEASE);
+        /// @endcond
+    }
+    
+    /**
+     * @brief Pop from the bottom (owner only).
+     * @return Pointer or NULL if empty.
+     */
+    T *pop(){
+        /// @cond
+        const long b = __atomic_load_n(&bottom_, __ATOMIC_RELAXED) - 1;
+        buffer *a = __atomic_load_n(&buffer_, __ATOMIC_RELAXED);
+        __atomic_store_n(&bottom_, b, __ATOMIC_RELAXED);
+        __atomic_thread_fence(__ATOMIC_SEQ_CST);
+        long t = __atomic_load_n(&top_, __ATOMIC_RELAXED);
+        T *p = 0;
+        if(t <= b){
+            p = a->get(b);
+            if(t == b){
+                // the last element, race with thieves
+                if(!__atomic_compare_exchange_n(&top_, &t, t + 1, false,
+                                                __ATOMIC_SEQ_CST, __ATOMIC_RELAXED))
+                    p = 0;
+                __atomic_store_n(&bottom_, b + 1, __ATOMIC_RELAXED);
+            }
+        }
+        else
+            __atomic_store_n(&bottom_, b + 1, __ATOMIC_RELAXED);
+        return p;
+        /// @endcond
+    }
+    
+    /**
+     * @brief Steal from the top (any thread).
+     * @return Pointer or NULL if empty or lost race.
+     */
+    T *steal(){
+        /// @cond
+        long t = __atomic_load_n(&top_, __ATOMIC_ACQUIRE);
+        __atomic_thread_fence(__ATOMIC_SEQ_CST);
+        const long b = __atomic_load_n(&bottom_, __ATOMIC_ACQUIRE);
+        if(t >= b)
+            return 0;
+        buffer *a = __atomic_load_n(&buffer_, __ATOMIC_ACQUIRE);
+        T *p = a->get(t);
+        if(!__atomic_compare_exchange_n(&top_, &t, t + 1, false,
+                                        __ATOMIC_SEQ_CST, __ATOMIC_RELAXED))
+            return 0;
+        return p;
+        /// @endcond
+    }
+    
+    /**
+     * @brief Approximate emptiness (any thread).
+     */
+    bool empty() const {
+        /// @cond
+        const long t = __atomic_load_n(&top_, __ATOMIC_ACQUIRE);
+        const long b = __atomic_load_n(&bottom_, __ATOMIC_ACQUIRE);
+        return b <= t;
+        /// @endcond
+    }
+};
+
+} //namespace bloom
@@ -24,6 +24,8 @@
 #include <typeinfo>
 #include <assert.h>
 #include <bloom++/exception.h>
+#include <bloom++/stream/stringer.h>
+#include <bloom++/_bits/traits.h>
 
 
 #ifdef AUX_DEBUG
@@ -46,58 +48,149 @@ public:
 
 /**
  * @brief Any type value keeper
+ * 
+ * Relocatable values (see is_relocatable) up to 3 pointers in size are
+ * kept inline, others are allocated. Type checks compare the address of
+ * the static type descriptor, typeid is only the fallback.
  */
 class any
 {
 protected:
-
-    class keeper_base
+    /// @cond
+    union storage
     {
-    public:
+        void *ptr;
+        char buf[3 * sizeof(void*)];
+        long long align_ll;
+        double align_d;
+    };
 
-        virtual ~keeper_base()
-        {
-        }
-        virtual const std::type_info & type() = 0;
-        virtual keeper_base * clone() = 0;
-    } *content_;
+    /** Operations of the kept type, 0 copy and destroy mean POD */
+    struct ops_type
+    {
+        const std::type_info &(*type)();
+        void (*copy)(storage &dst, const storage &src);
+        void (*destroy)(storage &s);
+    };
 
     template<class vT>
-    class keeper : public keeper_base
+    struct inplace
     {
-    public:
-        vT value_;
-
-        keeper(const vT &value) : value_(value){}
+        static const bool value = is_relocatable<vT>::value &&
+                                  sizeof(vT) <= sizeof(storage) &&
+                                  __alignof__(vT) <= __alignof__(storage);
+    };
 
-        virtual const std::type_info & type()
-        {
-            return typeid (vT);
+    template<class vT, bool = inplace<vT>::value>
+    struct holder
+    {
+        static const ops_type ops;
+        static const std::type_info &type(){
+            return typeid(vT);
+        }
+        static vT *value(storage &s){
+            return static_cast<vT*>(s.ptr);
+        }
+        static void create(storage &s, const vT &v){
+            s.ptr = new vT(v);
         }
+        static void copy(storage &dst, const storage &src){
+            dst.ptr = new vT(*static_cast<const vT*>(src.ptr));
+        }
+        static void destroy(storage &s){
+            delete static_cast<vT*>(s.ptr);
+        }
+    };
 
-        virtual keeper_base * clone()
-        {
-            return new keeper(value_);
+    template<class vT>
+    struct holder<vT, true>
+    {
+        static const ops_type ops;
+        static const std::type_info &type(){
+            return typeid(vT);
+        }
+        static vT *value(storage &s){
+            return reinterpret_cast<vT*>(s.buf);
+        }
+        static void create(storage &s, const vT &v){
+            ::new ((void*)s.buf) vT(v);
+        }
+        static void copy(storage &dst, const storage &src){
+            ::new ((void*)dst.buf) vT(*reinterpret_cast<const vT*>(src.buf));
+        }
+        static void destroy(storage &s){
+            reinterpret_cast<vT*>(s.buf)->~vT();
         }
     };
 
+    const ops_type *ops_;
+    storage storage_;
+
+    template<class vT>
+    vT *value_ptr() const
+    {
+        typedef holder<vT> H;
+        if(ops_ != &H::ops && (!ops_ || ops_->type() != typeid(vT)))
+            return 0;
+        return H::value(const_cast<storage&>(storage_));
+    }
+
+    template<class vT>
+    static void throw_bad_cast()
+    {
+        throw bad_any_cast(fast_ostring("bad cast to \"",
+                                        typeid(vT).name(),
+                                        "\"!"));
+    }
+    /// @endcond
+
 public:
-    any() : content_(0)
+    any() : ops_(0)
     {
+        storage_.ptr = 0;
     }
 
-    template<class vT> any(const vT &v)
+    template<class vT> any(const vT &v) : ops_(&holder<vT>::ops)
     {
-        content_ = new keeper<vT>(v);
+        holder<vT>::create(storage_, v);
     }
     
-    any(const any &o) : content_(o.content_ ? o.content_->clone() : NULL)
+    any(const any &o) : ops_(o.ops_)
     {
+        /// @cond
+        if(ops_ && ops_->copy)
+            ops_->copy(storage_, o.storage_);
+        else
+            storage_ = o.storage_;
+        /// @endcond
     }
 
+#ifdef BLOOM_CXX11
+    any(any &&o) : ops_(o.ops_), storage_(o.storage_)
+    {
+        o.ops_ = 0;
+    }
+
+    any & operator=(any &&o)
+    {
+        /// @cond
+        if(this != &o){
+            reset();
+            ops_ = o.ops_;
+            storage_ = o.storage_;
+            o.ops_ = 0;
+        }
+        return *this;
+        /// @endcond
+    }
+#endif
+
     ~any()
     {
-        delete content_;
+        /// @cond
+        if(ops_ && ops_->destroy)
+            ops_->destroy(storage_);
+        /// @endcond
     }
     /**
      * @brief Check if it's empty.
@@ -105,7 +198,7 @@ public:
      */
     bool empty() const
     {
-        return !content_;
+        return !ops_;
     }
     /**
      * @brief get type info
@@ -113,17 +206,31 @@ public:
      */
     const std::type_info & type() const
     {
-        return content_ ? content_->type() : typeid (void);
+        return ops_ ? ops_->type() : typeid (void);
+    }
+    /**
+     * @brief Check type of the value.
+     * @return true if value has type vT.
+     */
+    template<class vT>
+    bool is() const
+    {
+        return value_ptr<vT>() != 0;
     }
     /**
      * @brief Swap objects of class.
+     * 
+     * Doesn't copy or allocate, the kept values are relocatable.
      * @param o 2th object
      * @return this object.
      */
     any & swap(any &o)
     {
-        std::swap(content_, o.content_);
+        /// @cond
+        std::swap(ops_, o.ops_);
+        std::swap(storage_, o.storage_);
         return *this;
+        /// @endcond
     }
     /**
      * @brief Convert to real-type.
@@ -133,13 +240,21 @@ public:
     template<class vT>
     vT &get()
     {
-        keeper<vT> *ptr = dynamic_cast<keeper<vT> *>(content_);
-        if(!ptr){
-            throw bad_any_cast(fast_ostring("bad cast to \"", 
-                                            typeid(vT).name(), 
-                                            "\"!"));
-        }
-        return ptr->value_;
+        /// @cond
+        vT *p = value_ptr<vT>();
+        if(!p)throw_bad_cast<vT>();
+        return *p;
+        /// @endcond
+    }
+
+    template<class vT>
+    const vT &get() const
+    {
+        /// @cond
+        const vT *p = value_ptr<vT>();
+        if(!p)throw_bad_cast<vT>();
+        return *p;
+        /// @endcond
     }
     
     template<class vT>
@@ -162,4 +277,22 @@ public:
 
 };
 
+/// @cond
+template<class vT, bool inplace_>
+const any::ops_type any::holder<vT, inplace_>::ops = {
+    &any::holder<vT, inplace_>::type,
+    &any::holder<vT, inplace_>::copy,
+    &any::holder<vT, inplace_>::destroy
+};
+
+template<class vT>
+const any::ops_type any::holder<vT, true>::ops = {
+    &any::holder<vT, true>::type,
+    BLOOM_IS_POD(vT) ? 0 : &any::holder<vT, true>::copy,
+    BLOOM_IS_POD(vT) ? 0 : &any::holder<vT, true>::destroy
+};
+/// @endcond
+
 } //namespace bloom
+
+BLOOM_DECLARE_RELOCATABLE(bloom::any)
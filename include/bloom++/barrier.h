@@ -0,0 +1,85 @@
+/* 
+ * Copyright © 2015 Sergei Khairulin <sergei.khairulin@gmail.com>. 
+ * All rights reserved.
+ *
+ * This file is part of Bloom++.
+ *
+ * Bloom++ is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Bloom++ is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Bloom++.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#pragma once
+
+#include <bloom++/_bits/futex.h>
+
+namespace bloom
+{
+
+/**
+ * @brief Reusable barrier for a fixed number of threads.
+ * 
+ * Built on futex: arriving threads sleep on the phase number
+ * which the last thread increments.
+ */
+class barrier
+{
+public:
+    /**
+     * @param count Number of threads.
+     */
+    barrier(int count):count_(count), remaining_(count), phase_(0)
+    {
+    }
+    
+    /**
+     * @brief Wait for all threads of the current phase.
+     * @return true for one thread of each phase (the last arrived).
+     */
+    bool arrive_and_wait()
+    {
+        /// @cond
+        const int phase = __atomic_load_n(&phase_, __ATOMIC_ACQUIRE);
+        if(__sync_sub_and_fetch(&remaining_, 1) == 0){
+            // nobody can arrive to the next phase before phase_ changes
+            __atomic_store_n(&remaining_, count_, __ATOMIC_RELAXED);
+            __sync_fetch_and_add(&phase_, 1);
+            futex_wake_all(&phase_);
+            return true;
+        }
+        while(__atomic_load_n(&phase_, __ATOMIC_ACQUIRE) == phase)
+            futex_wait(&phase_, phase);
+        return false;
+        /// @endcond
+    }
+    
+    /**
+     * @brief Number of threads.
+     */
+    int size() const
+    {
+        return count_;
+    }
+    
+private:
+    /// @cond
+    const int count_;
+    volatile int remaining_;
+    volatile int phase_;
+    
+    barrier(const barrier &);
+    barrier &operator=(const barrier &);
+    /// @endcond
+};
+
+} //namespace bloom
@@ -0,0 +1,245 @@
+/* 
+ * Copyright © 2015 Sergei Khairulin <sergei.khairulin@gmail.com>. 
+ * All rights reserved.
+ *
+ * This file is part of Bloom++.
+ *
+ * Bloom++ is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Bloom++ is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Bloom++.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#pragma once
+
+#include <sched.h>
+#include <bloom++/spinlock.h>
+#include <bloom++/event_count.h>
+#include <bloom++/clock.h>
+#include <bloom++/mpmc_queue.h>
+#include <bloom++/spsc_queue.h>
+
+namespace bloom
+{
+
+/**
+ * @brief Waiting by busy spinning: the lowest latency, burns a core.
+ */
+class spin_wait
+{
+public:
+    typedef int key;
+    key prepare_wait(){ return 0; }
+    void cancel_wait(){}
+    void wait(key){ cpu_relax(); }
+    bool wait(key, long){ cpu_relax(); return true; }
+    void notify_one(){}
+    void notify_all(){}
+};
+
+/**
+ * @brief Waiting by yielding the CPU to other threads.
+ */
+class yield_wait
+{
+public:
+    typedef int key;
+    key prepare_wait(){ return 0; }
+    void cancel_wait(){}
+    void wait(key){ sched_yield(); }
+    bool wait(key, long){ sched_yield(); return true; }
+    void notify_one(){}
+    void notify_all(){}
+};
+
+/**
+ * @brief Waiting by sleeping in the kernel (futex), see event_count.
+ * 
+ * Notification costs a fence and a load while nobody sleeps.
+ */
+typedef event_count park_wait;
+
+/**
+ * @brief Blocking wrapper of mpmc_queue or spsc_queue.
+ * 
+ * push() waits while the queue is full, pop() waits while it's empty.
+ * Wait is the wait strategy: spin_wait, yield_wait or park_wait.
+ * @code
+ * blocking_queue<mpmc_queue<job*> > q(1024);
+ * @endcode
+ */
+template<class Q, class Wait = park_wait>
+class blocking_queue
+{
+public:
+    typedef typename Q::value_type value_type;
+    
+    /**
+     * @param capacity Minimal capacity.
+     */
+    blocking_queue(size_t capacity):q_(capacity)
+    {
+    }
+    
+    bool try_push(const value_type &v)
+    {
+        /// @cond
+        if(!q_.try_push(v))
+            return false;
+        not_empty_.notify_one();
+        return true;
+        /// @endcond
+    }
+    
+    bool try_pop(value_type &v)
+    {
+        /// @cond
+        if(!q_.try_pop(v))
+            return false;
+        not_full_.notify_one();
+        return true;
+        /// @endcond
+    }
+    
+    /**
+     * @brief Push value, wait while the queue is full.
+     */
+    void push(const value_type &v)
+    {
+        /// @cond
+        while(!q_.try_push(v)){
+            typename Wait::key k = not_full_.prepare_wait();
+            if(q_.try_push(v)){
+                not_full_.cancel_wait();
+                break;
+            }
+            not_full_.wait(k);
+        }
+        not_empty_.notify_one();
+        /// @endcond
+    }
+    
+    /**
+     * @brief Pop value, wait while the queue is empty.
+     */
+    void pop(value_type &v)
+    {
+        /// @cond
+        while(!q_.try_pop(v)){
+            typename Wait::key k = not_empty_.prepare_wait();
+            if(q_.try_pop(v)){
+                not_empty_.cancel_wait();
+                break;
+            }
+            not_empty_.wait(k);
+        }
+        not_full_.notify_one();
+        /// @endcond
+    }
+    
+    /**
+     * @brief Pop value, wait while the queue is empty.
+     * @param v Value.
+     * @param timeout_ms Timeout in milliseconds.
+     * @return false on timeout.
+     */
+    bool pop(value_type &v, long timeout_ms)
+    {
+        /// @cond
+        const unsigned long long deadline = clock::now_ns() + timeout_ms * 1000000ULL;
+        while(!q_.try_pop(v)){
+            const unsigned long long now = clock::now_ns();
+            if(now >= deadline)
+                return false;
+            typename Wait::key k = not_empty_.prepare_wait();
+            if(q_.try_pop(v)){
+                not_empty_.cancel_wait();
+                break;
+            }
+            not_empty_.wait(k, (long)((deadline - now + 999999) / 1000000));
+        }
+        not_full_.notify_one();
+        return true;
+        /// @endcond
+    }
+    
+    /**
+     * @brief Push all n values, wait while the queue is full.
+     */
+    void push_n(const value_type *v, size_t n)
+    {
+        /// @cond
+        while(n){
+            size_t k = q_.push_n(v, n);
+            if(!k){
+                typename Wait::key key = not_full_.prepare_wait();
+                if(!(k = q_.push_n(v, n))){
+                    not_full_.wait(key);
+                    continue;
+                }
+                not_full_.cancel_wait();
+            }
+            v += k;
+            n -= k;
+            not_empty_.notify_all();
+        }
+        /// @endcond
+    }
+    
+    /**
+     * @brief Pop up to n values, wait while the queue is empty.
+     * @return Number of popped values (at least 1).
+     */
+    size_t pop_n(value_type *v, size_t n)
+    {
+        /// @cond
+        size_t k;
+        while(!(k = q_.pop_n(v, n))){
+            typename Wait::key key = not_empty_.prepare_wait();
+            if((k = q_.pop_n(v, n))){
+                not_empty_.cancel_wait();
+                break;
+            }
+            not_empty_.wait(key);
+        }
+        not_full_.notify_all();
+        return k;
+        /// @endcond
+    }
+    
+    size_t size() const
+    {
+        return q_.size();
+    }
+    
+    bool empty() const
+    {
+        return q_.empty();
+    }
+    
+    size_t capacity() const
+    {
+        return q_.capacity();
+    }
+    
+private:
+    /// @cond
+    Q q_;
+    Wait not_empty_;
+    Wait not_full_;
+    
+    blocking_queue(const blocking_queue &);
+    blocking_queue &operator=(const blocking_queue &);
+    /// @endcond
+};
+
+} //namespace bloom
@@ -0,0 +1,148 @@
+/* 
+ * Copyright © 2015 Sergei Khairulin <sergei.khairulin@gmail.com>. 
+ * All rights reserved.
+ *
+ * This file is part of Bloom++.
+ *
+ * Bloom++ is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Bloom++ is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Bloom++.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#pragma once
+
+#include <time.h>
+#include <bloom++/_bits/c++config.h>
+
+namespace bloom
+{
+
+/// @cond
+struct clock_ticker;
+/// @endcond
+
+/**
+ * @brief Clocks for timing and latency measurement.
+ * 
+ * - now_ns(): CLOCK_MONOTONIC nanoseconds (vDSO, no system call);
+ * - coarse_ns(): CLOCK_MONOTONIC_COARSE, cheaper, scheduler tick resolution;
+ * - cycles(): CPU time stamp counter, convert with cycles_to_ns();
+ * - cached_ns(): value refreshed by the ticker thread (start_ticker()),
+ *   a plain memory load on the hot path.
+ * 
+ * All values count from an unspecified point, use differences.
+ */
+class clock
+{
+public:
+    /**
+     * @brief Monotonic nanoseconds.
+     */
+    static unsigned long long now_ns()
+    {
+        /// @cond
+        timespec ts;
+        clock_gettime(CLOCK_MONOTONIC, &ts);
+        return (unsigned long long)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+        /// @endcond
+    }
+    
+    /**
+     * @brief Monotonic nanoseconds with resolution of the scheduler tick.
+     */
+    static unsigned long long coarse_ns()
+    {
+        /// @cond
+        timespec ts;
+#ifdef CLOCK_MONOTONIC_COARSE
+        clock_gettime(CLOCK_MONOTONIC_COARSE, &ts);
+#else
+        clock_gettime(CLOCK_MONOTONIC, &ts);
+#endif
+        return (unsigned long long)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+        /// @endcond
+    }
+    
+    /**
+     * @brief CPU cycles (rdtsc), now_ns() on other architectures.
+     * 
+     * Not serializing: the CPU may reorder it with nearby instructions.
+     */
+    static unsigned long long cycles()
+    {
+        /// @cond
+#if defined(__i386__) || defined(__x86_64__)
+        return __builtin_ia32_rdtsc();
+#else
+        return now_ns();
+#endif
+        /// @endcond
+    }
+    
+    /**
+     * @brief Convert cycles (or their difference) to nanoseconds.
+     * 
+     * The first call calibrates the counter against CLOCK_MONOTONIC
+     * (about 10 ms).
+     */
+    static unsigned long long cycles_to_ns(unsigned long long c)
+    {
+        return (unsigned long long)(c * ns_per_cycle());
+    }
+    
+    /**
+     * @brief Nanoseconds per cycle (calibrated once).
+     */
+    static double ns_per_cycle();
+    
+    /**
+     * @brief Is the time stamp counter constant-rate and usable across CPUs.
+     * 
+     * If false, cycles() may drift with frequency scaling.
+     */
+    static bool invariant_tsc();
+    
+    /**
+     * @brief now_ns() refreshed by the ticker thread.
+     * 
+     * Lags by up to the ticker period. Equals now_ns() while the ticker
+     * isn't running.
+     */
+    static unsigned long long cached_ns()
+    {
+        /// @cond
+        const unsigned long long t = __atomic_load_n(&cached_, __ATOMIC_RELAXED);
+        return t ? t : now_ns();
+        /// @endcond
+    }
+    
+    /**
+     * @brief Start the ticker thread for cached_ns().
+     * @param period_us Refresh period in microseconds.
+     * @return false if already running or thread creation failed.
+     */
+    static bool start_ticker(long period_us = 100);
+    
+    /**
+     * @brief Stop the ticker thread.
+     */
+    static void stop_ticker();
+    
+private:
+    /// @cond
+    friend struct clock_ticker;
+    static unsigned long long cached_;
+    /// @endcond
+};
+
+} //namespace bloom
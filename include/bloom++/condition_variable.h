@@ -24,17 +24,28 @@
 #include <bloom++/mutex.h>
 #include <pthread.h>
 #include <errno.h>
+#include <time.h>
 
 namespace bloom
 {
 
 /**
  * @brief condition_variable
+ * 
+ * Timed waits take relative timeouts in milliseconds. Waits with
+ * a predicate check it in a loop until it's true or the timeout expires.
  */
 class condition_variable
 {
 public:
-    condition_variable();
+    /// Clock of timed waits
+    enum clock_type{
+        realtime = CLOCK_REALTIME,
+        /// Not affected by system time changes
+        monotonic = CLOCK_MONOTONIC
+    };
+    
+    condition_variable(clock_type clock = monotonic);
     ~condition_variable();
     
     void wait(mutex &m);
@@ -45,13 +56,13 @@ public:
     template<class T>
     void wait(mutex &m, bool (T::*method)(), T *obj){
         while(!((obj->*method)()))
-            pthread_cond_wait(&cv_, &m.mutex_);
+            cond_wait(m);
     }
     
     template<class T>
     void wait(mutex::scoped_lock &sl, bool (T::*method)(), T *obj){
         while(!((obj->*method)()))
-            pthread_cond_wait(&cv_, &sl.m_.mutex_);
+            cond_wait(sl.m_);
     }
     
     bool wait(mutex &m, long timeout_ms);
@@ -63,10 +74,9 @@ public:
     bool wait(mutex &m, bool (T::*method)(), T *obj, long timeout_ms){
         timespec ts;
         set_timeout(ts, timeout_ms);
-        if(!(obj->*method)())
-            if(pthread_cond_timedwait(&cv_, &m.mutex_, &ts) == ETIMEDOUT ||
-                    !(obj->*method)())
-                return false;
+        while(!(obj->*method)())
+            if(cond_timedwait(m, ts) == ETIMEDOUT)
+                return (obj->*method)();
         return true;
     }
     
@@ -74,10 +84,9 @@ public:
     bool wait(mutex::scoped_lock &sl, bool (T::*method)(), T *obj, long timeout_ms){
         timespec ts;
         set_timeout(ts, timeout_ms);
-        if(!(obj->*method)())
-            if(pthread_cond_timedwait(&cv_, &sl.m_.mutex_, &ts) == ETIMEDOUT ||
-                    !(obj->*method)())
-                return false;
+        while(!(obj->*method)())
+            if(cond_timedwait(sl.m_, ts) == ETIMEDOUT)
+                return (obj->*method)();
         return true;
     }
     
@@ -86,7 +95,30 @@ public:
     
 private:
     pthread_cond_t cv_;
+    clockid_t clock_;
     void set_timeout(timespec &ts, long ms);
+    
+    int cond_wait(mutex &m){
+#ifdef BLOOM_MUTEX_PROFILE
+        const unsigned int depth = m.before_wait();
+        const int r = pthread_cond_wait(&cv_, &m.mutex_);
+        m.after_wait(depth);
+        return r;
+#else
+        return pthread_cond_wait(&cv_, &m.mutex_);
+#endif
+    }
+    
+    int cond_timedwait(mutex &m, const timespec &ts){
+#ifdef BLOOM_MUTEX_PROFILE
+        const unsigned int depth = m.before_wait();
+        const int r = pthread_cond_timedwait(&cv_, &m.mutex_, &ts);
+        m.after_wait(depth);
+        return r;
+#else
+        return pthread_cond_timedwait(&cv_, &m.mutex_, &ts);
+#endif
+    }
 };
 
 }//namespace bloom
@@ -0,0 +1,930 @@
+/* 
+ * Copyright © 2015 Sergei Khairulin <sergei.khairulin@gmail.com>. 
+ * All rights reserved.
+ *
+ * This file is part of Bloom++.
+ *
+ * Bloom++ is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Bloom++ is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Bloom++.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#pragma once
+
+namespace bloom
+{
+
+/// @cond
+namespace _bits {
+/** Incomplete class used as common type of stored member function pointers */
+class delegate_any;
+}
+/// @endcond
+
+/**
+ * @brief Delegate without parameters.
+ *
+ * Keeps the object pointer and the member (or free) function pointer
+ * inline and calls it through a stub, so it's copied by value and
+ * never allocates.
+ */
+template<class T_Ret>
+class delegate0
+{
+public:
+    delegate0():obj_(0),stub_(0){}
+
+    template<class T_Obj>
+    delegate0(T_Obj *obj, T_Ret (T_Obj::*fn)()):
+    obj_(obj),stub_(&delegate0::template mem_stub<T_Obj>){
+        mfn_ = reinterpret_cast<any_mem_fn>(fn);
+    }
+
+    template<class T_Obj>
+    delegate0(const T_Obj *obj, T_Ret (T_Obj::*fn)() const):
+    obj_(const_cast<T_Obj *>(obj)),stub_(&delegate0::template const_mem_stub<T_Obj>){
+        mfn_ = reinterpret_cast<any_mem_fn>(fn);
+    }
+
+    delegate0(T_Ret (*fn)()):
+    obj_(0),stub_(&delegate0::fn_stub){
+        fn_ = fn;
+    }
+
+    /**
+     * @brief Delegate to the member function known at compile time.
+     *
+     * The stub calls the function directly, so it can be inlined.
+     */
+    template<class T_Obj, T_Ret (T_Obj::*fn)()>
+    static delegate0 from_method(T_Obj *obj){
+        /// @cond
+        delegate0 d;
+        d.obj_ = obj;
+        d.mfn_ = reinterpret_cast<any_mem_fn>(fn);
+        d.stub_ = &delegate0::template method_stub<T_Obj, fn>;
+        return d;
+        /// @endcond
+    }
+
+    T_Ret operator()() const {
+        return stub_(*this);
+    }
+
+    T_Ret emit() const {
+        return stub_(*this);
+    }
+
+    bool empty() const {
+        return !stub_;
+    }
+
+    void reset(){
+        obj_ = 0;
+        stub_ = 0;
+    }
+
+    bool operator==(const delegate0 &d) const {
+        /// @cond
+        if(stub_ != d.stub_ || obj_ != d.obj_)return false;
+        if(!stub_)return true;
+        return stub_ == &delegate0::fn_stub ? fn_ == d.fn_ : mfn_ == d.mfn_;
+        /// @endcond
+    }
+
+    bool operator!=(const delegate0 &d) const {
+        return !operator==(d);
+    }
+
+private:
+    /// @cond
+    typedef T_Ret (_bits::delegate_any::*any_mem_fn)();
+    typedef T_Ret (*stub_fn)(const delegate0 &);
+
+    template<class T_Obj>
+    static T_Ret mem_stub(const delegate0 &d){
+        typedef T_Ret (T_Obj::*mem_fn)();
+        return (static_cast<T_Obj *>(d.obj_)->*reinterpret_cast<mem_fn>(d.mfn_))();
+    }
+
+    template<class T_Obj>
+    static T_Ret const_mem_stub(const delegate0 &d){
+        typedef T_Ret (T_Obj::*mem_fn)() const;
+        return (static_cast<const T_Obj *>(d.obj_)->*reinterpret_cast<mem_fn>(d.mfn_))();
+    }
+
+    template<class T_Obj, T_Ret (T_Obj::*fn)()>
+    static T_Ret method_stub(const delegate0 &d){
+        return (static_cast<T_Obj *>(d.obj_)->*fn)();
+    }
+
+    static T_Ret fn_stub(const delegate0 &d){
+        return d.fn_();
+    }
+
+    void *obj_;
+    union {
+        any_mem_fn mfn_;
+        T_Ret (*fn_)();
+    };
+    stub_fn stub_;
+    /// @endcond
+};
+
+/**
+ * @brief Delegate with 1 parameter.
+ *
+ * Keeps the object pointer and the member (or free) function pointer
+ * inline and calls it through a stub, so it's copied by value and
+ * never allocates.
+ */
+template<class T_Ret, class T_Par1>
+class delegate1
+{
+public:
+    delegate1():obj_(0),stub_(0){}
+
+    template<class T_Obj>
+    delegate1(T_Obj *obj, T_Ret (T_Obj::*fn)(T_Par1)):
+    obj_(obj),stub_(&delegate1::template mem_stub<T_Obj>){
+        mfn_ = reinterpret_cast<any_mem_fn>(fn);
+    }
+
+    template<class T_Obj>
+    delegate1(const T_Obj *obj, T_Ret (T_Obj::*fn)(T_Par1) const):
+    obj_(const_cast<T_Obj *>(obj)),stub_(&delegate1::template const_mem_stub<T_Obj>){
+        mfn_ = reinterpret_cast<any_mem_fn>(fn);
+    }
+
+    delegate1(T_Ret (*fn)(T_Par1)):
+    obj_(0),stub_(&delegate1::fn_stub){
+        fn_ = fn;
+    }
+
+    /**
+     * @brief Delegate to the member function known at compile time.
+     *
+     * The stub calls the function directly, so it can be inlined.
+     */
+    template<class T_Obj, T_Ret (T_Obj::*fn)(T_Par1)>
+    static delegate1 from_method(T_Obj *obj){
+        /// @cond
+        delegate1 d;
+        d.obj_ = obj;
+        d.mfn_ = reinterpret_cast<any_mem_fn>(fn);
+        d.stub_ = &delegate1::template method_stub<T_Obj, fn>;
+        return d;
+        /// @endcond
+    }
+
+    T_Ret operator()(T_Par1 par1) const {
+        return stub_(*this, par1);
+    }
+
+    T_Ret emit(T_Par1 par1) const {
+        return stub_(*this, par1);
+    }
+
+    bool empty() const {
+        return !stub_;
+    }
+
+    void reset(){
+        obj_ = 0;
+        stub_ = 0;
+    }
+
+    bool operator==(const delegate1 &d) const {
+        /// @cond
+        if(stub_ != d.stub_ || obj_ != d.obj_)return false;
+        if(!stub_)return true;
+        return stub_ == &delegate1::fn_stub ? fn_ == d.fn_ : mfn_ == d.mfn_;
+        /// @endcond
+    }
+
+    bool operator!=(const delegate1 &d) const {
+        return !operator==(d);
+    }
+
+private:
+    /// @cond
+    typedef T_Ret (_bits::delegate_any::*any_mem_fn)(T_Par1);
+    typedef T_Ret (*stub_fn)(const delegate1 &, T_Par1);
+
+    template<class T_Obj>
+    static T_Ret mem_stub(const delegate1 &d, T_Par1 par1){
+        typedef T_Ret (T_Obj::*mem_fn)(T_Par1);
+        return (static_cast<T_Obj *>(d.obj_)->*reinterpret_cast<mem_fn>(d.mfn_))(par1);
+    }
+
+    template<class T_Obj>
+    static T_Ret const_mem_stub(const delegate1 &d, T_Par1 par1){
+        typedef T_Ret (T_Obj::*mem_fn)(T_Par1) const;
+        return (static_cast<const T_Obj *>(d.obj_)->*reinterpret_cast<mem_fn>(d.mfn_))(par1);
+    }
+
+    template<class T_Obj, T_Ret (T_Obj::*fn)(T_Par1)>
+    static T_Ret method_stub(const delegate1 &d, T_Par1 par1){
+        return (static_cast<T_Obj *>(d.obj_)->*fn)(par1);
+    }
+
+    static T_Ret fn_stub(const delegate1 &d, T_Par1 par1){
+        return d.fn_(par1);
+    }
+
+    void *obj_;
+    union {
+        any_mem_fn mfn_;
+        T_Ret (*fn_)(T_Par1);
+    };
+    stub_fn stub_;
+    /// @endcond
+};
+
+/**
+ * @brief Delegate with 2 parameters.
+ *
+ * Keeps the object pointer and the member (or free) function pointer
+ * inline and calls it through a stub, so it's copied by value and
+ * never allocates.
+ */
+template<class T_Ret, class T_Par1, class T_Par2>
+class delegate2
+{
+public:
+    delegate2():obj_(0),stub_(0){}
+
+    template<class T_Obj>
+    delegate2(T_Obj *obj, T_Ret (T_Obj::*fn)(T_Par1, T_Par2)):
+    obj_(obj),stub_(&delegate2::template mem_stub<T_Obj>){
+        mfn_ = reinterpret_cast<any_mem_fn>(fn);
+    }
+
+    template<class T_Obj>
+    delegate2(const T_Obj *obj, T_Ret (T_Obj::*fn)(T_Par1, T_Par2) const):
+    obj_(const_cast<T_Obj *>(obj)),stub_(&delegate2::template const_mem_stub<T_Obj>){
+        mfn_ = reinterpret_cast<any_mem_fn>(fn);
+    }
+
+    delegate2(T_Ret (*fn)(T_Par1, T_Par2)):
+    obj_(0),stub_(&delegate2::fn_stub){
+        fn_ = fn;
+    }
+
+    /**
+     * @brief Delegate to the member function known at compile time.
+     *
+     * The stub calls the function directly, so it can be inlined.
+     */
+    template<class T_Obj, T_Ret (T_Obj::*fn)(T_Par1, T_Par2)>
+    static delegate2 from_method(T_Obj *obj){
+        /// @cond
+        delegate2 d;
+        d.obj_ = obj;
+        d.mfn_ = reinterpret_cast<any_mem_fn>(fn);
+        d.stub_ = &delegate2::template method_stub<T_Obj, fn>;
+        return d;
+        /// @endcond
+    }
+
+    T_Ret operator()(T_Par1 par1, T_Par2 par2) const {
+        return stub_(*this, par1, par2);
+    }
+
+    T_Ret emit(T_Par1 par1, T_Par2 par2) const {
+        return stub_(*this, par1, par2);
+    }
+
+    bool empty() const {
+        return !stub_;
+    }
+
+    void reset(){
+        obj_ = 0;
+        stub_ = 0;
+    }
+
+    bool operator==(const delegate2 &d) const {
+        /// @cond
+        if(stub_ != d.stub_ || obj_ != d.obj_)return false;
+        if(!stub_)return true;
+        return stub_ == &delegate2::fn_stub ? fn_ == d.fn_ : mfn_ == d.mfn_;
+        /// @endcond
+    }
+
+    bool operator!=(const delegate2 &d) const {
+        return !operator==(d);
+    }
+
+private:
+    /// @cond
+    typedef T_Ret (_bits::delegate_any::*any_mem_fn)(T_Par1, T_Par2);
+    typedef T_Ret (*stub_fn)(const delegate2 &, T_Par1, T_Par2);
+
+    template<class T_Obj>
+    static T_Ret mem_stub(const delegate2 &d, T_Par1 par1, T_Par2 par2){
+        typedef T_Ret (T_Obj::*mem_fn)(T_Par1, T_Par2);
+        return (static_cast<T_Obj *>(d.obj_)->*reinterpret_cast<mem_fn>(d.mfn_))(par1, par2);
+    }
+
+    template<class T_Obj>
+    static T_Ret const_mem_stub(const delegate2 &d, T_Par1 par1, T_Par2 par2){
+        typedef T_Ret (T_Obj::*mem_fn)(T_Par1, T_Par2) const;
+        return (static_cast<const T_Obj *>(d.obj_)->*reinterpret_cast<mem_fn>(d.mfn_))(par1, par2);
+    }
+
+    template<class T_Obj, T_Ret (T_Obj::*fn)(T_Par1, T_Par2)>
+    static T_Ret method_stub(const delegate2 &d, T_Par1 par1, T_Par2 par2){
+        return (static_cast<T_Obj *>(d.obj_)->*fn)(par1, par2);
+    }
+
+    static T_Ret fn_stub(const delegate2 &d, T_Par1 par1, T_Par2 par2){
+        return d.fn_(par1, par2);
+    }
+
+    void *obj_;
+    union {
+        any_mem_fn mfn_;
+        T_Ret (*fn_)(T_Par1, T_Par2);
+    };
+    stub_fn stub_;
+    /// @endcond
+};
+
+/**
+ * @brief Delegate with 3 parameters.
+ *
+ * Keeps the object pointer and the member (or free) function pointer
+ * inline and calls it through a stub, so it's copied by value and
+ * never allocates.
+ */
+template<class T_Ret, class T_Par1, class T_Par2, class T_Par3>
+class delegate3
+{
+public:
+    delegate3():obj_(0),stub_(0){}
+
+    template<class T_Obj>
+    delegate3(T_Obj *obj, T_Ret (T_Obj::*fn)(T_Par1, T_Par2, T_Par3)):
+    obj_(obj),stub_(&delegate3::template mem_stub<T_Obj>){
+        mfn_ = reinterpret_cast<any_mem_fn>(fn);
+    }
+
+    template<class T_Obj>
+    delegate3(const T_Obj *obj, T_Ret (T_Obj::*fn)(T_Par1, T_Par2, T_Par3) const):
+    obj_(const_cast<T_Obj *>(obj)),stub_(&delegate3::template const_mem_stub<T_Obj>){
+        mfn_ = reinterpret_cast<any_mem_fn>(fn);
+    }
+
+    delegate3(T_Ret (*fn)(T_Par1, T_Par2, T_Par3)):
+    obj_(0),stub_(&delegate3::fn_stub){
+        fn_ = fn;
+    }
+
+    /**
+     * @brief Delegate to the member function known at compile time.
+     *
+     * The stub calls the function directly, so it can be inlined.
+     */
+    template<class T_Obj, T_Ret (T_Obj::*fn)(T_Par1, T_Par2, T_Par3)>
+    static delegate3 from_method(T_Obj *obj){
+        /// @cond
+        delegate3 d;
+        d.obj_ = obj;
+        d.mfn_ = reinterpret_cast<any_mem_fn>(fn);
+        d.stub_ = &delegate3::template method_stub<T_Obj, fn>;
+        return d;
+        /// @endcond
+    }
+
+    T_Ret operator()(T_Par1 par1, T_Par2 par2, T_Par3 par3) const {
+        return stub_(*this, par1, par2, par3);
+    }
+
+    T_Ret emit(T_Par1 par1, T_Par2 par2, T_Par3 par3) const {
+        return stub_(*this, par1, par2, par3);
+    }
+
+    bool empty() const {
+        return !stub_;
+    }
+
+    void reset(){
+        obj_ = 0;
+        stub_ = 0;
+    }
+
+    bool operator==(const delegate3 &d) const {
+        /// @cond
+        if(stub_ != d.stub_ || obj_ != d.obj_)return false;
+        if(!stub_)return true;
+        return stub_ == &delegate3::fn_stub ? fn_ == d.fn_ : mfn_ == d.mfn_;
+        /// @endcond
+    }
+
+    bool operator!=(const delegate3 &d) const {
+        return !operator==(d);
+    }
+
+private:
+    /// @cond
+    typedef T_Ret (_bits::delegate_any::*any_mem_fn)(T_Par1, T_Par2, T_Par3);
+    typedef T_Ret (*stub_fn)(const delegate3 &, T_Par1, T_Par2, T_Par3);
+
+    template<class T_Obj>
+    static T_Ret mem_stub(const delegate3 &d, T_Par1 par1, T_Par2 par2, T_Par3 par3){
+        typedef T_Ret (T_Obj::*mem_fn)(T_Par1, T_Par2, T_Par3);
+        return (static_cast<T_Obj *>(d.obj_)->*reinterpret_cast<mem_fn>(d.mfn_))(par1, par2, par3);
+    }
+
+    template<class T_Obj>
+    static T_Ret const_mem_stub(const delegate3 &d, T_Par1 par1, T_Par2 par2, T_Par3 par3){
+        typedef T_Ret (T_Obj::*mem_fn)(T_Par1, T_Par2, T_Par3) const;
+        return (static_cast<const T_Obj *>(d.obj_)->*reinterpret_cast<mem_fn>(d.mfn_))(par1, par2, par3);
+    }
+
+    template<class T_Obj, T_Ret (T_Obj::*fn)(T_Par1, T_Par2, T_Par3)>
+    static T_Ret method_stub(const delegate3 &d, T_Par1 par1, T_Par2 par2, T_Par3 par3){
+        return (static_cast<T_Obj *>(d.obj_)->*fn)(par1, par2, par3);
+    }
+
+    static T_Ret fn_stub(const delegate3 &d, T_Par1 par1, T_Par2 par2, T_Par3 par3){
+        return d.fn_(par1, par2, par3);
+    }
+
+    void *obj_;
+    union {
+        any_mem_fn mfn_;
+        T_Ret (*fn_)(T_Par1, T_Par2, T_Par3);
+    };
+    stub_fn stub_;
+    /// @endcond
+};
+
+/**
+ * @brief Delegate with 4 parameters.
+ *
+ * Keeps the object pointer and the member (or free) function pointer
+ * inline and calls it through a stub, so it's copied by value and
+ * never allocates.
+ */
+template<class T_Ret, class T_Par1, class T_Par2, class T_Par3, class T_Par4>
+class delegate4
+{
+public:
+    delegate4():obj_(0),stub_(0){}
+
+    template<class T_Obj>
+    delegate4(T_Obj *obj, T_Ret (T_Obj::*fn)(T_Par1, T_Par2, T_Par3, T_Par4)):
+    obj_(obj),stub_(&delegate4::template mem_stub<T_Obj>){
+        mfn_ = reinterpret_cast<any_mem_fn>(fn);
+    }
+
+    template<class T_Obj>
+    delegate4(const T_Obj *obj, T_Ret (T_Obj::*fn)(T_Par1, T_Par2, T_Par3, T_Par4) const):
+    obj_(const_cast<T_Obj *>(obj)),stub_(&delegate4::template const_mem_stub<T_Obj>){
+        mfn_ = reinterpret_cast<any_mem_fn>(fn);
+    }
+
+    delegate4(T_Ret (*fn)(T_Par1, T_Par2, T_Par3, T_Par4)):
+    obj_(0),stub_(&delegate4::fn_stub){
+        fn_ = fn;
+    }
+
+    /**
+     * @brief Delegate to the member function known at compile time.
+     *
+     * The stub calls the function directly, so it can be inlined.
+     */
+    template<class T_Obj, T_Ret (T_Obj::*fn)(T_Par1, T_Par2, T_Par3, T_Par4)>
+    static delegate4 from_method(T_Obj *obj){
+        /// @cond
+        delegate4 d;
+        d.obj_ = obj;
+        d.mfn_ = reinterpret_cast<any_mem_fn>(fn);
+        d.stub_ = &delegate4::template method_stub<T_Obj, fn>;
+        return d;
+        /// @endcond
+    }
+
+    T_Ret operator()(T_Par1 par1, T_Par2 par2, T_Par3 par3, T_Par4 par4) const {
+        return stub_(*this, par1, par2, par3, par4);
+    }
+
+    T_Ret emit(T_Par1 par1, T_Par2 par2, T_Par3 par3, T_Par4 par4) const {
+        return stub_(*this, par1, par2, par3, par4);
+    }
+
+    bool empty() const {
+        return !stub_;
+    }
+
+    void reset(){
+        obj_ = 0;
+        stub_ = 0;
+    }
+
+    bool operator==(const delegate4 &d) const {
+        /// @cond
+        if(stub_ != d.stub_ || obj_ != d.obj_)return false;
+        if(!stub_)return true;
+        return stub_ == &delegate4::fn_stub ? fn_ == d.fn_ : mfn_ == d.mfn_;
+        /// @endcond
+    }
+
+    bool operator!=(const delegate4 &d) const {
+        return !operator==(d);
+    }
+
+private:
+    /// @cond
+    typedef T_Ret (_bits::delegate_any::*any_mem_fn)(T_Par1, T_Par2, T_Par3, T_Par4);
+    typedef T_Ret (*stub_fn)(const delegate4 &, T_Par1, T_Par2, T_Par3, T_Par4);
+
+    template<class T_Obj>
+    static T_Ret mem_stub(const delegate4 &d, T_Par1 par1, T_Par2 par2, T_Par3 par3, T_Par4 par4){
+        typedef T_Ret (T_Obj::*mem_fn)(T_Par1, T_Par2, T_Par3, T_Par4);
+        return (static_cast<T_Obj *>(d.obj_)->*reinterpret_cast<mem_fn>(d.mfn_))(par1, par2, par3, par4);
+    }
+
+    template<class T_Obj>
+    static T_Ret const_mem_stub(const delegate4 &d, T_Par1 par1, T_Par2 par2, T_Par3 par3, T_Par4 par4){
+        typedef T_Ret (T_Obj::*mem_fn)(T_Par1, T_Par2, T_Par3, T_Par4) const;
+        return (static_cast<const T_Obj *>(d.obj_)->*reinterpret_cast<mem_fn>(d.mfn_))(par1, par2, par3, par4);
+    }
+
+    template<class T_Obj, T_Ret (T_Obj::*fn)(T_Par1, T_Par2, T_Par3, T_Par4)>
+    static T_Ret method_stub(const delegate4 &d, T_Par1 par1, T_Par2 par2, T_Par3 par3, T_Par4 par4){
+        return (static_cast<T_Obj *>(d.obj_)->*fn)(par1, par2, par3, par4);
+    }
+
+    static T_Ret fn_stub(const delegate4 &d, T_Par1 par1, T_Par2 par2, T_Par3 par3, T_Par4 par4){
+        return d.fn_(par1, par2, par3, par4);
+    }
+
+    void *obj_;
+    union {
+        any_mem_fn mfn_;
+        T_Ret (*fn_)(T_Par1, T_Par2, T_Par3, T_Par4);
+    };
+    stub_fn stub_;
+    /// @endcond
+};
+
+/**
+ * @brief Delegate with 5 parameters.
+ *
+ * Keeps the object pointer and the member (or free) function pointer
+ * inline and calls it through a stub, so it's copied by value and
+ * never allocates.
+ */
+template<class T_Ret, class T_Par1, class T_Par2, class T_Par3, class T_Par4, class T_Par5>
+class delegate5
+{
+public:
+    delegate5():obj_(0),stub_(0){}
+
+    template<class T_Obj>
+    delegate5(T_Obj *obj, T_Ret (T_Obj::*fn)(T_Par1, T_Par2, T_Par3, T_Par4, T_Par5)):
+    obj_(obj),stub_(&delegate5::template mem_stub<T_Obj>){
+        mfn_ = reinterpret_cast<any_mem_fn>(fn);
+    }
+
+    template<class T_Obj>
+    delegate5(const T_Obj *obj, T_Ret (T_Obj::*fn)(T_Par1, T_Par2, T_Par3, T_Par4, T_Par5) const):
+    obj_(const_cast<T_Obj *>(obj)),stub_(&delegate5::template const_mem_stub<T_Obj>){
+        mfn_ = reinterpret_cast<any_mem_fn>(fn);
+    }
+
+    delegate5(T_Ret (*fn)(T_Par1, T_Par2, T_Par3, T_Par4, T_Par5)):
+    obj_(0),stub_(&delegate5::fn_stub){
+        fn_ = fn;
+    }
+
+    /**
+     * @brief Delegate to the member function known at compile time.
+     *
+     * The stub calls the function directly, so it can be inlined.
+     */
+    template<class T_Obj, T_Ret (T_Obj::*fn)(T_Par1, T_Par2, T_Par3, T_Par4, T_Par5)>
+    static delegate5 from_method(T_Obj *obj){
+        /// @cond
+        delegate5 d;
+        d.obj_ = obj;
+        d.mfn_ = reinterpret_cast<any_mem_fn>(fn);
+        d.stub_ = &delegate5::template method_stub<T_Obj, fn>;
+        return d;
+        /// @endcond
+    }
+
+    T_Ret operator()(T_Par1 par1, T_Par2 par2, T_Par3 par3, T_Par4 par4, T_Par5 par5) const {
+        return stub_(*this, par1, par2, par3, par4, par5);
+    }
+
+    T_Ret emit(T_Par1 par1, T_Par2 par2, T_Par3 par3, T_Par4 par4, T_Par5 par5) const {
+        return stub_(*this, par1, par2, par3, par4, par5);
+    }
+
+    bool empty() const {
+        return !stub_;
+    }
+
+    void reset(){
+        obj_ = 0;
+        stub_ = 0;
+    }
+
+    bool operator==(const delegate5 &d) const {
+        /// @cond
+        if(stub_ != d.stub_ || obj_ != d.obj_)return false;
+        if(!stub_)return true;
+        return stub_ == &delegate5::fn_stub ? fn_ == d.fn_ : mfn_ == d.mfn_;
+        /// @endcond
+    }
+
+    bool operator!=(const delegate5 &d) const {
+        return !operator==(d);
+    }
+
+private:
+    /// @cond
+    typedef T_Ret (_bits::delegate_any::*any_mem_fn)(T_Par1, T_Par2, T_Par3, T_Par4, T_Par5);
+    typedef T_Ret (*stub_fn)(const delegate5 &, T_Par1, T_Par2, T_Par3, T_Par4, T_Par5);
+
+    template<class T_Obj>
+    static T_Ret mem_stub(const delegate5 &d, T_Par1 par1, T_Par2 par2, T_Par3 par3, T_Par4 par4, T_Par5 par5){
+        typedef T_Ret (T_Obj::*mem_fn)(T_Par1, T_Par2, T_Par3, T_Par4, T_Par5);
+        return (static_cast<T_Obj *>(d.obj_)->*reinterpret_cast<mem_fn>(d.mfn_))(par1, par2, par3, par4, par5);
+    }
+
+    template<class T_Obj>
+    static T_Ret const_mem_stub(const delegate5 &d, T_Par1 par1, T_Par2 par2, T_Par3 par3, T_Par4 par4, T_Par5 par5){
+        typedef T_Ret (T_Obj::*mem_fn)(T_Par1, T_Par2, T_Par3, T_Par4, T_Par5) const;
+        return (static_cast<const T_Obj *>(d.obj_)->*reinterpret_cast<mem_fn>(d.mfn_))(par1, par2, par3, par4, par5);
+    }
+
+    template<class T_Obj, T_Ret (T_Obj::*fn)(T_Par1, T_Par2, T_Par3, T_Par4, T_Par5)>
+    static T_Ret method_stub(const delegate5 &d, T_Par1 par1, T_Par2 par2, T_Par3 par3, T_Par4 par4, T_Par5 par5){
+        return (static_cast<T_Obj *>(d.obj_)->*fn)(par1, par2, par3, par4, par5);
+    }
+
+    static T_Ret fn_stub(const delegate5 &d, T_Par1 par1, T_Par2 par2, T_Par3 par3, T_Par4 par4, T_Par5 par5){
+        return d.fn_(par1, par2, par3, par4, par5);
+    }
+
+    void *obj_;
+    union {
+        any_mem_fn mfn_;
+        T_Ret (*fn_)(T_Par1, T_Par2, T_Par3, T_Par4, T_Par5);
+    };
+    stub_fn stub_;
+    /// @endcond
+};
+
+/**
+ * @brief Delegate with 6 parameters.
+ *
+ * Keeps the object pointer and the member (or free) function pointer
+ * inline and calls it through a stub, so it's copied by value and
+ * never allocates.
+ */
+template<class T_Ret, class T_Par1, class T_Par2, class T_Par3, class T_Par4, class T_Par5, class T_Par6>
+class delegate6
+{
+public:
+    delegate6():obj_(0),stub_(0){}
+
+    template<class T_Obj>
+    delegate6(T_Obj *obj, T_Ret (T_Obj::*fn)(T_Par1, T_Par2, T_Par3, T_Par4, T_Par5, T_Par6)):
+    obj_(obj),stub_(&delegate6::template mem_stub<T_Obj>){
+        mfn_ = reinterpret_cast<any_mem_fn>(fn);
+    }
+
+    template<class T_Obj>
+    delegate6(const T_Obj *obj, T_Ret (T_Obj::*fn)(T_Par1, T_Par2, T_Par3, T_Par4, T_Par5, T_Par6) const):
+    obj_(const_cast<T_Obj *>(obj)),stub_(&delegate6::template const_mem_stub<T_Obj>){
+        mfn_ = reinterpret_cast<any_mem_fn>(fn);
+    }
+
+    delegate6(T_Ret (*fn)(T_Par1, T_Par2, T_Par3, T_Par4, T_Par5, T_Par6)):
+    obj_(0),stub_(&delegate6::fn_stub){
+        fn_ = fn;
+    }
+
+    /**
+     * @brief Delegate to the member function known at compile time.
+     *
+     * The stub calls the function directly, so it can be inlined.
+     */
+    template<class T_Obj, T_Ret (T_Obj::*fn)(T_Par1, T_Par2, T_Par3, T_Par4, T_Par5, T_Par6)>
+    static delegate6 from_method(T_Obj *obj){
+        /// @cond
+        delegate6 d;
+        d.obj_ = obj;
+        d.mfn_ = reinterpret_cast<any_mem_fn>(fn);
+        d.stub_ = &delegate6::template method_stub<T_Obj, fn>;
+        return d;
+        /// @endcond
+    }
+
+    T_Ret operator()(T_Par1 par1, T_Par2 par2, T_Par3 par3, T_Par4 par4, T_Par5 par5, T_Par6 par6) const {
+        return stub_(*this, par1, par2, par3, par4, par5, par6);
+    }
+
+    T_Ret emit(T_Par1 par1, T_Par2 par2, T_Par3 par3, T_Par4 par4, T_Par5 par5, T_Par6 par6) const {
+        return stub_(*this, par1, par2, par3, par4, par5, par6);
+    }
+
+    bool empty() const {
+        return !stub_;
+    }
+
+    void reset(){
+        obj_ = 0;
+        stub_ = 0;
+    }
+
+    bool operator==(const delegate6 &d) const {
+        /// @cond
+        if(stub_ != d.stub_ || obj_ != d.obj_)return false;
+        if(!stub_)return true;
+        return stub_ == &delegate6::fn_stub ? fn_ == d.fn_ : mfn_ == d.mfn_;
+        /// @endcond
+    }
+
+    bool operator!=(const delegate6 &d) const {
+        return !operator==(d);
+    }
+
+private:
+    /// @cond
+    typedef T_Ret (_bits::delegate_any::*any_mem_fn)(T_Par1, T_Par2, T_Par3, T_Par4, T_Par5, T_Par6);
+    typedef T_Ret (*stub_fn)(const delegate6 &, T_Par1, T_Par2, T_Par3, T_Par4, T_Par5, T_Par6);
+
+    template<class T_Obj>
+    static T_Ret mem_stub(const delegate6 &d, T_Par1 par1, T_Par2 par2, T_Par3 par3, T_Par4 par4, T_Par5 par5, T_Par6 par6){
+        typedef T_Ret (T_Obj::*mem_fn)(T_Par1, T_Par2, T_Par3, T_Par4, T_Par5, T_Par6);
+        return (static_cast<T_Obj *>(d.obj_)->*reinterpret_cast<mem_fn>(d.mfn_))(par1, par2, par3, par4, par5, par6);
+    }
+
+    template<class T_Obj>
+    static T_Ret const_mem_stub(const delegate6 &d, T_Par1 par1, T_Par2 par2, T_Par3 par3, T_Par4 par4, T_Par5 par5, T_Par6 par6){
+        typedef T_Ret (T_Obj::*mem_fn)(T_Par1, T_Par2, T_Par3, T_Par4, T_Par5, T_Par6) const;
+        return (static_cast<const T_Obj *>(d.obj_)->*reinterpret_cast<mem_fn>(d.mfn_))(par1, par2, par3, par4, par5, par6);
+    }
+
+    template<class T_Obj, T_Ret (T_Obj::*fn)(T_Par1, T_Par2, T_Par3, T_Par4, T_Par5, T_Par6)>
+    static T_Ret method_stub(const delegate6 &d, T_Par1 par1, T_Par2 par2, T_Par3 par3, T_Par4 par4, T_Par5 par5, T_Par6 par6){
+        return (static_cast<T_Obj *>(d.obj_)->*fn)(par1, par2, par3, par4, par5, par6);
+    }
+
+    static T_Ret fn_stub(const delegate6 &d, T_Par1 par1, T_Par2 par2, T_Par3 par3, T_Par4 par4, T_Par5 par5, T_Par6 par6){
+        return d.fn_(par1, par2, par3, par4, par5, par6);
+    }
+
+    void *obj_;
+    union {
+        any_mem_fn mfn_;
+        T_Ret (*fn_)(T_Par1, T_Par2, T_Par3, T_Par4, T_Par5, T_Par6);
+    };
+    stub_fn stub_;
+    /// @endcond
+};
+
+template<class T_Ret, class T_Obj>
+inline delegate0<T_Ret>
+make_delegate(T_Obj *obj, T_Ret (T_Obj::*fn)()){
+    return delegate0<T_Ret>(obj, fn);
+}
+
+template<class T_Ret, class T_Obj>
+inline delegate0<T_Ret>
+make_delegate(const T_Obj *obj, T_Ret (T_Obj::*fn)() const){
+    return delegate0<T_Ret>(obj, fn);
+}
+
+template<class T_Ret>
+inline delegate0<T_Ret>
+make_delegate(T_Ret (*fn)()){
+    return delegate0<T_Ret>(fn);
+}
+
+template<class T_Ret, class T_Obj, class T_Par1>
+inline delegate1<T_Ret, T_Par1>
+make_delegate(T_Obj *obj, T_Ret (T_Obj::*fn)(T_Par1)){
+    return delegate1<T_Ret, T_Par1>(obj, fn);
+}
+
+template<class T_Ret, class T_Obj, class T_Par1>
+inline delegate1<T_Ret, T_Par1>
+make_delegate(const T_Obj *obj, T_Ret (T_Obj::*fn)(T_Par1) const){
+    return delegate1<T_Ret, T_Par1>(obj, fn);
+}
+
+template<class T_Ret, class T_Par1>
+inline delegate1<T_Ret, T_Par1>
+make_delegate(T_Ret (*fn)(T_Par1)){
+    return delegate1<T_Ret, T_Par1>(fn);
+}
+
+template<class T_Ret, class T_Obj, class T_Par1, class T_Par2>
+inline delegate2<T_Ret, T_Par1, T_Par2>
+make_delegate(T_Obj *obj, T_Ret (T_Obj::*fn)(T_Par1, T_Par2)){
+    return delegate2<T_Ret, T_Par1, T_Par2>(obj, fn);
+}
+
+template<class T_Ret, class T_Obj, class T_Par1, class T_Par2>
+inline delegate2<T_Ret, T_Par1, T_Par2>
+make_delegate(const T_Obj *obj, T_Ret (T_Obj::*fn)(T_Par1, T_Par2) const){
+    return delegate2<T_Ret, T_Par1, T_Par2>(obj, fn);
+}
+
+template<class T_Ret, class T_Par1, class T_Par2>
+inline delegate2<T_Ret, T_Par1, T_Par2>
+make_delegate(T_Ret (*fn)(T_Par1, T_Par2)){
+    return delegate2<T_Ret, T_Par1, T_Par2>(fn);
+}
+
+template<class T_Ret, class T_Obj, class T_Par1, class T_Par2, class T_Par3>
+inline delegate3<T_Ret, T_Par1, T_Par2, T_Par3>
+make_delegate(T_Obj *obj, T_Ret (T_Obj::*fn)(T_Par1, T_Par2, T_Par3)){
+    return delegate3<T_Ret, T_Par1, T_Par2, T_Par3>(obj, fn);
+}
+
+template<class T_Ret, class T_Obj, class T_Par1, class T_Par2, class T_Par3>
+inline delegate3<T_Ret, T_Par1, T_Par2, T_Par3>
+make_delegate(const T_Obj *obj, T_Ret (T_Obj::*fn)(T_Par1, T_Par2, T_Par3) const){
+    return delegate3<T_Ret, T_Par1, T_Par2, T_Par3>(obj, fn);
+}
+
+template<class T_Ret, class T_Par1, class T_Par2, class T_Par3>
+inline delegate3<T_Ret, T_Par1, T_Par2, T_Par3>
+make_delegate(T_Ret (*fn)(T_Par1, T_Par2, T_Par3)){
+    return delegate3<T_Ret, T_Par1, T_Par2, T_Par3>(fn);
+}
+
+template<class T_Ret, class T_Obj, class T_Par1, class T_Par2, class T_Par3, class T_Par4>
+inline delegate4<T_Ret, T_Par1, T_Par2, T_Par3, T_Par4>
+make_delegate(T_Obj *obj, T_Ret (T_Obj::*fn)(T_Par1, T_Par2, T_Par3, T_Par4)){
+    return delegate4<T_Ret, T_Par1, T_Par2, T_Par3, T_Par4>(obj, fn);
+}
+
+template<class T_Ret, class T_Obj, class T_Par1, class T_Par2, class T_Par3, class T_Par4>
+inline delegate4<T_Ret, T_Par1, T_Par2, T_Par3, T_Par4>
+make_delegate(const T_Obj *obj, T_Ret (T_Obj::*fn)(T_Par1, T_Par2, T_Par3, T_Par4) const){
+    return delegate4<T_Ret, T_Par1, T_Par2, T_Par3, T_Par4>(obj, fn);
+}
+
+template<class T_Ret, class T_Par1, class T_Par2, class T_Par3, class T_Par4>
+inline delegate4<T_Ret, T_Par1, T_Par2, T_Par3, T_Par4>
+make_delegate(T_Ret (*fn)(T_Par1, T_Par2, T_Par3, T_Par4)){
+    return delegate4<T_Ret, T_Par1, T_Par2, T_Par3, T_Par4>(fn);
+}
+
+template<class T_Ret, class T_Obj, class T_Par1, class T_Par2, class T_Par3, class T_Par4, class T_Par5>
+inline delegate5<T_Ret, T_Par1, T_Par2, T_Par3, T_Par4, T_Par5>
+make_delegate(T_Obj *obj, T_Ret (T_Obj::*fn)(T_Par1, T_Par2, T_Par3, T_Par4, T_Par5)){
+    return delegate5<T_Ret, T_Par1, T_Par2, T_Par3, T_Par4, T_Par5>(obj, fn);
+}
+
+template<class T_Ret, class T_Obj, class T_Par1, class T_Par2, class T_Par3, class T_Par4, class T_Par5>
+inline delegate5<T_Ret, T_Par1, T_Par2, T_Par3, T_Par4, T_Par5>
+make_delegate(const T_Obj *obj, T_Ret (T_Obj::*fn)(T_Par1, T_Par2, T_Par3, T_Par4, T_Par5) const){
+    return delegate5<T_Ret, T_Par1, T_Par2, T_Par3, T_Par4, T_Par5>(obj, fn);
+}
+
+template<class T_Ret, class T_Par1, class T_Par2, class T_Par3, class T_Par4, class T_Par5>
+inline delegate5<T_Ret, T_Par1, T_Par2, T_Par3, T_Par4, T_Par5>
+make_delegate(T_Ret (*fn)(T_Par1, T_Par2, T_Par3, T_Par4, T_Par5)){
+    return delegate5<T_Ret, T_Par1, T_Par2, T_Par3, T_Par4, T_Par5>(fn);
+}
+
+template<class T_Ret, class T_Obj, class T_Par1, class T_Par2, class T_Par3, class T_Par4, class T_Par5, class T_Par6>
+inline delegate6<T_Ret, T_Par1, T_Par2, T_Par3, T_Par4, T_Par5, T_Par6>
+make_delegate(T_Obj *obj, T_Ret (T_Obj::*fn)(T_Par1, T_Par2, T_Par3, T_Par4, T_Par5, T_Par6)){
+    return delegate6<T_Ret, T_Par1, T_Par2, T_Par3, T_Par4, T_Par5, T_Par6>(obj, fn);
+}
+
+template<class T_Ret, class T_Obj, class T_Par1, class T_Par2, class T_Par3, class T_Par4, class T_Par5, class T_Par6>
+inline delegate6<T_Ret, T_Par1, T_Par2, T_Par3, T_Par4, T_Par5, T_Par6>
+make_delegate(const T_Obj *obj, T_Ret (T_Obj::*fn)(T_Par1, T_Par2, T_Par3, T_Par4, T_Par5, T_Par6) const){
+    return delegate6<T_Ret, T_Par1, T_Par2, T_Par3, T_Par4, T_Par5, T_Par6>(obj, fn);
+}
+
+template<class T_Ret, class T_Par1, class T_Par2, class T_Par3, class T_Par4, class T_Par5, class T_Par6>
+inline delegate6<T_Ret, T_Par1, T_Par2, T_Par3, T_Par4, T_Par5, T_Par6>
+make_delegate(T_Ret (*fn)(T_Par1, T_Par2, T_Par3, T_Par4, T_Par5, T_Par6)){
+    return delegate6<T_Ret, T_Par1, T_Par2, T_Par3, T_Par4, T_Par5, T_Par6>(fn);
+}
+
+} //namespace bloom
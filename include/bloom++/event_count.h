@@ -0,0 +1,172 @@
+/* 
+ * Copyright © 2015 Sergei Khairulin <sergei.khairulin@gmail.com>. 
+ * All rights reserved.
+ *
+ * This file is part of Bloom++.
+ *
+ * Bloom++ is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Bloom++ is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Bloom++.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#pragma once
+
+#include <bloom++/_bits/futex.h>
+
+namespace bloom
+{
+
+/**
+ * @brief Event count: blocking for lock-free data structures.
+ * 
+ * Waiter:
+ * @code
+ * for(;;){
+ *     if(queue.try_pop(v))break;
+ *     event_count::key k = ec.prepare_wait();
+ *     if(queue.try_pop(v)){ ec.cancel_wait(); break; }
+ *     ec.wait(k);
+ * }
+ * @endcode
+ * Notifier: queue.push(v); ec.notify_one();
+ * 
+ * A notification after prepare_wait() is never lost. notify_*() doesn't
+ * enter the kernel if nobody waits or all waiters are already being
+ * woken up.
+ */
+class event_count
+{
+public:
+    typedef int key;
+    
+    event_count():epoch_(0), state_(0)
+    {
+    }
+    
+    /**
+     * @brief Register as waiter, then recheck the condition.
+     * @return Key for wait().
+     */
+    key prepare_wait()
+    {
+        /// @cond
+        __sync_fetch_and_add(&state_, waiter);
+        return __atomic_load_n(&epoch_, __ATOMIC_SEQ_CST);
+        /// @endcond
+    }
+    
+    /**
+     * @brief Unregister if the condition became true after prepare_wait().
+     */
+    void cancel_wait()
+    {
+        leave();
+    }
+    
+    /**
+     * @brief Wait for notification after prepare_wait().
+     * @param k Key from prepare_wait().
+     */
+    void wait(key k)
+    {
+        /// @cond
+        while(__atomic_load_n(&epoch_, __ATOMIC_ACQUIRE) == k)
+            futex_wait(&epoch_, k);
+        leave();
+        /// @endcond
+    }
+    
+    /**
+     * @brief Wait for notification after prepare_wait().
+     * @param k Key from prepare_wait().
+     * @param timeout_ms Timeout in milliseconds.
+     * @return false on timeout.
+     */
+    bool wait(key k, long timeout_ms)
+    {
+        /// @cond
+        timespec deadline;
+        monotonic_deadline(deadline, timeout_ms);
+        bool r = true;
+        while(__atomic_load_n(&epoch_, __ATOMIC_ACQUIRE) == k)
+            if(!futex_wait(&epoch_, k, &deadline)){
+                r = __atomic_load_n(&epoch_, __ATOMIC_ACQUIRE) != k;
+                break;
+            }
+        leave();
+        return r;
+        /// @endcond
+    }
+    
+    void notify_one()
+    {
+        /// @cond
+        // pairs with the increment in prepare_wait()
+        __sync_synchronize();
+        unsigned long long s = __atomic_load_n(&state_, __ATOMIC_RELAXED);
+        for(;;){
+            if((s >> 32) <= (s & signal_mask))
+                return; // nobody waits or everybody is being woken up
+            if(__atomic_compare_exchange_n(&state_, &s, s + 1, true,
+                                           __ATOMIC_SEQ_CST, __ATOMIC_RELAXED))
+                break;
+        }
+        __sync_fetch_and_add(&epoch_, 1);
+        futex_wake(&epoch_, 1);
+        /// @endcond
+    }
+    
+    void notify_all()
+    {
+        /// @cond
+        __sync_synchronize();
+        unsigned long long s = __atomic_load_n(&state_, __ATOMIC_RELAXED);
+        for(;;){
+            if((s >> 32) <= (s & signal_mask))
+                return;
+            if(__atomic_compare_exchange_n(&state_, &s, (s & ~signal_mask) | (s >> 32), true,
+                                           __ATOMIC_SEQ_CST, __ATOMIC_RELAXED))
+                break;
+        }
+        __sync_fetch_and_add(&epoch_, 1);
+        futex_wake_all(&epoch_);
+        /// @endcond
+    }
+    
+private:
+    /// @cond
+    static const unsigned long long waiter = 1ULL << 32;
+    static const unsigned long long signal_mask = 0xffffffffULL;
+    
+    volatile int epoch_;
+    // waiters (high half) and wakeups not yet consumed by them (low half)
+    unsigned long long state_;
+    
+    void leave()
+    {
+        unsigned long long s = __atomic_load_n(&state_, __ATOMIC_RELAXED);
+        unsigned long long n;
+        do{
+            n = s - waiter;
+            if(s & signal_mask)
+                --n;
+        }while(!__atomic_compare_exchange_n(&state_, &s, n, true,
+                                            __ATOMIC_SEQ_CST, __ATOMIC_RELAXED));
+    }
+    
+    event_count(const event_count &);
+    event_count &operator=(const event_count &);
+    /// @endcond
+};
+
+} //namespace bloom
@@ -0,0 +1,288 @@
+/* 
+ * Copyright © 2015 Sergei Khairulin <sergei.khairulin@gmail.com>. 
+ * All rights reserved.
+ *
+ * This file is part of Bloom++.
+ *
+ * Bloom++ is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Bloom++ is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Bloom++.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#pragma once
+
+#include <stddef.h>
+#include <bloom++/exception.h>
+#include <bloom++/delegate.h>
+#include <bloom++/spinlock.h>
+
+namespace bloom
+{
+
+class fiber_scheduler;
+
+/// @cond
+namespace _bits {
+class fiber_queue;
+}
+/// @endcond
+
+/**
+ * @brief Exception of fibers.
+ */
+class fiber_exception: public exception
+{
+public:
+    fiber_exception(const string &msg):exception(msg){}
+};
+
+/**
+ * @brief Stackful coroutine run by fiber_scheduler.
+ * 
+ * Fibers are created by fiber_scheduler::spawn() and never migrate from
+ * the scheduler's thread. Static methods act on the current fiber.
+ * An exception leaving a fiber function is swallowed and the fiber
+ * finishes, handle errors in the function.
+ */
+class fiber
+{
+public:
+    /// Events for wait_fd()
+    enum io_event {
+        io_read = 1,
+        io_write = 2
+    };
+
+    /**
+     * @brief Current fiber.
+     * @return NULL outside of fibers.
+     */
+    static fiber *current();
+
+    /**
+     * @brief Let other ready fibers run.
+     */
+    static void yield();
+
+    /**
+     * @brief Suspend the current fiber.
+     * @param ms Milliseconds.
+     */
+    static void sleep(long ms);
+
+    /**
+     * @brief Suspend the current fiber until fd is ready.
+     * 
+     * Outside of fibers polls fd. One fiber may wait for reading and
+     * another one for writing the same descriptor.
+     * @param fd File descriptor.
+     * @param ev io_read and/or io_write.
+     * @param timeout_ms Timeout in milliseconds (-1 - infinite).
+     * @return false on timeout or if polling failed (errno is set).
+     */
+    static bool wait_fd(int fd, int ev, long timeout_ms = -1);
+
+    fiber_scheduler *scheduler() const {
+        return scheduler_;
+    }
+
+    /**
+     * @brief Start waiting, for synchronization primitives.
+     * 
+     * Call on the current fiber before publishing it to wakers,
+     * then call wait().
+     */
+    void prepare_wait();
+
+    /**
+     * @brief Suspend after prepare_wait() until wake() or timeout.
+     * @param timeout_ms Timeout in milliseconds (-1 - infinite).
+     * @return false on timeout.
+     */
+    bool wait(long timeout_ms = -1);
+
+    /**
+     * @brief Resume the waiting fiber. Thread-safe.
+     * @return false if it doesn't wait or is already woken up
+     * (e.g. by timeout).
+     */
+    bool wake();
+
+private:
+    /// @cond
+    friend class fiber_scheduler;
+    friend class _bits::fiber_queue;
+
+    enum state_type {
+        st_running = 0,
+        st_waiting = 1,
+        st_ready = 2
+    };
+
+    fiber(fiber_scheduler *s);
+    ~fiber();
+
+    fiber_scheduler *scheduler_;
+    delegate0<void> fn_;
+    void (*cfn_)(void *);
+    void *arg_;
+    void *sp_;          // saved stack pointer or ucontext
+    void *stack_;
+    size_t stackSize_;
+    volatile int state_;
+    unsigned int waitSeq_;
+    bool timedOut_;
+    bool done_;
+    fiber *next_;       // ready and free lists
+    fiber *waitNext_;   // waiters of primitives
+    /// @endcond
+
+    fiber(const fiber &);
+    fiber &operator=(const fiber &);
+};
+
+/// @cond
+namespace _bits {
+
+/** FIFO of waiting fibers, protected by the user's lock */
+class fiber_queue
+{
+public:
+    fiber_queue():head_(0), tail_(0){}
+
+    bool empty() const {
+        return !head_;
+    }
+    void push(fiber *f){
+        f->waitNext_ = 0;
+        if(tail_)tail_->waitNext_ = f;
+        else head_ = f;
+        tail_ = f;
+    }
+    fiber *pop(){
+        fiber *f = head_;
+        if(f){
+            head_ = f->waitNext_;
+            if(!head_)tail_ = 0;
+        }
+        return f;
+    }
+    void remove(fiber *f){
+        fiber *prev = 0;
+        for(fiber *i = head_; i; prev = i, i = i->waitNext_)
+            if(i == f){
+                if(prev)prev->waitNext_ = f->waitNext_;
+                else head_ = f->waitNext_;
+                if(tail_ == f)tail_ = prev;
+                return;
+            }
+    }
+private:
+    fiber *head_;
+    fiber *tail_;
+};
+
+} //namespace _bits
+/// @endcond
+
+/**
+ * @brief Per-thread scheduler of fibers with epoll readiness.
+ * 
+ * @code
+ * void handler(void *arg){
+ *     connection *c = (connection*)arg;
+ *     // socket calls suspend the fiber instead of the thread
+ *     c->socket()->recv(buf, sizeof buf);
+ * }
+ * fiber_scheduler s;
+ * s.spawn(&handler, conn);
+ * s.run(); // returns when all fibers are finished
+ * @endcode
+ */
+class fiber_scheduler
+{
+public:
+    /**
+     * @param stack_size Stack size of fibers.
+     * @param cached_stacks Number of stacks kept for reuse.
+     */
+    fiber_scheduler(size_t stack_size = 64 * 1024, size_t cached_stacks = 64);
+    ~fiber_scheduler();
+
+    /**
+     * @brief Scheduler running on the current thread.
+     * @return NULL if none.
+     */
+    static fiber_scheduler *current();
+
+    /**
+     * @brief Create fiber. Thread-safe.
+     * @param fn Fiber function.
+     */
+    void spawn(const delegate0<void> &fn);
+
+    /**
+     * @brief Create fiber. Thread-safe.
+     * @param fn Fiber function.
+     * @param arg Argument of fn.
+     */
+    void spawn(void (*fn)(void *), void *arg);
+
+    template<class T>
+    void spawn(T *obj, void (T::*fn)()){
+        spawn(delegate0<void>(obj, fn));
+    }
+
+    /**
+     * @brief Run fibers on the calling thread.
+     * 
+     * Returns when there are no fibers or stop() is called.
+     */
+    void run();
+
+    /**
+     * @brief Make run() return. Thread-safe.
+     */
+    void stop();
+
+    /**
+     * @brief Number of not finished fibers.
+     */
+    size_t size() const;
+
+private:
+    /// @cond
+    friend class fiber;
+    struct impl;
+    impl *impl_;
+
+    static void entry();
+    fiber *create();
+    void schedule(fiber *f);
+    void resume(fiber *f);
+    void finish(fiber *f);
+    void switch_out(fiber *f);
+    bool wait_fd(fiber *f, int fd, int ev, long timeout_ms);
+    bool arm_fd(int fd);
+    void fd_ready(int fd, unsigned int events);
+    void add_timer(fiber *f, long timeout_ms);
+    static bool wait_ended(fiber *f, unsigned int seq);
+    void drop_stale_timers();
+
+    fiber_scheduler(const fiber_scheduler &);
+    fiber_scheduler &operator=(const fiber_scheduler &);
+    /// @endcond
+};
+
+} //namespace bloom
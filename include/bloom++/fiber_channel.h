@@ -0,0 +1,176 @@
+/* 
+ * Copyright © 2015 Sergei Khairulin <sergei.khairulin@gmail.com>. 
+ * All rights reserved.
+ *
+ * This file is part of Bloom++.
+ *
+ * Bloom++ is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Bloom++ is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Bloom++.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#pragma once
+
+#include <bloom++/list.h>
+#include <bloom++/fiber_condition_variable.h>
+
+namespace bloom
+{
+
+/**
+ * @brief FIFO channel between fibers.
+ * 
+ * push() and pop() suspend the fiber while the channel is full or
+ * empty, try_push() and try_pop() may be used from any thread.
+ */
+template<class T>
+class fiber_channel
+{
+public:
+    /**
+     * @param capacity Maximum number of values (0 - unbounded).
+     */
+    explicit fiber_channel(size_t capacity = 0):
+    capacity_(capacity), closed_(false)
+    {
+    }
+
+    /**
+     * @brief Wait for room and push.
+     * @return false if closed.
+     */
+    bool push(const T &v)
+    {
+        /// @cond
+        fiber_mutex::scoped_lock sl(m_);
+        while(!closed_ && full())
+            notFull_.wait(m_);
+        if(closed_)return false;
+        q_.push_back(v);
+        notEmpty_.notify_one();
+        return true;
+        /// @endcond
+    }
+
+    /**
+     * @return false if full or closed.
+     */
+    bool try_push(const T &v)
+    {
+        /// @cond
+        fiber_mutex::scoped_lock sl(m_);
+        if(closed_ || full())return false;
+        q_.push_back(v);
+        notEmpty_.notify_one();
+        return true;
+        /// @endcond
+    }
+
+    /**
+     * @brief Wait for value and pop.
+     * @return false if closed and empty.
+     */
+    bool pop(T &v)
+    {
+        /// @cond
+        fiber_mutex::scoped_lock sl(m_);
+        while(!closed_ && !q_.size())
+            notEmpty_.wait(m_);
+        return take(v);
+        /// @endcond
+    }
+
+    /**
+     * @param timeout_ms Timeout in milliseconds.
+     * @return false on timeout or if closed and empty.
+     */
+    bool pop(T &v, long timeout_ms)
+    {
+        /// @cond
+        fiber_mutex::scoped_lock sl(m_);
+        notEmpty_.wait(m_, &fiber_channel::readable, this, timeout_ms);
+        return take(v);
+        /// @endcond
+    }
+
+    /**
+     * @return false if empty.
+     */
+    bool try_pop(T &v)
+    {
+        /// @cond
+        fiber_mutex::scoped_lock sl(m_);
+        return take(v);
+        /// @endcond
+    }
+
+    /**
+     * @brief Wake all waiters, the rest of values can be popped.
+     */
+    void close()
+    {
+        /// @cond
+        fiber_mutex::scoped_lock sl(m_);
+        closed_ = true;
+        notEmpty_.notify_all();
+        notFull_.notify_all();
+        /// @endcond
+    }
+
+    bool closed()
+    {
+        fiber_mutex::scoped_lock sl(m_);
+        return closed_;
+    }
+
+    size_t size()
+    {
+        fiber_mutex::scoped_lock sl(m_);
+        return q_.size();
+    }
+
+private:
+    /// @cond
+    fiber_mutex m_;
+    fiber_condition_variable notEmpty_;
+    fiber_condition_variable notFull_;
+    list<T> q_;
+    size_t capacity_;
+    bool closed_;
+
+    bool full() const
+    {
+        return capacity_ && q_.size() >= capacity_;
+    }
+
+    bool readable()
+    {
+        return closed_ || q_.size();
+    }
+
+    bool take(T &v)
+    {
+        if(!q_.size())return false;
+        v = q_.front();
+        q_.pop_front();
+        notFull_.notify_one();
+        return true;
+    }
+
+    fiber_channel(const fiber_channel &);
+    fiber_channel &operator=(const fiber_channel &);
+    /// @endcond
+};
+
+} //namespace bloom
@@ -0,0 +1,133 @@
+/* 
+ * Copyright © 2015 Sergei Khairulin <sergei.khairulin@gmail.com>. 
+ * All rights reserved.
+ *
+ * This file is part of Bloom++.
+ *
+ * Bloom++ is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Bloom++ is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Bloom++.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#pragma once
+
+#include <time.h>
+#include <bloom++/fiber_mutex.h>
+
+namespace bloom
+{
+
+/**
+ * @brief Condition variable for fiber_mutex.
+ * 
+ * Waiting is possible only in fibers, notifying from anywhere.
+ */
+class fiber_condition_variable
+{
+public:
+    fiber_condition_variable()
+    {
+    }
+
+    void wait(fiber_mutex &m)
+    {
+        wait(m, -1);
+    }
+
+    /**
+     * @param timeout_ms Timeout in milliseconds.
+     * @return false on timeout.
+     */
+    bool wait(fiber_mutex &m, long timeout_ms)
+    {
+        /// @cond
+        fiber *f = fiber::current();
+        if(!f)
+            throw fiber_exception("fiber_condition_variable::wait: not in fiber");
+        f->prepare_wait();
+        {
+            spinlock::scoped_lock sl(lock_);
+            waiters_.push(f);
+        }
+        m.unlock();
+        const bool r = f->wait(timeout_ms);
+        if(!r){
+            spinlock::scoped_lock sl(lock_);
+            waiters_.remove(f);
+        }
+        m.lock();
+        return r;
+        /// @endcond
+    }
+
+    template<class T>
+    void wait(fiber_mutex &m, bool (T::*method)(), T *obj)
+    {
+        while(!((obj->*method)()))
+            wait(m);
+    }
+
+    /**
+     * @return false if the predicate is false after timeout.
+     */
+    template<class T>
+    bool wait(fiber_mutex &m, bool (T::*method)(), T *obj, long timeout_ms)
+    {
+        /// @cond
+        const long long deadline = now_ms() + timeout_ms;
+        while(!(obj->*method)()){
+            const long long left = deadline - now_ms();
+            if(left <= 0 || (!wait(m, left) && !(obj->*method)()))
+                return false;
+        }
+        return true;
+        /// @endcond
+    }
+
+    void notify_one()
+    {
+        /// @cond
+        spinlock::scoped_lock sl(lock_);
+        while(fiber *f = waiters_.pop())
+            if(f->wake())break; // skip timed out waiters
+        /// @endcond
+    }
+
+    void notify_all()
+    {
+        /// @cond
+        spinlock::scoped_lock sl(lock_);
+        while(fiber *f = waiters_.pop())
+            f->wake();
+        /// @endcond
+    }
+
+private:
+    /// @cond
+    spinlock lock_;
+    _bits::fiber_queue waiters_;
+
+    static long long now_ms()
+    {
+        timespec ts;
+        clock_gettime(CLOCK_MONOTONIC, &ts);
+        return ts.tv_sec * 1000LL + ts.tv_nsec / 1000000;
+    }
+
+    fiber_condition_variable(const fiber_condition_variable &);
+    fiber_condition_variable &operator=(const fiber_condition_variable &);
+    /// @endcond
+};
+
+} //namespace bloom
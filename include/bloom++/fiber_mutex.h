@@ -0,0 +1,110 @@
+/* 
+ * Copyright © 2015 Sergei Khairulin <sergei.khairulin@gmail.com>. 
+ * All rights reserved.
+ *
+ * This file is part of Bloom++.
+ *
+ * Bloom++ is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Bloom++ is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Bloom++.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#pragma once
+
+#include <errno.h>
+#include <sched.h>
+#include <bloom++/fiber.h>
+#include <bloom++/spinlock.h>
+
+namespace bloom
+{
+
+/**
+ * @brief Mutex which suspends the fiber instead of the thread.
+ * 
+ * Fibers of any schedulers may share it. Ownership is passed to the
+ * first waiter in FIFO order. Outside of fibers lock() spins with
+ * sched_yield().
+ */
+class fiber_mutex
+{
+public:
+    typedef basic_scoped_lock<fiber_mutex> scoped_lock;
+    typedef basic_unique_lock<fiber_mutex> unique_lock;
+
+    fiber_mutex():locked_(false)
+    {
+    }
+
+    int lock()
+    {
+        /// @cond
+        lock_.lock();
+        if(!locked_){
+            locked_ = true;
+            lock_.unlock();
+            return 0;
+        }
+        fiber *f = fiber::current();
+        if(!f){
+            lock_.unlock();
+            while(trylock())
+                sched_yield();
+            return 0;
+        }
+        f->prepare_wait();
+        waiters_.push(f);
+        lock_.unlock();
+        f->wait(); // unlock() passes ownership
+        return 0;
+        /// @endcond
+    }
+
+    /**
+     * @return 0 if locked, EBUSY if not.
+     */
+    int trylock()
+    {
+        /// @cond
+        spinlock::scoped_lock sl(lock_);
+        if(locked_)return EBUSY;
+        locked_ = true;
+        return 0;
+        /// @endcond
+    }
+
+    int unlock()
+    {
+        /// @cond
+        lock_.lock();
+        fiber *f = waiters_.pop();
+        if(!f)locked_ = false;
+        lock_.unlock();
+        if(f)f->wake();
+        return 0;
+        /// @endcond
+    }
+
+private:
+    /// @cond
+    spinlock lock_;
+    bool locked_;
+    _bits::fiber_queue waiters_;
+
+    fiber_mutex(const fiber_mutex &);
+    fiber_mutex &operator=(const fiber_mutex &);
+    /// @endcond
+};
+
+} //namespace bloom
@@ -0,0 +1,750 @@
+/* 
+ * Copyright © 2015 Sergei Khairulin <sergei.khairulin@gmail.com>. 
+ * All rights reserved.
+ *
+ * This file is part of Bloom++.
+ *
+ * Bloom++ is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Bloom++ is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Bloom++.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include <new>
+#include <bloom++/exception.h>
+#include <bloom++/mutex.h>
+#include <bloom++/condition_variable.h>
+#include <bloom++/vector.h>
+
+namespace bloom
+{
+
+/**
+ * @brief Exception of future (exception of the task or broken promise).
+ */
+class future_error: public exception
+{
+public:
+    future_error(string msg):exception(string("future_error: ")+msg){}
+    virtual ~future_error() throw() {}
+};
+
+/**
+ * @brief Task for executor.
+ */
+class pool_task
+{
+public:
+    virtual ~pool_task(){}
+    virtual void run() = 0;
+};
+
+/**
+ * @brief Interface of task executors (thread_pool).
+ */
+class executor
+{
+public:
+    virtual ~executor(){}
+    /**
+     * @brief Asynchronous running of task.
+     * @param task Task, deleted by executor after running.
+     */
+    virtual void execute(pool_task *task) = 0;
+};
+
+/// @cond
+class future_state_base;
+
+/*
+ * Callback of state readiness, called once and owns itself.
+ */
+class future_callback
+{
+public:
+    future_callback *next_;
+    
+    future_callback():next_(0){}
+    virtual ~future_callback(){}
+    virtual void ready(future_state_base *state) = 0;
+};
+
+/*
+ * Shared state of future and promise (reference counted, thread safe).
+ */
+class future_state_base
+{
+public:
+    explicit future_state_base(executor *ex);
+    virtual ~future_state_base();
+    
+    void add_ref(){
+        __sync_fetch_and_add(&refs_, 1);
+    }
+    
+    void release(){
+        if(!__sync_sub_and_fetch(&refs_, 1))
+            delete this;
+    }
+    
+    executor *get_executor() const {
+        return executor_;
+    }
+    
+    bool is_ready() const {
+        return __atomic_load_n(&ready_, __ATOMIC_ACQUIRE);
+    }
+    
+    bool failed() const {
+        return failed_;
+    }
+    
+    // message of the failure, valid when the state is ready
+    const char *error() const {
+        return error_.c_str();
+    }
+    
+    /*
+     * Waiting in a thread_pool worker runs tasks of its own deque.
+     */
+    void wait();
+    bool wait(long timeout_ms);
+    
+    // inside of catch block
+    void set_exception();
+    void set_exception(const string &msg);
+    void copy_exception(const future_state_base &state);
+    void rethrow() const;
+    
+    void add_callback(future_callback *cb);
+    
+protected:
+    void set_ready();
+    void check_not_ready() const;
+    
+private:
+    volatile int refs_;
+    bool ready_;
+    bool failed_;
+    string error_;
+    executor *executor_;
+    mutex m_;
+    condition_variable cv_;
+    future_callback *callbacks_;
+    
+    future_state_base(const future_state_base &);
+    future_state_base &operator=(const future_state_base &);
+};
+
+template<class R>
+class future_state: public future_state_base
+{
+    union storage {
+        char data_[sizeof(R)];
+        long double align_ld_;
+        long long align_ll_;
+        void *align_p_;
+    };
+    storage storage_;
+    bool has_value_;
+    
+public:
+    explicit future_state(executor *ex):
+    future_state_base(ex), has_value_(false){}
+    
+    virtual ~future_state(){
+        if(has_value_)
+            value().~R();
+    }
+    
+    void set_value(const R &v){
+        check_not_ready();
+        ::new ((void*)storage_.data_) R(v);
+        has_value_ = true;
+        set_ready();
+    }
+    
+    /*
+     * Constructing of the value from f() without making it ready: the
+     * temporaries of the full expression (a shared rep of COW string)
+     * must be destroyed before a consumer gets the value.
+     */
+    template<class F>
+    void construct(F &f){
+        check_not_ready();
+        ::new ((void*)storage_.data_) R(f());
+        has_value_ = true;
+    }
+    
+    template<class F, class A>
+    void construct(F &f, A &a){
+        check_not_ready();
+        ::new ((void*)storage_.data_) R(f(a));
+        has_value_ = true;
+    }
+    
+    void make_ready(){
+        set_ready();
+    }
+    
+    R &value(){
+        return *reinterpret_cast<R*>(storage_.data_);
+    }
+};
+
+template<>
+class future_state<void>: public future_state_base
+{
+public:
+    explicit future_state(executor *ex):
+    future_state_base(ex){}
+    
+    void set_value(){
+        check_not_ready();
+        set_ready();
+    }
+};
+
+/*
+ * Calling of f() and setting of result to the state.
+ */
+template<class R>
+struct future_call
+{
+    template<class F>
+    static void call(future_state<R> &s, F &f){
+        s.construct(f);
+        s.make_ready();
+    }
+    
+    static R get(future_state<R> &s){
+        return s.value();
+    }
+};
+
+template<>
+struct future_call<void>
+{
+    template<class F>
+    static void call(future_state<void> &s, F &f){
+        f();
+        s.set_value();
+    }
+    
+    static void get(future_state<void> &){
+    }
+};
+
+/*
+ * Calling of continuation f(value) and setting of result.
+ */
+template<class R, class R2>
+struct future_then_call
+{
+    template<class F>
+    static void call(future_state<R> &from, future_state<R2> &to, F &f){
+        to.construct(f, from.value());
+        to.make_ready();
+    }
+};
+
+template<class R>
+struct future_then_call<R, void>
+{
+    template<class F>
+    static void call(future_state<R> &from, future_state<void> &to, F &f){
+        f(from.value());
+        to.set_value();
+    }
+};
+
+template<class R2>
+struct future_then_call<void, R2>
+{
+    template<class F>
+    static void call(future_state<void> &, future_state<R2> &to, F &f){
+        to.construct(f);
+        to.make_ready();
+    }
+};
+
+template<>
+struct future_then_call<void, void>
+{
+    template<class F>
+    static void call(future_state<void> &, future_state<void> &to, F &f){
+        f();
+        to.set_value();
+    }
+};
+
+/*
+ * Task computing the state by functor.
+ */
+template<class R, class F>
+class future_task: public pool_task
+{
+    future_state<R> *state_;
+    F f_;
+public:
+    future_task(future_state<R> *state, const F &f):
+    state_(state), f_(f){
+        state_->add_ref();
+    }
+    
+    virtual ~future_task(){
+        state_->release();
+    }
+    
+    virtual void run(){
+        try{
+            future_call<R>::call(*state_, f_);
+        }
+        catch(...){
+            state_->set_exception();
+        }
+    }
+};
+
+/*
+ * Continuation: runs f(value) on the executor of the result.
+ */
+template<class R, class R2, class F>
+class future_then: public future_callback, public pool_task
+{
+    future_state<R> *from_;
+    future_state<R2> *to_;
+    F f_;
+public:
+    future_then(future_state<R2> *to, const F &f):
+    from_(0), to_(to), f_(f){
+        to_->add_ref();
+    }
+    
+    virtual ~future_then(){
+        to_->release();
+        if(from_)
+            from_->release();
+    }
+    
+    virtual void ready(future_state_base *state){
+        from_ = static_cast<future_state<R>*>(state);
+        from_->add_ref();
+        if(from_->failed()){
+            to_->copy_exception(*from_);
+            delete this;
+            return;
+        }
+        executor *ex = to_->get_executor();
+        if(ex)
+            ex->execute(this);
+        else {
+            run();
+            delete this;
+        }
+    }
+    
+    virtual void run(){
+        try{
+            future_then_call<R, R2>::call(*from_, *to_, f_);
+        }
+        catch(...){
+            to_->set_exception();
+        }
+    }
+};
+
+template<class R, class T>
+struct future_mem_fn0
+{
+    R (T::*fn_)();
+    T *obj_;
+    
+    R operator()(){
+        return (obj_->*fn_)();
+    }
+};
+
+template<class R, class T, class A>
+struct future_mem_fn1
+{
+    R (T::*fn_)(A);
+    T *obj_;
+    
+    R operator()(A a){
+        return (obj_->*fn_)(a);
+    }
+};
+
+class when_all_counter;
+/// @endcond
+
+/**
+ * @brief Result of asynchronous task.
+ * 
+ * Copies share the same result. If the task threw an exception, get()
+ * throws future_error with the message of that exception.
+ * @param R Type of result (may be void).
+ */
+template<class R>
+class future
+{
+    /// @cond
+    future_state<R> *state_;
+    
+    template<class Rp>
+    friend class future;
+    friend class when_all_counter;
+    /// @endcond
+    
+public:
+    future():state_(0){
+    }
+    
+    /**
+     * @brief Future of the shared state (for executors and promises).
+     */
+    explicit future(future_state<R> *state):
+    state_(state){
+        /// @cond
+        if(state_)state_->add_ref();
+        /// @endcond
+    }
+    
+    future(const future &f):
+    state_(f.state_){
+        /// @cond
+        if(state_)state_->add_ref();
+        /// @endcond
+    }
+    
+    ~future(){
+        /// @cond
+        if(state_)state_->release();
+        /// @endcond
+    }
+    
+    future &operator=(const future &f){
+        /// @cond
+        if(f.state_)f.state_->add_ref();
+        if(state_)state_->release();
+        state_ = f.state_;
+        return *this;
+        /// @endcond
+    }
+    
+    /**
+     * @brief Future refers to a task (not default constructed).
+     */
+    bool valid() const {
+        return state_ != 0;
+    }
+    
+    bool is_ready() const {
+        return state_ && state_->is_ready();
+    }
+    
+    /**
+     * @brief Waiting for result.
+     * 
+     * Called in a worker of thread_pool runs the tasks submitted by the
+     * worker while waiting (see thread_pool::run_own()), other tasks
+     * of the pool aren't run.
+     */
+    void wait() const {
+        /// @cond
+        if(!state_)
+            throw future_error("no state");
+        state_->wait();
+        /// @endcond
+    }
+    
+    /**
+     * @brief Waiting for result with timeout.
+     * @return true if result is ready.
+     */
+    bool wait(long timeout_ms) const {
+        /// @cond
+        if(!state_)
+            throw future_error("no state");
+        return state_->wait(timeout_ms);
+        /// @endcond
+    }
+    
+    /**
+     * @brief Waiting for and getting of result.
+     */
+    R get() const {
+        /// @cond
+        wait();
+        if(state_->failed())
+            state_->rethrow();
+        return future_call<R>::get(*state_);
+        /// @endcond
+    }
+    
+    /**
+     * @brief Continuation.
+     * 
+     * f(result) (or f() for void) is run on the same executor when the
+     * result is ready. An exception of this future is passed to the
+     * returned future without calling f.
+     * @param R2 Type of result of f.
+     * @param f Functor.
+     */
+    template<class R2, class F>
+    future<R2> then(F f) const {
+        /// @cond
+        if(!state_)
+            throw future_error("no state");
+        future<R2> r(new future_state<R2>(state_->get_executor()));
+        state_->add_callback(new future_then<R, R2, F>(r.state_, f));
+        return r;
+        /// @endcond
+    }
+    
+    /**
+     * @brief Continuation by member function obj->fn(result).
+     */
+    template<class R2, class T, class A>
+    future<R2> then(R2 (T::*fn)(A), T *obj) const {
+        /// @cond
+        future_mem_fn1<R2, T, A> f = {fn, obj};
+        return then<R2>(f);
+        /// @endcond
+    }
+    
+    /**
+     * @brief Continuation by member function obj->fn() (for void result).
+     */
+    template<class R2, class T>
+    future<R2> then(R2 (T::*fn)(), T *obj) const {
+        /// @cond
+        future_mem_fn0<R2, T> f = {fn, obj};
+        return then<R2>(f);
+        /// @endcond
+    }
+};
+
+/**
+ * @brief Setting of result for future from any thread.
+ * 
+ * Not copyable. Destroying without result sets "broken promise" error.
+ */
+template<class R>
+class promise
+{
+    /// @cond
+    future_state<R> *state_;
+    
+    promise(const promise &);
+    promise &operator=(const promise &);
+    /// @endcond
+    
+public:
+    /**
+     * @param ex Executor for continuations (NULL - run in the thread
+     * which sets result).
+     */
+    explicit promise(executor *ex = 0):
+    state_(new future_state<R>(ex)){
+        /// @cond
+        state_->add_ref();
+        /// @endcond
+    }
+    
+    ~promise(){
+        /// @cond
+        if(!state_->is_ready())
+            state_->set_exception(string("broken promise"));
+        state_->release();
+        /// @endcond
+    }
+    
+    future<R> get_future() const {
+        return future<R>(state_);
+    }
+    
+    void set_value(const R &v){
+        state_->set_value(v);
+    }
+    
+    void set_exception(const string &msg){
+        state_->set_exception(msg);
+    }
+};
+
+template<>
+class promise<void>
+{
+    /// @cond
+    future_state<void> *state_;
+    
+    promise(const promise &);
+    promise &operator=(const promise &);
+    /// @endcond
+    
+public:
+    explicit promise(executor *ex = 0):
+    state_(new future_state<void>(ex)){
+        /// @cond
+        state_->add_ref();
+        /// @endcond
+    }
+    
+    ~promise(){
+        /// @cond
+        if(!state_->is_ready())
+            state_->set_exception(string("broken promise"));
+        state_->release();
+        /// @endcond
+    }
+    
+    future<void> get_future() const {
+        return future<void>(state_);
+    }
+    
+    void set_value(){
+        state_->set_value();
+    }
+    
+    void set_exception(const string &msg){
+        state_->set_exception(msg);
+    }
+};
+
+/// @cond
+/*
+ * Counting of ready futures of when_all(). The counter is created with
+ * one extra count, which is released by ready(0) after adding of all
+ * futures.
+ */
+class when_all_counter
+{
+    future_state<void> *state_;
+    volatile size_t count_;
+    volatile int failed_;
+    string error_;
+    
+    class callback: public future_callback
+    {
+        when_all_counter *counter_;
+    public:
+        callback(when_all_counter *counter):counter_(counter){}
+        virtual void ready(future_state_base *state){
+            counter_->ready(state);
+            delete this;
+        }
+    };
+    
+public:
+    when_all_counter(size_t count);
+    ~when_all_counter();
+    
+    future<void> get_future() const {
+        return future<void>(state_);
+    }
+    
+    /*
+     * Never throws: the counter is released by the last ready(), so a
+     * future without state (or without memory for the callback) is
+     * counted as a failed one.
+     */
+    template<class R>
+    void add(const future<R> &f){
+        callback *cb;
+        if(!f.state_)
+            fail("when_all: future without state");
+        else if(!(cb = new (std::nothrow) callback(this)))
+            fail("when_all: out of memory");
+        else
+            f.state_->add_callback(cb);
+    }
+    
+    void ready(future_state_base *state);
+    void fail(const char *msg);
+};
+/// @endcond
+
+/**
+ * @brief Future which is ready when all futures are ready.
+ * 
+ * If any future failed, the result fails with the first error.
+ */
+template<class R>
+future<void> when_all(const future<R> *futures, size_t size)
+{
+    /// @cond
+    when_all_counter *c = new when_all_counter(size);
+    future<void> r = c->get_future();
+    for(size_t i = 0; i < size; ++i)
+        c->add(futures[i]);
+    c->ready(0);
+    return r;
+    /// @endcond
+}
+
+template<class R>
+future<void> when_all(const vector<future<R> > &futures)
+{
+    /// @cond
+    return when_all(futures.data(), futures.size());
+    /// @endcond
+}
+
+template<class R1, class R2>
+future<void> when_all(const future<R1> &f1, const future<R2> &f2)
+{
+    /// @cond
+    when_all_counter *c = new when_all_counter(2);
+    future<void> r = c->get_future();
+    c->add(f1);
+    c->add(f2);
+    c->ready(0);
+    return r;
+    /// @endcond
+}
+
+template<class R1, class R2, class R3>
+future<void> when_all(const future<R1> &f1, const future<R2> &f2, const future<R3> &f3)
+{
+    /// @cond
+    when_all_counter *c = new when_all_counter(3);
+    future<void> r = c->get_future();
+    c->add(f1);
+    c->add(f2);
+    c->add(f3);
+    c->ready(0);
+    return r;
+    /// @endcond
+}
+
+template<class R1, class R2, class R3, class R4>
+future<void> when_all(const future<R1> &f1, const future<R2> &f2, const future<R3> &f3,
+                      const future<R4> &f4)
+{
+    /// @cond
+    when_all_counter *c = new when_all_counter(4);
+    future<void> r = c->get_future();
+    c->add(f1);
+    c->add(f2);
+    c->add(f3);
+    c->add(f4);
+    c->ready(0);
+    return r;
+    /// @endcond
+}
+
+} //namespace bloom
@@ -29,6 +29,10 @@
 #include <bloom++/_bits/list_iterator_t.h>
 #include <bloom++/exception.h>
 
+#ifdef BLOOM_CXX11
+#include <tuple>
+#endif
+
 #ifdef AUX_DEBUG
 #define __BLOOM_WITH_DEBUG
 #include <bloom++/log.h>
@@ -68,6 +72,16 @@ public:
     virtual ~bad_ht_index() throw() {}
 };
 
+/**
+ * Hash table exception.
+ */
+class bad_ht_key: public ht_exception
+{
+public:
+    bad_ht_key(string msg):ht_exception(string("hash_table: ")+msg){}
+    virtual ~bad_ht_key() throw() {}
+};
+
 using std::pair;
 using std::make_pair;
 
@@ -94,6 +108,21 @@ public:
 
     explicit hash_table(size_t hash_size, size_t collisions_limit = 8):
         base_ht(hash_size, collisions_limit){}
+    
+#ifdef BLOOM_CXX11
+    hash_table(Self &&ht):
+        base_ht(std::move(ht)){}
+    
+    Self &operator=(Self &&ht)
+    {
+        /// @cond
+        if(&ht == this)return *this;
+        base_ht::clear();
+        base_ht::swap(ht);
+        return *this;
+        /// @endcond
+    }
+#endif
 
     bool insert(const key_type &key, const value_type &value)
     {
@@ -105,12 +134,78 @@ public:
         return true;
         /// @endcond
     }
+    
+#ifdef BLOOM_CXX11
+    bool insert(const key_type &key, value_type &&value)
+    {
+        /// @cond
+        return try_emplace(key, std::move(value)).second;
+        /// @endcond
+    }
+    
+    bool insert(key_type &&key, value_type &&value)
+    {
+        /// @cond
+        return try_emplace(std::move(key), std::move(value)).second;
+        /// @endcond
+    }
+    
+    /**
+     * @brief Constructing value from arguments if there is no such key.
+     * 
+     * Arguments aren't used if the key exists.
+     * @param key Key.
+     * @param args Arguments of value_type constructor.
+     * @return Iterator to the element with the key and true if the value was
+     * inserted.
+     */
+    template<class K, class... Args>
+    pair<iterator, bool> try_emplace(K &&key, Args&&... args)
+    {
+        /// @cond
+        const size_t index = base_ht::hash_index(key);
+        list_iterable_base *i = base_ht::find_iterable(index, key);
+        if(i != base_list::end_iterable())
+            return pair<iterator, bool>(iterator(i), false);
+        i = new iterable(std::piecewise_construct,
+                         std::forward_as_tuple(std::forward<K>(key)),
+                         std::forward_as_tuple(std::forward<Args>(args)...));
+        base_ht::insert_iterable(index, i);
+        return pair<iterator, bool>(iterator(i), true);
+        /// @endcond
+    }
+    
+    /**
+     * @brief Constructing element (pair of key and value) from arguments.
+     * 
+     * The element is constructed before key checking and destroyed if
+     * the key exists.
+     * @param args Arguments of data_place constructor.
+     * @return Iterator to the element with the key and true if the element
+     * was inserted.
+     */
+    template<class... Args>
+    pair<iterator, bool> emplace(Args&&... args)
+    {
+        /// @cond
+        iterable *obj = new iterable(std::forward<Args>(args)...);
+        const size_t index = base_ht::hash_index(obj->value_.first);
+        list_iterable_base *i = base_ht::find_iterable(index, obj->value_.first);
+        if(i != base_list::end_iterable()){
+            delete obj;
+            return pair<iterator, bool>(iterator(i), false);
+        }
+        base_ht::insert_iterable(index, obj);
+        return pair<iterator, bool>(iterator(obj), true);
+        /// @endcond
+    }
+#endif
 
     iterator erase(iterator &it) {
         /// @cond
         iterator r(it.element_->pNext_);
         if(it.element_ != base_list::end_iterable_)
-            delete base_ht::erase_iterable(hash_index(static_cast<iterable*>(it.element_)->value_.first), 
+            delete base_ht::erase_iterable(base_ht::hash_index(static_cast<iterable*>(it.element_)->value_.first), 
                                            it.element_);
         else
             throw bad_ht_erase("can't erase end element!");
@@ -138,17 +233,25 @@ public:
             i = new iterable(data_place(key, value_type()));
             base_ht::insert_iterable(index, i);
         }
-        return static_cast<iterable*>(i)->value_;
+        return static_cast<iterable*>(i)->value_.second;
         /// @endcond
     }
     
+#ifdef BLOOM_CXX11
+    value_type &operator[](key_type &&key){
+        /// @cond
+        return try_emplace(std::move(key)).first->second;
+        /// @endcond
+    }
+#endif
+    
     const value_type &operator[](const key_type &key) const {
         /// @cond
         const size_t index = base_ht::hash_index(key);
         list_iterable_base *i = base_ht::find_iterable(index, key);
         if(i == base_list::end_iterable())
             throw bad_ht_key("no value with specified key!");
-        return static_cast<iterable*>(i)->value_;
+        return static_cast<iterable*>(i)->value_.second;
         /// @endcond
     }
 
@@ -160,6 +263,24 @@ public:
         return const_iterator(base_ht::find_iterable(base_ht::hash_index(key), key));
     }
     
+    /**
+     * @brief Find by key of other type without constructing key_type.
+     * 
+     * For example bloom::string_ref for bloom::string keys.
+     * hash<oT> must return the same value as hashT for equal keys.
+     * @param key Key.
+     * @return iterator.
+     */
+    template<class oT>
+    iterator find_as(const oT &key){
+        return iterator(base_ht::find_iterable(base_ht::hash_index_as(key), key));
+    }
+    
+    template<class oT>
+    const_iterator find_as(const oT &key) const{
+        return const_iterator(base_ht::find_iterable(base_ht::hash_index_as(key), key));
+    }
+    
     iterator begin(){
         return iterator(base_list::end_iterable_->pNext_);
     }
@@ -205,7 +326,7 @@ public:
     }
     
     inline void rehash(size_t hash_size) FORCE_INLINE {
-        base_ht::rehash();
+        base_ht::rehash(hash_size);
     }
 };
 
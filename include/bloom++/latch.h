@@ -0,0 +1,115 @@
+/* 
+ * Copyright © 2015 Sergei Khairulin <sergei.khairulin@gmail.com>. 
+ * All rights reserved.
+ *
+ * This file is part of Bloom++.
+ *
+ * Bloom++ is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Bloom++ is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Bloom++.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#pragma once
+
+#include <bloom++/_bits/futex.h>
+
+namespace bloom
+{
+
+/**
+ * @brief Single-use countdown latch.
+ * 
+ * Threads wait until the counter reaches zero.
+ * Built on futex, timeouts use CLOCK_MONOTONIC.
+ */
+class latch
+{
+public:
+    /**
+     * @param count Initial counter.
+     */
+    latch(int count):count_(count)
+    {
+    }
+    
+    /**
+     * @brief Decrease the counter, wake up waiting threads at zero.
+     * @param n Decrement.
+     */
+    void count_down(int n = 1)
+    {
+        /// @cond
+        if(__sync_sub_and_fetch(&count_, n) <= 0)
+            futex_wake_all(&count_);
+        /// @endcond
+    }
+    
+    /**
+     * @brief Counter reached zero.
+     */
+    bool try_wait() const
+    {
+        return __atomic_load_n(&count_, __ATOMIC_ACQUIRE) <= 0;
+    }
+    
+    /**
+     * @brief Wait for the counter to reach zero.
+     */
+    void wait()
+    {
+        /// @cond
+        int c;
+        while((c = __atomic_load_n(&count_, __ATOMIC_ACQUIRE)) > 0)
+            futex_wait(&count_, c);
+        /// @endcond
+    }
+    
+    /**
+     * @brief Wait for the counter to reach zero.
+     * @param timeout_ms Timeout in milliseconds.
+     * @return false on timeout.
+     */
+    bool wait(long timeout_ms)
+    {
+        /// @cond
+        if(try_wait())
+            return true;
+        timespec deadline;
+        monotonic_deadline(deadline, timeout_ms);
+        int c;
+        while((c = __atomic_load_n(&count_, __ATOMIC_ACQUIRE)) > 0)
+            if(!futex_wait(&count_, c, &deadline))
+                return try_wait();
+        return true;
+        /// @endcond
+    }
+    
+    /**
+     * @brief count_down() and wait().
+     */
+    void arrive_and_wait(int n = 1)
+    {
+        count_down(n);
+        wait();
+    }
+    
+private:
+    /// @cond
+    volatile int count_;
+    
+    latch(const latch &);
+    latch &operator=(const latch &);
+    /// @endcond
+};
+
+} //namespace bloom
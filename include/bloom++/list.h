@@ -104,6 +104,27 @@ public:
     typedef list_reverse_iterator_t<vT>                 reverse_iterator;
     typedef list_reverse_iterator_t<vT, const vT>       const_reverse_iterator;
 
+#ifdef BLOOM_CXX11
+    list(){}
+    
+    list(Self &&l)
+    {
+        /// @cond
+        transmit_back(l);
+        /// @endcond
+    }
+    
+    Self &operator=(Self &&l)
+    {
+        /// @cond
+        if(&l == this)return *this;
+        clear();
+        transmit_back(l);
+        return *this;
+        /// @endcond
+    }
+#endif
+
     void insert(const iterator &it, const vT &v)
     {
         /// @cond
@@ -152,9 +173,77 @@ public:
     {
         /// @cond
         list_iterable_base *i = new iterable(v);
-        base_list::include(base_list::end_iterable_->pNext_, i);
+        base_list::include(base_list::end_iterable(), i);
+        /// @endcond
+    }
+    
+#ifdef BLOOM_CXX11
+    void insert(const iterator &it, vT &&v)
+    {
+        /// @cond
+        emplace(it, std::move(v));
+        /// @endcond
+    }
+    
+    void insert_after(const iterator &it, vT &&v)
+    {
+        /// @cond
+        emplace(it, std::move(v));
+        /// @endcond
+    }
+    
+    void insert_before(const iterator &it, vT &&v)
+    {
+        /// @cond
+        list_iterable_base *i = new iterable(std::move(v));
+        base_list::include(it.element_->pPrev_, i);
+        /// @endcond
+    }
+    
+    void push_back(vT &&v)
+    {
+        /// @cond
+        emplace_back(std::move(v));
+        /// @endcond
+    }
+    
+    void push_front(vT &&v)
+    {
+        /// @cond
+        emplace_front(std::move(v));
+        /// @endcond
+    }
+    
+    /**
+     * @brief Constructing element after iterator from arguments (like insert()).
+     */
+    template<class... Args>
+    void emplace(const iterator &it, Args&&... args)
+    {
+        /// @cond
+        list_iterable_base *i = new iterable(std::forward<Args>(args)...);
+        base_list::include(it.element_, i);
+        /// @endcond
+    }
+    
+    template<class... Args>
+    void emplace_back(Args&&... args)
+    {
+        /// @cond
+        list_iterable_base *i = new iterable(std::forward<Args>(args)...);
+        base_list::include(base_list::end_iterable()->pPrev_, i);
+        /// @endcond
+    }
+    
+    template<class... Args>
+    void emplace_front(Args&&... args)
+    {
+        /// @cond
+        list_iterable_base *i = new iterable(std::forward<Args>(args)...);
+        base_list::include(base_list::end_iterable(), i);
         /// @endcond
     }
+#endif
 
     vT & back()
     {
@@ -245,7 +334,7 @@ public:
     }
     
     inline void transmit_front(base_list &l) FORCE_INLINE{
-        base_list::transmit(base_list::end_iterable()->pNext_, l);
+        base_list::transmit(base_list::end_iterable(), l);
     }
     
     inline void transmit_back(base_list &l) FORCE_INLINE{
@@ -24,6 +24,7 @@
 #include <fstream>
 #include <bloom++/list.h>
 #include <bloom++/string.h>
+#include <bloom++/string_builder.h>
 #include <bloom++/thread.h>
 #include <bloom++/mutex.h>
 #include <bloom++/condition_variable.h>
@@ -59,13 +60,15 @@ public:
     
     log &operator<<(string iob); 
     
+    /**
+     * @brief Appending of value formatted like ostring (a char as
+     * integer value).
+     */
     template<class T> log &operator<<(const T &v){
         /// @cond
-        string str;
-        stream::stringer sstr(str);
-        stream::ostring ios(sstr);
-        ios<<v;
-        return operator<<(str);
+        ostring_builder b;
+        b<<v;
+        return operator<<(b.str());
         /// @endcond
     }
     
@@ -73,6 +76,13 @@ public:
     size_t queue_size();
     void close();
     
+    /**
+     * @brief Applying of attributes (name, affinity, priority) to the
+     * logger thread.
+     * @return 0 or error code.
+     */
+    int set_thread_attributes(const thread_attributes &attr);
+    
     static string pf(const char *format, ...); //printf
     
 private:
@@ -0,0 +1,288 @@
+/* 
+ * Copyright © 2015 Sergei Khairulin <sergei.khairulin@gmail.com>. 
+ * All rights reserved.
+ *
+ * This file is part of Bloom++.
+ *
+ * Bloom++ is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Bloom++ is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Bloom++.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include <stdlib.h>
+#include <new>
+#include <utility>
+#include <bloom++/_bits/c++config.h>
+
+namespace bloom
+{
+
+/**
+ * @brief Bounded lock-free multi-producer multi-consumer queue.
+ * 
+ * Ring of cells with sequence numbers (D. Vyukov): a push or pop is one
+ * CAS on the shared position and doesn't allocate. Capacity is rounded
+ * up to a power of two. Producer and consumer positions are on
+ * separate cache lines.
+ * 
+ * A pushed value is constructed in a cell after the cell is claimed and
+ * consumers wait for the cell, so constructing it must not throw:
+ * try_push() copies the value before claiming with C++11 and only
+ * the move constructor of vT must not throw, the copy constructor must
+ * not throw for push_n() and for try_push() with C++98.
+ */
+template<class vT>
+class mpmc_queue
+{
+public:
+    typedef vT value_type;
+    
+    /**
+     * @param capacity Minimal capacity.
+     */
+    mpmc_queue(size_t capacity)
+    {
+        /// @cond
+        size_t cap = 2;
+        while(cap < capacity)
+            cap <<= 1;
+        mask_ = cap - 1;
+        cells_ = static_cast<cell*>(::operator new(cap * sizeof(cell)));
+        for(size_t i = 0; i < cap; ++i)
+            cells_[i].seq = i;
+        enqueue_ = 0;
+        dequeue_ = 0;
+        /// @endcond
+    }
+    
+    ~mpmc_queue()
+    {
+        /// @cond
+        for(size_t pos = dequeue_; pos != enqueue_; ++pos)
+            cells_[pos & mask_].value()->~vT();
+        ::operator delete(cells_);
+        /// @endcond
+    }
+    
+    /**
+     * @brief Push value if the queue isn't full.
+     * @return false if the queue is full.
+     */
+    bool try_push(const vT &v)
+    {
+        /// @cond
+#ifdef BLOOM_CXX11
+        vT tmp(v);
+#endif
+        size_t pos;
+        cell *c = claim_push(pos);
+        if(!c)
+            return false;
+#ifdef BLOOM_CXX11
+        new(c->data) vT(std::move(tmp));
+#else
+        new(c->data) vT(v);
+#endif
+        __atomic_store_n(&c->seq, pos + 1, __ATOMIC_RELEASE);
+        return true;
+        /// @endcond
+    }
+    
+    /**
+     * @brief Pop value if the queue isn't empty.
+     * @return false if the queue is empty.
+     */
+    bool try_pop(vT &v)
+    {
+        /// @cond
+        size_t pos;
+        cell *c = claim_pop(pos);
+        if(!c)
+            return false;
+        take(c, v, pos);
+        return true;
+        /// @endcond
+    }
+    
+    /**
+     * @brief Push up to n values with one CAS.
+     * @return Number of pushed values (from the beginning of v).
+     */
+    size_t push_n(const vT *v, size_t n)
+    {
+        /// @cond
+        if(!n)
+            return 0;
+        size_t pos = __atomic_load_n(&enqueue_, __ATOMIC_RELAXED);
+        size_t k;
+        for(;;){
+            k = 0;
+            while(k < n && __atomic_load_n(&cells_[(pos + k) & mask_].seq,
+                                           __ATOMIC_ACQUIRE) == pos + k)
+                ++k;
+            if(!k){
+                const size_t seq = __atomic_load_n(&cells_[pos & mask_].seq, __ATOMIC_ACQUIRE);
+                if((ptrdiff_t)(seq - pos) < 0)
+                    return 0; // full
+                pos = __atomic_load_n(&enqueue_, __ATOMIC_RELAXED);
+                continue;
+            }
+            if(__atomic_compare_exchange_n(&enqueue_, &pos, pos + k, true,
+                                           __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+                break;
+        }
+        for(size_t i = 0; i < k; ++i){
+            cell *c = &cells_[(pos + i) & mask_];
+            new(c->data) vT(v[i]);
+            __atomic_store_n(&c->seq, pos + i + 1, __ATOMIC_RELEASE);
+        }
+        return k;
+        /// @endcond
+    }
+    
+    /**
+     * @brief Pop up to n values with one CAS.
+     * @return Number of popped values.
+     */
+    size_t pop_n(vT *v, size_t n)
+    {
+        /// @cond
+        if(!n)
+            return 0;
+        size_t pos = __atomic_load_n(&dequeue_, __ATOMIC_RELAXED);
+        size_t k;
+        for(;;){
+            k = 0;
+            while(k < n && __atomic_load_n(&cells_[(pos + k) & mask_].seq,
+                                           __ATOMIC_ACQUIRE) == pos + k + 1)
+                ++k;
+            if(!k){
+                const size_t seq = __atomic_load_n(&cells_[pos & mask_].seq, __ATOMIC_ACQUIRE);
+                if((ptrdiff_t)(seq - (pos + 1)) < 0)
+                    return 0; // empty
+                pos = __atomic_load_n(&dequeue_, __ATOMIC_RELAXED);
+                continue;
+            }
+            if(__atomic_compare_exchange_n(&dequeue_, &pos, pos + k, true,
+                                           __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+                break;
+        }
+        for(size_t i = 0; i < k; ++i)
+            take(&cells_[(pos + i) & mask_], v[i], pos + i);
+        return k;
+        /// @endcond
+    }
+    
+    /**
+     * @brief Approximate number of values.
+     */
+    size_t size() const
+    {
+        /// @cond
+        const size_t d = __atomic_load_n(&dequeue_, __ATOMIC_RELAXED);
+        const size_t e = __atomic_load_n(&enqueue_, __ATOMIC_RELAXED);
+        return (ptrdiff_t)(e - d) > 0 ? e - d : 0;
+        /// @endcond
+    }
+    
+    bool empty() const
+    {
+        return !size();
+    }
+    
+    size_t capacity() const
+    {
+        return mask_ + 1;
+    }
+    
+private:
+    /// @cond
+    struct cell
+    {
+        size_t seq;
+        char data[sizeof(vT)] __attribute__((aligned(__alignof__(vT))));
+        
+        vT *value()
+        {
+            return reinterpret_cast<vT*>(data);
+        }
+    };
+    
+    char pad0_[BLOOM_CACHE_LINE];
+    cell *cells_;
+    size_t mask_;
+    char pad1_[BLOOM_CACHE_LINE - sizeof(cell*) - sizeof(size_t)];
+    size_t enqueue_;
+    char pad2_[BLOOM_CACHE_LINE - sizeof(size_t)];
+    size_t dequeue_;
+    char pad3_[BLOOM_CACHE_LINE - sizeof(size_t)];
+    
+    mpmc_queue(const mpmc_queue &);
+    mpmc_queue &operator=(const mpmc_queue &);
+    
+    cell *claim_push(size_t &pos)
+    {
+        pos = __atomic_load_n(&enqueue_, __ATOMIC_RELAXED);
+        for(;;){
+            cell *c = &cells_[pos & mask_];
+            const size_t seq = __atomic_load_n(&c->seq, __ATOMIC_ACQUIRE);
+            const ptrdiff_t dif = (ptrdiff_t)(seq - pos);
+            if(!dif){
+                if(__atomic_compare_exchange_n(&enqueue_, &pos, pos + 1, true,
+                                               __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+                    return c;
+            }
+            else if(dif < 0)
+                return 0;
+            else
+                pos = __atomic_load_n(&enqueue_, __ATOMIC_RELAXED);
+        }
+    }
+    
+    cell *claim_pop(size_t &pos)
+    {
+        pos = __atomic_load_n(&dequeue_, __ATOMIC_RELAXED);
+        for(;;){
+            cell *c = &cells_[pos & mask_];
+            const size_t seq = __atomic_load_n(&c->seq, __ATOMIC_ACQUIRE);
+            const ptrdiff_t dif = (ptrdiff_t)(seq - (pos + 1));
+            if(!dif){
+                if(__atomic_compare_exchange_n(&dequeue_, &pos, pos + 1, true,
+                                               __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+                    return c;
+            }
+            else if(dif < 0)
+                return 0;
+            else
+                pos = __atomic_load_n(&dequeue_, __ATOMIC_RELAXED);
+        }
+    }
+    
+    void take(cell *c, vT &v, size_t pos)
+    {
+        vT *p = c->value();
+#ifdef BLOOM_CXX11
+        v = std::move(*p);
+#else
+        v = *p;
+#endif
+        p->~vT();
+        __atomic_store_n(&c->seq, pos + mask_ + 1, __ATOMIC_RELEASE);
+    }
+    /// @endcond
+};
+
+} //namespace bloom
@@ -0,0 +1,951 @@
+/* 
+ * Copyright © 2015 Sergei Khairulin <sergei.khairulin@gmail.com>. 
+ * All rights reserved.
+ *
+ * This file is part of Bloom++.
+ *
+ * Bloom++ is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Bloom++ is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Bloom++.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include <bloom++/delegate.h>
+#include <bloom++/signal.h>
+#include <bloom++/shared_ptr.h>
+#include <bloom++/mutex.h>
+#include <bloom++/vector.h>
+
+namespace bloom
+{
+
+/// @cond
+namespace _bits {
+class mt_signal_base;
+}
+/// @endcond
+
+/**
+ * @brief Handle of the slot connected to mt_signalN.
+ *
+ * Copyable. The signal must outlive the handle's disconnect() and
+ * connected() calls.
+ */
+class signal_connection
+{
+public:
+    signal_connection():signal_(0), id_(0){}
+    signal_connection(_bits::mt_signal_base *signal, unsigned long id):
+    signal_(signal), id_(id){}
+
+    /**
+     * @brief Disconnect the slot.
+     * @return false if it was already disconnected.
+     */
+    bool disconnect();
+    bool connected() const;
+
+    unsigned long id() const {
+        return id_;
+    }
+
+private:
+    /// @cond
+    _bits::mt_signal_base *signal_;
+    unsigned long id_;
+    /// @endcond
+};
+
+/**
+ * @brief Disconnects the slot on destruction.
+ */
+class scoped_connection
+{
+public:
+    scoped_connection(){}
+    scoped_connection(const signal_connection &conn):conn_(conn){}
+    ~scoped_connection(){
+        conn_.disconnect();
+    }
+
+    scoped_connection &operator=(const signal_connection &conn){
+        /// @cond
+        conn_.disconnect();
+        conn_ = conn;
+        return *this;
+        /// @endcond
+    }
+
+    bool disconnect(){
+        return conn_.disconnect();
+    }
+
+    bool connected() const {
+        return conn_.connected();
+    }
+
+    /**
+     * @brief Keep the slot connected after destruction.
+     */
+    signal_connection release(){
+        /// @cond
+        signal_connection c = conn_;
+        conn_ = signal_connection();
+        return c;
+        /// @endcond
+    }
+
+private:
+    /// @cond
+    signal_connection conn_;
+
+    scoped_connection(const scoped_connection &);
+    scoped_connection &operator=(const scoped_connection &);
+    /// @endcond
+};
+
+/**
+ * @brief Combiner: result of the last slot (default value if none).
+ */
+template<class T_Ret>
+class combiner_last
+{
+public:
+    typedef T_Ret result_type;
+    combiner_last():r_(){}
+    bool operator()(const T_Ret &r){
+        r_ = r;
+        return true;
+    }
+    result_type result() const {
+        return r_;
+    }
+private:
+    /// @cond
+    T_Ret r_;
+    /// @endcond
+};
+
+/**
+ * @brief Combiner: result of the first slot, the rest aren't called.
+ */
+template<class T_Ret>
+class combiner_first
+{
+public:
+    typedef T_Ret result_type;
+    combiner_first():r_(){}
+    bool operator()(const T_Ret &r){
+        r_ = r;
+        return false;
+    }
+    result_type result() const {
+        return r_;
+    }
+private:
+    /// @cond
+    T_Ret r_;
+    /// @endcond
+};
+
+/**
+ * @brief Combiner: true if all slots return true (or there are none).
+ * 
+ * Stops at the first false.
+ */
+class combiner_all_true
+{
+public:
+    typedef bool result_type;
+    combiner_all_true():r_(true){}
+    bool operator()(bool r){
+        r_ = r;
+        return r;
+    }
+    result_type result() const {
+        return r_;
+    }
+private:
+    /// @cond
+    bool r_;
+    /// @endcond
+};
+
+/**
+ * @brief Combiner: results of all slots.
+ */
+template<class T_Ret>
+class combiner_collect
+{
+public:
+    typedef vector<T_Ret> result_type;
+    bool operator()(const T_Ret &r){
+        r_.push_back(r);
+        return true;
+    }
+    result_type result() const {
+        return r_;
+    }
+private:
+    /// @cond
+    vector<T_Ret> r_;
+    /// @endcond
+};
+
+/**
+ * @brief Combiner of void slots.
+ */
+class combiner_none
+{
+public:
+    typedef void result_type;
+    bool operator()(){
+        return true;
+    }
+    void result() const {
+    }
+};
+
+/**
+ * @brief Combiner used by mt_signalN by default.
+ */
+template<class T_Ret>
+struct default_combiner
+{
+    typedef combiner_last<T_Ret> type;
+};
+
+template<>
+struct default_combiner<void>
+{
+    typedef combiner_none type;
+};
+
+/// @cond
+namespace _bits {
+
+/** Immutable array of slots, replaced as a whole by connect/disconnect */
+struct slot_array_base
+{
+    slot_array_base(size_t n):size(n), retired_next(0){}
+    virtual ~slot_array_base(){}
+    size_t size;
+    slot_array_base *retired_next;
+};
+
+/**
+ * Publication and reclamation of slot arrays.
+ *
+ * Emitters register in one of two reader counters selected by the epoch
+ * and read the current array without locking. Writers are serialized by
+ * the mutex and publish a new array. Replaced arrays are freed after the
+ * epoch is flipped twice, each time once the previous counter has
+ * drained. Writers never wait for the counters: a counter in use is
+ * checked again by the next writer, the destructor frees the rest.
+ */
+class mt_signal_base
+{
+public:
+    virtual bool disconnect(unsigned long id) = 0;
+    virtual bool connected(unsigned long id) = 0;
+
+protected:
+    class reader
+    {
+    public:
+        reader(mt_signal_base &s):s_(s){
+            for(;;){
+                const unsigned int e = __atomic_load_n(&s_.epoch_, __ATOMIC_SEQ_CST);
+                idx_ = e & 1;
+                __atomic_fetch_add(&s_.readers_[idx_], 1, __ATOMIC_SEQ_CST);
+                if(__atomic_load_n(&s_.epoch_, __ATOMIC_SEQ_CST) == e)
+                    break;
+                __atomic_fetch_sub(&s_.readers_[idx_], 1, __ATOMIC_RELEASE);
+            }
+        }
+        ~reader(){
+            __atomic_fetch_sub(&s_.readers_[idx_], 1, __ATOMIC_RELEASE);
+        }
+        const slot_array_base *slots() const {
+            return __atomic_load_n(&s_.slots_, __ATOMIC_ACQUIRE);
+        }
+    private:
+        mt_signal_base &s_;
+        unsigned int idx_;
+    };
+
+    mt_signal_base();
+    virtual ~mt_signal_base();
+
+    /** Current array; mutex_ must be locked */
+    slot_array_base *slots() const {
+        return slots_;
+    }
+    /** Replace the current array (may be NULL); mutex_ must be locked */
+    void publish(slot_array_base *slots);
+    /** New connection id; mutex_ must be locked */
+    unsigned long next_id(){
+        return ++lastId_;
+    }
+
+    mutex mutex_;
+
+private:
+    slot_array_base *slots_;
+    slot_array_base *retired_;  // replaced, epoch not flipped yet
+    slot_array_base *draining_; // waiting for the reader counters
+    int flips_;                 // epoch flips done for draining_
+    unsigned long lastId_;
+    unsigned int epoch_;
+    unsigned int readers_[2];
+
+    void reclaim();
+
+    mt_signal_base(const mt_signal_base &);
+    mt_signal_base &operator=(const mt_signal_base &);
+};
+
+/** Slots of the signal with delegate type T_Delegate */
+template<class T_Delegate, class T_Slot>
+class mt_signal_impl: public mt_signal_base
+{
+public:
+    bool disconnect(unsigned long id){
+        mutex::scoped_lock sl(mutex_);
+        const array *cur = static_cast<const array *>(slots());
+        if(cur)
+            for(size_t i = 0; i < cur->size; ++i)
+                if(cur->items[i].id == id){
+                    publish(without(cur, i));
+                    return true;
+                }
+        return false;
+    }
+
+    bool connected(unsigned long id){
+        reader r(*this);
+        const array *cur = static_cast<const array *>(r.slots());
+        if(cur)
+            for(size_t i = 0; i < cur->size; ++i)
+                if(cur->items[i].id == id)
+                    return true;
+        return false;
+    }
+
+    /**
+     * @brief Disconnect the first slot equal to delegate.
+     * @return false if not connected.
+     */
+    bool disconnect(const T_Delegate &d){
+        mutex::scoped_lock sl(mutex_);
+        const array *cur = static_cast<const array *>(slots());
+        if(cur)
+            for(size_t i = 0; i < cur->size; ++i)
+                if(cur->items[i].delegate == d){
+                    publish(without(cur, i));
+                    return true;
+                }
+        return false;
+    }
+
+    void disconnect_all(){
+        mutex::scoped_lock sl(mutex_);
+        if(slots())publish(0);
+    }
+
+    /**
+     * @brief Number of connected slots.
+     */
+    size_t size(){
+        reader r(*this);
+        return r.slots() ? r.slots()->size : 0;
+    }
+
+    bool empty(){
+        return !size();
+    }
+
+protected:
+    struct item
+    {
+        unsigned long id;
+        T_Delegate delegate;
+        shared_ptr<T_Slot> slot;
+    };
+
+    struct array: public slot_array_base
+    {
+        array(size_t n):slot_array_base(n), items(new item[n]){}
+        ~array(){ delete [] items; }
+        item *items;
+    };
+
+    signal_connection append(const T_Delegate &d, const shared_ptr<T_Slot> &slot){
+        mutex::scoped_lock sl(mutex_);
+        const array *cur = static_cast<const array *>(slots());
+        const size_t n = cur ? cur->size : 0;
+        array *a = new array(n + 1);
+        for(size_t i = 0; i < n; ++i)
+            a->items[i] = cur->items[i];
+        a->items[n].id = next_id();
+        a->items[n].delegate = d;
+        a->items[n].slot = slot;
+        publish(a);
+        return signal_connection(this, a->items[n].id);
+    }
+
+private:
+    static array *without(const array *cur, size_t index){
+        if(cur->size == 1)return 0;
+        array *a = new array(cur->size - 1);
+        for(size_t i = 0, j = 0; i < cur->size; ++i)
+            if(i != index)a->items[j++] = cur->items[i];
+        return a;
+    }
+};
+
+/** Call of the slot with passing result to combiner */
+template<class T_Ret>
+struct slot_call
+{
+    template<class T_Comb, class T_Delegate>
+    static bool call(T_Comb &c, const T_Delegate &d){
+        return c(d());
+    }
+    template<class T_Comb, class T_Delegate, class T_Par1>
+    static bool call(T_Comb &c, const T_Delegate &d, T_Par1 par1){
+        return c(d(par1));
+    }
+    template<class T_Comb, class T_Delegate, class T_Par1, class T_Par2>
+    static bool call(T_Comb &c, const T_Delegate &d, T_Par1 par1, T_Par2 par2){
+        return c(d(par1, par2));
+    }
+    template<class T_Comb, class T_Delegate, class T_Par1, class T_Par2, class T_Par3>
+    static bool call(T_Comb &c, const T_Delegate &d, T_Par1 par1, T_Par2 par2, T_Par3 par3){
+        return c(d(par1, par2, par3));
+    }
+    template<class T_Comb, class T_Delegate, class T_Par1, class T_Par2, class T_Par3, class T_Par4>
+    static bool call(T_Comb &c, const T_Delegate &d, T_Par1 par1, T_Par2 par2, T_Par3 par3, T_Par4 par4){
+        return c(d(par1, par2, par3, par4));
+    }
+    template<class T_Comb, class T_Delegate, class T_Par1, class T_Par2, class T_Par3, class T_Par4, class T_Par5>
+    static bool call(T_Comb &c, const T_Delegate &d, T_Par1 par1, T_Par2 par2, T_Par3 par3, T_Par4 par4, T_Par5 par5){
+        return c(d(par1, par2, par3, par4, par5));
+    }
+    template<class T_Comb, class T_Delegate, class T_Par1, class T_Par2, class T_Par3, class T_Par4, class T_Par5, class T_Par6>
+    static bool call(T_Comb &c, const T_Delegate &d, T_Par1 par1, T_Par2 par2, T_Par3 par3, T_Par4 par4, T_Par5 par5, T_Par6 par6){
+        return c(d(par1, par2, par3, par4, par5, par6));
+    }
+};
+
+template<>
+struct slot_call<void>
+{
+    template<class T_Comb, class T_Delegate>
+    static bool call(T_Comb &c, const T_Delegate &d){
+        d();
+        return c();
+    }
+    template<class T_Comb, class T_Delegate, class T_Par1>
+    static bool call(T_Comb &c, const T_Delegate &d, T_Par1 par1){
+        d(par1);
+        return c();
+    }
+    template<class T_Comb, class T_Delegate, class T_Par1, class T_Par2>
+    static bool call(T_Comb &c, const T_Delegate &d, T_Par1 par1, T_Par2 par2){
+        d(par1, par2);
+        return c();
+    }
+    template<class T_Comb, class T_Delegate, class T_Par1, class T_Par2, class T_Par3>
+    static bool call(T_Comb &c, const T_Delegate &d, T_Par1 par1, T_Par2 par2, T_Par3 par3){
+        d(par1, par2, par3);
+        return c();
+    }
+    template<class T_Comb, class T_Delegate, class T_Par1, class T_Par2, class T_Par3, class T_Par4>
+    static bool call(T_Comb &c, const T_Delegate &d, T_Par1 par1, T_Par2 par2, T_Par3 par3, T_Par4 par4){
+        d(par1, par2, par3, par4);
+        return c();
+    }
+    template<class T_Comb, class T_Delegate, class T_Par1, class T_Par2, class T_Par3, class T_Par4, class T_Par5>
+    static bool call(T_Comb &c, const T_Delegate &d, T_Par1 par1, T_Par2 par2, T_Par3 par3, T_Par4 par4, T_Par5 par5){
+        d(par1, par2, par3, par4, par5);
+        return c();
+    }
+    template<class T_Comb, class T_Delegate, class T_Par1, class T_Par2, class T_Par3, class T_Par4, class T_Par5, class T_Par6>
+    static bool call(T_Comb &c, const T_Delegate &d, T_Par1 par1, T_Par2 par2, T_Par3 par3, T_Par4 par4, T_Par5 par5, T_Par6 par6){
+        d(par1, par2, par3, par4, par5, par6);
+        return c();
+    }
+};
+
+} //namespace _bits
+/// @endcond
+
+/**
+ * @brief Thread-safe multi-slot signal without parameters.
+ *
+ * Slots are called in the order of connection, results are passed to
+ * T_Combiner. emit() doesn't lock and may run concurrently with
+ * connect() and disconnect(), which are serialized and don't wait for
+ * emissions: a slot may still be called by an emission in progress
+ * after it is disconnected.
+ */
+template<class T_Ret, class T_Combiner = typename default_combiner<T_Ret>::type>
+class mt_signal0: public _bits::mt_signal_impl<delegate0<T_Ret>, slot_base0<T_Ret> >
+{
+public:
+    typedef slot_base0<T_Ret> slot_type;
+    typedef delegate0<T_Ret> delegate_type;
+    typedef typename T_Combiner::result_type result_type;
+
+    using _bits::mt_signal_impl<delegate_type, slot_type>::disconnect;
+
+    signal_connection connect(shared_ptr<slot_type> slot){
+        return this->append(delegate_type(slot.get(), &slot_type::emit), slot);
+    }
+    template<class T_Obj>
+    signal_connection connect(T_Obj *obj, T_Ret (T_Obj::*fn)())
+    {
+        return this->append(delegate_type(obj, fn), shared_ptr<slot_type>());
+    }
+    signal_connection connect(T_Ret (*fn)())
+    {
+        return this->append(delegate_type(fn), shared_ptr<slot_type>());
+    }
+    signal_connection connect(const delegate_type &d)
+    {
+        return this->append(d, shared_ptr<slot_type>());
+    }
+
+    result_type emit(){
+        /// @cond
+        T_Combiner c;
+        return combine(c);
+        /// @endcond
+    }
+
+    /**
+     * @brief Emit with own combiner.
+     * @param comb Combiner, its result is returned.
+     */
+    template<class T_Comb>
+    typename T_Comb::result_type combine(T_Comb &comb){
+        /// @cond
+        {
+            typename mt_signal0::reader r(*this);
+            const typename mt_signal0::array *a =
+                static_cast<const typename mt_signal0::array *>(r.slots());
+            if(a)
+                for(size_t i = 0; i < a->size; ++i)
+                    if(!_bits::slot_call<T_Ret>::template call<T_Comb, delegate_type>
+                                                  (comb, a->items[i].delegate))
+                        break;
+        }
+        return comb.result();
+        /// @endcond
+    }
+};
+
+/**
+ * @brief Thread-safe multi-slot signal with 1 parameter.
+ *
+ * Slots are called in the order of connection, results are passed to
+ * T_Combiner. emit() doesn't lock and may run concurrently with
+ * connect() and disconnect(), which are serialized and don't wait for
+ * emissions: a slot may still be called by an emission in progress
+ * after it is disconnected.
+ */
+template<class T_Ret, class T_Par1, class T_Combiner = typename default_combiner<T_Ret>::type>
+class mt_signal1: public _bits::mt_signal_impl<delegate1<T_Ret, T_Par1>, slot_base1<T_Ret, T_Par1> >
+{
+public:
+    typedef slot_base1<T_Ret, T_Par1> slot_type;
+    typedef delegate1<T_Ret, T_Par1> delegate_type;
+    typedef typename T_Combiner::result_type result_type;
+
+    using _bits::mt_signal_impl<delegate_type, slot_type>::disconnect;
+
+    signal_connection connect(shared_ptr<slot_type> slot){
+        return this->append(delegate_type(slot.get(), &slot_type::emit), slot);
+    }
+    template<class T_Obj>
+    signal_connection connect(T_Obj *obj, T_Ret (T_Obj::*fn)(T_Par1))
+    {
+        return this->append(delegate_type(obj, fn), shared_ptr<slot_type>());
+    }
+    signal_connection connect(T_Ret (*fn)(T_Par1))
+    {
+        return this->append(delegate_type(fn), shared_ptr<slot_type>());
+    }
+    signal_connection connect(const delegate_type &d)
+    {
+        return this->append(d, shared_ptr<slot_type>());
+    }
+
+    result_type emit(T_Par1 par1){
+        /// @cond
+        T_Combiner c;
+        return combine(c, par1);
+        /// @endcond
+    }
+
+    /**
+     * @brief Emit with own combiner.
+     * @param comb Combiner, its result is returned.
+     */
+    template<class T_Comb>
+    typename T_Comb::result_type combine(T_Comb &comb, T_Par1 par1){
+        /// @cond
+        {
+            typename mt_signal1::reader r(*this);
+            const typename mt_signal1::array *a =
+                static_cast<const typename mt_signal1::array *>(r.slots());
+            if(a)
+                for(size_t i = 0; i < a->size; ++i)
+                    if(!_bits::slot_call<T_Ret>::template call<T_Comb, delegate_type, T_Par1>
+                                                  (comb, a->items[i].delegate, par1))
+                        break;
+        }
+        return comb.result();
+        /// @endcond
+    }
+};
+
+/**
+ * @brief Thread-safe multi-slot signal with 2 parameters.
+ *
+ * Slots are called in the order of connection, results are passed to
+ * T_Combiner. emit() doesn't lock and may run concurrently with
+ * connect() and disconnect(), which are serialized and don't wait for
+ * emissions: a slot may still be called by an emission in progress
+ * after it is disconnected.
+ */
+template<class T_Ret, class T_Par1, class T_Par2, class T_Combiner = typename default_combiner<T_Ret>::type>
+class mt_signal2: public _bits::mt_signal_impl<delegate2<T_Ret, T_Par1, T_Par2>, slot_base2<T_Ret, T_Par1, T_Par2> >
+{
+public:
+    typedef slot_base2<T_Ret, T_Par1, T_Par2> slot_type;
+    typedef delegate2<T_Ret, T_Par1, T_Par2> delegate_type;
+    typedef typename T_Combiner::result_type result_type;
+
+    using _bits::mt_signal_impl<delegate_type, slot_type>::disconnect;
+
+    signal_connection connect(shared_ptr<slot_type> slot){
+        return this->append(delegate_type(slot.get(), &slot_type::emit), slot);
+    }
+    template<class T_Obj>
+    signal_connection connect(T_Obj *obj, T_Ret (T_Obj::*fn)(T_Par1, T_Par2))
+    {
+        return this->append(delegate_type(obj, fn), shared_ptr<slot_type>());
+    }
+    signal_connection connect(T_Ret (*fn)(T_Par1, T_Par2))
+    {
+        return this->append(delegate_type(fn), shared_ptr<slot_type>());
+    }
+    signal_connection connect(const delegate_type &d)
+    {
+        return this->append(d, shared_ptr<slot_type>());
+    }
+
+    result_type emit(T_Par1 par1, T_Par2 par2){
+        /// @cond
+        T_Combiner c;
+        return combine(c, par1, par2);
+        /// @endcond
+    }
+
+    /**
+     * @brief Emit with own combiner.
+     * @param comb Combiner, its result is returned.
+     */
+    template<class T_Comb>
+    typename T_Comb::result_type combine(T_Comb &comb, T_Par1 par1, T_Par2 par2){
+        /// @cond
+        {
+            typename mt_signal2::reader r(*this);
+            const typename mt_signal2::array *a =
+                static_cast<const typename mt_signal2::array *>(r.slots());
+            if(a)
+                for(size_t i = 0; i < a->size; ++i)
+                    if(!_bits::slot_call<T_Ret>::template call<T_Comb, delegate_type, T_Par1, T_Par2>
+                                                  (comb, a->items[i].delegate, par1, par2))
+                        break;
+        }
+        return comb.result();
+        /// @endcond
+    }
+};
+
+/**
+ * @brief Thread-safe multi-slot signal with 3 parameters.
+ *
+ * Slots are called in the order of connection, results are passed to
+ * T_Combiner. emit() doesn't lock and may run concurrently with
+ * connect() and disconnect(), which are serialized and don't wait for
+ * emissions: a slot may still be called by an emission in progress
+ * after it is disconnected.
+ */
+template<class T_Ret, class T_Par1, class T_Par2, class T_Par3, class T_Combiner = typename default_combiner<T_Ret>::type>
+class mt_signal3: public _bits::mt_signal_impl<delegate3<T_Ret, T_Par1, T_Par2, T_Par3>, slot_base3<T_Ret, T_Par1, T_Par2, T_Par3> >
+{
+public:
+    typedef slot_base3<T_Ret, T_Par1, T_Par2, T_Par3> slot_type;
+    typedef delegate3<T_Ret, T_Par1, T_Par2, T_Par3> delegate_type;
+    typedef typename T_Combiner::result_type result_type;
+
+    using _bits::mt_signal_impl<delegate_type, slot_type>::disconnect;
+
+    signal_connection connect(shared_ptr<slot_type> slot){
+        return this->append(delegate_type(slot.get(), &slot_type::emit), slot);
+    }
+    template<class T_Obj>
+    signal_connection connect(T_Obj *obj, T_Ret (T_Obj::*fn)(T_Par1, T_Par2, T_Par3))
+    {
+        return this->append(delegate_type(obj, fn), shared_ptr<slot_type>());
+    }
+    signal_connection connect(T_Ret (*fn)(T_Par1, T_Par2, T_Par3))
+    {
+        return this->append(delegate_type(fn), shared_ptr<slot_type>());
+    }
+    signal_connection connect(const delegate_type &d)
+    {
+        return this->append(d, shared_ptr<slot_type>());
+    }
+
+    result_type emit(T_Par1 par1, T_Par2 par2, T_Par3 par3){
+        /// @cond
+        T_Combiner c;
+        return combine(c, par1, par2, par3);
+        /// @endcond
+    }
+
+    /**
+     * @brief Emit with own combiner.
+     * @param comb Combiner, its result is returned.
+     */
+    template<class T_Comb>
+    typename T_Comb::result_type combine(T_Comb &comb, T_Par1 par1, T_Par2 par2, T_Par3 par3){
+        /// @cond
+        {
+            typename mt_signal3::reader r(*this);
+            const typename mt_signal3::array *a =
+                static_cast<const typename mt_signal3::array *>(r.slots());
+            if(a)
+                for(size_t i = 0; i < a->size; ++i)
+                    if(!_bits::slot_call<T_Ret>::template call<T_Comb, delegate_type, T_Par1, T_Par2, T_Par3>
+                                                  (comb, a->items[i].delegate, par1, par2, par3))
+                        break;
+        }
+        return comb.result();
+        /// @endcond
+    }
+};
+
+/**
+ * @brief Thread-safe multi-slot signal with 4 parameters.
+ *
+ * Slots are called in the order of connection, results are passed to
+ * T_Combiner. emit() doesn't lock and may run concurrently with
+ * connect() and disconnect(), which are serialized and don't wait for
+ * emissions: a slot may still be called by an emission in progress
+ * after it is disconnected.
+ */
+template<class T_Ret, class T_Par1, class T_Par2, class T_Par3, class T_Par4, class T_Combiner = typename default_combiner<T_Ret>::type>
+class mt_signal4: public _bits::mt_signal_impl<delegate4<T_Ret, T_Par1, T_Par2, T_Par3, T_Par4>, slot_base4<T_Ret, T_Par1, T_Par2, T_Par3, T_Par4> >
+{
+public:
+    typedef slot_base4<T_Ret, T_Par1, T_Par2, T_Par3, T_Par4> slot_type;
+    typedef delegate4<T_Ret, T_Par1, T_Par2, T_Par3, T_Par4> delegate_type;
+    typedef typename T_Combiner::result_type result_type;
+
+    using _bits::mt_signal_impl<delegate_type, slot_type>::disconnect;
+
+    signal_connection connect(shared_ptr<slot_type> slot){
+        return this->append(delegate_type(slot.get(), &slot_type::emit), slot);
+    }
+    template<class T_Obj>
+    signal_connection connect(T_Obj *obj, T_Ret (T_Obj::*fn)(T_Par1, T_Par2, T_Par3, T_Par4))
+    {
+        return this->append(delegate_type(obj, fn), shared_ptr<slot_type>());
+    }
+    signal_connection connect(T_Ret (*fn)(T_Par1, T_Par2, T_Par3, T_Par4))
+    {
+        return this->append(delegate_type(fn), shared_ptr<slot_type>());
+    }
+    signal_connection connect(const delegate_type &d)
+    {
+        return this->append(d, shared_ptr<slot_type>());
+    }
+
+    result_type emit(T_Par1 par1, T_Par2 par2, T_Par3 par3, T_Par4 par4){
+        /// @cond
+        T_Combiner c;
+        return combine(c, par1, par2, par3, par4);
+        /// @endcond
+    }
+
+    /**
+     * @brief Emit with own combiner.
+     * @param comb Combiner, its result is returned.
+     */
+    template<class T_Comb>
+    typename T_Comb::result_type combine(T_Comb &comb, T_Par1 par1, T_Par2 par2, T_Par3 par3, T_Par4 par4){
+        /// @cond
+        {
+            typename mt_signal4::reader r(*this);
+            const typename mt_signal4::array *a =
+                static_cast<const typename mt_signal4::array *>(r.slots());
+            if(a)
+                for(size_t i = 0; i < a->size; ++i)
+                    if(!_bits::slot_call<T_Ret>::template call<T_Comb, delegate_type, T_Par1, T_Par2, T_Par3, T_Par4>
+                                                  (comb, a->items[i].delegate, par1, par2, par3, par4))
+                        break;
+        }
+        return comb.result();
+        /// @endcond
+    }
+};
+
+/**
+ * @brief Thread-safe multi-slot signal with 5 parameters.
+ *
+ * Slots are called in the order of connection, results are passed to
+ * T_Combiner. emit() doesn't lock and may run concurrently with
+ * connect() and disconnect(), which are serialized and don't wait for
+ * emissions: a slot may still be called by an emission in progress
+ * after it is disconnected.
+ */
+template<class T_Ret, class T_Par1, class T_Par2, class T_Par3, class T_Par4, class T_Par5, class T_Combiner = typename default_combiner<T_Ret>::type>
+class mt_signal5: public _bits::mt_signal_impl<delegate5<T_Ret, T_Par1, T_Par2, T_Par3, T_Par4, T_Par5>, slot_base5<T_Ret, T_Par1, T_Par2, T_Par3, T_Par4, T_Par5> >
+{
+public:
+    typedef slot_base5<T_Ret, T_Par1, T_Par2, T_Par3, T_Par4, T_Par5> slot_type;
+    typedef delegate5<T_Ret, T_Par1, T_Par2, T_Par3, T_Par4, T_Par5> delegate_type;
+    typedef typename T_Combiner::result_type result_type;
+
+    using _bits::mt_signal_impl<delegate_type, slot_type>::disconnect;
+
+    signal_connection connect(shared_ptr<slot_type> slot){
+        return this->append(delegate_type(slot.get(), &slot_type::emit), slot);
+    }
+    template<class T_Obj>
+    signal_connection connect(T_Obj *obj, T_Ret (T_Obj::*fn)(T_Par1, T_Par2, T_Par3, T_Par4, T_Par5))
+    {
+        return this->append(delegate_type(obj, fn), shared_ptr<slot_type>());
+    }
+    signal_connection connect(T_Ret (*fn)(T_Par1, T_Par2, T_Par3, T_Par4, T_Par5))
+    {
+        return this->append(delegate_type(fn), shared_ptr<slot_type>());
+    }
+    signal_connection connect(const delegate_type &d)
+    {
+        return this->append(d, shared_ptr<slot_type>());
+    }
+
+    result_type emit(T_Par1 par1, T_Par2 par2, T_Par3 par3, T_Par4 par4, T_Par5 par5){
+        /// @cond
+        T_Combiner c;
+        return combine(c, par1, par2, par3, par4, par5);
+        /// @endcond
+    }
+
+    /**
+     * @brief Emit with own combiner.
+     * @param comb Combiner, its result is returned.
+     */
+    template<class T_Comb>
+    typename T_Comb::result_type combine(T_Comb &comb, T_Par1 par1, T_Par2 par2, T_Par3 par3, T_Par4 par4, T_Par5 par5){
+        /// @cond
+        {
+            typename mt_signal5::reader r(*this);
+            const typename mt_signal5::array *a =
+                static_cast<const typename mt_signal5::array *>(r.slots());
+            if(a)
+                for(size_t i = 0; i < a->size; ++i)
+                    if(!_bits::slot_call<T_Ret>::template call<T_Comb, delegate_type, T_Par1, T_Par2, T_Par3, T_Par4, T_Par5>
+                                                  (comb, a->items[i].delegate, par1, par2, par3, par4, par5))
+                        break;
+        }
+        return comb.result();
+        /// @endcond
+    }
+};
+
+/**
+ * @brief Thread-safe multi-slot signal with 6 parameters.
+ *
+ * Slots are called in the order of connection, results are passed to
+ * T_Combiner. emit() doesn't lock and may run concurrently with
+ * connect() and disconnect(), which are serialized and don't wait for
+ * emissions: a slot may still be called by an emission in progress
+ * after it is disconnected.
+ */
+template<class T_Ret, class T_Par1, class T_Par2, class T_Par3, class T_Par4, class T_Par5, class T_Par6, class T_Combiner = typename default_combiner<T_Ret>::type>
+class mt_signal6: public _bits::mt_signal_impl<delegate6<T_Ret, T_Par1, T_Par2, T_Par3, T_Par4, T_Par5, T_Par6>, slot_base6<T_Ret, T_Par1, T_Par2, T_Par3, T_Par4, T_Par5, T_Par6> >
+{
+public:
+    typedef slot_base6<T_Ret, T_Par1, T_Par2, T_Par3, T_Par4, T_Par5, T_Par6> slot_type;
+    typedef delegate6<T_Ret, T_Par1, T_Par2, T_Par3, T_Par4, T_Par5, T_Par6> delegate_type;
+    typedef typename T_Combiner::result_type result_type;
+
+    using _bits::mt_signal_impl<delegate_type, slot_type>::disconnect;
+
+    signal_connection connect(shared_ptr<slot_type> slot){
+        return this->append(delegate_type(slot.get(), &slot_type::emit), slot);
+    }
+    template<class T_Obj>
+    signal_connection connect(T_Obj *obj, T_Ret (T_Obj::*fn)(T_Par1, T_Par2, T_Par3, T_Par4, T_Par5, T_Par6))
+    {
+        return this->append(delegate_type(obj, fn), shared_ptr<slot_type>());
+    }
+    signal_connection connect(T_Ret (*fn)(T_Par1, T_Par2, T_Par3, T_Par4, T_Par5, T_Par6))
+    {
+        return this->append(delegate_type(fn), shared_ptr<slot_type>());
+    }
+    signal_connection connect(const delegate_type &d)
+    {
+        return this->append(d, shared_ptr<slot_type>());
+    }
+
+    result_type emit(T_Par1 par1, T_Par2 par2, T_Par3 par3, T_Par4 par4, T_Par5 par5, T_Par6 par6){
+        /// @cond
+        T_Combiner c;
+        return combine(c, par1, par2, par3, par4, par5, par6);
+        /// @endcond
+    }
+
+    /**
+     * @brief Emit with own combiner.
+     * @param comb Combiner, its result is returned.
+     */
+    template<class T_Comb>
+    typename T_Comb::result_type combine(T_Comb &comb, T_Par1 par1, T_Par2 par2, T_Par3 par3, T_Par4 par4, T_Par5 par5, T_Par6 par6){
+        /// @cond
+        {
+            typename mt_signal6::reader r(*this);
+            const typename mt_signal6::array *a =
+                static_cast<const typename mt_signal6::array *>(r.slots());
+            if(a)
+                for(size_t i = 0; i < a->size; ++i)
+                    if(!_bits::slot_call<T_Ret>::template call<T_Comb, delegate_type, T_Par1, T_Par2, T_Par3, T_Par4, T_Par5, T_Par6>
+                                                  (comb, a->items[i].delegate, par1, par2, par3, par4, par5, par6))
+                        break;
+        }
+        return comb.result();
+        /// @endcond
+    }
+};
+
+} //namespace bloom
@@ -23,6 +23,9 @@
 
 #include <pthread.h>
 #include <errno.h>
+#ifdef BLOOM_MUTEX_PROFILE
+#include <bloom++/mutex_profile.h>
+#endif
 
 namespace bloom
 {
@@ -37,13 +40,24 @@ class mutex
 private:
     friend condition_variable;
     pthread_mutex_t mutex_;
+#ifdef BLOOM_MUTEX_PROFILE
+    mutex_profile_site *site_;
+    unsigned long long acquired_;
+    unsigned int depth_;
+#endif
 
 public:
 
     enum mutex_type{
         normal = PTHREAD_MUTEX_NORMAL,
         recursive = PTHREAD_MUTEX_RECURSIVE,
-        errorcheck = PTHREAD_MUTEX_ERRORCHECK
+        errorcheck = PTHREAD_MUTEX_ERRORCHECK,
+        /// Spins for a while before sleeping (glibc), else normal
+#ifdef __USE_GNU
+        adaptive = PTHREAD_MUTEX_ADAPTIVE_NP
+#else
+        adaptive = PTHREAD_MUTEX_NORMAL
+#endif
     };
     
     enum mutex_errors{
@@ -156,11 +170,19 @@ public:
 
     mutex(mutex_type type = normal)
     {
-        pthread_mutexattr_t a;
-        pthread_mutexattr_init(&a);
-        pthread_mutexattr_settype(&a,type);
-        pthread_mutex_init(&mutex_, &a);
-        pthread_mutexattr_destroy(&a);
+        init(type);
+        set_name(0);
+    }
+
+    /**
+     * @brief Named mutex.
+     * @param name Lock site name for the profiler (see mutex_profile.h).
+     * @param type Mutex type.
+     */
+    mutex(const char *name, mutex_type type = normal)
+    {
+        init(type);
+        set_name(name);
     }
 
     ~mutex()
@@ -168,6 +190,23 @@ public:
         pthread_mutex_destroy(&mutex_);
     }
 
+    /**
+     * @brief Set lock site name for the profiler.
+     * 
+     * Does nothing if profiling isn't compiled in.
+     * @param name Site name (copied), 0 for "unnamed".
+     */
+    void set_name(const char *name)
+    {
+#ifdef BLOOM_MUTEX_PROFILE
+        site_ = mutex_profile::site(name);
+        depth_ = 0;
+#else
+        (void)name;
+#endif
+    }
+
+#ifndef BLOOM_MUTEX_PROFILE
     int lock()
     {
         return pthread_mutex_lock(&mutex_);
@@ -182,6 +221,80 @@ public:
     {
         return pthread_mutex_unlock(&mutex_);
     }
+#else
+    int lock()
+    {
+        /// @cond
+        int r = pthread_mutex_trylock(&mutex_);
+        if(!r){
+            on_acquired(0, false);
+            return 0;
+        }
+        const unsigned long long start = mutex_profile::now();
+        r = pthread_mutex_lock(&mutex_);
+        if(!r)
+            on_acquired(mutex_profile::now() - start, true);
+        return r;
+        /// @endcond
+    }
+
+    int trylock()
+    {
+        /// @cond
+        const int r = pthread_mutex_trylock(&mutex_);
+        if(!r)
+            on_acquired(0, false);
+        return r;
+        /// @endcond
+    }
+
+    int unlock()
+    {
+        /// @cond
+        if(depth_ && !--depth_)
+            mutex_profile::released(site_, mutex_profile::now() - acquired_);
+        return pthread_mutex_unlock(&mutex_);
+        /// @endcond
+    }
+#endif
+
+private:
+    /// @cond
+    void init(mutex_type type)
+    {
+        pthread_mutexattr_t a;
+        pthread_mutexattr_init(&a);
+        pthread_mutexattr_settype(&a,type);
+        pthread_mutex_init(&mutex_, &a);
+        pthread_mutexattr_destroy(&a);
+    }
+
+#ifdef BLOOM_MUTEX_PROFILE
+    void on_acquired(unsigned long long wait, bool contended)
+    {
+        if(!depth_++){
+            acquired_ = mutex_profile::now();
+            mutex_profile::acquired(site_, wait, contended);
+        }
+    }
+
+    // condition_variable releases and reacquires the mutex while waiting
+    unsigned int before_wait()
+    {
+        const unsigned int depth = depth_;
+        if(depth)
+            mutex_profile::released(site_, mutex_profile::now() - acquired_);
+        depth_ = 0;
+        return depth;
+    }
+
+    void after_wait(unsigned int depth)
+    {
+        depth_ = depth;
+        acquired_ = mutex_profile::now();
+    }
+#endif
+    /// @endcond
 };
 
 }//namespace bloom
\ No newline at end of file
@@ -0,0 +1,92 @@
+/* 
+ * Copyright © 2015 Sergei Khairulin <sergei.khairulin@gmail.com>. 
+ * All rights reserved.
+ *
+ * This file is part of Bloom++.
+ *
+ * Bloom++ is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Bloom++ is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Bloom++.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#pragma once
+
+#include <bloom++/string.h>
+
+/**
+ * @file mutex_profile.h
+ * 
+ * Lock contention profiler for bloom::mutex.
+ * 
+ * Profiling is compiled in only when BLOOM_MUTEX_PROFILE is defined
+ * both for the library (make CXXFLAGS="-DLINUX -O3 -DBLOOM_MUTEX_PROFILE")
+ * and for the application; otherwise mutex has no extra members and
+ * no extra code, and the report is empty.
+ * 
+ * Statistics are collected per lock site. A site is a name given to
+ * the mutex (mutex(name) or mutex::set_name()); mutexes with the same
+ * name are aggregated, unnamed mutexes go to the "unnamed" site.
+ * BLOOM_MUTEX_SITE makes a "file:line" name for the current line.
+ */
+
+/// @cond
+#define BLOOM_MUTEX_STR2(x) #x
+#define BLOOM_MUTEX_STR(x) BLOOM_MUTEX_STR2(x)
+/// @endcond
+
+/// Name of the lock site for the current source line
+#define BLOOM_MUTEX_SITE __FILE__ ":" BLOOM_MUTEX_STR(__LINE__)
+
+namespace bloom
+{
+
+struct mutex_profile_site;
+
+/**
+ * @brief Lock contention statistics.
+ * 
+ * For each site: acquisitions, contended acquisitions, total and max
+ * wait and hold times, log2 histograms of wait and hold times and
+ * the thread which held the lock for the longest time.
+ */
+class mutex_profile
+{
+public:
+    /// Number of histogram buckets. Bucket i counts times in [2^(i-1), 2^i) ns.
+    enum { histogram_size = 40 };
+    
+    /**
+     * @brief Is profiling compiled in.
+     */
+    static bool enabled();
+    
+    /**
+     * @brief Report of all sites sorted by total wait time (descending).
+     * @return JSON array of objects.
+     */
+    static string report_json();
+    
+    /**
+     * @brief Reset counters of all sites.
+     */
+    static void reset();
+    
+    /// @cond
+    static mutex_profile_site *site(const char *name);
+    static unsigned long long now();
+    static void acquired(mutex_profile_site *s, unsigned long long wait_ns, bool contended);
+    static void released(mutex_profile_site *s, unsigned long long hold_ns);
+    /// @endcond
+};
+
+} //namespace bloom
@@ -58,9 +58,9 @@ public:
     friend class tcp::server;
     friend class tcp::client;
     
-    receiver_t():ul_(0){}
+    receiver_t():ul_(0), onFree_(0), onFreeArg_(0){}
     receiver_t(shared_ptr<Tc> conn, mutex::unique_lock &ul):
-    connection_(conn), ul_(&ul)
+    connection_(conn), ul_(&ul), onFree_(0), onFreeArg_(0)
     {}
     
     /**
@@ -74,6 +74,19 @@ public:
         return connection_->socket_->recv(buffer, len);
     }
     
+    /**
+     * @brief Receive data from socket without removing it from socket queue.
+     * 
+     * The next recv() returns the same data.
+     * 
+     * @param buffer Buffer for received data.
+     * @param len Size of buffer.
+     * @return Received data size or errorcode (<0).
+     */
+    size_t peek(char *buffer, size_t len){
+        return connection_->socket_->recv(buffer, len, MSG_PEEK);
+    }
+    
     /**
      * @brief Receive data from socket and freeing threads loop.
      * 
@@ -86,7 +99,7 @@ public:
      */
     size_t recv_and_free(char *buffer, size_t len){
         size_t ret = connection_->socket_->recv(buffer, len);
-        ul_->unlock();
+        free();
         return ret;
     }
     
@@ -115,7 +128,7 @@ public:
      */
     size_t recvfrom_and_free(char *buffer, size_t len, addr_ipv4& from){
         size_t ret = connection_->socket_->recvfrom(buffer, len, from);
-        ul_->unlock();
+        free();
         return ret;
     }
     
@@ -123,7 +136,14 @@ public:
      * @brief Freeing threads loop.
      */
     void free(){
+        /// @cond
         ul_->unlock();
+        if(onFree_){
+            void (*fn)(void*) = onFree_;
+            onFree_ = 0;
+            fn(onFreeArg_);
+        }
+        /// @endcond
     }
     
     bool is_closing() const {
@@ -161,6 +181,12 @@ protected:
     void set_locker(mutex::unique_lock &ul){
         ul_ = &ul;
     }
+    
+    // fn(arg) is called once by the first free() after setting
+    void set_free_hook(void (*fn)(void*), void *arg){
+        onFree_ = fn;
+        onFreeArg_ = arg;
+    }
     /// @endcond
     
 private:
@@ -169,6 +195,8 @@ private:
     /// @cond
     shared_ptr<Tc> connection_;
     mutex::unique_lock *ul_;
+    void (*onFree_)(void*);
+    void *onFreeArg_;
     /// @endcond
 };
 
@@ -80,7 +80,7 @@ public:
 
     size_t send(const char * data, size_t len);
     size_t sendto(const addr_ipv4& dest, const char * data, size_t len);
-    size_t recv(char * data, size_t len);
+    size_t recv(char * data, size_t len, int flags = 0);
     size_t recvfrom(char * data, size_t len, addr_ipv4& from);
     
     int read_socket_addr(addr_ipv4 &addr) const;
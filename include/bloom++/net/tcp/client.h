@@ -27,6 +27,7 @@
 #include <bloom++/signal.h>
 #include <bloom++/list.h>
 #include <bloom++/thread.h>
+#include <bloom++/thread_pool.h>
 #include <bloom++/condition_variable.h>
 
 namespace bloom
@@ -43,6 +44,14 @@ namespace tcp
  * 
  * @param ipaddr IPv4 address.
  * @param numExecutors number of executors threads.
+ * @param pool Thread pool for executors (NULL - own threads). Every
+ * executor occupies a worker of the pool until the client is destroyed,
+ * own threads are used if the pool can't reserve enough workers
+ * (thread_pool::reserve()).
+ * @param mode handlers_on_fibers - every executor runs in a fiber of its
+ * thread: waiting for data and socket calls of the callback suspend the
+ * fiber, so fibers spawned by the callback (fiber_scheduler::current())
+ * run meanwhile.
  */
 class client
 {
@@ -50,7 +59,19 @@ public:
 
     client(int numExecutors, 
            size_t select_timeout_sec, 
-           size_t select_timeout_usec);
+           size_t select_timeout_usec,
+           thread_pool *pool = 0,
+           handler_mode mode = handlers_on_threads);
+    
+    /**
+     * @brief Client with own threads placed by layout.
+     * @param layout Attributes of executors threads (layout.executors).
+     */
+    client(int numExecutors, 
+           size_t select_timeout_sec, 
+           size_t select_timeout_usec,
+           const thread_layout &layout,
+           handler_mode mode = handlers_on_threads);
     ~client();
 
     int bind(const addr_ipv4& ipaddr);
@@ -66,8 +87,11 @@ private:
     size_t select_timeout_sec_;
     size_t select_timeout_usec_;
     bool bBlocking_;
+    handler_mode mode_;
 
     list<shared_ptr<thread<client> > > executors_;
+    thread_pool *pool_;
+    list<future<void> > tasks_;
     mutex clientMutex_;
     condition_variable cv_;
     
@@ -81,7 +105,9 @@ private:
 
     bool bStopping_;
 
+    void start(const thread_layout &layout);
     void runExecutor();
+    void runFiberExecutor();
     
     //Signal callbacks
     bool scb_allow(connection&){return true;}
@@ -23,6 +23,7 @@
 
 #include <bloom++/net/tcp/socket.h>
 #include <bloom++/net/receiver_t.h>
+#include <bloom++/fiber_mutex.h>
 
 namespace bloom
 {
@@ -39,6 +40,18 @@ class connection;
 
 typedef receiver_t<connection> receiver;
 
+/**
+ * @brief How executors of server and client run the callbacks.
+ */
+enum handler_mode
+{
+    /// On the executor thread, blocking socket calls block the thread.
+    handlers_on_threads,
+    /// In fibers of a fiber_scheduler on every executor thread: socket
+    /// calls suspend the fiber and the thread serves other connections.
+    handlers_on_fibers
+};
+
 /**
  * @brief TCP connection.
  * 
@@ -58,6 +71,12 @@ public:
     size_t send(const char * data, size_t len);
     size_t sendto(const addr_ipv4& dest, const char * data, size_t len);
     
+    /**
+     * @brief Mark the connection closing and shut down its reading side.
+     * 
+     * Callbacks blocked in recv() get the end of input, an idle
+     * connection of a server is woken and removed. Sending still works.
+     */
     void close();
     bool is_closing() const;
     
@@ -72,6 +91,7 @@ protected:
     addr_ipv4 remoteAddr_;
     mutex recv_m_;
     mutex send_m_;
+    fiber_mutex fiber_send_m_; // taken by fibers before send_m_
     shared_ptr<socket> socket_;
     bool bClosing_;
     /// @endcond
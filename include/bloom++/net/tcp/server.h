@@ -24,9 +24,11 @@
 #include <bloom++/net/tcp/socket.h>
 #include <bloom++/net/receiver_t.h>
 #include <bloom++/net/tcp/connection.h>
-#include <bloom++/signal.h>
+#include <bloom++/mt_signal.h>
 #include <bloom++/list.h>
+#include <bloom++/vector.h>
 #include <bloom++/thread.h>
+#include <bloom++/thread_pool.h>
 #include <bloom++/condition_variable.h>
 
 namespace bloom
@@ -40,9 +42,26 @@ namespace tcp
 
 /**
  * @brief TCP Server.
+ * 
+ * Executors wait on one epoll set of all connections (edge-triggered,
+ * EPOLLONESHOT): a connection is given to one executor when it has data
+ * and is rearmed after the executor callback returns or frees the
+ * receiver, so callbacks of a connection don't overlap until free() and
+ * no lock is held around them. Idle connections cost nothing. The select
+ * timeouts are used by acceptors only.
+ * 
  * @param ipaddr IPv4 address.
  * @param numAcceptors number of acceptors threads.
  * @param numExecutors number of executors threads.
+ * @param pool Thread pool for acceptors and executors (NULL - own threads).
+ * Every acceptor and executor occupies a worker of the pool until the
+ * server is destroyed, own threads are used if the pool can't reserve
+ * enough workers (thread_pool::reserve()).
+ * @param mode handlers_on_fibers - every ready connection is served by
+ * a new fiber of the executor thread, so a callback blocked in recv()
+ * or send() doesn't hold the thread. Callbacks mustn't block in other
+ * calls (use fiber_mutex, fiber::sleep...). The destructor shuts the
+ * connections down first to end callbacks waiting in recv() or send().
  */
 class server
 {
@@ -51,13 +70,36 @@ public:
     server(int numAcceptors,
            int numExecutors,
            size_t select_timeout_sec, 
-           size_t select_timeout_usec);
+           size_t select_timeout_usec,
+           thread_pool *pool = 0,
+           handler_mode mode = handlers_on_threads);
+    
+    /**
+     * @brief Server with own threads placed by layout.
+     * @param layout Attributes of acceptors and executors threads.
+     */
+    server(int numAcceptors,
+           int numExecutors,
+           size_t select_timeout_sec, 
+           size_t select_timeout_usec,
+           const thread_layout &layout,
+           handler_mode mode = handlers_on_threads);
     ~server();
 
     int bind(const addr_ipv4& ipaddr);
-    signal1<bool, connection& > &acceptor();
-    signal2<bool, receiver&, connection& > &executor();
-    signal1<void, connection& > &disconnector();
+    typedef mt_signal1<bool, connection&, combiner_all_true> acceptor_signal;
+    typedef mt_signal2<bool, receiver&, connection&, combiner_all_true> executor_signal;
+    typedef mt_signal1<void, connection&> disconnector_signal;
+
+    /**
+     * @brief Connection is accepted if all slots return true.
+     */
+    acceptor_signal &acceptor();
+    /**
+     * @brief Connection is closed if any slot returns false or throws.
+     */
+    executor_signal &executor();
+    disconnector_signal &disconnector();
     void allow_acceptor();
     void deny_acceptor();
 
@@ -67,32 +109,63 @@ private:
     int numExecutors_;
     size_t select_timeout_sec_;
     size_t select_timeout_usec_;
-    bool bBlocking_;
+    handler_mode mode_;
 
     list<shared_ptr<thread<server> > > acceptors_;
     list<shared_ptr<thread<server> > > executors_;
+    thread_pool *pool_;
+    list<future<void> > tasks_;
 
-    list<shared_ptr<connection> > connections_;
+    // connections by socket descriptor, events carry the generation
+    // of the connection: a descriptor may be reused by a new one
+    vector<shared_ptr<connection> > connections_;
+    vector<unsigned int> generations_;
+    unsigned int generation_;
+    int epfd_;
+    int wakeFd_;
 
     mutex mutexAcceptors_;
     condition_variable cvAcceptors_;
     mutex mutexExecutors_;
     mutex mutexConnections_;
-    condition_variable cvConnections_;
     shared_ptr<socket> socket_;
-    signal1<bool, connection& > acceptor_;
-    signal2<bool, receiver&, connection& > executor_;
-    signal1<void, connection& > disconnector_;
+    acceptor_signal acceptor_;
+    executor_signal executor_;
+    disconnector_signal disconnector_;
+    mutex mutexDeny_;
+    bool bDenied_;
 
     bool bStopping_;
 
+    struct serving
+    {
+        server *server_;
+        connection *conn_;
+        unsigned int gen_;
+        bool bRearmed_;
+    };
+    
+    struct fiber_serving
+    {
+        server *server_;
+        shared_ptr<connection> conn_;
+        unsigned int gen_;
+    };
+
+    void start(const thread_layout &layout);
     void runAcceptor();
     void runExecutor();
+    void runFiberExecutor();
+    void pollFibers();
+    static void serveFiber(void *arg);
+    void add_connection(shared_ptr<connection> &conn);
+    void remove_connection(const shared_ptr<connection> &conn);
+    void rearm(connection &conn, unsigned int gen);
+    void serve(receiver &r, const shared_ptr<connection> &conn, unsigned int gen);
+    static void on_free(void *arg);
     
     //Signal callbacks
-    bool scb_allow(connection&){return true;}
     bool scb_deny(connection&){return false;}
-    void scb_done(connection& conn){}
     /// @endcond
 };
 
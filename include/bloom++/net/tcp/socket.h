@@ -40,6 +40,8 @@ class socket : public socket_base
 {
 public:
     friend class server;
+    friend class client;
+    friend class connection;
 
     socket() : socket_base(){}
     ~socket(){}
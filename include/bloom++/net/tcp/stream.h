@@ -24,6 +24,11 @@
 #include <bloom++/stream/io.h>
 #include <bloom++/net/tcp/connection.h>
 
+#ifndef BLOOM_TCP_STREAM_WINDOW
+/// Size of the window for peek() (bytes).
+#define BLOOM_TCP_STREAM_WINDOW 4096
+#endif
+
 namespace bloom {
 
 namespace net {
@@ -32,6 +37,9 @@ namespace tcp {
 
 /**
  * @brief Input/output stream for TCP Connection.
+ * 
+ * peek() copies received data to the window without removing it from
+ * socket queue, so unconsumed data isn't lost if the stream is destroyed.
  * @param conn TCP Connection.
  */
 class iostream: public stream::io_base
@@ -48,10 +56,15 @@ public:
     virtual size_t read(char *data, size_t size);
     virtual bool iready();
     virtual bool oready();
+    virtual size_t peek(const char *&data);
+    virtual void consume(size_t size);
 private:
     /// @cond
     receiver& r_;
     connection& s_;
+    char window_[BLOOM_TCP_STREAM_WINDOW];
+    size_t wpos_;
+    size_t wsize_;
     /// @endcond
 };
 
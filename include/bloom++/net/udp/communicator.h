@@ -23,6 +23,7 @@
 
 #include <bloom++/signal.h>
 #include <bloom++/thread.h>
+#include <bloom++/thread_pool.h>
 #include <bloom++/list.h>
 #include <bloom++/condition_variable.h>
 #include <bloom++/net/udp/socket.h>
@@ -90,6 +91,24 @@ public:
     signal2<bool, receiver &, sender & > &executor();
     
     void add_threads(unsigned int num);
+    
+    /**
+     * @brief Adding of executors threads with attributes.
+     * 
+     * Thread i (counting all added threads) gets attr.for_index(i).
+     */
+    void add_threads(unsigned int num, const thread_attributes &attr);
+    
+    /**
+     * @brief Adding of executors running as tasks of pool.
+     * 
+     * Every executor occupies a worker of the pool until the
+     * communicator is destroyed, own threads are added if the pool
+     * can't reserve enough workers (thread_pool::reserve()).
+     * @param num Number of executors.
+     * @param pool Thread pool.
+     */
+    void add_threads(unsigned int num, thread_pool &pool);
     unsigned int num_threads();
     
     void bind(const addr_ipv4& ipaddr) ;
@@ -110,6 +129,8 @@ protected:
     mutex mutexExecutors_;
 
     list<shared_ptr<thread<communicator> > > executors_;
+    list<future<void> > tasks_;
+    list<thread_pool*> pools_; // pool of every task
 
     shared_ptr<socket> socket_;
     shared_ptr<sender> sender_;
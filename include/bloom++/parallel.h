@@ -0,0 +1,424 @@
+/* 
+ * Copyright © 2015 Sergei Khairulin <sergei.khairulin@gmail.com>. 
+ * All rights reserved.
+ *
+ * This file is part of Bloom++.
+ *
+ * Bloom++ is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Bloom++ is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Bloom++.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include <new>
+#include <algorithm>
+#include <memory>
+#include <bloom++/exception.h>
+#include <bloom++/vector.h>
+
+namespace bloom
+{
+
+/**
+ * @brief Exception in a worker thread of parallel algorithm.
+ */
+class parallel_exception: public exception
+{
+public:
+    parallel_exception(string msg):exception(string("parallel_exception: ")+msg){}
+    virtual ~parallel_exception() throw() {}
+};
+
+/**
+ * @brief Task for parallel_run().
+ */
+class parallel_task
+{
+public:
+    virtual ~parallel_task(){}
+    /**
+     * @brief Processing of chunk [begin, end).
+     * 
+     * Called concurrently for different chunks.
+     */
+    virtual void run(size_t begin, size_t end) = 0;
+};
+
+/**
+ * @brief Number of threads used by parallel algorithms.
+ */
+size_t parallel_concurrency();
+
+/**
+ * @brief Set number of threads used by parallel algorithms.
+ * @param n Number of threads (the calling thread is counted too),
+ * 0 - number of workers of thread_pool::shared().
+ */
+void set_parallel_concurrency(size_t n);
+
+/**
+ * @brief Chunk size used for range.
+ * @param size Size of range.
+ * @param grain Requested chunk size, 0 - automatic.
+ */
+size_t parallel_grain(size_t size, size_t grain);
+
+/**
+ * @brief Running of task over [0, size) by chunks of grain size.
+ * 
+ * Chunks start at multiples of grain. They are processed by the calling
+ * thread and tasks submitted to thread_pool::shared(), the call returns
+ * when all chunks are done. The calling thread takes chunks too, so
+ * nested and concurrent calls progress even if all workers are busy
+ * (the chunks then run in the calling thread).
+ * An exception of the calling thread is rethrown, an exception of a
+ * worker thread is reported by parallel_exception.
+ * @param task Task.
+ * @param size Size of range.
+ * @param grain Chunk size (> 0).
+ */
+void parallel_run(parallel_task &task, size_t size, size_t grain);
+
+/// @cond
+template<class Func>
+class parallel_for_task: public parallel_task
+{
+    size_t begin_;
+    const Func &f_;
+public:
+    parallel_for_task(size_t begin, const Func &f):
+    begin_(begin), f_(f){}
+    
+    virtual void run(size_t begin, size_t end){
+        Func f(f_);
+        for(size_t i = begin_ + begin; i != begin_ + end; ++i)
+            f(i);
+    }
+};
+
+template<class vT, class Func>
+class parallel_for_each_task: public parallel_task
+{
+    vT *data_;
+    const Func &f_;
+public:
+    parallel_for_each_task(vT *data, const Func &f):
+    data_(data), f_(f){}
+    
+    virtual void run(size_t begin, size_t end){
+        Func f(f_);
+        for(vT *p = data_ + begin; p != data_ + end; ++p)
+            f(*p);
+    }
+};
+
+template<class vT, class rT, class Func>
+class parallel_transform_task: public parallel_task
+{
+    const vT *data_;
+    rT *out_;
+    const Func &f_;
+public:
+    parallel_transform_task(const vT *data, rT *out, const Func &f):
+    data_(data), out_(out), f_(f){}
+    
+    virtual void run(size_t begin, size_t end){
+        Func f(f_);
+        for(size_t i = begin; i != end; ++i)
+            out_[i] = f(data_[i]);
+    }
+};
+
+template<class vT, class Op>
+class parallel_reduce_task: public parallel_task
+{
+    const vT *data_;
+    vT *partials_;
+    size_t grain_;
+    const Op &op_;
+public:
+    parallel_reduce_task(const vT *data, vT *partials, size_t grain, const Op &op):
+    data_(data), partials_(partials), grain_(grain), op_(op){}
+    
+    virtual void run(size_t begin, size_t end){
+        Op op(op_);
+        vT r(data_[begin]);
+        for(size_t i = begin + 1; i != end; ++i)
+            r = op(r, data_[i]);
+        partials_[begin / grain_] = r;
+    }
+};
+
+template<class vT, class Compare>
+class parallel_sort_task: public parallel_task
+{
+    vT *data_;
+    size_t size_;
+    size_t run_;
+    const Compare &comp_;
+public:
+    parallel_sort_task(vT *data, size_t size, size_t run, const Compare &comp):
+    data_(data), size_(size), run_(run), comp_(comp){}
+    
+    virtual void run(size_t begin, size_t end){
+        for(size_t k = begin; k != end; ++k)
+            std::sort(data_ + k * run_,
+                      data_ + std::min((k + 1) * run_, size_), comp_);
+    }
+};
+
+/*
+ * Merging of sorted runs pairs of width size from src to dst.
+ * Every pair is merged by pieces parts, the pieces are split by
+ * positions in the first run and lower bounds of them in the second one.
+ */
+template<class vT, class Compare>
+class parallel_merge_task: public parallel_task
+{
+    const vT *src_;
+    vT *dst_;
+    size_t size_;
+    size_t width_;
+    size_t pieces_;
+    const Compare &comp_;
+    
+    size_t split(const vT *a, size_t na, const vT *b, size_t nb, size_t piece) const {
+        if(!piece)return 0;
+        if(piece == pieces_)return nb;
+        const size_t ia = piece * na / pieces_;
+        if(ia == na)return nb;
+        return std::lower_bound(b, b + nb, a[ia], comp_) - b;
+    }
+public:
+    parallel_merge_task(const vT *src, vT *dst, size_t size, size_t width,
+                        size_t pieces, const Compare &comp):
+    src_(src), dst_(dst), size_(size), width_(width), pieces_(pieces), comp_(comp){}
+    
+    virtual void run(size_t begin, size_t end){
+        for(size_t t = begin; t != end; ++t){
+            const size_t pair = t / pieces_, piece = t % pieces_;
+            const size_t ofs = pair * 2 * width_;
+            const size_t na = std::min(width_, size_ - ofs);
+            const size_t nb = std::min(width_, size_ - ofs - na);
+            const vT *a = src_ + ofs, *b = a + na;
+            const size_t ia = piece * na / pieces_;
+            const size_t ia1 = (piece + 1) * na / pieces_;
+            const size_t ib = split(a, na, b, nb, piece);
+            const size_t ib1 = split(a, na, b, nb, piece + 1);
+            std::merge(a + ia, a + ia1, b + ib, b + ib1, dst_ + ofs + ia + ib, comp_);
+        }
+    }
+};
+
+template<class vT>
+struct parallel_less
+{
+    bool operator()(const vT &a, const vT &b) const {
+        return a < b;
+    }
+};
+/// @endcond
+
+/**
+ * @brief Calling f(i) for every i in [begin, end) in parallel.
+ * @param begin Begin of range.
+ * @param end End of range.
+ * @param f Functor, copied for every chunk.
+ * @param grain Chunk size, 0 - automatic.
+ */
+template<class Func>
+void parallel_for(size_t begin, size_t end, Func f, size_t grain = 0)
+{
+    /// @cond
+    if(end <= begin)return;
+    parallel_for_task<Func> task(begin, f);
+    parallel_run(task, end - begin, parallel_grain(end - begin, grain));
+    /// @endcond
+}
+
+/**
+ * @brief Calling f(element) for every element of [first, last) in parallel.
+ */
+template<class vT, class Func>
+void parallel_for(vT *first, vT *last, Func f, size_t grain = 0)
+{
+    /// @cond
+    if(last <= first)return;
+    parallel_for_each_task<vT, Func> task(first, f);
+    parallel_run(task, last - first, parallel_grain(last - first, grain));
+    /// @endcond
+}
+
+/**
+ * @brief Calling f(element) for every element of vector in parallel.
+ */
+template<class vT, class Traits, class Func>
+void parallel_for(vector<vT, Traits> &vec, Func f, size_t grain = 0)
+{
+    /// @cond
+    if(!vec.size())return;
+    parallel_for(vec.data(), vec.data() + vec.size(), f, grain);
+    /// @endcond
+}
+
+/**
+ * @brief Writing of f(first[i]) to out[i] in parallel.
+ */
+template<class vT, class rT, class Func>
+void parallel_transform(const vT *first, const vT *last, rT *out, Func f, size_t grain = 0)
+{
+    /// @cond
+    if(last <= first)return;
+    parallel_transform_task<vT, rT, Func> task(first, out, f);
+    parallel_run(task, last - first, parallel_grain(last - first, grain));
+    /// @endcond
+}
+
+/**
+ * @brief Filling of out by f(element) of every element of in in parallel.
+ */
+template<class vT, class T1, class rT, class T2, class Func>
+void parallel_transform(const vector<vT, T1> &in, vector<rT, T2> &out, Func f, size_t grain = 0)
+{
+    /// @cond
+    out.resize(in.size());
+    if(!in.size())return;
+    parallel_transform(in.data(), in.data() + in.size(), out.data(), f, grain);
+    /// @endcond
+}
+
+/**
+ * @brief Reduction of [first, last) by associative operation in parallel.
+ * @param init Initial value.
+ * @param op Binary operation, op(a, b) returns vT.
+ * @return op(...op(op(init, first[0]), first[1])...) up to the order
+ * of evaluation.
+ */
+template<class vT, class Op>
+vT parallel_reduce(const vT *first, const vT *last, vT init, Op op, size_t grain = 0)
+{
+    /// @cond
+    if(last <= first)return init;
+    const size_t size = last - first;
+    grain = parallel_grain(size, grain);
+    const size_t chunks = (size + grain - 1) / grain;
+    vector<vT> partials(chunks, init);
+    parallel_reduce_task<vT, Op> task(first, partials.data(), grain, op);
+    parallel_run(task, size, grain);
+    const vT *p = partials.data();
+    for(size_t i = 0; i != chunks; ++i)
+        init = op(init, p[i]);
+    return init;
+    /// @endcond
+}
+
+/**
+ * @brief Reduction of vector by associative operation in parallel.
+ */
+template<class vT, class Traits, class Op>
+vT parallel_reduce(const vector<vT, Traits> &vec, vT init, Op op, size_t grain = 0)
+{
+    /// @cond
+    return parallel_reduce(vec.data(), vec.data() + vec.size(), init, op, grain);
+    /// @endcond
+}
+
+/**
+ * @brief Sorting of [first, last) in parallel.
+ * 
+ * Runs are sorted by std::sort and merged by pieces in parallel.
+ * Not stable, uses temporary copy of the range.
+ * @param comp Less than comparison.
+ * @param grain Minimal size of sorted run, 0 - automatic.
+ */
+template<class vT, class Compare>
+void parallel_sort(vT *first, vT *last, Compare comp, size_t grain = 0)
+{
+    /// @cond
+    if(last <= first)return;
+    const size_t size = last - first;
+    const size_t threads = parallel_concurrency();
+    if(!grain)grain = 4096;
+    if(threads < 2 || size <= grain){
+        std::sort(first, last, comp);
+        return;
+    }
+    size_t run = (size + threads - 1) / threads;
+    if(run < grain)run = grain;
+    const size_t runs = (size + run - 1) / run;
+    {
+        parallel_sort_task<vT, Compare> task(first, size, run, comp);
+        parallel_run(task, runs, 1);
+    }
+    if(runs < 2)return;
+    
+    vT *tmp = static_cast<vT*>(::operator new(size * sizeof(vT)));
+    try{
+        std::uninitialized_copy(first, last, tmp);
+    }
+    catch(...){
+        ::operator delete(tmp);
+        throw;
+    }
+    vT *src = first, *dst = tmp;
+    try{
+        for(size_t width = run; width < size; width *= 2){
+            const size_t pairs = (size + 2 * width - 1) / (2 * width);
+            const size_t pieces = (2 * threads + pairs - 1) / pairs;
+            parallel_merge_task<vT, Compare> task(src, dst, size, width, pieces, comp);
+            parallel_run(task, pairs * pieces, 1);
+            std::swap(src, dst);
+        }
+        if(src != first)
+            std::copy(src, src + size, first);
+    }
+    catch(...){
+        for(size_t i = 0; i != size; ++i)
+            tmp[i].~vT();
+        ::operator delete(tmp);
+        throw;
+    }
+    for(size_t i = 0; i != size; ++i)
+        tmp[i].~vT();
+    ::operator delete(tmp);
+    /// @endcond
+}
+
+template<class vT>
+void parallel_sort(vT *first, vT *last)
+{
+    /// @cond
+    parallel_sort(first, last, parallel_less<vT>());
+    /// @endcond
+}
+
+template<class vT, class Traits, class Compare>
+void parallel_sort(vector<vT, Traits> &vec, Compare comp, size_t grain = 0)
+{
+    /// @cond
+    if(vec.size() < 2)return;
+    parallel_sort(vec.data(), vec.data() + vec.size(), comp, grain);
+    /// @endcond
+}
+
+template<class vT, class Traits>
+void parallel_sort(vector<vT, Traits> &vec)
+{
+    /// @cond
+    parallel_sort(vec, parallel_less<vT>());
+    /// @endcond
+}
+
+} //namespace bloom
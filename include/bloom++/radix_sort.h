@@ -0,0 +1,257 @@
+/* 
+ * Copyright © 2015 Sergei Khairulin <sergei.khairulin@gmail.com>. 
+ * All rights reserved.
+ *
+ * This file is part of Bloom++.
+ *
+ * Bloom++ is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Bloom++ is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Bloom++.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <new>
+#include <bloom++/vector.h>
+#include <bloom++/string.h>
+
+namespace bloom
+{
+
+/// @cond
+/*
+ * Mapping of keys to unsigned integers with the same order and number
+ * of bits of LSD digit.
+ */
+template<class kT>
+struct radix_key;
+
+#define BLOOM_RADIX_UNSIGNED_KEY(kT, uT, digit_bits) \
+template<> struct radix_key<kT> { \
+    typedef uT type; \
+    enum { bits = digit_bits }; \
+    inline static type value(kT k){ return k; } \
+}
+
+#define BLOOM_RADIX_SIGNED_KEY(kT, uT, digit_bits) \
+template<> struct radix_key<kT> { \
+    typedef uT type; \
+    enum { bits = digit_bits }; \
+    inline static type value(kT k){ \
+        return static_cast<type>(k) ^ (static_cast<type>(1) << (sizeof(type) * 8 - 1)); \
+    } \
+}
+
+// 32-bit keys are sorted by three 11-bit digits, 64-bit keys by eight
+// 8-bit digits (constant high bytes of ids and timestamps are skipped)
+BLOOM_RADIX_UNSIGNED_KEY(unsigned int, uint32_t, 11);
+BLOOM_RADIX_SIGNED_KEY(int, uint32_t, 11);
+BLOOM_RADIX_UNSIGNED_KEY(unsigned long long, uint64_t, 8);
+BLOOM_RADIX_SIGNED_KEY(long long, uint64_t, 8);
+#if __WORDSIZE == 64
+BLOOM_RADIX_UNSIGNED_KEY(unsigned long, uint64_t, 8);
+BLOOM_RADIX_SIGNED_KEY(long, uint64_t, 8);
+#else
+BLOOM_RADIX_UNSIGNED_KEY(unsigned long, uint32_t, 11);
+BLOOM_RADIX_SIGNED_KEY(long, uint32_t, 11);
+#endif
+
+#undef BLOOM_RADIX_UNSIGNED_KEY
+#undef BLOOM_RADIX_SIGNED_KEY
+
+template<class kT, class vT>
+void radix_sort_lsd(kT *keys, vT *values, size_t size, kT *key_scratch, vT *value_scratch)
+{
+    typedef radix_key<kT> rk;
+    typedef typename rk::type uT;
+    enum {
+        bits = rk::bits,
+        passes = (sizeof(uT) * 8 + bits - 1) / bits,
+        buckets = 1 << bits,
+        mask = buckets - 1
+    };
+    size_t count[passes][buckets];
+    memset(count, 0, sizeof(count));
+    for(size_t i = 0; i != size; ++i){
+        const uT k = rk::value(keys[i]);
+        for(size_t p = 0; p != passes; ++p)
+            ++count[p][(k >> (p * bits)) & mask];
+    }
+    
+    kT *ks = keys, *kd = key_scratch;
+    vT *vs = values, *vd = value_scratch;
+    for(size_t p = 0; p != passes; ++p){
+        size_t *c = count[p];
+        const size_t shift = p * bits;
+        if(c[(rk::value(ks[0]) >> shift) & mask] == size)
+            continue; // all keys have the same digit
+        size_t sum = 0;
+        for(size_t d = 0; d != buckets; ++d){
+            const size_t n = c[d];
+            c[d] = sum;
+            sum += n;
+        }
+        if(values){
+            for(size_t i = 0; i != size; ++i){
+                const size_t pos = c[(rk::value(ks[i]) >> shift) & mask]++;
+                kd[pos] = ks[i];
+                vd[pos] = vs[i];
+            }
+            vT *vt = vs; vs = vd; vd = vt;
+        }
+        else {
+            for(size_t i = 0; i != size; ++i)
+                kd[c[(rk::value(ks[i]) >> shift) & mask]++] = ks[i];
+        }
+        kT *kt = ks; ks = kd; kd = kt;
+    }
+    if(ks != keys){
+        memcpy(keys, ks, size * sizeof(kT));
+        if(values)
+            for(size_t i = 0; i != size; ++i)
+                values[i] = vs[i];
+    }
+}
+
+template<class vT>
+class radix_buffer
+{
+    vT *data_;
+public:
+    explicit radix_buffer(size_t size):
+    data_(static_cast<vT*>(::operator new(size * sizeof(vT)))){
+    }
+    ~radix_buffer(){
+        ::operator delete(data_);
+    }
+    vT *data(){
+        return data_;
+    }
+};
+
+/*
+ * Unsigned character at position, 0 is the end of string.
+ */
+inline size_t radix_char(const string &s, size_t depth)
+{
+    return depth < s.size() ? static_cast<unsigned char>(s.data()[depth]) + 1 : 0;
+}
+
+inline bool radix_less(const string &a, const string &b, size_t depth)
+{
+    const size_t na = a.size() - depth, nb = b.size() - depth;
+    const int r = memcmp(a.data() + depth, b.data() + depth, na < nb ? na : nb);
+    return r < 0 || (!r && na < nb);
+}
+
+void radix_sort_strings(string *data, size_t size, size_t depth);
+/// @endcond
+
+/**
+ * @brief Stable LSD radix sort of integer keys.
+ * 
+ * Sorts int, long, long long and unsigned of them.
+ * @param data Keys.
+ * @param size Number of keys.
+ * @param scratch Buffer for size keys (contents are overwritten).
+ */
+template<class kT>
+void radix_sort(kT *data, size_t size, kT *scratch)
+{
+    /// @cond
+    if(size < 2)return;
+    radix_sort_lsd(data, static_cast<kT*>(0), size, scratch, static_cast<kT*>(0));
+    /// @endcond
+}
+
+/**
+ * @brief Stable LSD radix sort of integer keys (allocates scratch buffer).
+ */
+template<class kT>
+void radix_sort(kT *data, size_t size)
+{
+    /// @cond
+    if(size < 2)return;
+    radix_buffer<kT> scratch(size);
+    radix_sort(data, size, scratch.data());
+    /// @endcond
+}
+
+/**
+ * @brief Stable LSD radix sort of key/value pairs by keys.
+ * @param keys Keys.
+ * @param values Values, moved together with keys.
+ * @param size Number of pairs.
+ * @param key_scratch Buffer for size keys.
+ * @param value_scratch Buffer for size constructed values.
+ */
+template<class kT, class vT>
+void radix_sort(kT *keys, vT *values, size_t size, kT *key_scratch, vT *value_scratch)
+{
+    /// @cond
+    if(size < 2)return;
+    radix_sort_lsd(keys, values, size, key_scratch, value_scratch);
+    /// @endcond
+}
+
+/**
+ * @brief Stable LSD radix sort of vector with reusable scratch vector.
+ * @param vec Keys.
+ * @param scratch Scratch vector, resized to size of vec (keep it between
+ * calls to avoid allocations).
+ */
+template<class kT, class Traits>
+void radix_sort(vector<kT, Traits> &vec, vector<kT, Traits> &scratch)
+{
+    /// @cond
+    if(vec.size() < 2)return;
+    if(scratch.size() < vec.size())
+        scratch.resize(vec.size());
+    radix_sort(vec.data(), vec.size(), scratch.data());
+    /// @endcond
+}
+
+template<class kT, class Traits>
+void radix_sort(vector<kT, Traits> &vec)
+{
+    /// @cond
+    radix_sort(vec.data(), vec.size());
+    /// @endcond
+}
+
+/**
+ * @brief Multikey quicksort (three-way radix quicksort) of strings.
+ * 
+ * Strings are compared as unsigned bytes and aren't copied (swapped only).
+ * Not stable.
+ */
+inline void radix_sort(string *data, size_t size)
+{
+    /// @cond
+    radix_sort_strings(data, size, 0);
+    /// @endcond
+}
+
+template<class Traits>
+void radix_sort(vector<string, Traits> &vec)
+{
+    /// @cond
+    radix_sort_strings(vec.data(), vec.size(), 0);
+    /// @endcond
+}
+
+} //namespace bloom
@@ -0,0 +1,130 @@
+/* 
+ * Copyright © 2015 Sergei Khairulin <sergei.khairulin@gmail.com>. 
+ * All rights reserved.
+ *
+ * This file is part of Bloom++.
+ *
+ * Bloom++ is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Bloom++ is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Bloom++.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#pragma once
+
+#include <bloom++/_bits/futex.h>
+
+namespace bloom
+{
+
+/**
+ * @brief Counting semaphore.
+ * 
+ * Built on futex, doesn't enter the kernel when the count is positive
+ * or nobody waits. Timeouts use CLOCK_MONOTONIC.
+ */
+class semaphore
+{
+public:
+    /**
+     * @param count Initial count.
+     */
+    semaphore(int count = 0):count_(count), waiters_(0)
+    {
+    }
+    
+    /**
+     * @brief Increase the count and wake up waiting threads.
+     * @param n Increment.
+     */
+    void post(int n = 1)
+    {
+        /// @cond
+        __sync_fetch_and_add(&count_, n);
+        if(__atomic_load_n(&waiters_, __ATOMIC_SEQ_CST))
+            futex_wake(&count_, n);
+        /// @endcond
+    }
+    
+    /**
+     * @brief Decrease the count if it's positive.
+     * @return true if decreased.
+     */
+    bool trywait()
+    {
+        /// @cond
+        int c = __atomic_load_n(&count_, __ATOMIC_RELAXED);
+        while(c > 0)
+            if(__atomic_compare_exchange_n(&count_, &c, c - 1, true,
+                                           __ATOMIC_ACQUIRE, __ATOMIC_RELAXED))
+                return true;
+        return false;
+        /// @endcond
+    }
+    
+    /**
+     * @brief Wait for the positive count and decrease it.
+     */
+    void wait()
+    {
+        /// @cond
+        while(!trywait()){
+            __sync_fetch_and_add(&waiters_, 1);
+            futex_wait(&count_, 0);
+            __sync_fetch_and_sub(&waiters_, 1);
+        }
+        /// @endcond
+    }
+    
+    /**
+     * @brief Wait for the positive count and decrease it.
+     * @param timeout_ms Timeout in milliseconds.
+     * @return false on timeout.
+     */
+    bool wait(long timeout_ms)
+    {
+        /// @cond
+        if(trywait())
+            return true;
+        timespec deadline;
+        monotonic_deadline(deadline, timeout_ms);
+        for(;;){
+            __sync_fetch_and_add(&waiters_, 1);
+            const bool in_time = futex_wait(&count_, 0, &deadline);
+            __sync_fetch_and_sub(&waiters_, 1);
+            if(trywait())
+                return true;
+            if(!in_time)
+                return false;
+        }
+        /// @endcond
+    }
+    
+    /**
+     * @brief Current count.
+     */
+    int value() const
+    {
+        return __atomic_load_n(&count_, __ATOMIC_RELAXED);
+    }
+    
+private:
+    /// @cond
+    volatile int count_;
+    volatile int waiters_;
+    
+    semaphore(const semaphore &);
+    semaphore &operator=(const semaphore &);
+    /// @endcond
+};
+
+} //namespace bloom
@@ -22,6 +22,7 @@
 #pragma once
 
 #include <bloom++/shared/shared_info.h>
+#include <bloom++/_bits/traits.h>
 
 #ifdef SHARED_DEBUG
 #define __BLOOM_WITH_DEBUG
@@ -245,5 +246,10 @@ bool operator!=(const ptr<Tp> &p, const ptr<Tp1> &p1)
 
 } //namespace shared
 
-} //namespace bloom
+template<class T>
+struct is_relocatable<shared::ptr<T> >
+{
+    static const bool value = true;
+};
 
+} //namespace bloom
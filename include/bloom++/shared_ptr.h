@@ -21,6 +21,8 @@
 
 #pragma once
 
+#include <bloom++/_bits/traits.h>
+
 #ifdef BLOOM_SHARED_PTR_MT
 #include <bloom++/mutex.h>
 #endif
@@ -86,6 +88,16 @@ public:
         pointer_(p.pointer_)
     {}
     
+#ifdef BLOOM_CXX11
+    shared_ptr(shared_ptr &&p) :
+        counter_(p.counter_),
+        pointer_(p.pointer_)
+    {
+        p.counter_ = 0;
+        p.pointer_ = 0;
+    }
+#endif
+    
     template<class Tp1>
     explicit shared_ptr(const shared_ptr<Tp1> &p, T *ptr) :
         counter_(p.get_inc_counter()),
@@ -101,6 +113,13 @@ public:
         shared_ptr(p).swap(*this);
         return *this;
     }
+    
+#ifdef BLOOM_CXX11
+    shared_ptr& operator=(shared_ptr &&p) {
+        shared_ptr(std::move(p)).swap(*this);
+        return *this;
+    }
+#endif
 
     T & operator*() const {
         return *pointer_;
@@ -172,6 +191,16 @@ public:
         pointer_(p.pointer_)
     {}
     
+#ifdef BLOOM_CXX11
+    shared_ptr(shared_ptr &&p) :
+        counter_(p.counter_),
+        pointer_(p.pointer_)
+    {
+        p.counter_ = 0;
+        p.pointer_ = 0;
+    }
+#endif
+    
     template<class Tp1>
     explicit shared_ptr(const shared_ptr<Tp1> &p, T *ptr) :
         counter_(p.get_inc_counter()),
@@ -187,6 +216,13 @@ public:
         shared_ptr(p).swap(*this);
         return *this;
     }
+    
+#ifdef BLOOM_CXX11
+    shared_ptr& operator=(shared_ptr &&p) {
+        shared_ptr(std::move(p)).swap(*this);
+        return *this;
+    }
+#endif
 
     T & operator*() const {
         return *pointer_;
@@ -219,14 +255,6 @@ public:
     }
 };
 
-/*  //this is C++11 code
-template<class T, class... Args>
-inline shared_ptr<T> make_shared(Args&&... args)
-{
-  return shared_ptr<T>(new T(std::forward<Args>(args)...));
-}
- */
-
 /*
  * Comparations
  */
@@ -247,6 +275,16 @@ bool operator!=(const shared_ptr<Tp> &p, const shared_ptr<Tp1> &p1)
  *  make_shared
  */
 
+#ifdef BLOOM_CXX11
+
+template<class T, class... Args>
+inline shared_ptr<T> make_shared(Args&&... args)
+{
+    return shared_ptr<T>(new T(std::forward<Args>(args)...));
+}
+
+#else
+
 template<class T>
 inline shared_ptr<T> make_shared()
 {
@@ -289,7 +327,7 @@ inline shared_ptr<T> make_shared(const P1 &p1, const P2 &p2, const P3 &p3, const
     return shared_ptr<T>(new T(p1, p2, p3, p4, p5, p6));
 }
 
-
+#endif
 
 /*
  * Casts
@@ -319,5 +357,10 @@ inline shared_ptr<Tp> reinterpret_pointer_cast(const shared_ptr<Tp1> &p)
     return shared_ptr<Tp>(p, reinterpret_cast<Tp*>(p.get()));
 }
 
-} //namespace bloom
+template<class T>
+struct is_relocatable<shared_ptr<T> >
+{
+    static const bool value = true;
+};
 
+} //namespace bloom
@@ -22,6 +22,7 @@
 #pragma once
 
 #include <bloom++/shared_ptr.h>
+#include <bloom++/delegate.h>
 
 namespace bloom
 {
@@ -251,20 +252,34 @@ class signal0
 {
 public:
     typedef slot_base0<T_Ret>  slot_type;
+    typedef delegate0<T_Ret> delegate_type;
     void connect(shared_ptr<slot_type> slot){
         slot_ = slot;
+        delegate_ = delegate_type(slot_.get(), &slot_type::emit);
     }
     template<class T_Obj>
     void connect(T_Obj *obj, T_Ret (T_Obj::*fn)())
     {
-        slot_ = new mem_slot0<T_Ret, T_Obj>(obj, fn);
+        slot_ = shared_ptr<slot_type>();
+        delegate_ = delegate_type(obj, fn);
+    }
+    void connect(T_Ret (*fn)())
+    {
+        slot_ = shared_ptr<slot_type>();
+        delegate_ = delegate_type(fn);
+    }
+    void connect(const delegate_type &d)
+    {
+        slot_ = shared_ptr<slot_type>();
+        delegate_ = d;
     }
     T_Ret emit(){
-        return slot_->emit();
+        return delegate_();
     }
 protected:
     /// @cond
     shared_ptr<slot_type> slot_;
+    delegate_type delegate_;
     /// @endcond
 };
 
@@ -276,20 +291,34 @@ class signal1
 {
 public:
     typedef slot_base1<T_Ret, T_Par1> slot_type;
+    typedef delegate1<T_Ret, T_Par1> delegate_type;
     void connect(shared_ptr<slot_type> slot){
         slot_ = slot;
+        delegate_ = delegate_type(slot_.get(), &slot_type::emit);
     }
     template<class T_Obj>
     void connect(T_Obj *obj, T_Ret (T_Obj::*fn)(T_Par1))
     {
-        slot_ = shared_ptr<slot_type> (new mem_slot1<T_Ret, T_Obj, T_Par1>(obj, fn));
+        slot_ = shared_ptr<slot_type>();
+        delegate_ = delegate_type(obj, fn);
+    }
+    void connect(T_Ret (*fn)(T_Par1))
+    {
+        slot_ = shared_ptr<slot_type>();
+        delegate_ = delegate_type(fn);
+    }
+    void connect(const delegate_type &d)
+    {
+        slot_ = shared_ptr<slot_type>();
+        delegate_ = d;
     }
     T_Ret emit(T_Par1 par1){
-        return slot_->emit(par1);
+        return delegate_(par1);
     }
 protected:
     /// @cond
     shared_ptr<slot_type> slot_;
+    delegate_type delegate_;
     /// @endcond
 };
 
@@ -301,20 +330,34 @@ class signal2
 {
 public:
     typedef slot_base2<T_Ret, T_Par1, T_Par2> slot_type;
+    typedef delegate2<T_Ret, T_Par1, T_Par2> delegate_type;
     void connect(shared_ptr<slot_type> slot){
         slot_ = slot;
+        delegate_ = delegate_type(slot_.get(), &slot_type::emit);
     }
     template<class T_Obj>
     void connect(T_Obj *obj, T_Ret (T_Obj::*fn)(T_Par1, T_Par2))
     {
-        slot_ = shared_ptr<slot_type> (new mem_slot2<T_Ret, T_Obj, T_Par1, T_Par2>(obj, fn));
+        slot_ = shared_ptr<slot_type>();
+        delegate_ = delegate_type(obj, fn);
+    }
+    void connect(T_Ret (*fn)(T_Par1, T_Par2))
+    {
+        slot_ = shared_ptr<slot_type>();
+        delegate_ = delegate_type(fn);
+    }
+    void connect(const delegate_type &d)
+    {
+        slot_ = shared_ptr<slot_type>();
+        delegate_ = d;
     }
     T_Ret emit(T_Par1 par1, T_Par2 par2){
-        return slot_->emit(par1, par2);
+        return delegate_(par1, par2);
     }
 protected:
     /// @cond
     shared_ptr<slot_type> slot_;
+    delegate_type delegate_;
     /// @endcond
 };
 
@@ -326,20 +369,34 @@ class signal3
 {
 public:
     typedef slot_base3<T_Ret, T_Par1, T_Par2, T_Par3> slot_type;
+    typedef delegate3<T_Ret, T_Par1, T_Par2, T_Par3> delegate_type;
     void connect(shared_ptr<slot_type> slot){
         slot_ = slot;
+        delegate_ = delegate_type(slot_.get(), &slot_type::emit);
     }
     template<class T_Obj>
     void connect(T_Obj *obj, T_Ret (T_Obj::*fn)(T_Par1, T_Par2, T_Par3))
     {
-        slot_ = shared_ptr<slot_type> (new mem_slot3<T_Ret, T_Obj, T_Par1, T_Par2, T_Par3>(obj, fn));
+        slot_ = shared_ptr<slot_type>();
+        delegate_ = delegate_type(obj, fn);
+    }
+    void connect(T_Ret (*fn)(T_Par1, T_Par2, T_Par3))
+    {
+        slot_ = shared_ptr<slot_type>();
+        delegate_ = delegate_type(fn);
+    }
+    void connect(const delegate_type &d)
+    {
+        slot_ = shared_ptr<slot_type>();
+        delegate_ = d;
     }
     T_Ret emit(T_Par1 par1, T_Par2 par2, T_Par3 par3){
-        return slot_->emit(par1, par2, par3);
+        return delegate_(par1, par2, par3);
     }
 protected:
     /// @cond
     shared_ptr<slot_type> slot_;
+    delegate_type delegate_;
     /// @endcond
 };
 
@@ -351,20 +408,34 @@ class signal4
 {
 public:
     typedef slot_base4<T_Ret, T_Par1, T_Par2, T_Par3, T_Par4> slot_type;
+    typedef delegate4<T_Ret, T_Par1, T_Par2, T_Par3, T_Par4> delegate_type;
     void connect(shared_ptr<slot_type> slot){
         slot_ = slot;
+        delegate_ = delegate_type(slot_.get(), &slot_type::emit);
     }
     template<class T_Obj>
     void connect(T_Obj *obj, T_Ret (T_Obj::*fn)(T_Par1, T_Par2, T_Par3, T_Par4))
     {
-        slot_ = shared_ptr<slot_type> (new mem_slot4<T_Ret, T_Obj, T_Par1, T_Par2, T_Par3, T_Par4>(obj, fn));
+        slot_ = shared_ptr<slot_type>();
+        delegate_ = delegate_type(obj, fn);
+    }
+    void connect(T_Ret (*fn)(T_Par1, T_Par2, T_Par3, T_Par4))
+    {
+        slot_ = shared_ptr<slot_type>();
+        delegate_ = delegate_type(fn);
+    }
+    void connect(const delegate_type &d)
+    {
+        slot_ = shared_ptr<slot_type>();
+        delegate_ = d;
     }
     T_Ret emit(T_Par1 par1, T_Par2 par2, T_Par3 par3, T_Par4 par4){
-        return slot_->emit(par1, par2, par3, par4);
+        return delegate_(par1, par2, par3, par4);
     }
 protected:
     /// @cond
     shared_ptr<slot_type> slot_;
+    delegate_type delegate_;
     /// @endcond
 };
 
@@ -376,20 +447,34 @@ class signal5
 {
 public:
     typedef slot_base5<T_Ret, T_Par1, T_Par2, T_Par3, T_Par4, T_Par5>  slot_type;
+    typedef delegate5<T_Ret, T_Par1, T_Par2, T_Par3, T_Par4, T_Par5> delegate_type;
     void connect(shared_ptr<slot_type> slot){
         slot_ = slot;
+        delegate_ = delegate_type(slot_.get(), &slot_type::emit);
     }
     template<class T_Obj>
     void connect(T_Obj *obj, T_Ret (T_Obj::*fn)(T_Par1, T_Par2, T_Par3, T_Par4, T_Par5))
     {
-        slot_ = shared_ptr<slot_type> (new mem_slot5<T_Ret, T_Obj, T_Par1, T_Par2, T_Par3, T_Par4, T_Par5>(obj, fn));
+        slot_ = shared_ptr<slot_type>();
+        delegate_ = delegate_type(obj, fn);
+    }
+    void connect(T_Ret (*fn)(T_Par1, T_Par2, T_Par3, T_Par4, T_Par5))
+    {
+        slot_ = shared_ptr<slot_type>();
+        delegate_ = delegate_type(fn);
+    }
+    void connect(const delegate_type &d)
+    {
+        slot_ = shared_ptr<slot_type>();
+        delegate_ = d;
     }
     T_Ret emit(T_Par1 par1, T_Par2 par2, T_Par3 par3, T_Par4 par4, T_Par5 par5){
-        return slot_->emit(par1, par2, par3, par4, par5);
+        return delegate_(par1, par2, par3, par4, par5);
     }
 protected:
     /// @cond
     shared_ptr<slot_type> slot_;
+    delegate_type delegate_;
     /// @endcond
 };
 
@@ -401,20 +486,34 @@ class signal6
 {
 public:
     typedef slot_base6<T_Ret, T_Par1, T_Par2, T_Par3, T_Par4, T_Par5, T_Par6> slot_type;
+    typedef delegate6<T_Ret, T_Par1, T_Par2, T_Par3, T_Par4, T_Par5, T_Par6> delegate_type;
     void connect(shared_ptr<slot_type> slot){
         slot_ = slot;
+        delegate_ = delegate_type(slot_.get(), &slot_type::emit);
     }
     template<class T_Obj>
     void connect(T_Obj *obj, T_Ret (T_Obj::*fn)(T_Par1, T_Par2, T_Par3, T_Par4, T_Par5, T_Par6))
     {
-        slot_ = shared_ptr<slot_type> (new mem_slot6<T_Ret, T_Obj, T_Par1, T_Par2, T_Par3, T_Par4, T_Par5, T_Par6>(obj, fn));
+        slot_ = shared_ptr<slot_type>();
+        delegate_ = delegate_type(obj, fn);
+    }
+    void connect(T_Ret (*fn)(T_Par1, T_Par2, T_Par3, T_Par4, T_Par5, T_Par6))
+    {
+        slot_ = shared_ptr<slot_type>();
+        delegate_ = delegate_type(fn);
+    }
+    void connect(const delegate_type &d)
+    {
+        slot_ = shared_ptr<slot_type>();
+        delegate_ = d;
     }
     T_Ret emit(T_Par1 par1, T_Par2 par2, T_Par3 par3, T_Par4 par4, T_Par5 par5, T_Par6 par6){
-        return slot_->emit(par1, par2, par3, par4, par5, par6);
+        return delegate_(par1, par2, par3, par4, par5, par6);
     }
 protected:
     /// @cond
     shared_ptr<slot_type> slot_;
+    delegate_type delegate_;
     /// @endcond
 };
 
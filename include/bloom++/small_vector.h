@@ -0,0 +1,518 @@
+/* 
+ * Copyright © 2015 Sergei Khairulin <sergei.khairulin@gmail.com>. 
+ * All rights reserved.
+ *
+ * This file is part of Bloom++.
+ *
+ * Bloom++ is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Bloom++ is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Bloom++.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+#include <bloom++/_bits/c++config.h>
+#include <bloom++/_bits/traits.h>
+#include <bloom++/_bits/vector_t.h>
+
+#ifdef AUX_DEBUG
+#define __BLOOM_WITH_DEBUG
+#endif
+#include <bloom++/_bits/debug.h>
+
+namespace bloom
+{
+
+/**
+ * @brief Vector with inline capacity.
+ * 
+ * Stores up to N elements inside the object and allocates heap memory
+ * only for more elements. Unlike vector it isn't shared (copy-on-write),
+ * copying copies elements. Throws the same exceptions as vector.
+ * @param vT Type of elements.
+ * @param N Inline capacity (> 0).
+ */
+template<class vT, size_t N, class Traits=traits<vT> >
+class small_vector
+{
+public:
+    typedef class small_vector<vT, N, Traits>   Self;
+    typedef vT *                                iterator;
+    typedef const vT *                          const_iterator;
+    
+private:
+    /// @cond
+    union storage {
+        char data_[N * sizeof(vT)];
+        long double align_ld_;
+        long long align_ll_;
+        void *align_p_;
+    };
+    
+    vT *data_;
+    size_t size_;
+    size_t capacity_;
+    storage inline_;
+    
+    inline vT *inline_data() const {
+        return reinterpret_cast<vT*>(const_cast<char*>(inline_.data_));
+    }
+    
+    /*
+     * Moving of elements to other (may be overlapping) memory.
+     */
+    inline static void relocate(vT *p1, vT *s2, size_t n) {
+        if(!n)return;
+        if(is_relocatable<vT>::value)
+            memmove(static_cast<void*>(p1), static_cast<void*>(s2), n * sizeof(vT));
+        else
+            Traits::move_construct(p1, s2, n);
+    }
+    
+    inline size_t grow_capacity(size_t size) const {
+        return (size < 2 * capacity_) ? 2 * capacity_ : size;
+    }
+    
+    /*
+     * New buffer for capacity, elements [0, index) and [index, size_) are
+     * moved to [0, index) and [index + gap, size_ + gap).
+     * The buffer is malloc()/realloc() memory like vector's rep but
+     * without its header: size and capacity are kept in the object and
+     * the buffer is never shared.
+     */
+    void reallocate(size_t capacity, size_t index = 0, size_t gap = 0){
+        vT *data;
+        if(is_relocatable<vT>::value && !gap && data_ != inline_data())
+            data = static_cast<vT*>(realloc(static_cast<void*>(data_), capacity * sizeof(vT)));
+        else {
+            data = static_cast<vT*>(malloc(capacity * sizeof(vT)));
+            relocate(data, data_, index);
+            relocate(data + index + gap, data_ + index, size_ - index);
+            if(data_ != inline_data())
+                free(static_cast<void*>(data_));
+        }
+        data_ = data;
+        capacity_ = capacity;
+    }
+    
+    /*
+     * Free space for size elements at index (elements aren't constructed).
+     */
+    void insert_prepare(size_t index, size_t size){
+        if(size_ + size > capacity_)
+            reallocate(grow_capacity(size_ + size), index, size);
+        else
+            relocate(data_ + index + size, data_ + index, size_ - index);
+        size_ += size;
+    }
+    
+    inline bool is_own(const vT *p) const {
+        return p >= data_ && p < data_ + size_;
+    }
+    /// @endcond
+    
+public:
+    small_vector():
+    data_(inline_data()), size_(0), capacity_(N){
+    }
+    
+    explicit small_vector(size_t size, const vT &v = vT()):
+    data_(inline_data()), size_(0), capacity_(N){
+        /// @cond
+        resize(size, v);
+        /// @endcond
+    }
+    
+    small_vector(const Self &vec):
+    data_(inline_data()), size_(0), capacity_(N){
+        /// @cond
+        append(vec.data_, vec.size_);
+        /// @endcond
+    }
+    
+#ifdef BLOOM_CXX11
+    small_vector(Self &&vec):
+    data_(inline_data()), size_(0), capacity_(N){
+        /// @cond
+        swap(vec);
+        /// @endcond
+    }
+#endif
+    
+    ~small_vector(){
+        /// @cond
+        Traits::destroy(data_, size_);
+        if(data_ != inline_data())
+            free(static_cast<void*>(data_));
+        /// @endcond
+    }
+    
+    Self &operator=(const Self &vec){
+        /// @cond
+        if(&vec == this)return *this;
+        clear();
+        append(vec.data_, vec.size_);
+        return *this;
+        /// @endcond
+    }
+    
+#ifdef BLOOM_CXX11
+    Self &operator=(Self &&vec){
+        /// @cond
+        if(&vec == this)return *this;
+        clear();
+        swap(vec);
+        return *this;
+        /// @endcond
+    }
+#endif
+    
+    /**
+     * @brief Data is stored inside the object (not in heap memory).
+     */
+    bool is_inline() const {
+        return data_ == inline_data();
+    }
+    
+    void reserve(size_t capacity){
+        /// @cond
+        if(capacity > capacity_)
+            reallocate(capacity, size_);
+        /// @endcond
+    }
+    
+    /**
+     * @brief Releasing of unused heap memory.
+     */
+    void shrink_to_fit(){
+        /// @cond
+        if(data_ == inline_data() || size_ == capacity_)return;
+        if(size_ <= N){
+            vT *data = data_;
+            data_ = inline_data();
+            relocate(data_, data, size_);
+            free(static_cast<void*>(data));
+            capacity_ = N;
+        }
+        else
+            reallocate(size_, size_);
+        /// @endcond
+    }
+    
+    void push_back(const vT &c){
+        /// @cond
+        if(size_ == capacity_){
+            if(is_own(&c)){
+                // c refers to element of this vector
+                const vT v(c);
+                push_back(v);
+                return;
+            }
+            reallocate(grow_capacity(size_ + 1), size_);
+        }
+        Traits::copy_construct(data_ + size_, &c, 1);
+        ++size_;
+        /// @endcond
+    }
+    
+#ifdef BLOOM_CXX11
+    void push_back(vT &&c){
+        /// @cond
+        emplace_back(std::move(c));
+        /// @endcond
+    }
+    
+    /**
+     * @brief Constructing element at the end from arguments.
+     */
+    template<class... Args>
+    void emplace_back(Args&&... args){
+        /// @cond
+        if(size_ == capacity_){
+            // arguments may refer to elements of this vector
+            vT v(std::forward<Args>(args)...);
+            reallocate(grow_capacity(size_ + 1), size_);
+            ::new ((void*)(data_ + size_)) vT(std::move(v));
+        }
+        else
+            ::new ((void*)(data_ + size_)) vT(std::forward<Args>(args)...);
+        ++size_;
+        /// @endcond
+    }
+#endif
+    
+    void pop_back(){
+        /// @cond
+        if(!size_)
+            throw bad_vector_pop_back("vector is empty"); // need throw
+        --size_;
+        Traits::destroy(data_ + size_, 1);
+        /// @endcond
+    }
+    
+    Self& append(const vT &c){
+        /// @cond
+        push_back(c);
+        return *this;
+        /// @endcond
+    }
+    
+    Self& append(const vT *vec, size_t size){
+        /// @cond
+        insert(size_, vec, size);
+        return *this;
+        /// @endcond
+    }
+    
+    Self& append(const Self &vec){
+        /// @cond
+        insert(size_, vec.data_, vec.size_);
+        return *this;
+        /// @endcond
+    }
+    
+    void insert(size_t index, const vT &c){
+        /// @cond
+        insert(index, &c, 1);
+        /// @endcond
+    }
+    
+    void insert(size_t index, const vT *values, size_t size){
+        /// @cond
+        if(!size)return;
+        if(index > size_)
+            throw bad_vector_insert("index > size"); //throw
+        if(is_own(values)){
+            const Self v(values, values + size);
+            insert(index, v.data_, size);
+            return;
+        }
+        insert_prepare(index, size);
+        Traits::copy_construct(data_ + index, values, size);
+        /// @endcond
+    }
+    
+    void insert(size_t index, const Self &vec){
+        /// @cond
+        insert(index, vec.data_, vec.size_);
+        /// @endcond
+    }
+    
+    iterator insert(iterator it, const vT &c){
+        /// @cond
+        const size_t index = it - data_;
+        insert(index, &c, 1);
+        return data_ + index + 1;
+        /// @endcond
+    }
+    
+    iterator insert(iterator it, const vT *values, size_t size){
+        /// @cond
+        const size_t index = it - data_;
+        insert(index, values, size);
+        return data_ + index + size;
+        /// @endcond
+    }
+    
+    iterator insert(iterator it, const Self &vec){
+        /// @cond
+        return insert(it, vec.data_, vec.size_);
+        /// @endcond
+    }
+    
+    void replace(size_t index, const vT *values, size_t size){
+        /// @cond
+        if(index + size > size_)
+            throw bad_vector_replace("index + size > size"); // throw
+        Traits::copy(data_ + index, values, size);
+        /// @endcond
+    }
+    
+    void replace(size_t index, const Self &vec){
+        /// @cond
+        if(&vec == this){
+            if(index)
+                throw bad_vector_replace("trying to replace self by self with offset"); // throw
+            return;
+        }
+        replace(index, vec.data_, vec.size_);
+        /// @endcond
+    }
+    
+    void assign(size_t index, size_t size, const vT &c){
+        /// @cond
+        if(index + size > size_)
+            throw bad_vector_assign("index + size > size"); // throw
+        Traits::assign(data_ + index, size, c);
+        /// @endcond
+    }
+    
+    void erase(size_t index, size_t size = 1){
+        /// @cond
+        if(!size)return;
+        if(index + size > size_)
+            throw bad_vector_erase("index + size > size"); // throw
+        Traits::destroy(data_ + index, size);
+        relocate(data_ + index, data_ + index + size, size_ - index - size);
+        size_ -= size;
+        /// @endcond
+    }
+    
+    iterator erase(iterator it){
+        /// @cond
+        erase(it - data_, 1);
+        return it;
+        /// @endcond
+    }
+    
+    void resize(size_t size, vT c = vT()){
+        /// @cond
+        if(size > size_){
+            reserve(size > 2 * capacity_ ? size : grow_capacity(size));
+            Traits::construct(data_ + size_, size - size_, c);
+        }
+        else
+            Traits::destroy(data_ + size, size_ - size);
+        size_ = size;
+        /// @endcond
+    }
+    
+    void clear(){
+        /// @cond
+        Traits::destroy(data_, size_);
+        size_ = 0;
+        /// @endcond
+    }
+    
+    void swap(Self &vec){
+        /// @cond
+        if(&vec == this)return;
+        if(data_ != inline_data() && vec.data_ != vec.inline_data()){
+            std::swap(data_, vec.data_);
+            std::swap(size_, vec.size_);
+            std::swap(capacity_, vec.capacity_);
+            return;
+        }
+        Self tmp;
+        tmp.take(*this);
+        take(vec);
+        vec.take(tmp);
+        /// @endcond
+    }
+    
+    vT &operator[](size_t index){
+        /// @cond
+        if(index >= size_)
+            resize(index + 1);
+        return data_[index];
+        /// @endcond
+    }
+    
+    const vT &operator[](size_t index) const {
+        /// @cond
+        if(index < size_)
+            return data_[index];
+        throw bad_vector_index("operator[] const: index > size"); // need throw
+        /// @endcond
+    }
+    
+    Self &operator+=(const vT &elem){
+        /// @cond
+        push_back(elem);
+        return *this;
+        /// @endcond
+    }
+    
+    Self &operator+=(const Self &vec){
+        /// @cond
+        return append(vec);
+        /// @endcond
+    }
+    
+    size_t size() const {
+        return size_;
+    }
+    
+    size_t capacity() const {
+        return capacity_;
+    }
+    
+    bool empty() const {
+        return !size_;
+    }
+    
+    vT *data(){
+        return data_;
+    }
+    
+    const vT *data() const {
+        return data_;
+    }
+    
+    iterator begin(){
+        return data_;
+    }
+    
+    const_iterator begin() const {
+        return data_;
+    }
+    
+    iterator end(){
+        return data_ + size_;
+    }
+    
+    const_iterator end() const {
+        return data_ + size_;
+    }
+    
+private:
+    /// @cond
+    small_vector(const vT *first, const vT *last):
+    data_(inline_data()), size_(0), capacity_(N){
+        insert(size_t(0), first, last - first);
+    }
+    
+    /*
+     * Taking elements of empty vec (this must be empty).
+     */
+    void take(Self &vec){
+        if(vec.data_ != vec.inline_data()){
+            if(data_ != inline_data())
+                free(static_cast<void*>(data_));
+            data_ = vec.data_;
+            capacity_ = vec.capacity_;
+            vec.data_ = vec.inline_data();
+            vec.capacity_ = N;
+        }
+        else {
+            if(vec.size_ > capacity_)
+                reallocate(vec.size_, 0);
+            relocate(data_, vec.data_, vec.size_);
+        }
+        size_ = vec.size_;
+        vec.size_ = 0;
+    }
+    /// @endcond
+};
+
+template<class vT, size_t N, class Traits>
+struct is_relocatable<small_vector<vT, N, Traits> >
+{
+    static const bool value = false; // inline data is referenced by pointer
+};
+
+} //namespace bloom
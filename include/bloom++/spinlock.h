@@ -0,0 +1,261 @@
+/* 
+ * Copyright © 2015 Sergei Khairulin <sergei.khairulin@gmail.com>. 
+ * All rights reserved.
+ *
+ * This file is part of Bloom++.
+ *
+ * Bloom++ is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Bloom++ is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Bloom++.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#pragma once
+
+#include <errno.h>
+#include <sched.h>
+
+namespace bloom
+{
+
+/**
+ * @brief Hint to CPU in spin-wait loops.
+ */
+inline void cpu_relax()
+{
+#if defined(__i386__) || defined(__x86_64__)
+    __builtin_ia32_pause();
+#elif defined(__aarch64__) || defined(__arm__)
+    __asm__ __volatile__("yield" ::: "memory");
+#else
+    __asm__ __volatile__("" ::: "memory");
+#endif
+}
+
+/**
+ * @brief Locking of L until the object of this class exists.
+ */
+template<class L>
+class basic_scoped_lock
+{
+public:
+    basic_scoped_lock(L &m):m_(m)
+    {
+        m_.lock();
+    }
+    
+    ~basic_scoped_lock()
+    {
+        m_.unlock();
+    }
+    
+private:
+    L &m_;
+    
+    basic_scoped_lock(const basic_scoped_lock &);
+    basic_scoped_lock &operator=(const basic_scoped_lock &);
+};
+
+/**
+ * @brief Locking of L until the object of this class exists.
+ * 
+ * Using unlock() and lock() methods for temporary unlocking.
+ */
+template<class L>
+class basic_unique_lock
+{
+public:
+    basic_unique_lock(L &m, bool b_lock = true):m_(m), bLocked_(b_lock)
+    {
+        if(b_lock)
+            m_.lock();
+    }
+    
+    ~basic_unique_lock()
+    {
+        if(bLocked_)
+            m_.unlock();
+    }
+    
+    void lock()
+    {
+        if(!bLocked_){
+            m_.lock();
+            bLocked_ = true;
+        }
+    }
+    
+    int trylock()
+    {
+        if(bLocked_)
+            return EBUSY;
+        int r = m_.trylock();
+        if(!r)
+            bLocked_ = true;
+        return r;
+    }
+    
+    void unlock()
+    {
+        if(bLocked_){
+            m_.unlock();
+            bLocked_ = false;
+        }
+    }
+    
+private:
+    L &m_;
+    bool bLocked_;
+    
+    basic_unique_lock(const basic_unique_lock &);
+    basic_unique_lock &operator=(const basic_unique_lock &);
+};
+
+/**
+ * @brief Test-and-test-and-set spin lock.
+ * 
+ * For very short critical sections: waiting threads spin on the cached
+ * value with pause and exponential backoff and don't park in the kernel
+ * (they yield the CPU only after long waiting).
+ * Not recursive. Interface of mutex (lock, trylock, unlock).
+ */
+class spinlock
+{
+public:
+    typedef basic_scoped_lock<spinlock> scoped_lock;
+    typedef basic_unique_lock<spinlock> unique_lock;
+    
+    spinlock():locked_(0)
+    {
+    }
+    
+    int lock()
+    {
+        /// @cond
+        if(!__sync_lock_test_and_set(&locked_, 1))
+            return 0;
+        unsigned int backoff = 1;
+        for(;;){
+            while(__atomic_load_n(&locked_, __ATOMIC_RELAXED)){
+                if(backoff < max_backoff){
+                    for(unsigned int i = 0; i < backoff; ++i)
+                        cpu_relax();
+                    backoff <<= 1;
+                }
+                else
+                    sched_yield(); // the owner may be preempted
+            }
+            if(!__sync_lock_test_and_set(&locked_, 1))
+                return 0;
+        }
+        /// @endcond
+    }
+    
+    int trylock()
+    {
+        /// @cond
+        if(!__atomic_load_n(&locked_, __ATOMIC_RELAXED) &&
+           !__sync_lock_test_and_set(&locked_, 1))
+            return 0;
+        return EBUSY;
+        /// @endcond
+    }
+    
+    int unlock()
+    {
+        /// @cond
+        __sync_lock_release(&locked_);
+        return 0;
+        /// @endcond
+    }
+    
+private:
+    /// @cond
+    enum { max_backoff = 1024 };
+    volatile int locked_;
+    
+    spinlock(const spinlock &);
+    spinlock &operator=(const spinlock &);
+    /// @endcond
+};
+
+/**
+ * @brief Fair (FIFO) spin lock.
+ * 
+ * Threads take tickets and spin until their ticket is served, so
+ * no thread starves under contention. Waiting backoff is proportional
+ * to the number of threads ahead.
+ * Not recursive. Interface of mutex (lock, trylock, unlock).
+ */
+class ticket_lock
+{
+public:
+    typedef basic_scoped_lock<ticket_lock> scoped_lock;
+    typedef basic_unique_lock<ticket_lock> unique_lock;
+    
+    ticket_lock():next_(0), owner_(0)
+    {
+    }
+    
+    int lock()
+    {
+        /// @cond
+        const unsigned int ticket = __sync_fetch_and_add(&next_, 1);
+        unsigned int spins = 0;
+        for(;;){
+            const unsigned int owner = __atomic_load_n(&owner_, __ATOMIC_ACQUIRE);
+            if(owner == ticket)
+                return 0;
+            if(spins < max_spins){
+                unsigned int ahead = ticket - owner;
+                if(ahead > max_ahead)
+                    ahead = max_ahead;
+                for(unsigned int i = 0; i < ahead * 16; ++i)
+                    cpu_relax();
+                ++spins;
+            }
+            else
+                sched_yield(); // the owner may be preempted
+        }
+        /// @endcond
+    }
+    
+    int trylock()
+    {
+        /// @cond
+        const unsigned int owner = __atomic_load_n(&owner_, __ATOMIC_ACQUIRE);
+        if(__sync_bool_compare_and_swap(&next_, owner, owner + 1))
+            return 0;
+        return EBUSY;
+        /// @endcond
+    }
+    
+    int unlock()
+    {
+        /// @cond
+        __atomic_store_n(&owner_, owner_ + 1, __ATOMIC_RELEASE);
+        return 0;
+        /// @endcond
+    }
+    
+private:
+    /// @cond
+    enum { max_spins = 64, max_ahead = 8 };
+    volatile unsigned int next_;
+    volatile unsigned int owner_;
+    
+    ticket_lock(const ticket_lock &);
+    ticket_lock &operator=(const ticket_lock &);
+    /// @endcond
+};
+
+} //namespace bloom
@@ -0,0 +1,204 @@
+/* 
+ * Copyright © 2015 Sergei Khairulin <sergei.khairulin@gmail.com>. 
+ * All rights reserved.
+ *
+ * This file is part of Bloom++.
+ *
+ * Bloom++ is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Bloom++ is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Bloom++.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include <new>
+#include <bloom++/_bits/c++config.h>
+
+namespace bloom
+{
+
+/**
+ * @brief Bounded wait-free single-producer single-consumer queue.
+ * 
+ * Only one thread may push and only one thread may pop. The producer
+ * and consumer indices are on separate cache lines, and each side keeps
+ * a cached copy of the other's index, so it reads the shared line only
+ * when the cached one says full (or empty). Capacity is rounded up
+ * to a power of two.
+ */
+template<class vT>
+class spsc_queue
+{
+public:
+    typedef vT value_type;
+    
+    /**
+     * @param capacity Minimal capacity.
+     */
+    spsc_queue(size_t capacity):
+    head_(0), tail_cache_(0), tail_(0), head_cache_(0)
+    {
+        /// @cond
+        size_t cap = 2;
+        while(cap < capacity)
+            cap <<= 1;
+        mask_ = cap - 1;
+        data_ = static_cast<vT*>(::operator new(cap * sizeof(vT)));
+        /// @endcond
+    }
+    
+    ~spsc_queue()
+    {
+        /// @cond
+        for(size_t pos = head_; pos != tail_; ++pos)
+            data_[pos & mask_].~vT();
+        ::operator delete(data_);
+        /// @endcond
+    }
+    
+    /**
+     * @brief Push value if the queue isn't full (producer thread).
+     * @return false if the queue is full.
+     */
+    bool try_push(const vT &v)
+    {
+        /// @cond
+        const size_t t = tail_;
+        if(t - head_cache_ > mask_){
+            head_cache_ = __atomic_load_n(&head_, __ATOMIC_ACQUIRE);
+            if(t - head_cache_ > mask_)
+                return false;
+        }
+        new(&data_[t & mask_]) vT(v);
+        __atomic_store_n(&tail_, t + 1, __ATOMIC_RELEASE);
+        return true;
+        /// @endcond
+    }
+    
+    /**
+     * @brief Pop value if the queue isn't empty (consumer thread).
+     * @return false if the queue is empty.
+     */
+    bool try_pop(vT &v)
+    {
+        /// @cond
+        const size_t h = head_;
+        if(h == tail_cache_){
+            tail_cache_ = __atomic_load_n(&tail_, __ATOMIC_ACQUIRE);
+            if(h == tail_cache_)
+                return false;
+        }
+        take(h, v);
+        __atomic_store_n(&head_, h + 1, __ATOMIC_RELEASE);
+        return true;
+        /// @endcond
+    }
+    
+    /**
+     * @brief Push up to n values (producer thread).
+     * @return Number of pushed values (from the beginning of v).
+     */
+    size_t push_n(const vT *v, size_t n)
+    {
+        /// @cond
+        const size_t t = tail_;
+        size_t room = mask_ + 1 - (t - head_cache_);
+        if(room < n){
+            head_cache_ = __atomic_load_n(&head_, __ATOMIC_ACQUIRE);
+            room = mask_ + 1 - (t - head_cache_);
+        }
+        if(n > room)
+            n = room;
+        for(size_t i = 0; i < n; ++i)
+            new(&data_[(t + i) & mask_]) vT(v[i]);
+        if(n)
+            __atomic_store_n(&tail_, t + n, __ATOMIC_RELEASE);
+        return n;
+        /// @endcond
+    }
+    
+    /**
+     * @brief Pop up to n values (consumer thread).
+     * @return Number of popped values.
+     */
+    size_t pop_n(vT *v, size_t n)
+    {
+        /// @cond
+        const size_t h = head_;
+        size_t avail = tail_cache_ - h;
+        if(avail < n){
+            tail_cache_ = __atomic_load_n(&tail_, __ATOMIC_ACQUIRE);
+            avail = tail_cache_ - h;
+        }
+        if(n > avail)
+            n = avail;
+        for(size_t i = 0; i < n; ++i)
+            take(h + i, v[i]);
+        if(n)
+            __atomic_store_n(&head_, h + n, __ATOMIC_RELEASE);
+        return n;
+        /// @endcond
+    }
+    
+    /**
+     * @brief Approximate number of values.
+     */
+    size_t size() const
+    {
+        return __atomic_load_n(&tail_, __ATOMIC_ACQUIRE) -
+               __atomic_load_n(&head_, __ATOMIC_ACQUIRE);
+    }
+    
+    bool empty() const
+    {
+        return !size();
+    }
+    
+    size_t capacity() const
+    {
+        return mask_ + 1;
+    }
+    
+private:
+    /// @cond
+    char pad0_[BLOOM_CACHE_LINE];
+    vT *data_;
+    size_t mask_;
+    char pad1_[BLOOM_CACHE_LINE - sizeof(vT*) - sizeof(size_t)];
+    // consumer line
+    size_t head_;
+    size_t tail_cache_;
+    char pad2_[BLOOM_CACHE_LINE - 2 * sizeof(size_t)];
+    // producer line
+    size_t tail_;
+    size_t head_cache_;
+    char pad3_[BLOOM_CACHE_LINE - 2 * sizeof(size_t)];
+    
+    spsc_queue(const spsc_queue &);
+    spsc_queue &operator=(const spsc_queue &);
+    
+    void take(size_t pos, vT &v)
+    {
+        vT *p = &data_[pos & mask_];
+#ifdef BLOOM_CXX11
+        v = std::move(*p);
+#else
+        v = *p;
+#endif
+        p->~vT();
+    }
+    /// @endcond
+};
+
+} //namespace bloom
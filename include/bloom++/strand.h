@@ -0,0 +1,191 @@
+/* 
+ * Copyright © 2015 Sergei Khairulin <sergei.khairulin@gmail.com>. 
+ * All rights reserved.
+ *
+ * This file is part of Bloom++.
+ *
+ * Bloom++ is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Bloom++ is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Bloom++.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include <bloom++/future.h>
+#include <bloom++/spinlock.h>
+#include <bloom++/_bits/hash_functions.h>
+
+namespace bloom
+{
+
+/**
+ * @brief Serial executor on top of another executor.
+ * 
+ * Tasks are run by the underlying executor (thread_pool) in FIFO order
+ * and never two at once, so state used only by tasks of one strand needs
+ * no locking. The strand has no thread: it posts one runner task to the
+ * executor while it has pending tasks, the runner gives the worker back
+ * after a batch of tasks.
+ * 
+ * The destructor waits for all submitted tasks, it must not be called
+ * from a task of the strand.
+ */
+class strand: public executor
+{
+public:
+    /**
+     * @param ex Executor running the tasks, must outlive the strand.
+     */
+    explicit strand(executor &ex);
+    virtual ~strand();
+    
+    /**
+     * @brief Running of task (deleted after running) after the tasks
+     * submitted before.
+     */
+    virtual void execute(pool_task *task);
+    
+    /**
+     * @brief Is the calling thread running a task of this strand.
+     */
+    bool running_in_this_thread() const;
+    
+    /**
+     * @brief Number of pending tasks.
+     */
+    size_t size() const;
+    
+    /**
+     * @brief Submitting of functor, continuations of the result run
+     * on the strand too.
+     * @param R Type of result of f().
+     */
+    template<class R, class F>
+    future<R> submit(F f){
+        /// @cond
+        future_state<R> *s = new future_state<R>(this);
+        future<R> r(s);
+        execute(new future_task<R, F>(s, f));
+        return r;
+        /// @endcond
+    }
+    
+    template<class R>
+    future<R> submit(R (*fn)()){
+        /// @cond
+        return submit<R, R (*)()>(fn);
+        /// @endcond
+    }
+    
+    template<class R, class T>
+    future<R> submit(R (T::*fn)(), T *obj){
+        /// @cond
+        future_mem_fn0<R, T> b = {fn, obj};
+        return submit<R>(b);
+        /// @endcond
+    }
+    
+private:
+    /// @cond
+    class runner;
+    
+    executor *ex_;
+    mutable spinlock lock_;
+    pool_task **ring_;
+    size_t capacity_;
+    size_t head_;
+    size_t size_;
+    volatile bool bScheduled_;
+    
+    strand(const strand &);
+    strand &operator=(const strand &);
+    
+    void drain();
+    pool_task *pop();
+    /// @endcond
+};
+
+/**
+ * @brief Fixed set of strands selected by hash of key.
+ * 
+ * Tasks of equal keys are run in order and never concurrently, tasks of
+ * different keys may share a strand.
+ */
+template<class kT, class hashT = hash<kT> >
+class keyed_strand
+{
+public:
+    /**
+     * @param ex Executor running the tasks, must outlive the object.
+     * @param n Number of strands (at least 1).
+     */
+    keyed_strand(executor &ex, size_t n):
+    strands_(0), size_(n ? n : 1){
+        /// @cond
+        strands_ = new strand*[size_];
+        for(size_t i = 0; i < size_; ++i)
+            strands_[i] = new strand(ex);
+        /// @endcond
+    }
+    
+    ~keyed_strand(){
+        /// @cond
+        for(size_t i = 0; i < size_; ++i)
+            delete strands_[i];
+        delete [] strands_;
+        /// @endcond
+    }
+    
+    /**
+     * @brief Number of strands.
+     */
+    size_t size() const {
+        return size_;
+    }
+    
+    /**
+     * @brief Strand of key.
+     */
+    strand &get(const kT &key){
+        /// @cond
+        hashT h;
+        return *strands_[h(key) % size_];
+        /// @endcond
+    }
+    
+    void execute(const kT &key, pool_task *task){
+        get(key).execute(task);
+    }
+    
+    template<class R, class F>
+    future<R> submit(const kT &key, F f){
+        return get(key).template submit<R, F>(f);
+    }
+    
+    template<class R, class T>
+    future<R> submit(const kT &key, R (T::*fn)(), T *obj){
+        return get(key).submit(fn, obj);
+    }
+    
+private:
+    /// @cond
+    strand **strands_;
+    size_t size_;
+    
+    keyed_strand(const keyed_strand &);
+    keyed_strand &operator=(const keyed_strand &);
+    /// @endcond
+};
+
+} //namespace bloom
@@ -57,6 +57,27 @@ public:
     virtual size_t read(char *data, size_t size) = 0;
     virtual i_base &operator>>(o_base &o) = 0;
     virtual bool iready() = 0;
+
+    /**
+     * @brief Getting contiguous readable data without copying.
+     * 
+     * Data isn't consumed. It stays valid until the next reading from
+     * the stream. Default implementation has no window.
+     * @param data pointer to readable data.
+     * @return size of readable data (0 if there is no data or the stream
+     * doesn't support windowed access).
+     */
+    virtual size_t peek(const char *&data){
+        data = 0;
+        return 0;
+    }
+
+    /**
+     * @brief Skipping data returned by peek().
+     * @param size size of data (not more than returned by peek()).
+     */
+    virtual void consume(size_t){
+    }
 };
 
 /**
@@ -285,6 +285,24 @@ public:
         return blocks_.back();
     }
 
+    /**
+     * @brief Getting contiguous readable data of the front block.
+     * 
+     * Data isn't consumed. It stays valid until the next reading
+     * from the buffer.
+     * @param data pointer to readable data.
+     * @return size of readable data (0 if buffer is empty).
+     */
+    virtual size_t peek(const char *&data);
+    /**
+     * @brief Skipping readable data of the front block.
+     * 
+     * Exhausted block isn't released here, so data returned by peek()
+     * stays valid until the next reading.
+     * @param size size of data (not more than returned by peek()).
+     */
+    virtual void consume(size_t size);
+
     ///Out stream to abstract
     //using i_base::operator >>;
     virtual i_base & operator>>(o_base &o);
@@ -65,7 +65,7 @@ public:
     }
     
     virtual bool oready(){
-        return o_;
+        return !o_.fail();
     }
 };
 
@@ -137,7 +137,7 @@ public:
     }
     
     virtual bool iready(){
-        return io_;
+        return !io_.fail();
     }
     
     using o_base::operator <<;
@@ -160,7 +160,7 @@ public:
     }
     
     virtual bool oready(){
-        return io_;
+        return !io_.fail();
     }
 };
 
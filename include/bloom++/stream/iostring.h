@@ -24,6 +24,7 @@
 #include <bloom++/string.h>
 #include <bloom++/stream/io.h>
 #include <bloom++/stream/iobuffer.h>
+#include <bloom++/_bits/number_parse.h>
 
 namespace bloom
 {
@@ -48,6 +49,7 @@ public:
     //Writing
     ostring &operator<<(const char *data);
     ostring &operator<<(const string &data); //the same as in o_base
+    ostring &operator<<(const string_ref &data);
     ostring &operator<<(const char &); //(as integer value)
     ostring &operator<<(const unsigned char &); //(as integer value)
     ostring &operator<<(const int &);
@@ -81,19 +83,34 @@ protected:
     unsigned char curr_ch;
     unsigned char prev_ch;
     size_t line_num_;
+    string token_; //< for elements which can't be referenced
+    number::parse_status status_; //< result of the last reading of number
 
     //fixme: user defined literals!!!
     bool check_literals(char ch);
+    
+    void skip(const char *data, size_t size);
+    size_t count_lines(const char *data, size_t size);
+    size_t skip_spaces(const char *data, size_t size);
+    void unget(char ch);
+    template<class T> istring &read_number(T &value, bool bNumberStr);
+    bool read_element_chars(string &elem, bool bNumberStr);
+    bool read_string_chars(char closeElem, string &str);
+    bool read_line_to_chars(char closeElem, string &str);
 
 public:
-    istring(io_base &io) : i_(io), iob_(16), curr_ch(0), prev_ch(0), line_num_(1){}
-    istring(i_base &o) : i_(o), curr_ch(0), prev_ch(0), line_num_(1){}
+    istring(io_base &io) : i_(io), iob_(16), curr_ch(0), prev_ch(0), line_num_(1),
+        status_(number::parse_ok){}
+    istring(i_base &o) : i_(o), curr_ch(0), prev_ch(0), line_num_(1),
+        status_(number::parse_ok){}
     virtual ~istring(){}
     
     //Reading
     virtual size_t read(char *data, size_t size);
     virtual istring &operator>>(o_base &o);
     virtual bool iready();
+    virtual size_t peek(const char *&data);
+    virtual void consume(size_t size);
     
     istring & operator>>(string &data);
     istring & operator>>(char &);
@@ -104,17 +121,59 @@ public:
     istring & operator>>(unsigned short &);
     istring & operator>>(long &);
     istring & operator>>(unsigned long &);
+    istring & operator>>(long long &);
+    istring & operator>>(unsigned long long &);
     istring & operator>>(double &);
     istring & operator>>(float &);
     istring & operator>>(bool &);
 
+    /**
+     * @brief Result of the last reading of number.
+     * 
+     * parse_invalid if element isn't a number (or isn't a number entirely),
+     * parse_overflow if number is out of range of the type,
+     * parse_underflow if non-zero number is read as zero.
+     */
+    number::parse_status status() const {
+        return status_;
+    }
+
     bool read_element(string &elem, bool bNumberStr = false);
     bool go_to(unsigned char ch);
     size_t line();
     void next_line();
     bool read_string(char closeElem, string &str);
     bool read_line_to(char closeElem, string &str);
-    bool find_string_value(const string &name);
+    bool find_string_value(const string_ref &name);
+    
+    /**
+     * @brief Reading element without copying.
+     * 
+     * The element references window of the input stream (see i_base::peek())
+     * if it's possible, else internal buffer. It's valid until the next reading.
+     * @param elem element.
+     * @param bNumberStr element is a number ('.' is a part of element).
+     * @return false if end of data was reached.
+     */
+    bool read_element(string_ref &elem, bool bNumberStr = false);
+    /**
+     * @brief Reading string up to closeElem without copying.
+     * 
+     * The same rules of reference validity as for read_element().
+     * @param closeElem closing symbol (not included).
+     * @param str string.
+     * @return true if closeElem was found.
+     */
+    bool read_string(char closeElem, string_ref &str);
+    /**
+     * @brief Reading string up to closeElem or end of line without copying.
+     * 
+     * The same rules of reference validity as for read_element().
+     * @param closeElem closing symbol (not included).
+     * @param str string.
+     * @return true if closeElem or end of line was found.
+     */
+    bool read_line_to(char closeElem, string_ref &str);
 
     unsigned char get();
     bool empty();
@@ -58,9 +58,9 @@ class json : public o_json
 protected:
     void out_str(const char *data, size_t size);
 
-    void out_str(const string &data)
+    void out_str(const string_ref &data)
     {
-        out_str(data.c_str(), data.length());
+        out_str(data.data(), data.size());
     }
 
 public:
@@ -75,7 +75,7 @@ public:
         out_ << "{";
     }
 
-    json(json &js, string name) : o_json(js)
+    json(json &js, const string_ref &name) : o_json(js)
     {
         js.out(name, "{");
     }
@@ -97,32 +97,33 @@ public:
     }
     
     template<class vT>
-    void out(const string &name, const vT &value){
+    void out(const string_ref &name, const vT &value){
         if (b_first_)b_first_ = false;
         else out_ << ",";
         out_ << "\"";
-        out_str(name.c_str(), name.length());
+        out_str(name);
         out_ << "\":";
         out_ << "\"" << value << "\"";
     }
     
     template<class vT>
-    void out(const string &name, vT *value){
+    void out(const string_ref &name, vT *value){
         if (b_first_)b_first_ = false;
         else out_ << ",";
         out_ << "\"";
-        out_str(name.c_str(), name.length());
+        out_str(name);
         out_ << "\":";
         out_ << "\"" << value << "\"";
     }
     
-    void out(const string &name, const string &value);
-    void out(const string &name, const char *value);
+    void out(const string_ref &name, const string &value);
+    void out(const string_ref &name, const string_ref &value);
+    void out(const string_ref &name, const char *value);
     void out(size_t id, const char *value);
-    void out(const string &name, const char *value, size_t val_sz);
+    void out(const string_ref &name, const char *value, size_t val_sz);
     void out(size_t id, const char *value, size_t val_sz);
-    void out(const string &name, i_base &buf);
-    void out_begin(const string &name);
+    void out(const string_ref &name, i_base &buf);
+    void out_begin(const string_ref &name);
     void out_end(){}
 
     //void                          out(const string &name, dynamic::CObjectContainer *obj);
@@ -152,7 +153,7 @@ public:
         out_ << "[";
     }
 
-    jarray(json &js, string name) : o_json(js)
+    jarray(json &js, const string_ref &name) : o_json(js)
     {
         js.out(name, "[");
     }
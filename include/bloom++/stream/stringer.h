@@ -24,6 +24,7 @@
 #include <bloom++/string.h>
 #include <bloom++/stream/io.h>
 #include <bloom++/stream/iostring.h>
+#include <bloom++/string_builder.h>
 
 #ifdef STREAM_DEBUG
 #define __BLOOM_WITH_DEBUG
@@ -56,6 +57,8 @@ public:
     virtual size_t read(char *data, size_t size);
     virtual i_base &operator>>(o_base &o);
     virtual bool iready();
+    virtual size_t peek(const char *&data);
+    virtual void consume(size_t size);
     
 private:
     explicit stringer(const stringer &o); //< Forbid default constructor
@@ -64,19 +67,39 @@ private:
 
 } //namespace stream
 
+/// @cond
+/*
+ * string_builder formatting like ostring: char is appended as integer
+ * value (string_builder appends it as a character).
+ */
+class ostring_builder: public string_builder
+{
+public:
+    template<class T>
+    ostring_builder &operator<<(const T &v){
+        static_cast<string_builder &>(*this)<<v;
+        return *this;
+    }
+    
+    ostring_builder &operator<<(char c){
+        static_cast<string_builder &>(*this)<<(int)c;
+        return *this;
+    }
+};
+/// @endcond
+
 /**
- * Fast string builder.
+ * Fast string builder (see string_builder), a char is written as
+ * integer value like ostring does.
  * @param p1 String element.
  * @return string
  */
 template<class P1>
 string fast_ostring(P1 p1)
 {
-    string out;
-    stream::stringer s(out);
-    stream::ostring os(s);
-    os<<p1;
-    return out;
+    ostring_builder b;
+    b<<p1;
+    return b.str();
 }
 
 /**
@@ -88,11 +111,9 @@ string fast_ostring(P1 p1)
 template<class P1, class P2>
 string fast_ostring(P1 p1, P2 p2)
 {
-    string out;
-    stream::stringer s(out);
-    stream::ostring os(s);
-    os<<p1<<p2;
-    return out;
+    ostring_builder b;
+    b<<p1<<p2;
+    return b.str();
 }
 
 /**
@@ -105,11 +126,9 @@ string fast_ostring(P1 p1, P2 p2)
 template<class P1, class P2, class P3>
 string fast_ostring(P1 p1, P2 p2, P3 p3)
 {
-    string out;
-    stream::stringer s(out);
-    stream::ostring os(s);
-    os<<p1<<p2<<p3;
-    return out;
+    ostring_builder b;
+    b<<p1<<p2<<p3;
+    return b.str();
 }
 
 /**
@@ -123,11 +142,9 @@ string fast_ostring(P1 p1, P2 p2, P3 p3)
 template<class P1, class P2, class P3, class P4>
 string fast_ostring(P1 p1, P2 p2, P3 p3, P4 p4)
 {
-    string out;
-    stream::stringer s(out);
-    stream::ostring os(s);
-    os<<p1<<p2<<p3<<p4;
-    return out;
+    ostring_builder b;
+    b<<p1<<p2<<p3<<p4;
+    return b.str();
 }
 
 /**
@@ -142,11 +159,9 @@ string fast_ostring(P1 p1, P2 p2, P3 p3, P4 p4)
 template<class P1, class P2, class P3, class P4, class P5>
 string fast_ostring(P1 p1, P2 p2, P3 p3, P4 p4, P5 p5)
 {
-    string out;
-    stream::stringer s(out);
-    stream::ostring os(s);
-    os<<p1<<p2<<p3<<p4<<p5;
-    return out;
+    ostring_builder b;
+    b<<p1<<p2<<p3<<p4<<p5;
+    return b.str();
 }
 
 /**
@@ -162,11 +177,9 @@ string fast_ostring(P1 p1, P2 p2, P3 p3, P4 p4, P5 p5)
 template<class P1, class P2, class P3, class P4, class P5, class P6>
 string fast_ostring(P1 p1, P2 p2, P3 p3, P4 p4, P5 p5, P6 p6)
 {
-    string out;
-    stream::stringer s(out);
-    stream::ostring os(s);
-    os<<p1<<p2<<p3<<p4<<p5<<p6;
-    return out;
+    ostring_builder b;
+    b<<p1<<p2<<p3<<p4<<p5<<p6;
+    return b.str();
 }
 
 /**
@@ -183,11 +196,9 @@ string fast_ostring(P1 p1, P2 p2, P3 p3, P4 p4, P5 p5, P6 p6)
 template<class P1, class P2, class P3, class P4, class P5, class P6, class P7>
 string fast_ostring(P1 p1, P2 p2, P3 p3, P4 p4, P5 p5, P6 p6, P7 p7)
 {
-    string out;
-    stream::stringer s(out);
-    stream::ostring os(s);
-    os<<p1<<p2<<p3<<p4<<p5<<p6<<p7;
-    return out;
+    ostring_builder b;
+    b<<p1<<p2<<p3<<p4<<p5<<p6<<p7;
+    return b.str();
 }
 
 /**
@@ -207,11 +218,9 @@ template<class P1, class P2, class P3, class P4, class P5, class P6,
 string fast_ostring(P1 p1, P2 p2, P3 p3, P4 p4, P5 p5, P6 p6, P7 p7,
                     P8 p8)
 {
-    string out;
-    stream::stringer s(out);
-    stream::ostring os(s);
-    os<<p1<<p2<<p3<<p4<<p5<<p6<<p7<<p8;
-    return out;
+    ostring_builder b;
+    b<<p1<<p2<<p3<<p4<<p5<<p6<<p7<<p8;
+    return b.str();
 }
 
 /**
@@ -232,11 +241,9 @@ template<class P1, class P2, class P3, class P4, class P5, class P6,
 string fast_ostring(P1 p1, P2 p2, P3 p3, P4 p4, P5 p5, P6 p6, P7 p7,
                     P8 p8, P9 p9)
 {
-    string out;
-    stream::stringer s(out);
-    stream::ostring os(s);
-    os<<p1<<p2<<p3<<p4<<p5<<p6<<p7<<p8<<p9;
-    return out;
+    ostring_builder b;
+    b<<p1<<p2<<p3<<p4<<p5<<p6<<p7<<p8<<p9;
+    return b.str();
 }
 
 /**
@@ -258,11 +265,9 @@ template<class P1, class P2, class P3, class P4, class P5, class P6,
 string fast_ostring(P1 p1, P2 p2, P3 p3, P4 p4, P5 p5, P6 p6, P7 p7,
                     P8 p8, P9 p9, P10 p10)
 {
-    string out;
-    stream::stringer s(out);
-    stream::ostring os(s);
-    os<<p1<<p2<<p3<<p4<<p5<<p6<<p7<<p8<<p9<<p10;
-    return out;
+    ostring_builder b;
+    b<<p1<<p2<<p3<<p4<<p5<<p6<<p7<<p8<<p9<<p10;
+    return b.str();
 }
 
 } //namespace bloom
\ No newline at end of file
@@ -42,6 +42,15 @@ typedef class string_t<char> string;
 
 std::ostream& operator<< (std::ostream&o, const bloom::string& str);
 
+/**
+ * @brief Like std::string_view (C++17).
+ * 
+ * Non-owning reference to the characters data.
+ */
+typedef class string_ref_t<char> string_ref;
+
+std::ostream& operator<< (std::ostream&o, const bloom::string_ref& str);
+
 
 /**
  * @brief Like std::wstring.
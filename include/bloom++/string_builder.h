@@ -0,0 +1,377 @@
+/* 
+ * Copyright © 2015 Sergei Khairulin <sergei.khairulin@gmail.com>. 
+ * All rights reserved.
+ *
+ * This file is part of Bloom++.
+ *
+ * Bloom++ is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Bloom++ is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Bloom++.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include <string.h>
+#include <stdarg.h>
+#include <bloom++/string.h>
+
+namespace bloom
+{
+
+/**
+ * @brief Fast string builder.
+ * 
+ * Appends strings and numbers directly to the own buffer (without streams
+ * and virtual calls). Short strings are built in the internal buffer,
+ * longer ones grow geometrically.
+ * 
+ * Numbers are formatted by bloom::number functions (floating point
+ * numbers in the shortest form). Unlike stream::ostring, char is appended
+ * as a character.
+ */
+class string_builder
+{
+public:
+    string_builder();
+    /**
+     * @param capacity Initial capacity.
+     */
+    explicit string_builder(size_t capacity);
+    ~string_builder();
+    
+    /**
+     * @brief Reserve space for at least capacity characters.
+     */
+    void reserve(size_t capacity){
+        /// @cond
+        if(capacity > capacity_)grow(capacity);
+        /// @endcond
+    }
+    
+    void clear(){
+        size_ = 0;
+    }
+    
+    size_t size() const {
+        return size_;
+    }
+    
+    size_t length() const {
+        return size_;
+    }
+    
+    bool empty() const {
+        return !size_;
+    }
+    
+    size_t capacity() const {
+        return capacity_;
+    }
+    
+    /**
+     * @brief Built data (not null-terminated).
+     */
+    const char *data() const {
+        return data_;
+    }
+    
+    /**
+     * @brief Built data (null-terminated).
+     */
+    const char *c_str() const {
+        /// @cond
+        data_[size_] = 0;
+        return data_;
+        /// @endcond
+    }
+    
+    /**
+     * @brief Reference to the built data (valid until next appending).
+     */
+    string_ref ref() const {
+        return string_ref(data_, size_);
+    }
+    
+    /**
+     * @brief Copy built data to the new string.
+     */
+    string str() const {
+        return string(ref());
+    }
+    
+    string_builder &append(const char *data, size_t size){
+        /// @cond
+        if(size_ + size > capacity_){
+            // the data may be a part of this builder (b << b)
+            if(data >= data_ && data < data_ + size_){
+                const size_t offset = data - data_;
+                grow(size_ + size);
+                data = data_ + offset;
+            }
+            else
+                grow(size_ + size);
+        }
+        memcpy(data_ + size_, data, size);
+        size_ += size;
+        return *this;
+        /// @endcond
+    }
+    
+    string_builder &append(char c){
+        /// @cond
+        if(size_ == capacity_)grow(size_ + 1);
+        data_[size_++] = c;
+        return *this;
+        /// @endcond
+    }
+    
+    string_builder &append(size_t count, char c){
+        /// @cond
+        if(size_ + count > capacity_)grow(size_ + count);
+        memset(data_ + size_, c, count);
+        size_ += count;
+        return *this;
+        /// @endcond
+    }
+    
+    /**
+     * @brief Append printf-like formatted data (never truncated).
+     */
+    string_builder &appendf(const char *format, ...) __attribute__((__format__(__printf__, 2, 3)));
+    string_builder &vappendf(const char *format, va_list args);
+    
+    /**
+     * @brief Append format up to the next "{}" placeholder.
+     * 
+     * "{{" and "}}" are appended as "{" and "}".
+     * @param format Format, moved after the placeholder (or to the end).
+     * @return false if there is no placeholder.
+     */
+    bool append_format(const char *&format);
+    
+    string_builder &operator<<(const char *str){
+        return append(str, strlen(str));
+    }
+    
+    string_builder &operator<<(const string &str){
+        return append(str.data(), str.size());
+    }
+    
+    string_builder &operator<<(const string_ref &str){
+        return append(str.data(), str.size());
+    }
+    
+    string_builder &operator<<(const string_builder &sb){
+        return append(sb.data(), sb.size());
+    }
+    
+    string_builder &operator<<(char c){
+        return append(c);
+    }
+    
+    string_builder &operator<<(bool value){
+        /// @cond
+        if(value)return append("true", 4);
+        return append("false", 5);
+        /// @endcond
+    }
+    
+    string_builder &operator<<(unsigned char value){
+        return append_unsigned(value);
+    }
+    
+    string_builder &operator<<(short value){
+        return append_signed(value);
+    }
+    
+    string_builder &operator<<(unsigned short value){
+        return append_unsigned(value);
+    }
+    
+    string_builder &operator<<(int value){
+        return append_signed(value);
+    }
+    
+    string_builder &operator<<(unsigned int value){
+        return append_unsigned(value);
+    }
+    
+    string_builder &operator<<(long value){
+        return append_signed(value);
+    }
+    
+    string_builder &operator<<(unsigned long value){
+        return append_unsigned(value);
+    }
+    
+    string_builder &operator<<(long long value){
+        return append_signed(value);
+    }
+    
+    string_builder &operator<<(unsigned long long value){
+        return append_unsigned(value);
+    }
+    
+    string_builder &operator<<(double value);
+    
+    string_builder &operator<<(float value);
+    
+    string_builder &operator<<(const void *ptr);
+    
+private:
+    /// @cond
+    enum { local_size = 128 };
+    
+    char *data_;
+    size_t size_;
+    size_t capacity_;
+    char local_[local_size + 1];
+    
+    void grow(size_t size);
+    string_builder &append_unsigned(unsigned long long value);
+    string_builder &append_signed(long long value);
+    
+    string_builder(const string_builder &); //Disable
+    string_builder &operator=(const string_builder &); //Disable
+    /// @endcond
+};
+
+/**
+ * @brief printf-like formatting (never truncated).
+ */
+string formatf(const char *format, ...) __attribute__((__format__(__printf__, 1, 2)));
+
+/**
+ * @brief vprintf-like formatting (never truncated).
+ */
+string vformatf(const char *format, va_list args);
+
+/**
+ * @brief Formatting with "{}" placeholders.
+ * 
+ * Arguments are appended by string_builder::operator<< (in order).
+ * Extra arguments are appended to the end.
+ * @param format Format.
+ * @param p1 Argument.
+ * @return string.
+ */
+template<class P1>
+string format(const char *format, const P1 &p1)
+{
+    string_builder b;
+    b.append_format(format); b<<p1;
+    b.append_format(format);
+    return b.str();
+}
+
+template<class P1, class P2>
+string format(const char *format, const P1 &p1, const P2 &p2)
+{
+    string_builder b;
+    b.append_format(format); b<<p1;
+    b.append_format(format); b<<p2;
+    b.append_format(format);
+    return b.str();
+}
+
+template<class P1, class P2, class P3>
+string format(const char *format, const P1 &p1, const P2 &p2, const P3 &p3)
+{
+    string_builder b;
+    b.append_format(format); b<<p1;
+    b.append_format(format); b<<p2;
+    b.append_format(format); b<<p3;
+    b.append_format(format);
+    return b.str();
+}
+
+template<class P1, class P2, class P3, class P4>
+string format(const char *format, const P1 &p1, const P2 &p2, const P3 &p3,
+              const P4 &p4)
+{
+    string_builder b;
+    b.append_format(format); b<<p1;
+    b.append_format(format); b<<p2;
+    b.append_format(format); b<<p3;
+    b.append_format(format); b<<p4;
+    b.append_format(format);
+    return b.str();
+}
+
+template<class P1, class P2, class P3, class P4, class P5>
+string format(const char *format, const P1 &p1, const P2 &p2, const P3 &p3,
+              const P4 &p4, const P5 &p5)
+{
+    string_builder b;
+    b.append_format(format); b<<p1;
+    b.append_format(format); b<<p2;
+    b.append_format(format); b<<p3;
+    b.append_format(format); b<<p4;
+    b.append_format(format); b<<p5;
+    b.append_format(format);
+    return b.str();
+}
+
+template<class P1, class P2, class P3, class P4, class P5, class P6>
+string format(const char *format, const P1 &p1, const P2 &p2, const P3 &p3,
+              const P4 &p4, const P5 &p5, const P6 &p6)
+{
+    string_builder b;
+    b.append_format(format); b<<p1;
+    b.append_format(format); b<<p2;
+    b.append_format(format); b<<p3;
+    b.append_format(format); b<<p4;
+    b.append_format(format); b<<p5;
+    b.append_format(format); b<<p6;
+    b.append_format(format);
+    return b.str();
+}
+
+template<class P1, class P2, class P3, class P4, class P5, class P6,
+         class P7>
+string format(const char *format, const P1 &p1, const P2 &p2, const P3 &p3,
+              const P4 &p4, const P5 &p5, const P6 &p6, const P7 &p7)
+{
+    string_builder b;
+    b.append_format(format); b<<p1;
+    b.append_format(format); b<<p2;
+    b.append_format(format); b<<p3;
+    b.append_format(format); b<<p4;
+    b.append_format(format); b<<p5;
+    b.append_format(format); b<<p6;
+    b.append_format(format); b<<p7;
+    b.append_format(format);
+    return b.str();
+}
+
+template<class P1, class P2, class P3, class P4, class P5, class P6,
+         class P7, class P8>
+string format(const char *format, const P1 &p1, const P2 &p2, const P3 &p3,
+              const P4 &p4, const P5 &p5, const P6 &p6, const P7 &p7,
+              const P8 &p8)
+{
+    string_builder b;
+    b.append_format(format); b<<p1;
+    b.append_format(format); b<<p2;
+    b.append_format(format); b<<p3;
+    b.append_format(format); b<<p4;
+    b.append_format(format); b<<p5;
+    b.append_format(format); b<<p6;
+    b.append_format(format); b<<p7;
+    b.append_format(format); b<<p8;
+    b.append_format(format);
+    return b.str();
+}
+
+} //namespace bloom
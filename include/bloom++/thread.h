@@ -23,6 +23,7 @@
 
 #include <pthread.h>
 #include <unistd.h>
+#include <bloom++/thread_attributes.h>
 
 namespace bloom
 {
@@ -75,14 +76,26 @@ private:
     P5 p5_;
     P6 p6_;
     P7 p7_;
+    thread_attributes attr_;
 
     thread(const thread& copy); // copy constructor denied
 
     static void *thread_func(void *d)
     {
+        ((thread *) d)->attr_.apply();
         ((thread *) d)->run();
         pthread_exit(0);
     }
+    
+    int create()
+    {
+        pthread_attr_t a;
+        pthread_attr_init(&a);
+        attr_.init(a);
+        int ret = pthread_create(&thread_, &a, thread::thread_func, (void*) this);
+        pthread_attr_destroy(&a);
+        return ret;
+    }
 
     void run()
     {
@@ -147,14 +160,35 @@ public:
     {
         bDestroy_ = true;
     }
+    
+    /**
+     * @brief Attributes (name, affinity, stack size, priority) of thread
+     * started after this call.
+     */
+    void set_attributes(const thread_attributes &attr)
+    {
+        attr_ = attr;
+    }
+    
+    const thread_attributes &attributes() const
+    {
+        return attr_;
+    }
+    
+    /**
+     * @brief pthread handle of started thread.
+     */
+    pthread_t native_handle() const
+    {
+        return thread_;
+    }
 
     int start()
     {
         if(!func_){
             return -1;
         }
-        return pthread_create(&thread_, NULL,
-                              thread::thread_func, (void*) this);
+        return create();
     }
     
     int start(P1 p1)
@@ -163,8 +197,7 @@ public:
             return -1;
         }
         p1_ = p1;
-        return pthread_create(&thread_, NULL,
-                              thread::thread_func, (void*) this);
+        return create();
     }
     
     int start(P1 p1, P2 p2)
@@ -174,8 +207,7 @@ public:
         }
         p1_ = p1;
         p2_ = p2;
-        return pthread_create(&thread_, NULL,
-                              thread::thread_func, (void*) this);
+        return create();
     }
     
     int start(P1 p1, P2 p2, P3 p3)
@@ -186,8 +218,7 @@ public:
         p1_ = p1;
         p2_ = p2;
         p3_ = p3;
-        return pthread_create(&thread_, NULL,
-                              thread::thread_func, (void*) this);
+        return create();
     }
     
     int start(P1 p1, P2 p2, P3 p3, P4 p4)
@@ -199,8 +230,7 @@ public:
         p2_ = p2;
         p3_ = p3;
         p4_ = p4;
-        return pthread_create(&thread_, NULL,
-                              thread::thread_func, (void*) this);
+        return create();
     }
     
     int start(P1 p1, P2 p2, P3 p3, P4 p4, P5 p5)
@@ -213,8 +243,7 @@ public:
         p3_ = p3;
         p4_ = p4;
         p5_ = p5;
-        return pthread_create(&thread_, NULL,
-                              thread::thread_func, (void*) this);
+        return create();
     }
     
     int start(P1 p1, P2 p2, P3 p3, P4 p4, P5 p5, P6 p6)
@@ -228,8 +257,7 @@ public:
         p4_ = p4;
         p5_ = p5;
         p6_ = p6;
-        return pthread_create(&thread_, NULL,
-                              thread::thread_func, (void*) this);
+        return create();
     }
     
     int start(P1 p1, P2 p2, P3 p3, P4 p4, P5 p5, P6 p6, P7 p7)
@@ -244,8 +272,7 @@ public:
         p5_ = p5;
         p6_ = p6;
         p7_ = p7;
-        return pthread_create(&thread_, NULL,
-                              thread::thread_func, (void*) this);
+        return create();
     }
 
     int wait()
@@ -0,0 +1,150 @@
+/* 
+ * Copyright © 2015 Sergei Khairulin <sergei.khairulin@gmail.com>. 
+ * All rights reserved.
+ *
+ * This file is part of Bloom++.
+ *
+ * Bloom++ is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Bloom++ is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Bloom++.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include <pthread.h>
+#include <sched.h>
+
+namespace bloom
+{
+
+/**
+ * @brief Attributes of thread: name, CPU affinity, stack size and
+ * real-time priority.
+ * 
+ * Setters return *this for chaining:
+ * thread_attributes().set_name("exec").add_cpus(2, 5).set_spread(true)
+ * 
+ * Name, affinity and priority are applied by the new thread itself
+ * before running of its function. Errors (e.g. no privileges for
+ * SCHED_FIFO) don't prevent running of thread, apply() returns them.
+ */
+class thread_attributes
+{
+public:
+    thread_attributes();
+    
+    /**
+     * @brief Name shown by top -H, ps and perf (up to 15 characters).
+     */
+    thread_attributes &set_name(const char *name);
+    
+    /**
+     * @brief Adding of CPU to affinity mask.
+     */
+    thread_attributes &add_cpu(int cpu);
+    
+    /**
+     * @brief Adding of CPUs [first, last] to affinity mask.
+     */
+    thread_attributes &add_cpus(int first, int last);
+    
+    /**
+     * @brief Pinning of every thread of a group to one CPU of the mask.
+     * 
+     * for_index(i) pins to i-th CPU of the mask (round robin) instead of
+     * the whole mask.
+     */
+    thread_attributes &set_spread(bool spread);
+    
+    /**
+     * @brief Stack size in bytes (0 - default).
+     */
+    thread_attributes &set_stack_size(size_t size);
+    
+    /**
+     * @brief SCHED_FIFO priority (1..99, 0 - default scheduling).
+     */
+    thread_attributes &set_priority(int priority);
+    
+    const char *name() const {
+        return name_;
+    }
+    
+    size_t stack_size() const {
+        return stack_size_;
+    }
+    
+    int priority() const {
+        return priority_;
+    }
+    
+    /**
+     * @brief Number of CPUs in affinity mask.
+     */
+    int cpus() const {
+        return ncpus_;
+    }
+    
+    /**
+     * @brief Attributes of index-th thread of a group.
+     * 
+     * Adds "-index" to the name and pins to one CPU in spread mode.
+     */
+    thread_attributes for_index(size_t index) const;
+    
+    /**
+     * @brief Setting of creation attributes (stack size).
+     */
+    void init(pthread_attr_t &attr) const;
+    
+    /**
+     * @brief Applying of name, affinity and priority to running thread.
+     * @return 0 or error code of the first failed call.
+     */
+    int apply(pthread_t thread) const;
+    
+    /**
+     * @brief Applying to the calling thread.
+     */
+    int apply() const {
+        return apply(pthread_self());
+    }
+    
+private:
+    /// @cond
+    char name_[16];
+#ifdef __linux__
+    // keyed on the compiler's macro: the layout must not depend on
+    // flags of the library build (-DLINUX)
+    cpu_set_t cpuset_;
+#endif
+    int ncpus_;
+    bool bSpread_;
+    size_t stack_size_;
+    int priority_;
+    /// @endcond
+};
+
+/**
+ * @brief Attributes of threads of network classes.
+ * 
+ * Thread i of a role gets attributes.for_index(i).
+ */
+struct thread_layout
+{
+    thread_attributes acceptors;
+    thread_attributes executors;
+};
+
+} //namespace bloom
@@ -0,0 +1,547 @@
+/* 
+ * Copyright © 2015 Sergei Khairulin <sergei.khairulin@gmail.com>. 
+ * All rights reserved.
+ *
+ * This file is part of Bloom++.
+ *
+ * Bloom++ is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Bloom++ is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Bloom++.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include <bloom++/future.h>
+#include <bloom++/mutex.h>
+#include <bloom++/condition_variable.h>
+#include <bloom++/list.h>
+#include <bloom++/thread_attributes.h>
+
+namespace bloom
+{
+
+/// @cond
+template<class R, class F, class P1>
+struct pool_fn1
+{
+    F f_;
+    P1 p1_;
+    
+    R operator()(){
+        return f_(p1_);
+    }
+};
+
+template<class R, class F, class P1, class P2>
+struct pool_fn2
+{
+    F f_;
+    P1 p1_;
+    P2 p2_;
+    
+    R operator()(){
+        return f_(p1_, p2_);
+    }
+};
+
+template<class R, class F, class P1, class P2, class P3>
+struct pool_fn3
+{
+    F f_;
+    P1 p1_;
+    P2 p2_;
+    P3 p3_;
+    
+    R operator()(){
+        return f_(p1_, p2_, p3_);
+    }
+};
+
+template<class R, class F, class P1, class P2, class P3, class P4>
+struct pool_fn4
+{
+    F f_;
+    P1 p1_;
+    P2 p2_;
+    P3 p3_;
+    P4 p4_;
+    
+    R operator()(){
+        return f_(p1_, p2_, p3_, p4_);
+    }
+};
+
+template<class R, class F, class P1, class P2, class P3, class P4, class P5>
+struct pool_fn5
+{
+    F f_;
+    P1 p1_;
+    P2 p2_;
+    P3 p3_;
+    P4 p4_;
+    P5 p5_;
+    
+    R operator()(){
+        return f_(p1_, p2_, p3_, p4_, p5_);
+    }
+};
+
+template<class R, class F, class P1, class P2, class P3, class P4, class P5, class P6>
+struct pool_fn6
+{
+    F f_;
+    P1 p1_;
+    P2 p2_;
+    P3 p3_;
+    P4 p4_;
+    P5 p5_;
+    P6 p6_;
+    
+    R operator()(){
+        return f_(p1_, p2_, p3_, p4_, p5_, p6_);
+    }
+};
+
+template<class R, class F, class P1, class P2, class P3, class P4, class P5, class P6, class P7>
+struct pool_fn7
+{
+    F f_;
+    P1 p1_;
+    P2 p2_;
+    P3 p3_;
+    P4 p4_;
+    P5 p5_;
+    P6 p6_;
+    P7 p7_;
+    
+    R operator()(){
+        return f_(p1_, p2_, p3_, p4_, p5_, p6_, p7_);
+    }
+};
+
+template<class R, class M, class T, class P1>
+struct pool_mem_fn1
+{
+    M fn_;
+    T *obj_;
+    P1 p1_;
+    
+    R operator()(){
+        return (obj_->*fn_)(p1_);
+    }
+};
+
+template<class R, class M, class T, class P1, class P2>
+struct pool_mem_fn2
+{
+    M fn_;
+    T *obj_;
+    P1 p1_;
+    P2 p2_;
+    
+    R operator()(){
+        return (obj_->*fn_)(p1_, p2_);
+    }
+};
+
+template<class R, class M, class T, class P1, class P2, class P3>
+struct pool_mem_fn3
+{
+    M fn_;
+    T *obj_;
+    P1 p1_;
+    P2 p2_;
+    P3 p3_;
+    
+    R operator()(){
+        return (obj_->*fn_)(p1_, p2_, p3_);
+    }
+};
+
+template<class R, class M, class T, class P1, class P2, class P3, class P4>
+struct pool_mem_fn4
+{
+    M fn_;
+    T *obj_;
+    P1 p1_;
+    P2 p2_;
+    P3 p3_;
+    P4 p4_;
+    
+    R operator()(){
+        return (obj_->*fn_)(p1_, p2_, p3_, p4_);
+    }
+};
+
+template<class R, class M, class T, class P1, class P2, class P3, class P4, class P5>
+struct pool_mem_fn5
+{
+    M fn_;
+    T *obj_;
+    P1 p1_;
+    P2 p2_;
+    P3 p3_;
+    P4 p4_;
+    P5 p5_;
+    
+    R operator()(){
+        return (obj_->*fn_)(p1_, p2_, p3_, p4_, p5_);
+    }
+};
+
+template<class R, class M, class T, class P1, class P2, class P3, class P4, class P5, class P6>
+struct pool_mem_fn6
+{
+    M fn_;
+    T *obj_;
+    P1 p1_;
+    P2 p2_;
+    P3 p3_;
+    P4 p4_;
+    P5 p5_;
+    P6 p6_;
+    
+    R operator()(){
+        return (obj_->*fn_)(p1_, p2_, p3_, p4_, p5_, p6_);
+    }
+};
+
+template<class R, class M, class T, class P1, class P2, class P3, class P4, class P5, class P6, class P7>
+struct pool_mem_fn7
+{
+    M fn_;
+    T *obj_;
+    P1 p1_;
+    P2 p2_;
+    P3 p3_;
+    P4 p4_;
+    P5 p5_;
+    P6 p6_;
+    P7 p7_;
+    
+    R operator()(){
+        return (obj_->*fn_)(p1_, p2_, p3_, p4_, p5_, p6_, p7_);
+    }
+};
+/// @endcond
+
+/**
+ * @brief Thread pool with work stealing.
+ * 
+ * Every worker has own Chase-Lev deque: tasks submitted by a worker are
+ * pushed to its deque and popped in LIFO order, idle workers steal
+ * from the others. Tasks of other threads go to the shared queue.
+ * 
+ * Tasks are functors (R f()), functions and member functions with up to
+ * 7 arguments like thread<>, the result is returned by future. The
+ * destructor waits for all submitted tasks.
+ * 
+ * Loops of tcp::server, tcp::client and udp::communicator given a pool
+ * keep their workers until they are destroyed (see reserve()): the pool
+ * replaces their own threads but doesn't make those threads free for
+ * other tasks, size the pool for the loops plus the short tasks.
+ */
+class thread_pool: public executor
+{
+public:
+    /**
+     * @param threads Number of workers, 0 - number of online processors.
+     */
+    explicit thread_pool(size_t threads = 0);
+    
+    /**
+     * @param threads Number of workers, 0 - number of online processors.
+     * @param attr Attributes of workers, worker i gets attr.for_index(i).
+     */
+    thread_pool(size_t threads, const thread_attributes &attr);
+    virtual ~thread_pool();
+    
+    /**
+     * @brief Number of workers.
+     */
+    size_t size() const {
+        return size_;
+    }
+    
+    /**
+     * @brief Running of task (deleted after running).
+     */
+    virtual void execute(pool_task *task);
+    
+    /**
+     * @brief Reserving of workers for tasks which run until shutdown
+     * (loops of servers), so they can't starve the pool.
+     * @param n Number of workers.
+     * @return false if less than n workers are not reserved yet.
+     */
+    bool reserve(size_t n);
+    
+    /**
+     * @brief Returning of workers taken by reserve().
+     */
+    void unreserve(size_t n);
+    
+    /**
+     * @brief Running of one pending task in the calling thread.
+     * 
+     * The task may be a loop which runs until shutdown.
+     * @return false if there is no task.
+     */
+    bool run_one();
+    
+    /**
+     * @brief Running of one task submitted by the calling worker and
+     * not stolen yet (the last one first).
+     * 
+     * Used by future::wait(): tasks of the shared queue and of other
+     * workers, e.g. loops of servers, aren't run.
+     * @return false if there is no task or the caller isn't a worker
+     * of this pool.
+     */
+    bool run_own();
+    
+    /**
+     * @brief Pool of the calling worker thread or NULL.
+     */
+    static thread_pool *current();
+    
+    /**
+     * @brief Shared pool of the process (number of online processors
+     * workers, created on first use).
+     */
+    static thread_pool &shared();
+    
+    /**
+     * @brief Submitting of functor.
+     * @param R Type of result of f().
+     */
+    template<class R, class F>
+    future<R> submit(F f){
+        /// @cond
+        future_state<R> *s = new future_state<R>(this);
+        future<R> r(s);
+        execute(new future_task<R, F>(s, f));
+        return r;
+        /// @endcond
+    }
+    
+    template<class R, class F, class P1>
+    future<R> submit(F f, P1 p1){
+        /// @cond
+        pool_fn1<R, F, P1> b = {f, p1};
+        return submit<R>(b);
+        /// @endcond
+    }
+    
+    template<class R, class F, class P1, class P2>
+    future<R> submit(F f, P1 p1, P2 p2){
+        /// @cond
+        pool_fn2<R, F, P1, P2> b = {f, p1, p2};
+        return submit<R>(b);
+        /// @endcond
+    }
+    
+    template<class R, class F, class P1, class P2, class P3>
+    future<R> submit(F f, P1 p1, P2 p2, P3 p3){
+        /// @cond
+        pool_fn3<R, F, P1, P2, P3> b = {f, p1, p2, p3};
+        return submit<R>(b);
+        /// @endcond
+    }
+    
+    template<class R, class F, class P1, class P2, class P3, class P4>
+    future<R> submit(F f, P1 p1, P2 p2, P3 p3, P4 p4){
+        /// @cond
+        pool_fn4<R, F, P1, P2, P3, P4> b = {f, p1, p2, p3, p4};
+        return submit<R>(b);
+        /// @endcond
+    }
+    
+    template<class R, class F, class P1, class P2, class P3, class P4, class P5>
+    future<R> submit(F f, P1 p1, P2 p2, P3 p3, P4 p4, P5 p5){
+        /// @cond
+        pool_fn5<R, F, P1, P2, P3, P4, P5> b = {f, p1, p2, p3, p4, p5};
+        return submit<R>(b);
+        /// @endcond
+    }
+    
+    template<class R, class F, class P1, class P2, class P3, class P4, class P5, class P6>
+    future<R> submit(F f, P1 p1, P2 p2, P3 p3, P4 p4, P5 p5, P6 p6){
+        /// @cond
+        pool_fn6<R, F, P1, P2, P3, P4, P5, P6> b = {f, p1, p2, p3, p4, p5, p6};
+        return submit<R>(b);
+        /// @endcond
+    }
+    
+    template<class R, class F, class P1, class P2, class P3, class P4, class P5, class P6, class P7>
+    future<R> submit(F f, P1 p1, P2 p2, P3 p3, P4 p4, P5 p5, P6 p6, P7 p7){
+        /// @cond
+        pool_fn7<R, F, P1, P2, P3, P4, P5, P6, P7> b = {f, p1, p2, p3, p4, p5, p6, p7};
+        return submit<R>(b);
+        /// @endcond
+    }
+    
+    /**
+     * @brief Submitting of function.
+     */
+    template<class R>
+    future<R> submit(R (*fn)()){
+        /// @cond
+        return submit<R, R (*)()>(fn);
+        /// @endcond
+    }
+    
+    template<class R, class A1, class P1>
+    future<R> submit(R (*fn)(A1), P1 p1){
+        /// @cond
+        return submit<R, R (*)(A1), P1>(fn, p1);
+        /// @endcond
+    }
+    
+    template<class R, class A1, class A2, class P1, class P2>
+    future<R> submit(R (*fn)(A1, A2), P1 p1, P2 p2){
+        /// @cond
+        return submit<R, R (*)(A1, A2), P1, P2>(fn, p1, p2);
+        /// @endcond
+    }
+    
+    template<class R, class A1, class A2, class A3, class P1, class P2, class P3>
+    future<R> submit(R (*fn)(A1, A2, A3), P1 p1, P2 p2, P3 p3){
+        /// @cond
+        return submit<R, R (*)(A1, A2, A3), P1, P2, P3>(fn, p1, p2, p3);
+        /// @endcond
+    }
+    
+    template<class R, class A1, class A2, class A3, class A4, class P1, class P2, class P3, class P4>
+    future<R> submit(R (*fn)(A1, A2, A3, A4), P1 p1, P2 p2, P3 p3, P4 p4){
+        /// @cond
+        return submit<R, R (*)(A1, A2, A3, A4), P1, P2, P3, P4>(fn, p1, p2, p3, p4);
+        /// @endcond
+    }
+    
+    template<class R, class A1, class A2, class A3, class A4, class A5, class P1, class P2, class P3, class P4, class P5>
+    future<R> submit(R (*fn)(A1, A2, A3, A4, A5), P1 p1, P2 p2, P3 p3, P4 p4, P5 p5){
+        /// @cond
+        return submit<R, R (*)(A1, A2, A3, A4, A5), P1, P2, P3, P4, P5>(fn, p1, p2, p3, p4, p5);
+        /// @endcond
+    }
+    
+    template<class R, class A1, class A2, class A3, class A4, class A5, class A6, class P1, class P2, class P3, class P4, class P5, class P6>
+    future<R> submit(R (*fn)(A1, A2, A3, A4, A5, A6), P1 p1, P2 p2, P3 p3, P4 p4, P5 p5, P6 p6){
+        /// @cond
+        return submit<R, R (*)(A1, A2, A3, A4, A5, A6), P1, P2, P3, P4, P5, P6>(fn, p1, p2, p3, p4, p5, p6);
+        /// @endcond
+    }
+    
+    template<class R, class A1, class A2, class A3, class A4, class A5, class A6, class A7, class P1, class P2, class P3, class P4, class P5, class P6, class P7>
+    future<R> submit(R (*fn)(A1, A2, A3, A4, A5, A6, A7), P1 p1, P2 p2, P3 p3, P4 p4, P5 p5, P6 p6, P7 p7){
+        /// @cond
+        return submit<R, R (*)(A1, A2, A3, A4, A5, A6, A7), P1, P2, P3, P4, P5, P6, P7>(fn, p1, p2, p3, p4, p5, p6, p7);
+        /// @endcond
+    }
+    
+    /**
+     * @brief Submitting of member function obj->fn(...).
+     */
+    template<class R, class T>
+    future<R> submit(R (T::*fn)(), T *obj){
+        /// @cond
+        future_mem_fn0<R, T> b = {fn, obj};
+        return submit<R>(b);
+        /// @endcond
+    }
+    
+    template<class R, class T, class A1, class P1>
+    future<R> submit(R (T::*fn)(A1), T *obj, P1 p1){
+        /// @cond
+        pool_mem_fn1<R, R (T::*)(A1), T, P1> b = {fn, obj, p1};
+        return submit<R>(b);
+        /// @endcond
+    }
+    
+    template<class R, class T, class A1, class A2, class P1, class P2>
+    future<R> submit(R (T::*fn)(A1, A2), T *obj, P1 p1, P2 p2){
+        /// @cond
+        pool_mem_fn2<R, R (T::*)(A1, A2), T, P1, P2> b = {fn, obj, p1, p2};
+        return submit<R>(b);
+        /// @endcond
+    }
+    
+    template<class R, class T, class A1, class A2, class A3, class P1, class P2, class P3>
+    future<R> submit(R (T::*fn)(A1, A2, A3), T *obj, P1 p1, P2 p2, P3 p3){
+        /// @cond
+        pool_mem_fn3<R, R (T::*)(A1, A2, A3), T, P1, P2, P3> b = {fn, obj, p1, p2, p3};
+        return submit<R>(b);
+        /// @endcond
+    }
+    
+    template<class R, class T, class A1, class A2, class A3, class A4, class P1, class P2, class P3, class P4>
+    future<R> submit(R (T::*fn)(A1, A2, A3, A4), T *obj, P1 p1, P2 p2, P3 p3, P4 p4){
+        /// @cond
+        pool_mem_fn4<R, R (T::*)(A1, A2, A3, A4), T, P1, P2, P3, P4> b = {fn, obj, p1, p2, p3, p4};
+        return submit<R>(b);
+        /// @endcond
+    }
+    
+    template<class R, class T, class A1, class A2, class A3, class A4, class A5, class P1, class P2, class P3, class P4, class P5>
+    future<R> submit(R (T::*fn)(A1, A2, A3, A4, A5), T *obj, P1 p1, P2 p2, P3 p3, P4 p4, P5 p5){
+        /// @cond
+        pool_mem_fn5<R, R (T::*)(A1, A2, A3, A4, A5), T, P1, P2, P3, P4, P5> b = {fn, obj, p1, p2, p3, p4, p5};
+        return submit<R>(b);
+        /// @endcond
+    }
+    
+    template<class R, class T, class A1, class A2, class A3, class A4, class A5, class A6, class P1, class P2, class P3, class P4, class P5, class P6>
+    future<R> submit(R (T::*fn)(A1, A2, A3, A4, A5, A6), T *obj, P1 p1, P2 p2, P3 p3, P4 p4, P5 p5, P6 p6){
+        /// @cond
+        pool_mem_fn6<R, R (T::*)(A1, A2, A3, A4, A5, A6), T, P1, P2, P3, P4, P5, P6> b = {fn, obj, p1, p2, p3, p4, p5, p6};
+        return submit<R>(b);
+        /// @endcond
+    }
+    
+    template<class R, class T, class A1, class A2, class A3, class A4, class A5, class A6, class A7, class P1, class P2, class P3, class P4, class P5, class P6, class P7>
+    future<R> submit(R (T::*fn)(A1, A2, A3, A4, A5, A6, A7), T *obj, P1 p1, P2 p2, P3 p3, P4 p4, P5 p5, P6 p6, P7 p7){
+        /// @cond
+        pool_mem_fn7<R, R (T::*)(A1, A2, A3, A4, A5, A6, A7), T, P1, P2, P3, P4, P5, P6, P7> b = {fn, obj, p1, p2, p3, p4, p5, p6, p7};
+        return submit<R>(b);
+        /// @endcond
+    }
+    
+private:
+    /// @cond
+    struct worker;
+    
+    worker **workers_;
+    size_t size_;
+    mutex m_;
+    condition_variable cv_;
+    list<pool_task*> queue_;
+    volatile size_t queued_;
+    volatile size_t sleepers_;
+    volatile size_t reserved_;
+    volatile bool bStopping_;
+    
+    thread_pool(const thread_pool &);
+    thread_pool &operator=(const thread_pool &);
+    
+    void start(const thread_attributes &attr);
+    void run_worker(worker *w);
+    pool_task *find_task(worker *w);
+    pool_task *take_queued();
+    bool has_tasks() const;
+    static void run_task(pool_task *task);
+    /// @endcond
+};
+
+} //namespace bloom
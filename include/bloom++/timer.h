@@ -19,9 +19,10 @@
  *
  */
 
-#include <pthread.h>
-#include <unistd.h>
 #include <bloom++/time.h>
+#include <bloom++/thread_attributes.h>
+#include <bloom++/timer_service.h>
+#include <bloom++/condition_variable.h>
 
 namespace bloom
 {
@@ -29,6 +30,13 @@ namespace bloom
 
 /**
  * @brief Timer in milliseconds.
+ * 
+ * Calls the method at start() and then every interval on
+ * the thread of timer_service::shared() by default. The thread is common
+ * to all timers of the process, so a slow method delays the other
+ * timers: give such a timer its own timer_service (or one with an
+ * executor) or thread attributes, a timer with its own thread
+ * attributes gets its own timer_service.
  */
 template<class T>
 class timer
@@ -37,62 +45,93 @@ public:
     typedef void (T::*timerFnPtr)(void);
 
 private:
-    pthread_t thread_;
     timerFnPtr func_;
     T * obj_;
     long interval_;
-    long last_invoked_;
+    timer_service *service_;
+    timer_service::timer_id id_;
     bool bRunning_;
-    bool bStopping_;
+    bool bAttributes_;
+    thread_attributes attr_;
+    mutex m_;
+    condition_variable cv_;
 
-    static void *thread_func(void *d)
+    timer(const timer &);
+    timer &operator=(const timer &);
+
+public:
+
+    timer(timerFnPtr func, T *obj, time_t interval) : func_(func), obj_(obj), interval_(interval),
+    service_(0), id_(0), bRunning_(false), bAttributes_(false)
     {
-        ((timer *) d)->timer_loop();
-        pthread_exit(0);
     }
-
-    void timer_loop()
+    
+    /**
+     * @brief Timer running on the given service (it must outlive the
+     * timer), set_attributes() is ignored.
+     */
+    timer(timerFnPtr func, T *obj, time_t interval, timer_service &service) : func_(func), obj_(obj),
+    interval_(interval), service_(&service), id_(0), bRunning_(false), bAttributes_(false)
     {
-        last_invoked_ = get_milli_sec();
-        (obj_->*func_)();
-        while (!bStopping_)
-        {
-            long current_timer = get_milli_sec();
-            if (current_timer - last_invoked_ >= interval_)
-            {
-                (obj_->*func_)();
-                last_invoked_ = current_timer;
-            }
-            usleep(1000);
-        }
-        bRunning_ = false;
-        bStopping_ = false;
     }
-
-public:
-
-    timer(timerFnPtr func, T *obj, time_t interval) : func_(func), obj_(obj), interval_(interval), bRunning_(false), bStopping_(false)
+    
+    ~timer()
     {
+        stop();
+        if(bAttributes_)
+            delete service_;
     }
 
     int start()
     {
-        if(bStopping_ || bRunning_)return -1;
+        mutex::scoped_lock sl(m_);
+        if(bRunning_)return -1;
+        if(!service_)
+            service_ = bAttributes_ ? new timer_service(1, 0, attr_) : &timer_service::shared();
+        id_ = service_->schedule(func_, obj_, 0, interval_ > 0 ? interval_ : 1);
         bRunning_ = true;
-        bStopping_ = false;
-        return pthread_create(&thread_, NULL, timer::thread_func, (void*) this);
+        return 0;
+    }
+    
+    /**
+     * @brief Attributes of the timer thread (before the first start()).
+     */
+    void set_attributes(const thread_attributes &attr)
+    {
+        mutex::scoped_lock sl(m_);
+        if(service_)return;
+        attr_ = attr;
+        bAttributes_ = true;
     }
 
+    /**
+     * @brief Wait until the timer is stopped.
+     */
     int wait()
     {
-        return pthread_join(thread_, NULL);
+        mutex::scoped_lock sl(m_);
+        while(bRunning_)
+            cv_.wait(sl);
+        return 0;
     }
 
+    /**
+     * @brief Stop the timer, waits for the running call of the method
+     * (unless called from a timer handler).
+     */
     void stop()
     {
-        if(bStopping_ || !bRunning_)return;
-        bStopping_ = true;
-        wait();
+        timer_service::timer_id id;
+        {
+            mutex::scoped_lock sl(m_);
+            if(!bRunning_ || !id_)return; // not started or being stopped
+            id = id_;
+            id_ = 0;
+        }
+        service_->cancel(id, true);
+        mutex::scoped_lock sl(m_);
+        bRunning_ = false;
+        cv_.notify_all();
     }
 
     bool isRunning()
@@ -101,4 +140,4 @@ public:
     }
 };
 
-} //namespace bloom
\ No newline at end of file
+} //namespace bloom
@@ -0,0 +1,273 @@
+/* 
+ * Copyright © 2015 Sergei Khairulin <sergei.khairulin@gmail.com>. 
+ * All rights reserved.
+ *
+ * This file is part of Bloom++.
+ *
+ * Bloom++ is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Bloom++ is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Bloom++.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#pragma once
+
+#include <bloom++/exception.h>
+#include <bloom++/mutex.h>
+#include <bloom++/thread.h>
+#include <bloom++/thread_attributes.h>
+#include <bloom++/future.h>
+#include <bloom++/vector.h>
+
+namespace bloom
+{
+
+/**
+ * @brief Exception of timer_service.
+ */
+class timer_service_exception: public exception
+{
+public:
+    timer_service_exception(const string &msg):exception(msg){}
+};
+
+/**
+ * @brief Callback of timer_service.
+ * 
+ * Reference counted: the service keeps it while the timer is scheduled
+ * and while its firing is dispatched to the executor.
+ */
+class timer_handler
+{
+public:
+    timer_handler():refs_(1), cancelled_(0){}
+    virtual ~timer_handler(){}
+    virtual void fire() = 0;
+    
+    /// @cond
+    void add_ref();
+    void release();
+    void wait_idle(int refs = 1);
+    
+    int refs() const
+    {
+        return __atomic_load_n(&refs_, __ATOMIC_ACQUIRE) & refs_mask;
+    }
+    
+    void cancel()
+    {
+        __atomic_store_n(&cancelled_, 1, __ATOMIC_RELEASE);
+    }
+    
+    bool cancelled() const
+    {
+        return __atomic_load_n(&cancelled_, __ATOMIC_ACQUIRE);
+    }
+    /// @endcond
+    
+private:
+    /// @cond
+    enum { waiting = 1 << 30, refs_mask = waiting - 1 };
+    // references and the waiting flag in one word: release() doesn't
+    // touch the handler after the decrement, which may let it be deleted
+    volatile int refs_;
+    volatile int cancelled_;
+    /// @endcond
+};
+
+/// @cond
+template<class T>
+class timer_mem_fn: public timer_handler
+{
+public:
+    typedef void (T::*Method)();
+    
+    timer_mem_fn(Method m, T *obj):m_(m), obj_(obj){}
+    
+    void fire()
+    {
+        (obj_->*m_)();
+    }
+    
+private:
+    Method m_;
+    T *obj_;
+};
+
+class timer_fn: public timer_handler
+{
+public:
+    typedef void (*Function)(void*);
+    
+    timer_fn(Function fn, void *arg):fn_(fn), arg_(arg){}
+    
+    void fire()
+    {
+        fn_(arg_);
+    }
+    
+private:
+    Function fn_;
+    void *arg_;
+};
+
+struct timer_node;
+/// @endcond
+
+/**
+ * @brief One-shot and periodic timers on a hierarchical timing wheel.
+ * 
+ * A single thread driven by timerfd advances the wheel by ticks,
+ * scheduling and cancelling are O(1). The wheel has 256 slots for
+ * the nearest ticks and 4 levels of 64 slots which cascade down,
+ * so millions of timers cost only memory. Timers beyond 2^32 ticks
+ * are re-placed until they come into range.
+ * 
+ * Handlers run on the service thread or are dispatched to
+ * the executor (thread_pool). The service thread sleeps in the
+ * kernel while no timers are scheduled.
+ */
+class timer_service
+{
+public:
+    /// Timer identifier, 0 is never returned.
+    typedef unsigned long long timer_id;
+    
+    /**
+     * @param tick_ms Resolution in milliseconds.
+     * @param ex Executor of handlers, 0 for the service thread.
+     * @param attr Attributes of the service thread.
+     */
+    timer_service(long tick_ms = 1, executor *ex = 0,
+                  const thread_attributes &attr = thread_attributes());
+    
+    /**
+     * @brief Stops the service thread, pending timers are dropped.
+     */
+    ~timer_service();
+    
+    /**
+     * @brief Schedule member function.
+     * @param method Handler.
+     * @param obj Object.
+     * @param delay_ms First firing after delay_ms.
+     * @param period_ms Period of firing, 0 for one-shot timer.
+     * @return Timer identifier.
+     */
+    template<class T>
+    timer_id schedule(void (T::*method)(), T *obj, long delay_ms, long period_ms = 0)
+    {
+        return schedule(new timer_mem_fn<T>(method, obj), delay_ms, period_ms);
+    }
+    
+    /**
+     * @brief Schedule function.
+     * @param fn Handler.
+     * @param arg Argument of handler.
+     * @param delay_ms First firing after delay_ms.
+     * @param period_ms Period of firing, 0 for one-shot timer.
+     * @return Timer identifier.
+     */
+    timer_id schedule(void (*fn)(void*), void *arg, long delay_ms, long period_ms = 0)
+    {
+        return schedule(new timer_fn(fn, arg), delay_ms, period_ms);
+    }
+    
+    /**
+     * @brief Schedule handler.
+     * @param h Handler, owned by the service.
+     * @param delay_ms First firing after delay_ms.
+     * @param period_ms Period of firing, 0 for one-shot timer.
+     * @return Timer identifier.
+     */
+    timer_id schedule(timer_handler *h, long delay_ms, long period_ms = 0);
+    
+    /**
+     * @brief Cancel timer.
+     * @param id Timer identifier.
+     * @param wait Wait for running and dispatched firings of the timer,
+     *             also of a one-shot timer which has already fired.
+     *             Ignored when called from a timer handler: firings
+     *             not yet started are skipped, but a running one isn't
+     *             waited for (it may be the caller's own or queued
+     *             behind it).
+     * @return false if the timer has already fired (one-shot) or
+     *         has been cancelled.
+     */
+    bool cancel(timer_id id, bool wait = false);
+    
+    /**
+     * @brief Number of scheduled timers.
+     */
+    size_t size();
+    
+    /**
+     * @brief Resolution in milliseconds.
+     */
+    long tick() const
+    {
+        return tick_ms_;
+    }
+    
+    /**
+     * @brief Process-wide service with 1 ms resolution.
+     */
+    static timer_service &shared();
+    
+private:
+    /// @cond
+    enum {
+        root_bits = 8,
+        level_bits = 6,
+        levels = 4,
+        root_size = 1 << root_bits,
+        level_size = 1 << level_bits,
+        chunk_bits = 12
+    };
+    
+    long tick_ms_;
+    executor *executor_;
+    mutex m_;
+    timer_node *root_[root_size];
+    timer_node *level_[levels][level_size];
+    unsigned long long ticks_;
+    unsigned long long start_ns_;
+    size_t count_;
+    timer_node **chunks_;
+    size_t nchunks_;
+    timer_node *free_;
+    int timerfd_;
+    int eventfd_;
+    volatile bool bStopping_;
+    vector<timer_handler*> fired_;
+    timer_node *firing_; // fired one-shot timers, kept until the firing ends
+    thread<timer_service> thread_;
+    
+    timer_service(const timer_service &);
+    timer_service &operator=(const timer_service &);
+    
+    void run();
+    void arm(bool on);
+    unsigned long long now_ticks();
+    void advance(unsigned long long target);
+    void place(timer_node *n);
+    size_t cascade(int level);
+    void expire(timer_node *n);
+    void dispatch(timer_handler *h);
+    void reclaim();
+    timer_node *node(timer_id id);
+    timer_node *alloc_node();
+    void free_node(timer_node *n);
+    /// @endcond
+};
+
+} //namespace bloom
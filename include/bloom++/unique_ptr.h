@@ -21,6 +21,8 @@
 
 #pragma once
 
+#include <bloom++/_bits/c++config.h>
+
 #ifdef AUX_DEBUG
 #define __BLOOM_WITH_DEBUG
 #endif
@@ -50,6 +52,10 @@ public:
     
     unique_ptr(const unique_ptr &ptr):pointer_(ptr.release()){}
     
+#ifdef BLOOM_CXX11
+    unique_ptr(unique_ptr &&ptr):pointer_(ptr.release()){}
+#endif
+    
     ~unique_ptr(){
         reset();
     }
@@ -58,6 +64,13 @@ public:
         reset(ptr.release());
         return *this;
     }
+    
+#ifdef BLOOM_CXX11
+    unique_ptr &operator=(unique_ptr &&ptr){
+        reset(ptr.release());
+        return *this;
+    }
+#endif
         
     T & operator*() const {
         return *pointer_;
@@ -112,6 +125,10 @@ public:
     
     unique_ptr(const unique_ptr &ptr):pointer_(ptr.release()){}
     
+#ifdef BLOOM_CXX11
+    unique_ptr(unique_ptr &&ptr):pointer_(ptr.release()){}
+#endif
+    
     ~unique_ptr(){
         reset();
     }
@@ -121,6 +138,13 @@ public:
         return *this;
     }
     
+#ifdef BLOOM_CXX11
+    unique_ptr &operator=(unique_ptr &&ptr){
+        reset(ptr.release());
+        return *this;
+    }
+#endif
+    
     T & operator*() const {
         return *pointer_;
     }
@@ -137,7 +161,7 @@ public:
         return pointer_[index];
     }
             
-    T *release() {
+    T *release() const {
         T *ret = pointer_;
         pointer_ = NULL;
         return ret;
@@ -52,6 +52,11 @@ public:
     vector(const Self &vec) throw():
     base_vector(vec){}
     
+#ifdef BLOOM_CXX11
+    vector(Self &&vec) throw():
+    base_vector(std::move(vec)){}
+#endif
+    
     ~vector() throw(){}
     
     Self &operator=(const Self &vec){
@@ -61,6 +66,15 @@ public:
         /// @endcond
     }
     
+#ifdef BLOOM_CXX11
+    Self &operator=(Self &&vec){
+        /// @cond
+        base_vector::assign(std::move(vec));
+        return *this;
+        /// @endcond
+    }
+#endif
+    
     Self& append(const vT &c){
         /// @cond
         base_vector::push_back(c);
@@ -95,6 +109,29 @@ public:
         /// @endcond
     }
     
+#ifdef BLOOM_CXX11
+    void insert(size_t index, vT &&c) {
+        /// @cond
+        base_vector::emplace(index, std::move(c));
+        /// @endcond
+    }
+    
+    iterator insert(iterator it, vT &&c) {
+        /// @cond
+        base_vector::emplace(it - begin(), std::move(c));
+        return ++it;
+        /// @endcond
+    }
+    
+    template<class... Args>
+    iterator emplace(iterator it, Args&&... args) {
+        /// @cond
+        base_vector::emplace(it - begin(), std::forward<Args>(args)...);
+        return ++it;
+        /// @endcond
+    }
+#endif
+    
     iterator insert(iterator it, const vT *values, size_t size) {
         /// @cond
         base_vector::insert(it - begin(), values, size);
@@ -221,6 +258,9 @@ public:
     }
     
     using base_vector::push_back;
+#ifdef BLOOM_CXX11
+    using base_vector::emplace_back;
+#endif
     using base_vector::pop_back;
     using base_vector::erase;
     using base_vector::clear;
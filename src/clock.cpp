@@ -0,0 +1,129 @@
+/* 
+ * Copyright © 2015 Sergei Khairulin <sergei.khairulin@gmail.com>. 
+ * All rights reserved.
+ *
+ * This file is part of Bloom++.
+ *
+ * Bloom++ is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Bloom++ is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Bloom++.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <pthread.h>
+#include <unistd.h>
+#include <bloom++/clock.h>
+#include <bloom++/mutex.h>
+
+namespace bloom
+{
+
+unsigned long long clock::cached_ = 0;
+
+namespace
+{
+
+pthread_once_t calibrate_once = PTHREAD_ONCE_INIT;
+double ns_per_cycle_ = 1.0;
+
+void calibrate()
+{
+#if defined(__i386__) || defined(__x86_64__)
+    // the shortest of a few runs is the least disturbed by preemption
+    double best = 0;
+    for(int i = 0; i < 3; ++i){
+        const unsigned long long t0 = clock::now_ns();
+        const unsigned long long c0 = clock::cycles();
+        timespec ts = {0, 3000000};
+        nanosleep(&ts, 0);
+        const unsigned long long t1 = clock::now_ns();
+        const unsigned long long c1 = clock::cycles();
+        if(c1 <= c0)
+            continue;
+        const double r = (double)(t1 - t0) / (c1 - c0);
+        if(!best || r < best)
+            best = r;
+    }
+    if(best)
+        ns_per_cycle_ = best;
+#endif
+}
+
+mutex ticker_m("clock::ticker");
+pthread_t ticker_;
+volatile bool ticker_running_ = false;
+long ticker_period_us_ = 100;
+
+} //namespace
+
+double clock::ns_per_cycle()
+{
+    pthread_once(&calibrate_once, calibrate);
+    return ns_per_cycle_;
+}
+
+bool clock::invariant_tsc()
+{
+#if defined(__i386__) || defined(__x86_64__)
+    unsigned int a, b, c, d;
+    __asm__ __volatile__("cpuid" : "=a"(a), "=b"(b), "=c"(c), "=d"(d) : "a"(0x80000000));
+    if(a < 0x80000007)
+        return false;
+    __asm__ __volatile__("cpuid" : "=a"(a), "=b"(b), "=c"(c), "=d"(d) : "a"(0x80000007));
+    return (d >> 8) & 1;
+#else
+    return false;
+#endif
+}
+
+/// @cond
+struct clock_ticker
+{
+    static void *run(void *)
+    {
+        const long period = ticker_period_us_;
+        while(__atomic_load_n(&ticker_running_, __ATOMIC_ACQUIRE)){
+            __atomic_store_n(&clock::cached_, clock::now_ns(), __ATOMIC_RELAXED);
+            usleep(period);
+        }
+        __atomic_store_n(&clock::cached_, 0ULL, __ATOMIC_RELAXED);
+        return 0;
+    }
+};
+/// @endcond
+
+bool clock::start_ticker(long period_us)
+{
+    mutex::scoped_lock sl(ticker_m);
+    if(ticker_running_)
+        return false;
+    ticker_period_us_ = period_us > 0 ? period_us : 1;
+    __atomic_store_n(&cached_, now_ns(), __ATOMIC_RELAXED);
+    __atomic_store_n(&ticker_running_, true, __ATOMIC_RELEASE);
+    if(pthread_create(&ticker_, 0, clock_ticker::run, 0)){
+        __atomic_store_n(&ticker_running_, false, __ATOMIC_RELEASE);
+        __atomic_store_n(&cached_, 0ULL, __ATOMIC_RELAXED);
+        return false;
+    }
+    return true;
+}
+
+void clock::stop_ticker()
+{
+    mutex::scoped_lock sl(ticker_m);
+    if(!ticker_running_)
+        return;
+    __atomic_store_n(&ticker_running_, false, __ATOMIC_RELEASE);
+    pthread_join(ticker_, 0);
+}
+
+} //namespace bloom
@@ -27,9 +27,14 @@
 namespace bloom
 {
 
-condition_variable::condition_variable()
+condition_variable::condition_variable(clock_type clock):
+clock_(clock)
 {
-    pthread_cond_init(&cv_, NULL);
+    pthread_condattr_t a;
+    pthread_condattr_init(&a);
+    pthread_condattr_setclock(&a, clock_);
+    pthread_cond_init(&cv_, &a);
+    pthread_condattr_destroy(&a);
 }
 
 condition_variable::~condition_variable()
@@ -40,41 +45,40 @@ condition_variable::~condition_variable()
 void condition_variable::wait(mutex& m, bool(*func)())
 {
     while(!(*func)())
-        pthread_cond_wait(&cv_, &m.mutex_);   
+        cond_wait(m);   
 }
 
 void condition_variable::wait(mutex& m)
 {
-    pthread_cond_wait(&cv_, &m.mutex_);   
+    cond_wait(m);   
 }
 
 void condition_variable::wait(mutex::scoped_lock& sl, bool(*func)())
 {
     while(!(*func)())
-        pthread_cond_wait(&cv_, &sl.m_.mutex_);   
+        cond_wait(sl.m_);   
 }
 
 void condition_variable::wait(mutex::scoped_lock& sl)
 {
-    pthread_cond_wait(&cv_, &sl.m_.mutex_);
+    cond_wait(sl.m_);
 }
 
 bool condition_variable::wait(mutex& m, bool(*func)(), long timeout_ms)
 {
     timespec ts;
     set_timeout(ts, timeout_ms);
-    if(!(*func)())
-        if(pthread_cond_timedwait(&cv_, &m.mutex_, &ts) == ETIMEDOUT ||
-                !(*func)())
-            return false;
-    return true;  
+    while(!(*func)())
+        if(cond_timedwait(m, ts) == ETIMEDOUT)
+            return (*func)();
+    return true;
 }
 
 bool condition_variable::wait(mutex& m, long timeout_ms)
 {
     timespec ts;
     set_timeout(ts, timeout_ms);
-    if(pthread_cond_timedwait(&cv_, &m.mutex_, &ts) == ETIMEDOUT)
+    if(cond_timedwait(m, ts) == ETIMEDOUT)
         return false;
     return true;
 }
@@ -83,10 +87,9 @@ bool condition_variable::wait(mutex::scoped_lock& sl, bool(*func)(), long timeou
 {
     timespec ts;
     set_timeout(ts, timeout_ms);
-    if(!(*func)())
-        if(pthread_cond_timedwait(&cv_, &sl.m_.mutex_, &ts) == ETIMEDOUT ||
-                !(*func)())
-            return false;
+    while(!(*func)())
+        if(cond_timedwait(sl.m_, ts) == ETIMEDOUT)
+            return (*func)();
     return true;
 }
 
@@ -94,7 +97,7 @@ bool condition_variable::wait(mutex::scoped_lock& sl, long timeout_ms)
 {
     timespec ts;
     set_timeout(ts, timeout_ms);
-    if(pthread_cond_timedwait(&cv_, &sl.m_.mutex_, &ts) == ETIMEDOUT)
+    if(cond_timedwait(sl.m_, ts) == ETIMEDOUT)
         return false;
     return true;
 }
@@ -111,9 +114,13 @@ void condition_variable::notify_all()
 
 void condition_variable::set_timeout(timespec& ts, long ms)
 {
-    clock_gettime(CLOCK_REALTIME, &ts);
+    clock_gettime(clock_, &ts);
     ts.tv_sec += ms / 1000;
     ts.tv_nsec += (ms % 1000) * 1000000;
+    if(ts.tv_nsec >= 1000000000){
+        ts.tv_nsec -= 1000000000;
+        ++ts.tv_sec;
+    }
 }
 
 }//namespace bloom
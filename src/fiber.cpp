@@ -0,0 +1,681 @@
+/* 
+ * Copyright © 2015 Sergei Khairulin <sergei.khairulin@gmail.com>. 
+ * All rights reserved.
+ *
+ * This file is part of Bloom++.
+ *
+ * Bloom++ is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Bloom++ is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Bloom++.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include <errno.h>
+#include <time.h>
+#include <unistd.h>
+#include <poll.h>
+#include <stdint.h>
+#include <sys/mman.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <vector>
+#include <algorithm>
+#include <bloom++/fiber.h>
+
+#if defined(LINUX) && defined(__x86_64__) && !defined(BLOOM_FIBER_UCONTEXT)
+#define BLOOM_FIBER_ASM
+#else
+#include <ucontext.h>
+#endif
+
+#ifdef BLOOM_FIBER_ASM
+/*
+ * Saves callee-saved registers, x87 control word and MXCSR on the current
+ * stack, stores the stack pointer to *from and switches to the stack to.
+ * A new fiber starts in the trampoline which calls the function in r13.
+ */
+extern "C" void bloom_fiber_switch(void **from, void *to);
+extern "C" void bloom_fiber_trampoline();
+
+asm(
+    ".text\n"
+    ".globl bloom_fiber_switch\n"
+    ".hidden bloom_fiber_switch\n"
+    ".type bloom_fiber_switch,@function\n"
+    "bloom_fiber_switch:\n"
+    "    pushq %rbp\n"
+    "    pushq %rbx\n"
+    "    pushq %r12\n"
+    "    pushq %r13\n"
+    "    pushq %r14\n"
+    "    pushq %r15\n"
+    "    subq $16, %rsp\n"
+    "    stmxcsr 8(%rsp)\n"
+    "    fnstcw (%rsp)\n"
+    "    movq %rsp, (%rdi)\n"
+    "    movq %rsi, %rsp\n"
+    "    fldcw (%rsp)\n"
+    "    ldmxcsr 8(%rsp)\n"
+    "    addq $16, %rsp\n"
+    "    popq %r15\n"
+    "    popq %r14\n"
+    "    popq %r13\n"
+    "    popq %r12\n"
+    "    popq %rbx\n"
+    "    popq %rbp\n"
+    "    ret\n"
+    ".size bloom_fiber_switch,.-bloom_fiber_switch\n"
+    ".globl bloom_fiber_trampoline\n"
+    ".hidden bloom_fiber_trampoline\n"
+    ".type bloom_fiber_trampoline,@function\n"
+    "bloom_fiber_trampoline:\n"
+    "    callq *%r13\n"
+    "    ud2\n"
+    ".size bloom_fiber_trampoline,.-bloom_fiber_trampoline\n"
+);
+#endif
+
+namespace bloom
+{
+
+namespace
+{
+
+__thread fiber *current_fiber_ = 0;
+__thread fiber_scheduler *current_scheduler_ = 0;
+
+unsigned long long now_ms()
+{
+    timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000ULL + ts.tv_nsec / 1000000;
+}
+
+/*
+ * Fibers waiting for one descriptor: the registration is EPOLLONESHOT
+ * with the union of their events and is armed while someone waits.
+ */
+struct fd_waiters
+{
+    fiber *reader;
+    fiber *writer;
+    unsigned int armed; // events of the armed registration, 0 if none
+    bool added;         // registered in the epoll set
+};
+
+struct timer_entry
+{
+    unsigned long long deadline;
+    fiber *f;
+    unsigned int seq;
+
+    bool operator<(const timer_entry &t) const {
+        return deadline > t.deadline; // min-heap
+    }
+};
+
+} //namespace
+
+/// @cond
+struct fiber_scheduler::impl
+{
+    size_t stackSize;
+    size_t cachedStacks;
+    size_t pageSize;
+#ifdef BLOOM_FIBER_ASM
+    void *mainSp;
+#else
+    ucontext_t mainCtx;
+#endif
+    fiber *readyHead;
+    fiber *readyTail;
+    spinlock remoteLock;
+    fiber *remoteHead;
+    fiber *remoteTail;
+    fiber *freeFibers;
+    std::vector<void*> stacks;
+    std::vector<timer_entry> timers;
+    size_t timersCompactAt;      // size at which stale timers are dropped
+    std::vector<fd_waiters> fds; // by descriptor
+    int epfd;
+    int evfd;
+    volatile int live;
+    volatile int stopping;
+
+    void push_ready(fiber *f)
+    {
+        f->next_ = 0;
+        if(readyTail)readyTail->next_ = f;
+        else readyHead = f;
+        readyTail = f;
+    }
+
+    void *alloc_stack()
+    {
+        if(!stacks.empty()){
+            void *s = stacks.back();
+            stacks.pop_back();
+            return s;
+        }
+        void *s = mmap(0, stackSize + pageSize, PROT_READ | PROT_WRITE,
+                       MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if(s == MAP_FAILED)
+            throw fiber_exception("fiber: out of memory for stack");
+        mprotect(s, pageSize, PROT_NONE); // guard page
+        return s;
+    }
+
+    void free_stack(void *s)
+    {
+        if(stacks.size() < cachedStacks)
+            stacks.push_back(s);
+        else
+            munmap(s, stackSize + pageSize);
+    }
+};
+/// @endcond
+
+//=======================================
+// fiber
+//=======================================
+
+fiber::fiber(fiber_scheduler *s):
+scheduler_(s),
+cfn_(0),
+arg_(0),
+sp_(0),
+stack_(0),
+stackSize_(0),
+state_(st_ready),
+waitSeq_(0),
+timedOut_(false),
+done_(false),
+next_(0),
+waitNext_(0)
+{
+#ifndef BLOOM_FIBER_ASM
+    sp_ = new ucontext_t;
+#endif
+}
+
+fiber::~fiber()
+{
+#ifndef BLOOM_FIBER_ASM
+    delete static_cast<ucontext_t*>(sp_);
+#endif
+}
+
+fiber *fiber::current()
+{
+    return current_fiber_;
+}
+
+void fiber::yield()
+{
+    fiber *f = current_fiber_;
+    if(!f){
+        sched_yield();
+        return;
+    }
+    f->state_ = st_ready;
+    f->scheduler_->impl_->push_ready(f);
+    f->scheduler_->switch_out(f);
+}
+
+void fiber::sleep(long ms)
+{
+    fiber *f = current_fiber_;
+    if(!f){
+        timespec ts = {ms / 1000, (ms % 1000) * 1000000};
+        while(nanosleep(&ts, &ts) && errno == EINTR);
+        return;
+    }
+    f->prepare_wait();
+    f->wait(ms);
+}
+
+bool fiber::wait_fd(int fd, int ev, long timeout_ms)
+{
+    fiber *f = current_fiber_;
+    if(f)
+        return f->scheduler_->wait_fd(f, fd, ev, timeout_ms);
+    pollfd p;
+    p.fd = fd;
+    p.events = ((ev & io_read) ? POLLIN : 0) | ((ev & io_write) ? POLLOUT : 0);
+    p.revents = 0;
+    int r;
+    while((r = ::poll(&p, 1, timeout_ms)) < 0 && errno == EINTR);
+    return r > 0;
+}
+
+void fiber::prepare_wait()
+{
+    timedOut_ = false;
+    ++waitSeq_;
+    __atomic_store_n(&state_, st_waiting, __ATOMIC_SEQ_CST);
+}
+
+bool fiber::wait(long timeout_ms)
+{
+    if(timeout_ms >= 0)
+        scheduler_->add_timer(this, timeout_ms);
+    scheduler_->switch_out(this);
+    return !timedOut_;
+}
+
+bool fiber::wake()
+{
+    int expected = st_waiting;
+    if(!__atomic_compare_exchange_n(&state_, &expected, st_ready, false,
+                                    __ATOMIC_SEQ_CST, __ATOMIC_RELAXED))
+        return false;
+    scheduler_->schedule(this);
+    return true;
+}
+
+//=======================================
+// fiber_scheduler
+//=======================================
+
+fiber_scheduler::fiber_scheduler(size_t stack_size, size_t cached_stacks):
+impl_(new impl)
+{
+    impl_->pageSize = sysconf(_SC_PAGESIZE);
+    impl_->stackSize = (stack_size + impl_->pageSize - 1) & ~(impl_->pageSize - 1);
+    impl_->cachedStacks = cached_stacks;
+    impl_->readyHead = impl_->readyTail = 0;
+    impl_->remoteHead = impl_->remoteTail = 0;
+    impl_->freeFibers = 0;
+    impl_->timersCompactAt = 64;
+    impl_->live = 0;
+    impl_->stopping = 0;
+    impl_->epfd = epoll_create1(EPOLL_CLOEXEC);
+    impl_->evfd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if(impl_->epfd < 0 || impl_->evfd < 0){
+        if(impl_->epfd >= 0)::close(impl_->epfd);
+        if(impl_->evfd >= 0)::close(impl_->evfd);
+        delete impl_;
+        throw fiber_exception("fiber_scheduler: epoll/eventfd failed");
+    }
+    epoll_event e;
+    e.events = EPOLLIN;
+    e.data.fd = impl_->evfd;
+    epoll_ctl(impl_->epfd, EPOLL_CTL_ADD, impl_->evfd, &e);
+}
+
+fiber_scheduler::~fiber_scheduler()
+{
+    // fibers which haven't finished are abandoned with their stacks
+    while(impl_->freeFibers){
+        fiber *f = impl_->freeFibers;
+        impl_->freeFibers = f->next_;
+        delete f;
+    }
+    for(size_t i = 0; i < impl_->stacks.size(); ++i)
+        munmap(impl_->stacks[i], impl_->stackSize + impl_->pageSize);
+    ::close(impl_->epfd);
+    ::close(impl_->evfd);
+    delete impl_;
+}
+
+fiber_scheduler *fiber_scheduler::current()
+{
+    return current_scheduler_;
+}
+
+fiber *fiber_scheduler::create()
+{
+    if(current_scheduler_ != this || !impl_->freeFibers)
+        return new fiber(this);
+    fiber *f = impl_->freeFibers;
+    impl_->freeFibers = f->next_;
+    f->done_ = false;
+    f->state_ = fiber::st_ready;
+    return f;
+}
+
+void fiber_scheduler::spawn(void (*fn)(void *), void *arg)
+{
+    fiber *f = create();
+    f->fn_.reset();
+    f->cfn_ = fn;
+    f->arg_ = arg;
+    __atomic_fetch_add(&impl_->live, 1, __ATOMIC_SEQ_CST);
+    schedule(f);
+}
+
+void fiber_scheduler::spawn(const delegate0<void> &fn)
+{
+    fiber *f = create();
+    f->fn_ = fn;
+    f->cfn_ = 0;
+    __atomic_fetch_add(&impl_->live, 1, __ATOMIC_SEQ_CST);
+    schedule(f);
+}
+
+void fiber_scheduler::stop()
+{
+    __atomic_store_n(&impl_->stopping, 1, __ATOMIC_SEQ_CST);
+    uint64_t one = 1;
+    if(::write(impl_->evfd, &one, sizeof(one)) < 0){}
+}
+
+size_t fiber_scheduler::size() const
+{
+    return __atomic_load_n(&impl_->live, __ATOMIC_RELAXED);
+}
+
+void fiber_scheduler::schedule(fiber *f)
+{
+    if(current_scheduler_ == this){
+        impl_->push_ready(f);
+        return;
+    }
+    bool first;
+    {
+        spinlock::scoped_lock sl(impl_->remoteLock);
+        f->next_ = 0;
+        first = !impl_->remoteHead;
+        if(impl_->remoteTail)impl_->remoteTail->next_ = f;
+        else __atomic_store_n(&impl_->remoteHead, f, __ATOMIC_RELEASE);
+        impl_->remoteTail = f;
+    }
+    if(first){
+        uint64_t one = 1;
+        if(::write(impl_->evfd, &one, sizeof(one)) < 0){}
+    }
+}
+
+void fiber_scheduler::entry()
+{
+    fiber *f = current_fiber_;
+    try{
+        if(f->cfn_)
+            f->cfn_(f->arg_);
+        else
+            f->fn_();
+    }
+    catch(...){
+        // nothing above the fiber's stack can handle it, the fiber
+        // just finishes
+    }
+    f->done_ = true;
+    f->scheduler_->switch_out(f);
+}
+
+void fiber_scheduler::resume(fiber *f)
+{
+    if(!f->stack_){
+        f->stack_ = impl_->alloc_stack();
+        f->stackSize_ = impl_->stackSize;
+        char *top = static_cast<char*>(f->stack_) + impl_->pageSize + impl_->stackSize;
+#ifdef BLOOM_FIBER_ASM
+        // frame popped by bloom_fiber_switch, ret goes to the trampoline
+        // with the stack aligned for the call
+        void **sp = reinterpret_cast<void**>(top - 24);
+        *sp = reinterpret_cast<void*>(&bloom_fiber_trampoline);
+        *--sp = 0;                                      // rbp
+        *--sp = 0;                                      // rbx
+        *--sp = 0;                                      // r12
+        *--sp = reinterpret_cast<void*>(&entry);        // r13
+        *--sp = 0;                                      // r14
+        *--sp = 0;                                      // r15
+        sp -= 2;
+        unsigned int *fpu = reinterpret_cast<unsigned int*>(sp);
+        fpu[0] = 0x037F;                                // x87 control word
+        fpu[1] = 0;
+        fpu[2] = 0x1F80;                                // MXCSR
+        fpu[3] = 0;
+        f->sp_ = sp;
+#else
+        ucontext_t *uc = static_cast<ucontext_t*>(f->sp_);
+        getcontext(uc);
+        uc->uc_stack.ss_sp = static_cast<char*>(f->stack_) + impl_->pageSize;
+        uc->uc_stack.ss_size = impl_->stackSize;
+        uc->uc_link = 0;
+        makecontext(uc, &entry, 0);
+#endif
+    }
+    f->state_ = fiber::st_running;
+    current_fiber_ = f;
+#ifdef BLOOM_FIBER_ASM
+    bloom_fiber_switch(&impl_->mainSp, f->sp_);
+#else
+    swapcontext(&impl_->mainCtx, static_cast<ucontext_t*>(f->sp_));
+#endif
+    current_fiber_ = 0;
+    if(f->done_)
+        finish(f);
+}
+
+void fiber_scheduler::switch_out(fiber *f)
+{
+#ifdef BLOOM_FIBER_ASM
+    bloom_fiber_switch(&f->sp_, impl_->mainSp);
+#else
+    swapcontext(static_cast<ucontext_t*>(f->sp_), &impl_->mainCtx);
+#endif
+}
+
+void fiber_scheduler::finish(fiber *f)
+{
+    impl_->free_stack(f->stack_);
+    f->stack_ = 0;
+    f->fn_.reset();
+    f->state_ = fiber::st_running; // stale timers and wakes fail
+    f->next_ = impl_->freeFibers;
+    impl_->freeFibers = f;
+    __atomic_fetch_sub(&impl_->live, 1, __ATOMIC_SEQ_CST);
+}
+
+void fiber_scheduler::add_timer(fiber *f, long timeout_ms)
+{
+    timer_entry t;
+    t.deadline = now_ms() + timeout_ms;
+    t.f = f;
+    t.seq = f->waitSeq_;
+    std::vector<timer_entry> &timers = impl_->timers;
+    if(timers.size() >= impl_->timersCompactAt){
+        // timers of waits ended by i/o or wake() stay until they expire,
+        // they are dropped when the heap doubles
+        size_t n = 0;
+        for(size_t i = 0; i < timers.size(); ++i)
+            if(!wait_ended(timers[i].f, timers[i].seq))
+                timers[n++] = timers[i];
+        timers.resize(n);
+        std::make_heap(timers.begin(), timers.end());
+        impl_->timersCompactAt = std::max<size_t>(64, timers.size() * 2);
+    }
+    timers.push_back(t);
+    std::push_heap(timers.begin(), timers.end());
+}
+
+bool fiber_scheduler::wait_ended(fiber *f, unsigned int seq)
+{
+    // woken early or waiting again
+    return f->waitSeq_ != seq ||
+           __atomic_load_n(&f->state_, __ATOMIC_ACQUIRE) != fiber::st_waiting;
+}
+
+void fiber_scheduler::drop_stale_timers()
+{
+    std::vector<timer_entry> &timers = impl_->timers;
+    while(!timers.empty() && wait_ended(timers.front().f, timers.front().seq)){
+        std::pop_heap(timers.begin(), timers.end());
+        timers.pop_back();
+    }
+}
+
+namespace
+{
+
+const unsigned int read_events = EPOLLIN | EPOLLRDHUP;
+const unsigned int write_events = EPOLLOUT;
+const unsigned int error_events = EPOLLERR | EPOLLHUP;
+
+} //namespace
+
+bool fiber_scheduler::arm_fd(int fd)
+{
+    fd_waiters &w = impl_->fds[fd];
+    const unsigned int events = (w.reader ? read_events : 0) |
+                                (w.writer ? write_events : 0);
+    if(!events || events == w.armed)
+        return true;
+    epoll_event e;
+    e.events = events | EPOLLONESHOT;
+    e.data.fd = fd;
+    // a closed descriptor leaves the set, the number may be reused
+    if(!w.added || epoll_ctl(impl_->epfd, EPOLL_CTL_MOD, fd, &e)){
+        if(epoll_ctl(impl_->epfd, EPOLL_CTL_ADD, fd, &e))
+            return false;
+        w.added = true;
+    }
+    w.armed = events;
+    return true;
+}
+
+void fiber_scheduler::fd_ready(int fd, unsigned int events)
+{
+    if((size_t)fd >= impl_->fds.size())
+        return;
+    fd_waiters &w = impl_->fds[fd];
+    w.armed = 0; // one-shot
+    fiber *r = (events & (read_events | error_events)) ? w.reader : 0;
+    fiber *wr = (events & (write_events | error_events)) ? w.writer : 0;
+    if(r){
+        w.reader = 0;
+        if(w.writer == r)
+            w.writer = 0; // waits for both
+        r->wake();
+    }
+    if(wr && wr != r){
+        w.writer = 0;
+        wr->wake();
+    }
+    arm_fd(fd); // the other direction still waits
+}
+
+bool fiber_scheduler::wait_fd(fiber *f, int fd, int ev, long timeout_ms)
+{
+    if(fd < 0)
+        return true;
+    if((size_t)fd >= impl_->fds.size()){
+        fd_waiters none = {0, 0, 0, false};
+        impl_->fds.resize(fd + 1, none);
+    }
+    fd_waiters &w = impl_->fds[fd];
+    if(((ev & fiber::io_read) && w.reader) || ((ev & fiber::io_write) && w.writer))
+        throw fiber_exception("fiber::wait_fd: another fiber waits for the same event");
+    if(ev & fiber::io_read)
+        w.reader = f;
+    if(ev & fiber::io_write)
+        w.writer = f;
+    f->prepare_wait();
+    bool r = true;
+    if(arm_fd(fd))
+        r = f->wait(timeout_ms);
+    else
+        f->state_ = fiber::st_running; // not pollable, let the caller do the i/o
+    // timeout or not pollable, the registration may stay armed
+    fd_waiters &fw = impl_->fds[fd];
+    if(fw.reader == f)
+        fw.reader = 0;
+    if(fw.writer == f)
+        fw.writer = 0;
+    return r;
+}
+
+void fiber_scheduler::run()
+{
+    if(current_scheduler_ || current_fiber_)
+        throw fiber_exception("fiber_scheduler::run: already running on this thread");
+    current_scheduler_ = this;
+    const int max_events = 256;
+    epoll_event events[max_events];
+    unsigned int busyRounds = 0;
+
+    while(!__atomic_load_n(&impl_->stopping, __ATOMIC_ACQUIRE)){
+        // fibers scheduled from other threads
+        fiber *remote = 0;
+        if(__atomic_load_n(&impl_->remoteHead, __ATOMIC_ACQUIRE)){
+            spinlock::scoped_lock sl(impl_->remoteLock);
+            remote = impl_->remoteHead;
+            __atomic_store_n(&impl_->remoteHead, (fiber*)0, __ATOMIC_RELAXED);
+            impl_->remoteTail = 0;
+        }
+        while(remote){
+            fiber *next = remote->next_;
+            impl_->push_ready(remote);
+            remote = next;
+        }
+
+        // one round, fibers made ready by it run in the next one
+        fiber *f = impl_->readyHead;
+        impl_->readyHead = impl_->readyTail = 0;
+        while(f){
+            fiber *next = f->next_;
+            resume(f);
+            f = next;
+        }
+
+        if(!__atomic_load_n(&impl_->live, __ATOMIC_ACQUIRE))
+            break;
+
+        // while fibers are ready i/o is polled every 64 rounds
+        int timeout = -1;
+        if(impl_->readyHead){
+            if(++busyRounds & 63)
+                continue;
+            timeout = 0;
+        }
+        else {
+            drop_stale_timers();
+            if(!impl_->timers.empty()){
+                const unsigned long long now = now_ms();
+                const unsigned long long d = impl_->timers.front().deadline;
+                timeout = d > now ? static_cast<int>(d - now) : 0;
+            }
+        }
+
+        const int n = epoll_wait(impl_->epfd, events, max_events, timeout);
+        for(int i = 0; i < n; ++i){
+            if(events[i].data.fd != impl_->evfd)
+                fd_ready(events[i].data.fd, events[i].events);
+            else {
+                uint64_t v;
+                if(::read(impl_->evfd, &v, sizeof(v)) < 0){}
+            }
+        }
+
+        if(!impl_->timers.empty()){
+            const unsigned long long now = now_ms();
+            while(!impl_->timers.empty() && impl_->timers.front().deadline <= now){
+                timer_entry t = impl_->timers.front();
+                std::pop_heap(impl_->timers.begin(), impl_->timers.end());
+                impl_->timers.pop_back();
+                int expected = fiber::st_waiting;
+                if(t.f->waitSeq_ == t.seq &&
+                   __atomic_compare_exchange_n(&t.f->state_, &expected, fiber::st_ready,
+                                               false, __ATOMIC_SEQ_CST, __ATOMIC_RELAXED)){
+                    t.f->timedOut_ = true;
+                    impl_->push_ready(t.f);
+                }
+            }
+        }
+    }
+    __atomic_store_n(&impl_->stopping, 0, __ATOMIC_RELEASE);
+    current_scheduler_ = 0;
+}
+
+} //namespace bloom
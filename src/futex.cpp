@@ -0,0 +1,101 @@
+/* 
+ * Copyright © 2015 Sergei Khairulin <sergei.khairulin@gmail.com>. 
+ * All rights reserved.
+ *
+ * This file is part of Bloom++.
+ *
+ * Bloom++ is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Bloom++ is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Bloom++.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <errno.h>
+#include <limits.h>
+#include <sched.h>
+#ifdef LINUX
+#include <unistd.h>
+#include <sys/syscall.h>
+#include <linux/futex.h>
+#endif
+#include <bloom++/_bits/futex.h>
+
+namespace bloom
+{
+
+void monotonic_deadline(timespec &ts, long ms)
+{
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    if(ms < 0)
+        ms = 0;
+    ts.tv_sec += ms / 1000;
+    ts.tv_nsec += (ms % 1000) * 1000000;
+    if(ts.tv_nsec >= 1000000000){
+        ts.tv_nsec -= 1000000000;
+        ++ts.tv_sec;
+    }
+}
+
+namespace
+{
+
+bool passed(const timespec *deadline)
+{
+    if(!deadline)
+        return false;
+    timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec > deadline->tv_sec ||
+           (now.tv_sec == deadline->tv_sec && now.tv_nsec >= deadline->tv_nsec);
+}
+
+} //namespace
+
+#ifdef LINUX
+
+bool futex_wait(volatile int *addr, int val, const timespec *deadline)
+{
+    // FUTEX_WAIT_BITSET takes an absolute CLOCK_MONOTONIC timeout
+    if(syscall(SYS_futex, addr, FUTEX_WAIT_BITSET | FUTEX_PRIVATE_FLAG,
+               val, deadline, 0, FUTEX_BITSET_MATCH_ANY) == -1 &&
+       errno == ETIMEDOUT)
+        return false;
+    return !passed(deadline);
+}
+
+void futex_wake(volatile int *addr, int n)
+{
+    syscall(SYS_futex, addr, FUTEX_WAKE | FUTEX_PRIVATE_FLAG, n, 0, 0, 0);
+}
+
+#else
+
+bool futex_wait(volatile int *addr, int val, const timespec *deadline)
+{
+    // no futex: spurious wakeup after yielding
+    if(__atomic_load_n(addr, __ATOMIC_ACQUIRE) == val)
+        sched_yield();
+    return !passed(deadline);
+}
+
+void futex_wake(volatile int *, int)
+{
+}
+
+#endif
+
+void futex_wake_all(volatile int *addr)
+{
+    futex_wake(addr, INT_MAX);
+}
+
+} //namespace bloom
@@ -0,0 +1,191 @@
+/* 
+ * Copyright © 2015 Sergei Khairulin <sergei.khairulin@gmail.com>. 
+ * All rights reserved.
+ *
+ * This file is part of Bloom++.
+ *
+ * Bloom++ is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Bloom++ is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Bloom++.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <exception>
+#include <bloom++/future.h>
+#include <bloom++/thread_pool.h>
+
+namespace bloom
+{
+
+future_state_base::future_state_base(executor *ex):
+refs_(0),
+ready_(false),
+failed_(false),
+executor_(ex),
+callbacks_(0)
+{
+    m_.set_name("future_state");
+}
+
+future_state_base::~future_state_base()
+{
+}
+
+void future_state_base::wait()
+{
+    if(is_ready())
+        return;
+    thread_pool *pool = thread_pool::current();
+    if(pool){
+        // the result may be computed by a task of the worker's own
+        // deque; tasks of others aren't run, they may be loops of
+        // servers which never return
+        while(!is_ready()){
+            if(!pool->run_own()){
+                mutex::scoped_lock sl(m_);
+                if(!ready_)
+                    cv_.wait(sl, 1);
+            }
+        }
+        return;
+    }
+    mutex::scoped_lock sl(m_);
+    while(!ready_)
+        cv_.wait(sl);
+}
+
+bool future_state_base::wait(long timeout_ms)
+{
+    if(is_ready())
+        return true;
+    mutex::scoped_lock sl(m_);
+    if(!ready_)
+        cv_.wait(sl, timeout_ms);
+    return ready_;
+}
+
+void future_state_base::set_exception()
+{
+    try{
+        throw;
+    }
+    catch(exception &e){
+        set_exception(string(e.what()));
+    }
+    catch(std::exception &e){
+        set_exception(string(e.what()));
+    }
+    catch(...){
+        set_exception(string("unknown exception"));
+    }
+}
+
+void future_state_base::set_exception(const string &msg)
+{
+    check_not_ready();
+    // strings aren't thread safe, the state gets own copy
+    error_ = string(msg.c_str());
+    failed_ = true;
+    set_ready();
+}
+
+void future_state_base::copy_exception(const future_state_base &state)
+{
+    set_exception(state.error_);
+}
+
+void future_state_base::rethrow() const
+{
+    throw future_error(string(error_.c_str()));
+}
+
+void future_state_base::check_not_ready() const
+{
+    if(is_ready())
+        throw future_error("result is already set");
+}
+
+void future_state_base::add_callback(future_callback *cb)
+{
+    {
+        mutex::scoped_lock sl(m_);
+        if(!ready_){
+            cb->next_ = callbacks_;
+            callbacks_ = cb;
+            return;
+        }
+    }
+    cb->ready(this);
+}
+
+void future_state_base::set_ready()
+{
+    future_callback *cb;
+    add_ref(); // callbacks may release the last reference
+    {
+        mutex::scoped_lock sl(m_);
+        __atomic_store_n(&ready_, true, __ATOMIC_RELEASE);
+        cb = callbacks_;
+        callbacks_ = 0;
+        cv_.notify_all();
+    }
+    // callbacks are called in the order of adding
+    future_callback *prev = 0;
+    while(cb){
+        future_callback *next = cb->next_;
+        cb->next_ = prev;
+        prev = cb;
+        cb = next;
+    }
+    while(prev){
+        future_callback *next = prev->next_;
+        prev->ready(this);
+        prev = next;
+    }
+    release();
+}
+
+when_all_counter::when_all_counter(size_t count):
+state_(new future_state<void>(0)),
+count_(count + 1),
+failed_(0)
+{
+    state_->add_ref();
+}
+
+when_all_counter::~when_all_counter()
+{
+    state_->release();
+}
+
+void when_all_counter::fail(const char *msg)
+{
+    if(__sync_bool_compare_and_swap(&failed_, 0, 1))
+        error_ = msg;
+    ready(0);
+}
+
+void when_all_counter::ready(future_state_base *state)
+{
+    // the message is copied, strings aren't thread safe
+    if(state && state->failed() && __sync_bool_compare_and_swap(&failed_, 0, 1))
+        error_ = state->error();
+    if(__sync_sub_and_fetch(&count_, 1))
+        return;
+    if(failed_)
+        state_->set_exception(error_);
+    else
+        state_->set_value();
+    delete this;
+}
+
+}//namespace bloom
@@ -42,6 +42,8 @@ maxSize_(0),
 minSize_(0),
 logThread_(&log::logThread, this)
 {
+    listMutex_.set_name("log::list");
+    fileMutex_.set_name("log::file");
     logThread_.start();
 }
 
@@ -52,6 +54,12 @@ log::~log()
     if(file_.is_open())close();
 }
 
+int log::set_thread_attributes(const thread_attributes &attr)
+{
+    logThread_.set_attributes(attr);
+    return attr.apply(logThread_.native_handle());
+}
+
 bool log::open(string filename, size_t max_size)
 {
     mutex::scoped_lock sl(fileMutex_);
@@ -108,8 +116,7 @@ string log::pf(const char *format, ...)
 {
     va_list args;
     va_start (args, format);
-    char msg[256];
-    vsnprintf(msg, 256, format, args);
+    string msg = vformatf(format, args);
     va_end(args);
     return msg;
 }
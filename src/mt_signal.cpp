@@ -0,0 +1,115 @@
+/* 
+ * Copyright © 2015 Sergei Khairulin <sergei.khairulin@gmail.com>. 
+ * All rights reserved.
+ *
+ * This file is part of Bloom++.
+ *
+ * Bloom++ is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Bloom++ is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Bloom++.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include <bloom++/mt_signal.h>
+
+namespace bloom
+{
+
+bool signal_connection::disconnect()
+{
+    if(!signal_)return false;
+    const bool r = signal_->disconnect(id_);
+    signal_ = 0;
+    return r;
+}
+
+bool signal_connection::connected() const
+{
+    return signal_ && signal_->connected(id_);
+}
+
+namespace _bits {
+
+mt_signal_base::mt_signal_base():
+slots_(0),
+retired_(0),
+draining_(0),
+flips_(0),
+lastId_(0),
+epoch_(0)
+{
+    readers_[0] = readers_[1] = 0;
+    mutex_.set_name("mt_signal");
+}
+
+namespace
+{
+
+void free_arrays(slot_array_base *a)
+{
+    while(a){
+        slot_array_base *next = a->retired_next;
+        delete a;
+        a = next;
+    }
+}
+
+} //namespace
+
+mt_signal_base::~mt_signal_base()
+{
+    delete slots_;
+    free_arrays(retired_);
+    free_arrays(draining_);
+}
+
+void mt_signal_base::publish(slot_array_base *slots)
+{
+    slot_array_base *old = slots_;
+    __atomic_store_n(&slots_, slots, __ATOMIC_SEQ_CST);
+    if(old){
+        old->retired_next = retired_;
+        retired_ = old;
+    }
+    reclaim();
+}
+
+void mt_signal_base::reclaim()
+{
+    // Two flips: readers of any draining array have registered in one
+    // of the counters before it was drained. A counter still in use
+    // is checked again by the next writer, nobody waits for emissions.
+    for(;;){
+        if(!draining_){
+            if(!retired_)
+                return;
+            draining_ = retired_;
+            retired_ = 0;
+            flips_ = 0;
+            __atomic_fetch_add(&epoch_, 1, __ATOMIC_SEQ_CST);
+        }
+        const unsigned int e = __atomic_load_n(&epoch_, __ATOMIC_SEQ_CST) - 1;
+        if(__atomic_load_n(&readers_[e & 1], __ATOMIC_ACQUIRE))
+            return;
+        if(++flips_ < 2){
+            __atomic_fetch_add(&epoch_, 1, __ATOMIC_SEQ_CST);
+            continue;
+        }
+        free_arrays(draining_);
+        draining_ = 0;
+    }
+}
+
+} //namespace _bits
+
+} //namespace bloom
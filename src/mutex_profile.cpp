@@ -0,0 +1,277 @@
+/* 
+ * Copyright © 2015 Sergei Khairulin <sergei.khairulin@gmail.com>. 
+ * All rights reserved.
+ *
+ * This file is part of Bloom++.
+ *
+ * Bloom++ is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Bloom++ is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Bloom++.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <pthread.h>
+#include <unistd.h>
+#include <sys/syscall.h>
+#include <algorithm>
+#include <vector>
+#include <bloom++/mutex_profile.h>
+#include <bloom++/spinlock.h>
+
+namespace bloom
+{
+
+/// @cond
+struct mutex_profile_site
+{
+    char *name;
+    mutex_profile_site *next;
+    
+    unsigned long long acquisitions;
+    unsigned long long contended;
+    unsigned long long wait_ns;
+    unsigned long long max_wait_ns;
+    unsigned long long hold_ns;
+    unsigned long long max_hold_ns;
+    unsigned long long wait_hist[mutex_profile::histogram_size];
+    unsigned long long hold_hist[mutex_profile::histogram_size];
+    
+    spinlock holder_lock;
+    long max_holder_tid;
+    char max_holder_name[16];
+};
+/// @endcond
+
+namespace
+{
+
+pthread_mutex_t sites_m = PTHREAD_MUTEX_INITIALIZER;
+mutex_profile_site *sites = 0;
+mutex_profile_site *unnamed = 0;
+
+inline unsigned int bucket(unsigned long long ns)
+{
+    if(!ns)
+        return 0;
+    const unsigned int b = 64 - __builtin_clzll(ns);
+    return b < mutex_profile::histogram_size ? b : mutex_profile::histogram_size - 1;
+}
+
+inline void add(unsigned long long *v, unsigned long long x)
+{
+    __atomic_fetch_add(v, x, __ATOMIC_RELAXED);
+}
+
+inline unsigned long long load(const unsigned long long *v)
+{
+    return __atomic_load_n(v, __ATOMIC_RELAXED);
+}
+
+inline bool update_max(unsigned long long *v, unsigned long long x)
+{
+    unsigned long long cur = load(v);
+    while(x > cur)
+        if(__atomic_compare_exchange_n(v, &cur, x, true,
+                                       __ATOMIC_RELAXED, __ATOMIC_RELAXED))
+            return true;
+    return false;
+}
+
+inline void store(unsigned long long *v, unsigned long long x)
+{
+    __atomic_store_n(v, x, __ATOMIC_RELAXED);
+}
+
+void clear(mutex_profile_site *s)
+{
+    store(&s->acquisitions, 0);
+    store(&s->contended, 0);
+    store(&s->wait_ns, 0);
+    store(&s->max_wait_ns, 0);
+    store(&s->hold_ns, 0);
+    store(&s->max_hold_ns, 0);
+    for(unsigned int i = 0; i < mutex_profile::histogram_size; ++i){
+        store(&s->wait_hist[i], 0);
+        store(&s->hold_hist[i], 0);
+    }
+    s->max_holder_tid = 0;
+    s->max_holder_name[0] = 0;
+}
+
+bool more_wait(const mutex_profile_site *a, const mutex_profile_site *b)
+{
+    return load(&a->wait_ns) > load(&b->wait_ns);
+}
+
+void out_str(string &o, const char *s)
+{
+    o += '"';
+    for(; *s; ++s){
+        char buf[8];
+        if(*s == '"' || *s == '\\'){
+            o += '\\';
+            o += *s;
+        }
+        else if((unsigned char)*s < 0x20){
+            snprintf(buf, sizeof(buf), "\\u%04x", (unsigned char)*s);
+            o += buf;
+        }
+        else
+            o += *s;
+    }
+    o += '"';
+}
+
+void out_num(string &o, const char *name, unsigned long long v)
+{
+    char buf[64];
+    snprintf(buf, sizeof(buf), ",\"%s\":%llu", name, v);
+    o += buf;
+}
+
+void out_hist(string &o, const char *name, const unsigned long long *h)
+{
+    unsigned int n = mutex_profile::histogram_size;
+    while(n && !load(&h[n - 1]))
+        --n;
+    o += ",\"";
+    o += name;
+    o += "\":[";
+    for(unsigned int i = 0; i < n; ++i){
+        char buf[32];
+        snprintf(buf, sizeof(buf), i ? ",%llu" : "%llu", load(&h[i]));
+        o += buf;
+    }
+    o += ']';
+}
+
+} //namespace
+
+bool mutex_profile::enabled()
+{
+#ifdef BLOOM_MUTEX_PROFILE
+    return true;
+#else
+    return false;
+#endif
+}
+
+mutex_profile_site *mutex_profile::site(const char *name)
+{
+    if(!name){
+        // every unnamed mutex gets here from the constructor
+        mutex_profile_site *s = __atomic_load_n(&unnamed, __ATOMIC_ACQUIRE);
+        if(s)
+            return s;
+        s = site("unnamed");
+        __atomic_store_n(&unnamed, s, __ATOMIC_RELEASE);
+        return s;
+    }
+    pthread_mutex_lock(&sites_m);
+    mutex_profile_site *s = sites;
+    while(s && strcmp(s->name, name))
+        s = s->next;
+    if(!s){
+        s = new mutex_profile_site;
+        s->name = strdup(name);
+        clear(s);
+        s->next = sites;
+        sites = s;
+    }
+    pthread_mutex_unlock(&sites_m);
+    return s;
+}
+
+unsigned long long mutex_profile::now()
+{
+    timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (unsigned long long)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+void mutex_profile::acquired(mutex_profile_site *s, unsigned long long wait_ns, bool contended)
+{
+    add(&s->acquisitions, 1);
+    add(&s->wait_hist[bucket(wait_ns)], 1);
+    if(contended){
+        add(&s->contended, 1);
+        add(&s->wait_ns, wait_ns);
+        update_max(&s->max_wait_ns, wait_ns);
+    }
+}
+
+void mutex_profile::released(mutex_profile_site *s, unsigned long long hold_ns)
+{
+    add(&s->hold_ns, hold_ns);
+    add(&s->hold_hist[bucket(hold_ns)], 1);
+    if(hold_ns > load(&s->max_hold_ns)){
+        spinlock::scoped_lock sl(s->holder_lock);
+        if(update_max(&s->max_hold_ns, hold_ns)){
+            s->max_holder_tid = syscall(SYS_gettid);
+            s->max_holder_name[0] = 0;
+#ifdef LINUX
+            pthread_getname_np(pthread_self(), s->max_holder_name,
+                               sizeof(s->max_holder_name));
+#endif
+        }
+    }
+}
+
+string mutex_profile::report_json()
+{
+    std::vector<mutex_profile_site*> v;
+    pthread_mutex_lock(&sites_m);
+    for(mutex_profile_site *s = sites; s; s = s->next)
+        v.push_back(s);
+    pthread_mutex_unlock(&sites_m);
+    std::stable_sort(v.begin(), v.end(), more_wait);
+    
+    string o("[");
+    for(size_t i = 0; i < v.size(); ++i){
+        mutex_profile_site *s = v[i];
+        o += i ? ",{\"name\":" : "{\"name\":";
+        out_str(o, s->name);
+        out_num(o, "acquisitions", load(&s->acquisitions));
+        out_num(o, "contended", load(&s->contended));
+        out_num(o, "wait_ns", load(&s->wait_ns));
+        out_num(o, "max_wait_ns", load(&s->max_wait_ns));
+        out_num(o, "hold_ns", load(&s->hold_ns));
+        out_num(o, "max_hold_ns", load(&s->max_hold_ns));
+        {
+            spinlock::scoped_lock sl(s->holder_lock);
+            out_num(o, "max_holder_tid", s->max_holder_tid);
+            o += ",\"max_holder_name\":";
+            out_str(o, s->max_holder_name);
+        }
+        out_hist(o, "wait_histogram", s->wait_hist);
+        out_hist(o, "hold_histogram", s->hold_hist);
+        o += '}';
+    }
+    o += ']';
+    return o;
+}
+
+void mutex_profile::reset()
+{
+    pthread_mutex_lock(&sites_m);
+    for(mutex_profile_site *s = sites; s; s = s->next){
+        spinlock::scoped_lock sl(s->holder_lock);
+        clear(s);
+    }
+    pthread_mutex_unlock(&sites_m);
+}
+
+} //namespace bloom
@@ -52,6 +52,7 @@ typedef struct ip_mreq
 #endif
 
 #include <bloom++/net/socket_base.h>
+#include <bloom++/fiber.h>
 
 
 #ifdef NET_DEBUG
@@ -229,9 +230,40 @@ int socket_base::bind__(const addr_ipv4 &addr)
     return sock_OK;
 }
 
+#ifdef LINUX
+/*
+ * In fibers sockets are used without blocking, the fiber is suspended
+ * until the socket is ready.
+ */
+static inline bool would_block()
+{
+    return errno == EAGAIN || errno == EWOULDBLOCK;
+}
+#endif
+
 size_t socket_base::send(const char * data, size_t len)
 {
-    int sendRet = ::send(sd_, data, len, 0);
+    int sendRet;
+#ifdef LINUX
+    if(fiber::current()){
+        // all data is sent like by the blocking call
+        size_t sent = 0;
+        while(sent < len){
+            // a socket shut down to wake the fiber fails with EPIPE
+            sendRet = ::send(sd_, data + sent, len - sent, MSG_DONTWAIT | MSG_NOSIGNAL);
+            if(sendRet >= 0)
+                sent += sendRet;
+            else if(would_block())
+                fiber::wait_fd(sd_, fiber::io_write);
+            else if(errno != EINTR)
+                break;
+        }
+        if(sent == len)
+            sendRet = len;
+    }
+    else
+#endif
+        sendRet = ::send(sd_, data, len, 0);
     if (sendRet == -1){
         DEBUG_WARN("send error...\n");
         return sock_ERROR;
@@ -241,7 +273,15 @@ size_t socket_base::send(const char * data, size_t len)
 
 size_t socket_base::sendto(const addr_ipv4 &dest, const char * data, size_t len)
 {
-    int sendRet = ::sendto(sd_, data, len, 0, (sockaddr *) (&dest.sockaddr_in_), sizeof (struct sockaddr_in));
+    int sendRet;
+#ifdef LINUX
+    if(fiber::current()){
+        while((sendRet = ::sendto(sd_, data, len, MSG_DONTWAIT, (sockaddr *) (&dest.sockaddr_in_), sizeof (struct sockaddr_in))) < 0 && would_block())
+            fiber::wait_fd(sd_, fiber::io_write);
+    }
+    else
+#endif
+        sendRet = ::sendto(sd_, data, len, 0, (sockaddr *) (&dest.sockaddr_in_), sizeof (struct sockaddr_in));
     if (sendRet == -1){
         DEBUG_WARN(log::pf("send to <%s:%d> error...\n", dest.ip().c_str(), dest.port()));
         return sock_ERROR;
@@ -249,12 +289,19 @@ size_t socket_base::sendto(const addr_ipv4 &dest, const char * data, size_t len)
     return sendRet;
 }
 
-size_t socket_base::recv(char * data, size_t len)
+size_t socket_base::recv(char * data, size_t len, int flags)
 {
     int recvRet = 0;
     char *mem = data;
 
-    recvRet = ::recv(sd_, mem, len, 0);
+#ifdef LINUX
+    if(fiber::current()){
+        while((recvRet = ::recv(sd_, mem, len, flags | MSG_DONTWAIT)) < 0 && would_block())
+            fiber::wait_fd(sd_, fiber::io_read);
+    }
+    else
+#endif
+        recvRet = ::recv(sd_, mem, len, flags);
     if (recvRet < 0)
     {
         DEBUG_WARN("socket::recv error = "<<recvRet<<"\n");
@@ -273,7 +320,15 @@ size_t socket_base::recvfrom(char * data, size_t len, addr_ipv4 &from)
 #endif
             sizeof (struct sockaddr_in);
 
-    int recvRet = ::recvfrom(sd_, data, len, 0, (sockaddr *) (&from.sockaddr_in_), &dest_len);
+    int recvRet;
+#ifdef LINUX
+    if(fiber::current()){
+        while((recvRet = ::recvfrom(sd_, data, len, MSG_DONTWAIT, (sockaddr *) (&from.sockaddr_in_), &dest_len)) < 0 && would_block())
+            fiber::wait_fd(sd_, fiber::io_read);
+    }
+    else
+#endif
+        recvRet = ::recvfrom(sd_, data, len, 0, (sockaddr *) (&from.sockaddr_in_), &dest_len);
     if (recvRet < 0)
     {
         DEBUG_WARN("socket::recvfrom - recvRet = "<<recvRet<<"\n");
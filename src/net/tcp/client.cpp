@@ -19,6 +19,7 @@
  *
  */
 
+#include <bloom++/fiber.h>
 #include <bloom++/net/tcp/client.h>
 #include <bloom++/net/tcp/connection.h>
 
@@ -38,22 +39,65 @@ namespace tcp
 
 client::client(int numExecutors, 
                size_t select_timeout_sec, 
-               size_t select_timeout_usec) :
+               size_t select_timeout_usec,
+               thread_pool *pool,
+               handler_mode mode) :
 numExecutors_(numExecutors),
 select_timeout_sec_(select_timeout_sec),
 select_timeout_usec_(select_timeout_usec),
 bBlocking_((select_timeout_sec==select_timeout_usec&&
             select_timeout_sec==0)?true:false),
-bStopping_(false),
-socket_(new socket)
+mode_(mode),
+pool_(pool),
+socket_(new socket),
+bStopping_(false)
+{
+    clientMutex_.set_name("tcp::client");
+    start(thread_layout());
+}
+
+client::client(int numExecutors, 
+               size_t select_timeout_sec, 
+               size_t select_timeout_usec,
+               const thread_layout &layout,
+               handler_mode mode) :
+numExecutors_(numExecutors),
+select_timeout_sec_(select_timeout_sec),
+select_timeout_usec_(select_timeout_usec),
+bBlocking_((select_timeout_sec==select_timeout_usec&&
+            select_timeout_sec==0)?true:false),
+mode_(mode),
+pool_(0),
+socket_(new socket),
+bStopping_(false)
+{
+    clientMutex_.set_name("tcp::client");
+    start(layout);
+}
+
+void client::start(const thread_layout &layout)
 {
     connector_.connect<client>(this, &client::scb_done);
     disconnector_.connect<client>(this, &client::scb_done);
     
+    if(pool_ && !pool_->reserve(numExecutors_)){
+        DEBUG_WARN("Pool is too small, own threads are used\n");
+        pool_ = 0;
+    }
+    void (client::*executor)() = mode_ == handlers_on_fibers ?
+                                 &client::runFiberExecutor : &client::runExecutor;
+    if(pool_){
+        for (int i = 0; i < numExecutors_; ++i)
+            tasks_.push_back(pool_->submit(executor, this));
+        DEBUG_INFO("Client STARTED!!!\n");
+        return;
+    }
+
     for (int i = 0; i < numExecutors_; ++i)
     {
-        shared_ptr<thread<client> > thr(new thread<client>(&client::runExecutor, this));
+        shared_ptr<thread<client> > thr(new thread<client>(executor, this));
         executors_.push_back(thr);
+        thr->set_attributes(layout.executors.for_index(i));
         thr->start();
     }
     DEBUG_INFO("Client STARTED!!!\n");
@@ -73,6 +117,13 @@ client::~client()
     {
         (*it)->wait();
     }
+    list<future<void> >::iterator tit;
+    for (tit = tasks_.begin(); tit != tasks_.end(); ++tit)
+    {
+        (*tit).wait();
+    }
+    if(pool_)
+        pool_->unreserve(numExecutors_);
     DEBUG_INFO("Client STOPPED!!!\n");
 }
 
@@ -167,7 +218,14 @@ void client::runExecutor()
         if(conn->is_closing())continue;
         
         if(!bBlocking_){
-            if(conn->socket_->select(select_timeout_sec_, 
+            if(fiber::current()){
+                // other fibers of the thread run while waiting
+                const long timeout_ms = select_timeout_sec_ * 1000 +
+                                        (select_timeout_usec_ + 999) / 1000;
+                if(!fiber::wait_fd(conn->socket_->sd_, fiber::io_read, timeout_ms))
+                    continue;
+            }
+            else if(conn->socket_->select(select_timeout_sec_, 
                        select_timeout_usec_, 
                        select_Read) != sock_SELECT_READY)
                 continue;
@@ -182,6 +240,14 @@ void client::runExecutor()
     DEBUG_INFO("TCP Client Executor thread stopped...\n");
 }
 
+void client::runFiberExecutor()
+{
+    // callbacks in fibers may keep buffers on the stack
+    fiber_scheduler scheduler(256 * 1024);
+    scheduler.spawn(this, &client::runExecutor);
+    scheduler.run();
+}
+
 } //namespace tcp
 
 } //namespace net
@@ -19,6 +19,7 @@
  *
  */
 
+#include <sys/socket.h>
 #include <bloom++/net/tcp/connection.h>
 
 #ifdef NET_DEBUG
@@ -35,9 +36,47 @@ namespace net
 namespace tcp
 {
 
+namespace
+{
+
+/*
+ * Holds send_m_ for one send. A fiber first takes fiber_send_m_, so a
+ * second fiber of the same thread is parked there instead of blocking
+ * the thread on send_m_ while the holder is suspended in send().
+ */
+class send_lock
+{
+public:
+    send_lock(mutex &m, fiber_mutex &fm) : m_(m), fm_(0)
+    {
+#ifdef LINUX
+        if(fiber::current()){
+            fm_ = &fm;
+            fm_->lock();
+        }
+#endif
+        m_.lock();
+    }
+    
+    ~send_lock()
+    {
+        m_.unlock();
+        if(fm_)
+            fm_->unlock();
+    }
+    
+private:
+    mutex &m_;
+    fiber_mutex *fm_;
+};
+
+} //namespace
+
 connection::connection(shared_ptr<socket> sock, const addr_ipv4& remote):
 socket_(sock), remoteAddr_(remote), bClosing_(false)
 {
+    recv_m_.set_name("tcp::connection::recv");
+    send_m_.set_name("tcp::connection::send");
     //DEBUG_INFO("creating connection...\n");
 }
 
@@ -48,13 +87,13 @@ connection::~connection()
 
 size_t connection::send(const char* data, size_t len)
 {
-    mutex::scoped_lock sl(send_m_);
+    send_lock sl(send_m_, fiber_send_m_);
     return socket_->send(data, len);
 }
 
 size_t connection::sendto(const addr_ipv4& dest, const char* data, size_t len)
 {
-    mutex::scoped_lock sl(send_m_);
+    send_lock sl(send_m_, fiber_send_m_);
     return socket_->sendto(dest, data, len);
 }
 
@@ -71,6 +110,8 @@ const addr_ipv4& connection::remote_addr() const
 void connection::close()
 {
     bClosing_ = true;
+    // an idle connection of a server is woken by the end of input
+    ::shutdown(socket_->sd_, SHUT_RD);
 }
 
 bool connection::is_closing() const
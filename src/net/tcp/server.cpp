@@ -19,6 +19,14 @@
  *
  */
 
+#include <unistd.h>
+#include <errno.h>
+#include <stdint.h>
+#include <sys/socket.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <bloom++/exception.h>
+#include <bloom++/fiber.h>
 #include <bloom++/net/tcp/server.h>
 
 #ifdef NET_DEBUG
@@ -38,30 +46,113 @@ namespace tcp
 server::server(int numAcceptors,
                int numExecutors,
                size_t select_timeout_sec, 
-               size_t select_timeout_usec) :
+               size_t select_timeout_usec,
+               thread_pool *pool,
+               handler_mode mode) :
 numAcceptors_(numAcceptors),
 numExecutors_(numExecutors),
 select_timeout_sec_(select_timeout_sec),
 select_timeout_usec_(select_timeout_usec),
-bBlocking_((select_timeout_sec==select_timeout_usec&&
-            select_timeout_sec==0)?true:false),
-bStopping_(false),
-socket_(new socket)
+mode_(mode),
+pool_(pool),
+generation_(0),
+epfd_(-1),
+wakeFd_(-1),
+socket_(new socket),
+bDenied_(false),
+bStopping_(false)
 {
-    acceptor_.connect<server>(this, &server::scb_allow);
-    disconnector_.connect<server>(this, &server::scb_done);
+    mutexAcceptors_.set_name("tcp::server::acceptors");
+    mutexExecutors_.set_name("tcp::server::executors");
+    mutexConnections_.set_name("tcp::server::connections");
+    mutexDeny_.set_name("tcp::server::deny");
+    start(thread_layout());
+}
+
+server::server(int numAcceptors,
+               int numExecutors,
+               size_t select_timeout_sec, 
+               size_t select_timeout_usec,
+               const thread_layout &layout,
+               handler_mode mode) :
+numAcceptors_(numAcceptors),
+numExecutors_(numExecutors),
+select_timeout_sec_(select_timeout_sec),
+select_timeout_usec_(select_timeout_usec),
+mode_(mode),
+pool_(0),
+generation_(0),
+epfd_(-1),
+wakeFd_(-1),
+socket_(new socket),
+bDenied_(false),
+bStopping_(false)
+{
+    mutexAcceptors_.set_name("tcp::server::acceptors");
+    mutexExecutors_.set_name("tcp::server::executors");
+    mutexConnections_.set_name("tcp::server::connections");
+    mutexDeny_.set_name("tcp::server::deny");
+    start(layout);
+}
+
+namespace
+{
+
+// events taken by one epoll_wait of a single executor or of a fiber
+// executor; threads of several executors take one event each, so
+// a slow callback doesn't delay connections other executors could serve
+const int executor_events = 16;
+
+uint64_t event_key(int fd, unsigned int gen)
+{
+    return ((uint64_t)gen << 32) | (uint32_t)fd;
+}
+
+// callbacks in fibers may keep buffers on the stack
+const size_t fiber_stack_size = 256 * 1024;
+
+} //namespace
+
+void server::start(const thread_layout &layout)
+{
+    epfd_ = epoll_create1(EPOLL_CLOEXEC);
+    wakeFd_ = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+    if(epfd_ < 0 || wakeFd_ < 0)
+        throw exception("tcp::server: epoll/eventfd creation failed");
+    // level-triggered: stays ready for all executors when stopping
+    epoll_event ev;
+    ev.events = EPOLLIN;
+    ev.data.u64 = event_key(wakeFd_, 0);
+    epoll_ctl(epfd_, EPOLL_CTL_ADD, wakeFd_, &ev);
     
+    if(pool_ && !pool_->reserve(numAcceptors_ + numExecutors_)){
+        DEBUG_WARN("Pool is too small, own threads are used\n");
+        pool_ = 0;
+    }
+    void (server::*executor)() = mode_ == handlers_on_fibers ?
+                                 &server::runFiberExecutor : &server::runExecutor;
+    if(pool_){
+        for (int i = 0; i < numAcceptors_; ++i)
+            tasks_.push_back(pool_->submit(&server::runAcceptor, this));
+        for (int i = 0; i < numExecutors_; ++i)
+            tasks_.push_back(pool_->submit(executor, this));
+        DEBUG_INFO("Server STARTED!!!\n");
+        return;
+    }
+
     for (int i = 0; i < numAcceptors_; ++i)
     {
         shared_ptr<thread<server> > thr(new thread<server>(&server::runAcceptor, this));
         acceptors_.push_back(thr);
+        thr->set_attributes(layout.acceptors.for_index(i));
         thr->start();
     }
 
     for (int i = 0; i < numExecutors_; ++i)
     {
-        shared_ptr<thread<server> > thr(new thread<server>(&server::runExecutor, this));
+        shared_ptr<thread<server> > thr(new thread<server>(executor, this));
         executors_.push_back(thr);
+        thr->set_attributes(layout.executors.for_index(i));
         thr->start();
     }
     DEBUG_INFO("Server STARTED!!!\n");
@@ -74,9 +165,18 @@ server::~server()
         mutex::scoped_lock sl(mutexAcceptors_);
         cvAcceptors_.notify_all();
     }
-    {
+    uint64_t one = 1;
+    if(::write(wakeFd_, &one, sizeof(one)) < 0)
+        DEBUG_ERROR("executors wakeup failed\n");
+    if(mode_ == handlers_on_fibers){
+        // fibers waiting in recv() or send() finish, executors return
+        // when all their fibers are finished
         mutex::scoped_lock sl(mutexConnections_);
-        cvConnections_.notify_all();
+        for (size_t i = 0; i < connections_.size(); ++i)
+            if(connections_[i].get()){
+                connections_[i]->close();
+                ::shutdown(connections_[i]->socket_->sd_, SHUT_RDWR);
+            }
     }
     ::bloom::list<shared_ptr<thread<server> > >::iterator it;
     ::bloom::list<shared_ptr<thread<server> > >::iterator end_it = acceptors_.end();
@@ -90,32 +190,65 @@ server::~server()
         DEBUG_INFO("executors wait...\n");
         (*it)->wait();
     }
+    ::bloom::list<future<void> >::iterator tit;
+    for (tit = tasks_.begin(); tit != tasks_.end(); ++tit)
+    {
+        (*tit).wait();
+    }
+    if(pool_)
+        pool_->unreserve(numAcceptors_ + numExecutors_);
+    
+    ::bloom::list<shared_ptr<connection> > rest;
+    {
+        mutex::scoped_lock sl(mutexConnections_);
+        for (size_t i = 0; i < connections_.size(); ++i)
+        {
+            if(connections_[i].get()){
+                rest.push_back(connections_[i]);
+                connections_[i].reset();
+            }
+        }
+    }
+    ::bloom::list<shared_ptr<connection> >::iterator cit;
+    for (cit = rest.begin(); cit != rest.end(); ++cit)
+    {
+        (*cit)->close();
+        disconnector_.emit(**cit);
+    }
+    ::close(epfd_);
+    ::close(wakeFd_);
     DEBUG_INFO("Server STOPPED!!!\n");
 }
 
-::bloom::signal1<bool, connection& > &server::acceptor()
+server::acceptor_signal &server::acceptor()
 {
     return acceptor_;
 }
 
-::bloom::signal2<bool, receiver&, connection& > &server::executor()
+server::executor_signal &server::executor()
 {
     return executor_;
 }
 
-::bloom::signal1<void, connection& > &server::disconnector()
+server::disconnector_signal &server::disconnector()
 {
     return disconnector_;
 }
 
 void server::deny_acceptor()
 {
-    acceptor_.connect<server>(this, &server::scb_deny);
+    mutex::scoped_lock sl(mutexDeny_);
+    if(!bDenied_)
+        acceptor_.connect<server>(this, &server::scb_deny);
+    bDenied_ = true;
 }
 
 void server::allow_acceptor()
 {
-    acceptor_.connect<server>(this, &server::scb_allow);
+    mutex::scoped_lock sl(mutexDeny_);
+    if(bDenied_)
+        acceptor_.disconnect(acceptor_signal::delegate_type(this, &server::scb_deny));
+    bDenied_ = false;
 }
 
 int server::bind(const addr_ipv4& ipaddr)
@@ -191,14 +324,113 @@ void server::runAcceptor()
         else 
             continue;
         
-        if(bAdding){
-            mutex::scoped_lock sl(mutexConnections_);
-            connections_.push_back(conn);
+        if(bAdding)
+            add_connection(conn);
+        else
+            conn.reset();
+    }
+    DEBUG_INFO("Acceptor thread stopped...\n");
+}
+
+void server::add_connection(shared_ptr<connection> &conn)
+{
+    const int fd = conn->socket_->sd_;
+    epoll_event ev;
+    ev.events = EPOLLIN | EPOLLRDHUP | EPOLLET | EPOLLONESHOT;
+    {
+        mutex::scoped_lock sl(mutexConnections_);
+        if(!++generation_)
+            ++generation_; // 0 is the wakeup event
+        ev.data.u64 = event_key(fd, generation_);
+        if(!epoll_ctl(epfd_, EPOLL_CTL_ADD, fd, &ev)){
+            const size_t size = connections_.size();
+            if((size_t)fd >= size){
+                const size_t new_size = (size_t)fd + 1 > size * 2 ? fd + 1 : size * 2;
+                connections_.resize(new_size);
+                generations_.resize(new_size, 0);
+            }
+            connections_[fd] = conn;
+            generations_[fd] = generation_;
             conn.reset(); // For thread safe.
-            cvConnections_.notify_all();
+            return;
         }
     }
-    DEBUG_INFO("Acceptor thread stopped...\n");
+    DEBUG_ERROR("epoll add failed\n");
+    conn->close();
+    disconnector_.emit(*conn);
+    conn.reset();
+}
+
+void server::remove_connection(const shared_ptr<connection> &conn)
+{
+    const int fd = conn->socket_->sd_;
+    {
+        // the executor which frees the receiver and the next one
+        // may both find the connection closed
+        mutex::scoped_lock sl(mutexConnections_);
+        if((size_t)fd >= connections_.size() ||
+           connections_[fd].get() != conn.get())
+            return;
+        epoll_ctl(epfd_, EPOLL_CTL_DEL, fd, 0);
+        connections_[fd].reset();
+        generations_[fd] = 0;
+    }
+    DEBUG_INFO("Connection destroing!\n");
+    disconnector_.emit(*conn);
+}
+
+void server::rearm(connection &conn, unsigned int gen)
+{
+    // modifying rechecks readiness, so data left unread fires again
+    const int fd = conn.socket_->sd_;
+    epoll_event ev;
+    ev.events = EPOLLIN | EPOLLRDHUP | EPOLLET | EPOLLONESHOT;
+    ev.data.u64 = event_key(fd, gen);
+    epoll_ctl(epfd_, EPOLL_CTL_MOD, fd, &ev);
+}
+
+void server::on_free(void *arg)
+{
+    serving *s = static_cast<serving*>(arg);
+    s->bRearmed_ = true;
+    if(!s->conn_->is_closing())
+        s->server_->rearm(*s->conn_, s->gen_);
+}
+
+void server::serve(receiver &r, const shared_ptr<connection> &conn, unsigned int gen)
+{
+    if(bStopping_)
+        return; // the destructor closes the connection
+    
+    if(conn->is_closing()){
+        remove_connection(conn);
+        return;
+    }
+    
+    // the connection is disarmed until rearm(), nobody else serves it:
+    // the receiver gets a lock which isn't held
+    mutex::unique_lock ul(conn->recv_m_, false);
+    serving s = {this, conn.get(), gen, false};
+    r.set_locker(ul);
+    r.set_free_hook(&server::on_free, &s);
+    
+    bool keep;
+    try{
+        keep = executor_.emit(r, *conn);
+    }
+    catch(...){
+        // a callback in a fiber can't unwind the executor thread
+        DEBUG_ERROR("executor callback failed, closing the connection\n");
+        keep = false;
+    }
+    if(!keep)
+        conn->close();
+    r.set_free_hook(0, 0);
+    
+    if(conn->is_closing())
+        remove_connection(conn);
+    else if(!s.bRearmed_)
+        rearm(*conn, gen);
 }
 
 void server::runExecutor()
@@ -206,65 +438,102 @@ void server::runExecutor()
     DEBUG_INFO("Executor thread started...\n");
     shared_ptr<connection> conn;
     receiver r;
+    epoll_event events[executor_events];
+    const int batch = numExecutors_ > 1 ? 1 : executor_events;
     
-    while (true)
-    {   
+    while (!bStopping_)
+    {
+        int n = epoll_wait(epfd_, events, batch, -1);
+        if(n < 0){
+            if(errno == EINTR)
+                continue;
+            DEBUG_ERROR("epoll_wait failed\n");
+            break;
+        }
+        
+        for (int i = 0; i < n && !bStopping_; ++i)
         {
-            mutex::scoped_lock sl(mutexConnections_);
-
-            if(!connections_.size()){
-                if(bStopping_){
-                    conn.reset(); //safe release
-                    r.reset_connection(); //safe release
-                    break;
-                }
-                cvConnections_.wait(mutexConnections_);
-                if(bStopping_ && !connections_.size()){
-                    conn.reset(); //safe release
-                    r.reset_connection(); //safe release
-                    break;
-                }
+            const int fd = (int)(events[i].data.u64 & 0xffffffffULL);
+            const unsigned int gen = (unsigned int)(events[i].data.u64 >> 32);
+            if(!gen)
+                continue; // wakeup
+            {
+                mutex::scoped_lock sl(mutexConnections_);
+                if((size_t)fd < connections_.size() && generations_[fd] == gen)
+                    conn = connections_[fd];
+                r.set_connection(conn);
             }
-
-            conn = connections_.front();
-            connections_.pop_front();
-
-            if(bStopping_)conn->close();
-            
-            if(conn->is_closing()){
-                DEBUG_INFO("Connection destroing!\n");
-                disconnector_.emit(*conn);
-                continue;
+            if(conn.get())
+                serve(r, conn, gen);
+            {
+                // copies of connections are released under the lock,
+                // shared_ptr isn't thread safe
+                mutex::scoped_lock sl(mutexConnections_);
+                conn.reset();
+                r.reset_connection();
             }
+        }
+    }
+    DEBUG_INFO("Executor thread stopped...\n");
+}
 
-            connections_.push_back(conn);
+void server::runFiberExecutor()
+{
+    DEBUG_INFO("Fiber executor thread started...\n");
+    fiber_scheduler scheduler(fiber_stack_size);
+    scheduler.spawn(this, &server::pollFibers);
+    scheduler.run();
+    DEBUG_INFO("Fiber executor thread stopped...\n");
+}
 
-            r.set_connection(conn);
-        }
-        
-        // Current connection locking.
-        mutex::unique_lock ul2(conn->recv_m_);
+void server::pollFibers()
+{
+    epoll_event events[executor_events];
+    
+    while (!bStopping_)
+    {
+        // the epoll set is readable while it has events
+        fiber::wait_fd(epfd_, fiber::io_read);
+        int n = epoll_wait(epfd_, events, executor_events, 0);
         
-        if(conn->is_closing())
-            continue;
-
-        bool bExec  = true;
-        if(!bBlocking_){
-            if(conn->socket_->select(select_timeout_sec_, 
-                       select_timeout_usec_, 
-                       select_Read) != sock_SELECT_READY){
-                bExec = false;
+        for (int i = 0; i < n && !bStopping_; ++i)
+        {
+            const int fd = (int)(events[i].data.u64 & 0xffffffffULL);
+            const unsigned int gen = (unsigned int)(events[i].data.u64 >> 32);
+            if(!gen)
+                continue; // wakeup
+            fiber_serving *fs = new fiber_serving;
+            fs->server_ = this;
+            fs->gen_ = gen;
+            {
+                mutex::scoped_lock sl(mutexConnections_);
+                if((size_t)fd < connections_.size() && generations_[fd] == gen)
+                    fs->conn_ = connections_[fd];
+                if(!fs->conn_.get()){
+                    delete fs;
+                    continue;
+                }
             }
+            fiber_scheduler::current()->spawn(&server::serveFiber, fs);
         }
+    }
+}
 
-        if(bExec){
-            r.set_locker(ul2);
-            
-            if(!executor_.emit(r, *conn))
-                conn->close();
-        }
+void server::serveFiber(void *arg)
+{
+    fiber_serving *fs = static_cast<fiber_serving*>(arg);
+    server *s = fs->server_;
+    receiver r;
+    {
+        mutex::scoped_lock sl(s->mutexConnections_);
+        r.set_connection(fs->conn_);
+    }
+    s->serve(r, fs->conn_, fs->gen_);
+    {
+        mutex::scoped_lock sl(s->mutexConnections_);
+        r.reset_connection();
+        delete fs;
     }
-    DEBUG_INFO("Executor thread stopped...\n");
 }
 
 } //namespace tcp
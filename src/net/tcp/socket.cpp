@@ -19,8 +19,11 @@
  *
  */
 
+#include <errno.h>
+#include <fcntl.h>
 #include <bloom++/net/tcp/socket.h>
 #include <bloom++/net/tcp/connection.h>
+#include <bloom++/fiber.h>
 
 #ifdef NET_DEBUG
 #define __BLOOM_WITH_DEBUG
@@ -74,7 +77,24 @@ int socket::accept(addr_ipv4 &remote)
 #endif
             sizeof (struct sockaddr_in);
     
-    int connfd = ::accept(sd_, (sockaddr *) (&remote.sockaddr_in_), &dest_len);
+    int connfd;
+#ifdef LINUX
+    if(fiber::current()){
+        // in fibers wait for a connection without blocking the thread,
+        // another acceptor may take it first
+        const int flags = fcntl(sd_, F_GETFL);
+        if(flags >= 0 && !(flags & O_NONBLOCK))
+            fcntl(sd_, F_SETFL, flags | O_NONBLOCK);
+    }
+    // the socket is non-blocking once accepted in a fiber,
+    // outside of fibers wait_fd() polls
+    while((connfd = ::accept(sd_, (sockaddr *) (&remote.sockaddr_in_), &dest_len)) == -1 &&
+          (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR))
+        if(!fiber::wait_fd(sd_, fiber::io_read))
+            break;
+#else
+    connfd = ::accept(sd_, (sockaddr *) (&remote.sockaddr_in_), &dest_len);
+#endif
     if(connfd == -1){
         return sock_ACCEPT_ERROR;
     }
@@ -33,7 +33,7 @@ namespace net {
 namespace tcp {
 
 iostream::iostream(receiver &r, connection &s):
-r_(r),s_(s)
+r_(r),s_(s),wpos_(0),wsize_(0)
 {
 }
 
@@ -49,9 +49,40 @@ size_t iostream::write(const char* data, size_t size)
 
 size_t iostream::read(char* data, size_t size)
 {
+    //unconsumed window data is still in socket queue
+    wpos_ = wsize_ = 0;
     return r_.recv(data, size);
 }
 
+size_t iostream::peek(const char *&data)
+{
+    if (wpos_ == wsize_)
+    {
+        size_t ret = r_.peek(window_, sizeof(window_));
+        wpos_ = 0;
+        wsize_ = (ret == (size_t)sock_ERROR) ? 0 : ret;
+    }
+    data = window_ + wpos_;
+    return wsize_ - wpos_;
+}
+
+void iostream::consume(size_t size)
+{
+    if (size > wsize_ - wpos_)size = wsize_ - wpos_;
+    //the same data is received over the window
+    while (size)
+    {
+        size_t ret = r_.recv(window_ + wpos_, size);
+        if (ret == (size_t)sock_ERROR || !ret)
+        {
+            wpos_ = wsize_ = 0;
+            return;
+        }
+        wpos_ += ret;
+        size -= ret;
+    }
+}
+
 bool iostream::iready()
 {
     return !r_.is_closing();
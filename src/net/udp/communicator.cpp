@@ -48,6 +48,7 @@ bStopping_(false),
 socket_(new socket),
 sender_(new sender(socket_))
 {
+    mutexExecutors_.set_name("udp::communicator::executors");
 }
 
 communicator::communicator(size_t select_timeout_sec, 
@@ -60,6 +61,7 @@ bStopping_(false),
 socket_(new socket),
 sender_(new sender(socket_))
 {
+    mutexExecutors_.set_name("udp::communicator::executors");
 }
 
 communicator::~communicator()
@@ -73,6 +75,16 @@ communicator::~communicator()
     {
         (*it)->wait();
     }
+    ::bloom::list<future<void> >::iterator tit;
+    for (tit = tasks_.begin(); tit != tasks_.end(); ++tit)
+    {
+        (*tit).wait();
+    }
+    ::bloom::list<thread_pool*>::iterator pit;
+    for (pit = pools_.begin(); pit != pools_.end(); ++pit)
+    {
+        (*pit)->unreserve(1);
+    }
 }
 
 void communicator::add_threads(unsigned int num)
@@ -85,9 +97,34 @@ void communicator::add_threads(unsigned int num)
     }
 }
 
+void communicator::add_threads(unsigned int num, const thread_attributes &attr)
+{
+    for (unsigned int i = 0; i < num; ++i)
+    {
+        shared_ptr<thread<communicator> > thr (new thread<communicator>(&communicator::runExecutor, this));
+        thr->set_attributes(attr.for_index(executors_.size()));
+        executors_.push_back(thr);
+        thr->start();
+    }
+}
+
+void communicator::add_threads(unsigned int num, thread_pool &pool)
+{
+    if(!pool.reserve(num)){
+        DEBUG_WARN("Pool is too small, own threads are added\n");
+        add_threads(num);
+        return;
+    }
+    for (unsigned int i = 0; i < num; ++i)
+    {
+        tasks_.push_back(pool.submit(&communicator::runExecutor, this));
+        pools_.push_back(&pool);
+    }
+}
+
 unsigned int communicator::num_threads()
 {
-    return (unsigned int)executors_.size();
+    return (unsigned int)(executors_.size() + tasks_.size());
 }
 
 void communicator::bind(const addr_ipv4& ipaddr)
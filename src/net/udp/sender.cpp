@@ -33,6 +33,8 @@ namespace udp
 
 sender::sender(shared_ptr<socket> sock): socket_(sock), bClosing_(false)
 {
+    recv_m_.set_name("udp::sender::recv");
+    send_m_.set_name("udp::sender::send");
 }
 
 size_t sender::sendto(const addr_ipv4& dest, const char* data, size_t size)
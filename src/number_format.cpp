@@ -0,0 +1,500 @@
+/* 
+ * Copyright © 2015 Sergei Khairulin <sergei.khairulin@gmail.com>. 
+ * All rights reserved.
+ *
+ * This file is part of Bloom++.
+ *
+ * Bloom++ is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Bloom++ is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Bloom++.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <bloom++/_bits/number_format.h>
+
+namespace bloom
+{
+
+namespace number
+{
+
+static const char digits_lut[201] =
+    "00010203040506070809"
+    "10111213141516171819"
+    "20212223242526272829"
+    "30313233343536373839"
+    "40414243444546474849"
+    "50515253545556575859"
+    "60616263646566676869"
+    "70717273747576777879"
+    "80818283848586878889"
+    "90919293949596979899";
+
+size_t utoa(unsigned long long value, char *buf)
+{
+    char tmp[20];
+    char *p = tmp + sizeof(tmp);
+    if (value >> 32)
+    {
+        while (value >= 100000000)
+        {
+            // 8 digits by 32-bit arithmetic
+            uint32_t low = static_cast<uint32_t>(value % 100000000);
+            value /= 100000000;
+            for (int i = 0; i < 4; i++)
+            {
+                const char *d = digits_lut + (low % 100) * 2;
+                low /= 100;
+                p -= 2;
+                p[0] = d[0];
+                p[1] = d[1];
+            }
+        }
+    }
+    uint32_t v = static_cast<uint32_t>(value);
+    while (v >= 100)
+    {
+        const char *d = digits_lut + (v % 100) * 2;
+        v /= 100;
+        p -= 2;
+        p[0] = d[0];
+        p[1] = d[1];
+    }
+    if (v < 10)
+        *--p = static_cast<char>('0' + v);
+    else {
+        p -= 2;
+        p[0] = digits_lut[v * 2];
+        p[1] = digits_lut[v * 2 + 1];
+    }
+    const size_t size = tmp + sizeof(tmp) - p;
+    memcpy(buf, p, size);
+    return size;
+}
+
+size_t itoa(long long value, char *buf)
+{
+    if (value < 0)
+    {
+        buf[0] = '-';
+        return utoa(0ULL - static_cast<unsigned long long>(value), buf + 1) + 1;
+    }
+    return utoa(value, buf);
+}
+
+//-------------------------
+// Grisu3 (Florian Loitsch, "Printing Floating-Point Numbers Quickly
+// and Accurately with Integers") with an exact fallback for the
+// values it can't prove shortest (about 0.5%)
+//-------------------------
+
+/*
+ * "Do it yourself" floating point: f * 2^e.
+ */
+struct diy_fp
+{
+    uint64_t f;
+    int e;
+
+    diy_fp(uint64_t fp, int exp) : f(fp), e(exp){}
+
+    diy_fp operator-(const diy_fp &o) const
+    {
+        return diy_fp(f - o.f, e);
+    }
+
+    // rounded upper half of 128-bit product
+    diy_fp operator*(const diy_fp &o) const
+    {
+        const uint64_t m32 = 0xFFFFFFFFULL;
+        const uint64_t a = f >> 32, b = f & m32;
+        const uint64_t c = o.f >> 32, d = o.f & m32;
+        const uint64_t ac = a * c, bc = b * c, ad = a * d, bd = b * d;
+        uint64_t tmp = (bd >> 32) + (ad & m32) + (bc & m32);
+        tmp += 1ULL << 31;
+        return diy_fp(ac + (ad >> 32) + (bc >> 32) + (tmp >> 32), e + o.e + 64);
+    }
+
+    diy_fp normalize() const
+    {
+        const int s = __builtin_clzll(f);
+        return diy_fp(f << s, e - s);
+    }
+};
+
+/*
+ * Normalized 10^k for k = -348, -340, ..., 340.
+ */
+static const uint64_t cached_powers_f[] = {
+    0xfa8fd5a0081c0288ULL, 0xbaaee17fa23ebf76ULL, 0x8b16fb203055ac76ULL,
+    0xcf42894a5dce35eaULL, 0x9a6bb0aa55653b2dULL, 0xe61acf033d1a45dfULL,
+    0xab70fe17c79ac6caULL, 0xff77b1fcbebcdc4fULL, 0xbe5691ef416bd60cULL,
+    0x8dd01fad907ffc3cULL, 0xd3515c2831559a83ULL, 0x9d71ac8fada6c9b5ULL,
+    0xea9c227723ee8bcbULL, 0xaecc49914078536dULL, 0x823c12795db6ce57ULL,
+    0xc21094364dfb5637ULL, 0x9096ea6f3848984fULL, 0xd77485cb25823ac7ULL,
+    0xa086cfcd97bf97f4ULL, 0xef340a98172aace5ULL, 0xb23867fb2a35b28eULL,
+    0x84c8d4dfd2c63f3bULL, 0xc5dd44271ad3cdbaULL, 0x936b9fcebb25c996ULL,
+    0xdbac6c247d62a584ULL, 0xa3ab66580d5fdaf6ULL, 0xf3e2f893dec3f126ULL,
+    0xb5b5ada8aaff80b8ULL, 0x87625f056c7c4a8bULL, 0xc9bcff6034c13053ULL,
+    0x964e858c91ba2655ULL, 0xdff9772470297ebdULL, 0xa6dfbd9fb8e5b88fULL,
+    0xf8a95fcf88747d94ULL, 0xb94470938fa89bcfULL, 0x8a08f0f8bf0f156bULL,
+    0xcdb02555653131b6ULL, 0x993fe2c6d07b7facULL, 0xe45c10c42a2b3b06ULL,
+    0xaa242499697392d3ULL, 0xfd87b5f28300ca0eULL, 0xbce5086492111aebULL,
+    0x8cbccc096f5088ccULL, 0xd1b71758e219652cULL, 0x9c40000000000000ULL,
+    0xe8d4a51000000000ULL, 0xad78ebc5ac620000ULL, 0x813f3978f8940984ULL,
+    0xc097ce7bc90715b3ULL, 0x8f7e32ce7bea5c70ULL, 0xd5d238a4abe98068ULL,
+    0x9f4f2726179a2245ULL, 0xed63a231d4c4fb27ULL, 0xb0de65388cc8ada8ULL,
+    0x83c7088e1aab65dbULL, 0xc45d1df942711d9aULL, 0x924d692ca61be758ULL,
+    0xda01ee641a708deaULL, 0xa26da3999aef774aULL, 0xf209787bb47d6b85ULL,
+    0xb454e4a179dd1877ULL, 0x865b86925b9bc5c2ULL, 0xc83553c5c8965d3dULL,
+    0x952ab45cfa97a0b3ULL, 0xde469fbd99a05fe3ULL, 0xa59bc234db398c25ULL,
+    0xf6c69a72a3989f5cULL, 0xb7dcbf5354e9beceULL, 0x88fcf317f22241e2ULL,
+    0xcc20ce9bd35c78a5ULL, 0x98165af37b2153dfULL, 0xe2a0b5dc971f303aULL,
+    0xa8d9d1535ce3b396ULL, 0xfb9b7cd9a4a7443cULL, 0xbb764c4ca7a44410ULL,
+    0x8bab8eefb6409c1aULL, 0xd01fef10a657842cULL, 0x9b10a4e5e9913129ULL,
+    0xe7109bfba19c0c9dULL, 0xac2820d9623bf429ULL, 0x80444b5e7aa7cf85ULL,
+    0xbf21e44003acdd2dULL, 0x8e679c2f5e44ff8fULL, 0xd433179d9c8cb841ULL,
+    0x9e19db92b4e31ba9ULL, 0xeb96bf6ebadf77d9ULL, 0xaf87023b9bf0ee6bULL
+};
+
+static const int16_t cached_powers_e[] = {
+    -1220, -1193, -1166, -1140, -1113, -1087, -1060, -1034, -1007, -980,
+    -954, -927, -901, -874, -847, -821, -794, -768, -741, -715,
+    -688, -661, -635, -608, -582, -555, -529, -502, -475, -449,
+    -422, -396, -369, -343, -316, -289, -263, -236, -210, -183,
+    -157, -130, -103, -77, -50, -24, 3, 30, 56, 83,
+    109, 136, 162, 189, 216, 242, 269, 295, 322, 348,
+    375, 402, 428, 455, 481, 508, 534, 561, 588, 614,
+    641, 667, 694, 720, 747, 774, 800, 827, 853, 880,
+    907, 933, 960, 986, 1013, 1039, 1066
+};
+
+static diy_fp cached_power(int e, int *k)
+{
+    // 10^-k * 2^e must be in the range [2^-60, 2^-32)
+    const double dk = (-61 - e) * 0.30102999566398114 + 347;
+    int ik = static_cast<int>(dk);
+    if (dk - ik > 0.0)ik++;
+    const unsigned index = static_cast<unsigned>((ik >> 3) + 1);
+    *k = -(-348 + static_cast<int>(index << 3));
+    return diy_fp(cached_powers_f[index], cached_powers_e[index]);
+}
+
+static const uint64_t pow10_lut[] = {
+    1ULL, 10ULL, 100ULL, 1000ULL, 10000ULL, 100000ULL, 1000000ULL,
+    10000000ULL, 100000000ULL, 1000000000ULL, 10000000000ULL,
+    100000000000ULL, 1000000000000ULL, 10000000000000ULL,
+    100000000000000ULL, 1000000000000000ULL, 10000000000000000ULL,
+    100000000000000000ULL, 1000000000000000000ULL,
+    10000000000000000000ULL
+};
+
+/*
+ * Moves the last digit towards w while it stays in the safe interval.
+ * Returns false if the result isn't provably the closest shortest one.
+ */
+static bool round_weed(char *buf, int len, uint64_t distance_too_high_w,
+                       uint64_t unsafe_interval, uint64_t rest,
+                       uint64_t ten_kappa, uint64_t unit)
+{
+    const uint64_t small_distance = distance_too_high_w - unit;
+    const uint64_t big_distance = distance_too_high_w + unit;
+    while (rest < small_distance && unsafe_interval - rest >= ten_kappa &&
+           (rest + ten_kappa < small_distance ||
+            small_distance - rest >= rest + ten_kappa - small_distance))
+    {
+        buf[len - 1]--;
+        rest += ten_kappa;
+    }
+    if (rest < big_distance && unsafe_interval - rest >= ten_kappa &&
+        (rest + ten_kappa < big_distance ||
+         big_distance - rest > rest + ten_kappa - big_distance))
+        return false;
+    return 2 * unit <= rest && rest <= unsafe_interval - 4 * unit;
+}
+
+static int count_digits(uint32_t n)
+{
+    if (n < 10)return 1;
+    if (n < 100)return 2;
+    if (n < 1000)return 3;
+    if (n < 10000)return 4;
+    if (n < 100000)return 5;
+    if (n < 1000000)return 6;
+    if (n < 10000000)return 7;
+    if (n < 100000000)return 8;
+    return 9;
+}
+
+/*
+ * Digits of the shortest number in (low, high), all scaled by the same
+ * cached power; unit is the error of the scaled values.
+ */
+static bool digit_gen(const diy_fp &low, const diy_fp &w, const diy_fp &high,
+                      char *buf, int *len, int *k)
+{
+    uint64_t unit = 1;
+    const diy_fp too_low(low.f - unit, low.e);
+    const diy_fp too_high(high.f + unit, high.e);
+    uint64_t unsafe_interval = (too_high - too_low).f;
+    const diy_fp one(1ULL << -w.e, w.e);
+    uint32_t p1 = static_cast<uint32_t>(too_high.f >> -one.e);
+    uint64_t p2 = too_high.f & (one.f - 1);
+    int kappa = count_digits(p1);
+    *len = 0;
+
+    while (kappa > 0)
+    {
+        const uint32_t div = static_cast<uint32_t>(pow10_lut[kappa - 1]);
+        buf[(*len)++] = static_cast<char>('0' + p1 / div);
+        p1 %= div;
+        kappa--;
+        const uint64_t rest = (static_cast<uint64_t>(p1) << -one.e) + p2;
+        if (rest < unsafe_interval)
+        {
+            *k += kappa;
+            return round_weed(buf, *len, (too_high - w).f, unsafe_interval,
+                              rest, static_cast<uint64_t>(div) << -one.e, unit);
+        }
+    }
+
+    while (true)
+    {
+        p2 *= 10;
+        unit *= 10;
+        unsafe_interval *= 10;
+        buf[(*len)++] = static_cast<char>('0' + (p2 >> -one.e));
+        p2 &= one.f - 1;
+        kappa--;
+        if (p2 < unsafe_interval)
+        {
+            *k += kappa;
+            return round_weed(buf, *len, (too_high - w).f * unit,
+                              unsafe_interval, p2, one.f, unit);
+        }
+    }
+}
+
+/*
+ * v = f * 2^e. lower_closer - the lower neighbour of v is nearer than
+ * the upper one (v is a power of two and not the smallest normal).
+ */
+static bool grisu3(uint64_t f, int e, bool lower_closer, char *buf, int *len, int *k)
+{
+    const diy_fp plus = diy_fp((f << 1) + 1, e - 1).normalize();
+    diy_fp minus = lower_closer ? diy_fp((f << 2) - 1, e - 2) : diy_fp((f << 1) - 1, e - 1);
+    minus.f <<= minus.e - plus.e;
+    minus.e = plus.e;
+
+    const diy_fp c_mk = cached_power(plus.e, k);
+    const diy_fp w = diy_fp(f, e).normalize() * c_mk;
+    return digit_gen(minus * c_mk, w, plus * c_mk, buf, len, k);
+}
+
+/*
+ * Shortest digits which strtod()/strtof() reads back to value, found by
+ * the correctly rounded conversions of the C library. The closest
+ * n-digit number may be out of the rounding interval of a power of two
+ * while its neighbour on the wider side is in, both are tried. The
+ * search starts from *len digits found by Grisu3 in a wider interval.
+ */
+static void exact_digits(double value, bool single, char *buf, int *len, int *k)
+{
+    const int max_digits = single ? 9 : 17;
+    for (int n = *len; n <= max_digits; n++)
+    {
+        char tmp[40];
+        snprintf(tmp, sizeof(tmp), "%.*e", n - 1, value);
+        uint64_t m = 0;
+        const char *c = tmp;
+        for (; *c && *c != 'e'; c++)
+            if (*c >= '0' && *c <= '9')
+                m = m * 10 + (*c - '0');
+        const int exp10 = atoi(c + 1) - (n - 1);
+        const uint64_t candidates[3] = {m, m + 1, m - 1};
+        for (int i = 0; i < 3; i++)
+        {
+            if (!candidates[i])
+                continue;
+            char num[40];
+            char *p = num + utoa(candidates[i], num);
+            *p++ = 'e';
+            *(p + itoa(exp10, p)) = 0;
+            const bool same = single ? strtof(num, 0) == static_cast<float>(value)
+                                     : strtod(num, 0) == value;
+            if (!same)
+                continue;
+            *len = static_cast<int>(utoa(candidates[i], buf));
+            *k = exp10;
+            while (*len > 1 && buf[*len - 1] == '0')
+            {
+                (*len)--;
+                (*k)++;
+            }
+            return;
+        }
+    }
+    // not reached, 17 (9) digits always read back
+    *len = static_cast<int>(utoa(0, buf));
+    *k = 0;
+}
+
+static char *write_exponent(int k, char *buf)
+{
+    if (k < 0)
+    {
+        *buf++ = '-';
+        k = -k;
+    }
+    else
+        *buf++ = '+';
+    if (k >= 100)
+    {
+        *buf++ = static_cast<char>('0' + k / 100);
+        k %= 100;
+        *buf++ = digits_lut[k * 2];
+        *buf++ = digits_lut[k * 2 + 1];
+    }
+    else if (k >= 10)
+    {
+        *buf++ = digits_lut[k * 2];
+        *buf++ = digits_lut[k * 2 + 1];
+    }
+    else
+        *buf++ = static_cast<char>('0' + k);
+    return buf;
+}
+
+/*
+ * Digits buf[0..len) * 10^k to decimal notation.
+ */
+static char *prettify(char *buf, int len, int k)
+{
+    const int kk = len + k; // 10^(kk-1) <= v < 10^kk
+
+    if (0 <= k && kk <= 21)
+    {
+        // 1234e7 -> 12340000000
+        for (int i = len; i < kk; i++)
+            buf[i] = '0';
+        return buf + kk;
+    }
+    if (0 < kk && kk <= 21)
+    {
+        // 1234e-2 -> 12.34
+        memmove(buf + kk + 1, buf + kk, len - kk);
+        buf[kk] = '.';
+        return buf + len + 1;
+    }
+    if (-6 < kk && kk <= 0)
+    {
+        // 1234e-6 -> 0.001234
+        const int offset = 2 - kk;
+        memmove(buf + offset, buf, len);
+        buf[0] = '0';
+        buf[1] = '.';
+        for (int i = 2; i < offset; i++)
+            buf[i] = '0';
+        return buf + len + offset;
+    }
+    if (len == 1)
+    {
+        // 1e30
+        buf[1] = 'e';
+        return write_exponent(kk - 1, buf + 2);
+    }
+    // 1234e30 -> 1.234e+33
+    memmove(buf + 2, buf + 1, len - 1);
+    buf[1] = '.';
+    buf[len + 1] = 'e';
+    return write_exponent(kk - 1, buf + len + 2);
+}
+
+static size_t special(bool minus, bool nan, char *buf)
+{
+    if (nan)
+    {
+        memcpy(buf, "nan", 3);
+        return 3;
+    }
+    if (minus)
+    {
+        memcpy(buf, "-inf", 4);
+        return 4;
+    }
+    memcpy(buf, "inf", 3);
+    return 3;
+}
+
+size_t dtoa(double value, char *buf)
+{
+    union { double d; uint64_t u; } bits;
+    bits.d = value;
+    const bool minus = (bits.u >> 63) != 0;
+    const int biased_e = static_cast<int>((bits.u >> 52) & 0x7FF);
+    const uint64_t significand = bits.u & 0x000FFFFFFFFFFFFFULL;
+    const uint64_t hidden = 0x0010000000000000ULL;
+
+    if (biased_e == 0x7FF)return special(minus, significand != 0, buf);
+
+    char *p = buf;
+    if (minus)*p++ = '-';
+    if (!biased_e && !significand)
+    {
+        *p++ = '0';
+        return p - buf;
+    }
+
+    int len, k;
+    const bool found = biased_e ?
+        grisu3(significand + hidden, biased_e - 1075, !significand && biased_e > 1, p, &len, &k) :
+        grisu3(significand, -1074, false, p, &len, &k);
+    if (!found)
+        exact_digits(minus ? -value : value, false, p, &len, &k);
+    return prettify(p, len, k) - buf;
+}
+
+size_t ftoa(float value, char *buf)
+{
+    union { float f; uint32_t u; } bits;
+    bits.f = value;
+    const bool minus = (bits.u >> 31) != 0;
+    const int biased_e = static_cast<int>((bits.u >> 23) & 0xFF);
+    const uint64_t significand = bits.u & 0x007FFFFF;
+    const uint64_t hidden = 0x00800000;
+
+    if (biased_e == 0xFF)return special(minus, significand != 0, buf);
+
+    char *p = buf;
+    if (minus)*p++ = '-';
+    if (!biased_e && !significand)
+    {
+        *p++ = '0';
+        return p - buf;
+    }
+
+    int len, k;
+    const bool found = biased_e ?
+        grisu3(significand + hidden, biased_e - 150, !significand && biased_e > 1, p, &len, &k) :
+        grisu3(significand, -149, false, p, &len, &k);
+    if (!found)
+        exact_digits(minus ? -value : value, true, p, &len, &k);
+    return prettify(p, len, k) - buf;
+}
+
+} //namespace number
+
+} //namespace bloom
@@ -0,0 +1,375 @@
+/* 
+ * Copyright © 2015 Sergei Khairulin <sergei.khairulin@gmail.com>. 
+ * All rights reserved.
+ *
+ * This file is part of Bloom++.
+ *
+ * Bloom++ is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Bloom++ is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Bloom++.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <string.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <errno.h>
+#include <limits>
+#include <new>
+#include <bloom++/_bits/number_parse.h>
+
+namespace bloom
+{
+
+namespace number
+{
+
+static inline bool is_digit(char c)
+{
+    return static_cast<unsigned char>(c - '0') < 10;
+}
+
+static inline void set_status(parse_status *status, parse_status value)
+{
+    if (status)*status = value;
+}
+
+#if defined(__BYTE_ORDER__) && (__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__)
+#define BLOOM_PARSE_SWAR
+
+/*
+ * 8 digits at once (SWAR), little endian.
+ */
+static inline bool is_eight_digits(uint64_t v)
+{
+    return ((v & 0xF0F0F0F0F0F0F0F0ULL) |
+            (((v + 0x0606060606060606ULL) & 0xF0F0F0F0F0F0F0F0ULL) >> 4)) ==
+           0x3333333333333333ULL;
+}
+
+static inline uint32_t eight_digits(uint64_t v)
+{
+    const uint64_t mask = 0x000000FF000000FFULL;
+    const uint64_t mul1 = 100 + (1000000ULL << 32);
+    const uint64_t mul2 = 1 + (10000ULL << 32);
+    v -= 0x3030303030303030ULL;
+    v = (v * 10) + (v >> 8);
+    v = (((v & mask) * mul1) + (((v >> 16) & mask) * mul2)) >> 32;
+    return static_cast<uint32_t>(v);
+}
+#endif
+
+/*
+ * Digits to value <= max (clamped on overflow).
+ * Returns count of digits.
+ */
+static size_t parse_digits(const char *s, size_t n, unsigned long long max,
+                           unsigned long long &value, bool &overflow)
+{
+    unsigned long long v = 0;
+    size_t i = 0;
+    overflow = false;
+#ifdef BLOOM_PARSE_SWAR
+    // while v * 10^8 + 99999999 can't overflow
+    while (i + 8 <= n && v < 184467440737ULL)
+    {
+        uint64_t chunk;
+        memcpy(&chunk, s + i, 8);
+        if (!is_eight_digits(chunk))break;
+        v = v * 100000000ULL + eight_digits(chunk);
+        i += 8;
+    }
+#endif
+    for (; i < n && is_digit(s[i]); i++)
+    {
+        const unsigned d = s[i] - '0';
+        if (v > (max - d) / 10)
+        {
+            overflow = true;
+            for (i++; i < n && is_digit(s[i]); i++);
+            break;
+        }
+        v = v * 10 + d;
+    }
+    if (overflow || v > max)
+    {
+        overflow = true;
+        v = max;
+    }
+    value = v;
+    return i;
+}
+
+template<class T>
+static size_t parse_unsigned(const char *s, size_t n, T &value, parse_status *status)
+{
+    size_t i = (n && s[0] == '+') ? 1 : 0;
+    unsigned long long v;
+    bool overflow;
+    const size_t digits = parse_digits(s + i, n - i, std::numeric_limits<T>::max(), v, overflow);
+    if (!digits)
+    {
+        set_status(status, parse_invalid);
+        return 0;
+    }
+    value = static_cast<T>(v);
+    set_status(status, overflow ? parse_overflow : parse_ok);
+    return i + digits;
+}
+
+template<class T>
+static size_t parse_signed(const char *s, size_t n, T &value, parse_status *status)
+{
+    size_t i = 0;
+    bool minus = false;
+    if (n && (s[0] == '-' || s[0] == '+'))
+    {
+        minus = (s[0] == '-');
+        i = 1;
+    }
+    unsigned long long max = std::numeric_limits<T>::max();
+    if (minus)max++;
+    unsigned long long v;
+    bool overflow;
+    const size_t digits = parse_digits(s + i, n - i, max, v, overflow);
+    if (!digits)
+    {
+        set_status(status, parse_invalid);
+        return 0;
+    }
+    value = minus ? static_cast<T>(0ULL - v) : static_cast<T>(v);
+    set_status(status, overflow ? parse_overflow : parse_ok);
+    return i + digits;
+}
+
+/*
+ * Decimal floating point number: mantissa (up to 19 digits) * 10^exp10.
+ */
+struct decimal
+{
+    bool minus;
+    bool truncated; //< non-zero digits were dropped from mantissa
+    uint64_t mantissa;
+    int exp10;
+};
+
+static size_t scan_decimal(const char *s, size_t n, decimal &d)
+{
+    size_t i = 0;
+    int digits = 0;
+    d.minus = false;
+    d.truncated = false;
+    d.mantissa = 0;
+    d.exp10 = 0;
+
+    if (n && (s[0] == '-' || s[0] == '+'))
+    {
+        d.minus = (s[0] == '-');
+        i = 1;
+    }
+
+    const size_t int_start = i;
+    for (; i < n && is_digit(s[i]); i++)
+    {
+        if (digits < 19)
+        {
+            d.mantissa = d.mantissa * 10 + (s[i] - '0');
+            if (d.mantissa)digits++;
+        }
+        else {
+            d.exp10++;
+            if (s[i] != '0')d.truncated = true;
+        }
+    }
+    const size_t int_digits = i - int_start;
+
+    size_t frac_digits = 0;
+    if (i < n && s[i] == '.')
+    {
+        size_t j = i + 1;
+        for (; j < n && is_digit(s[j]); j++)
+        {
+            if (digits < 19)
+            {
+                d.mantissa = d.mantissa * 10 + (s[j] - '0');
+                if (d.mantissa)digits++;
+                d.exp10--;
+            }
+            else if (s[j] != '0')d.truncated = true;
+        }
+        frac_digits = j - i - 1;
+        if (int_digits || frac_digits)i = j;
+    }
+    if (!int_digits && !frac_digits)return 0;
+
+    if (i < n && (s[i] == 'e' || s[i] == 'E'))
+    {
+        size_t j = i + 1;
+        bool minus = false;
+        if (j < n && (s[j] == '-' || s[j] == '+'))
+        {
+            minus = (s[j] == '-');
+            j++;
+        }
+        if (j < n && is_digit(s[j]))
+        {
+            int e = 0;
+            for (; j < n && is_digit(s[j]); j++)
+            {
+                if (e < 100000)e = e * 10 + (s[j] - '0');
+            }
+            d.exp10 += minus ? -e : e;
+            i = j;
+        }
+    }
+    return i;
+}
+
+static const double pow10_lut[] = {
+    1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+/*
+ * Not exact cases: strtod()/strtof() (correctly rounded) over
+ * null-terminated copy.
+ */
+template<class T>
+static T parse_slow(const char *s, size_t n, parse_status &status)
+{
+    char local[128];
+    char *buf = (n < sizeof(local)) ? local : static_cast<char *>(malloc(n + 1));
+    if (!buf)throw std::bad_alloc();
+    memcpy(buf, s, n);
+    buf[n] = 0;
+    errno = 0;
+    T value;
+    if (sizeof(T) == sizeof(float))
+        value = static_cast<T>(strtof(buf, 0));
+    else
+        value = static_cast<T>(strtod(buf, 0));
+    // denormal results aren't errors, only lost values
+    status = parse_ok;
+    if (errno == ERANGE)
+    {
+        if (value > 1 || value < -1)status = parse_overflow;
+        else if (value == 0)status = parse_underflow;
+    }
+    if (buf != local)free(buf);
+    return value;
+}
+
+size_t parse(const char *s, size_t n, double &value, parse_status *status)
+{
+    decimal d;
+    const size_t size = scan_decimal(s, n, d);
+    if (!size)
+    {
+        set_status(status, parse_invalid);
+        return 0;
+    }
+    // exact mantissa and power of ten: the only rounding is correct
+    if (!d.truncated && d.mantissa <= (1ULL << 53) && d.exp10 >= -22 && d.exp10 <= 22)
+    {
+        double v = static_cast<double>(d.mantissa);
+        if (d.exp10 < 0)v /= pow10_lut[-d.exp10];
+        else v *= pow10_lut[d.exp10];
+        value = d.minus ? -v : v;
+        set_status(status, parse_ok);
+        return size;
+    }
+    parse_status slow;
+    value = parse_slow<double>(s, size, slow);
+    set_status(status, slow);
+    return size;
+}
+
+size_t parse(const char *s, size_t n, float &value, parse_status *status)
+{
+    decimal d;
+    const size_t size = scan_decimal(s, n, d);
+    if (!size)
+    {
+        set_status(status, parse_invalid);
+        return 0;
+    }
+    if (!d.truncated && d.mantissa <= (1ULL << 24) && d.exp10 >= -10 && d.exp10 <= 10)
+    {
+        float v = static_cast<float>(d.mantissa);
+        if (d.exp10 < 0)v /= static_cast<float>(pow10_lut[-d.exp10]);
+        else v *= static_cast<float>(pow10_lut[d.exp10]);
+        value = d.minus ? -v : v;
+        set_status(status, parse_ok);
+        return size;
+    }
+    parse_status slow;
+    value = parse_slow<float>(s, size, slow);
+    set_status(status, slow);
+    return size;
+}
+
+size_t parse(const char *s, size_t n, char &value, parse_status *status)
+{
+    signed char v;
+    const size_t size = parse_signed(s, n, v, status);
+    if (size)value = static_cast<char>(v);
+    return size;
+}
+
+size_t parse(const char *s, size_t n, unsigned char &value, parse_status *status)
+{
+    return parse_unsigned(s, n, value, status);
+}
+
+size_t parse(const char *s, size_t n, short &value, parse_status *status)
+{
+    return parse_signed(s, n, value, status);
+}
+
+size_t parse(const char *s, size_t n, unsigned short &value, parse_status *status)
+{
+    return parse_unsigned(s, n, value, status);
+}
+
+size_t parse(const char *s, size_t n, int &value, parse_status *status)
+{
+    return parse_signed(s, n, value, status);
+}
+
+size_t parse(const char *s, size_t n, unsigned int &value, parse_status *status)
+{
+    return parse_unsigned(s, n, value, status);
+}
+
+size_t parse(const char *s, size_t n, long &value, parse_status *status)
+{
+    return parse_signed(s, n, value, status);
+}
+
+size_t parse(const char *s, size_t n, unsigned long &value, parse_status *status)
+{
+    return parse_unsigned(s, n, value, status);
+}
+
+size_t parse(const char *s, size_t n, long long &value, parse_status *status)
+{
+    return parse_signed(s, n, value, status);
+}
+
+size_t parse(const char *s, size_t n, unsigned long long &value, parse_status *status)
+{
+    return parse_unsigned(s, n, value, status);
+}
+
+} //namespace number
+
+} //namespace bloom
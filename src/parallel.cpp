@@ -0,0 +1,190 @@
+/* 
+ * Copyright © 2015 Sergei Khairulin <sergei.khairulin@gmail.com>. 
+ * All rights reserved.
+ *
+ * This file is part of Bloom++.
+ *
+ * Bloom++ is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Bloom++ is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Bloom++.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <bloom++/parallel.h>
+#include <bloom++/mutex.h>
+#include <bloom++/condition_variable.h>
+#include <bloom++/thread_pool.h>
+
+namespace bloom
+{
+
+namespace
+{
+
+/*
+ * Chunks of one parallel_run(). The caller and the helper tasks submitted
+ * to the shared thread_pool claim chunks by next, the caller waits until
+ * all claimed chunks are done. Helpers which start late find no chunks
+ * and only drop their reference, so the caller never waits for a queued
+ * helper and nested or concurrent calls can't starve each other.
+ */
+struct parallel_job
+{
+    parallel_task *task;
+    size_t size;
+    size_t grain;
+    size_t chunks;
+    volatile size_t next;
+    volatile size_t done;
+    volatile int failed;
+    volatile int refs;
+    mutex m;
+    condition_variable cv;
+    
+    void release()
+    {
+        if(!__sync_sub_and_fetch(&refs, 1))
+            delete this;
+    }
+    
+    /*
+     * Running of chunks until all are claimed. Chunks claimed after
+     * a failure are only counted.
+     * @return true if the last chunk was done by this call.
+     */
+    bool work(bool rethrow)
+    {
+        size_t n = 0;
+        bool last = false;
+        for(;;){
+            const size_t begin = __sync_fetch_and_add(&next, grain);
+            if(begin >= size)break;
+            if(!failed){
+                const size_t end = size - begin > grain ? begin + grain : size;
+                try{
+                    task->run(begin, end);
+                }
+                catch(...){
+                    failed = 1;
+                    if(rethrow){
+                        finish(n + 1);
+                        throw;
+                    }
+                }
+            }
+            ++n;
+        }
+        if(n)last = finish(n);
+        return last;
+    }
+    
+    bool finish(size_t n)
+    {
+        if(__sync_add_and_fetch(&done, n) != chunks)
+            return false;
+        mutex::scoped_lock sl(m);
+        cv.notify_all();
+        return true;
+    }
+    
+    void wait()
+    {
+        mutex::scoped_lock sl(m);
+        while(done != chunks)
+            cv.wait(sl);
+    }
+};
+
+class parallel_helper: public pool_task
+{
+    parallel_job *job_;
+public:
+    explicit parallel_helper(parallel_job *job):
+    job_(job){}
+    
+    virtual ~parallel_helper()
+    {
+        job_->release();
+    }
+    
+    virtual void run()
+    {
+        job_->work(false);
+    }
+};
+
+volatile size_t concurrency_ = 0;
+
+} //namespace
+
+size_t parallel_concurrency()
+{
+    const size_t n = concurrency_;
+    return n ? n : thread_pool::shared().size();
+}
+
+void set_parallel_concurrency(size_t n)
+{
+    concurrency_ = n;
+}
+
+size_t parallel_grain(size_t size, size_t grain)
+{
+    if(grain)return grain;
+    grain = size / (parallel_concurrency() * 8);
+    return grain ? grain : 1;
+}
+
+void parallel_run(parallel_task &task, size_t size, size_t grain)
+{
+    if(!size)return;
+    if(!grain)grain = 1;
+    const size_t chunks = (size + grain - 1) / grain;
+    size_t threads = parallel_concurrency();
+    if(threads > chunks)threads = chunks;
+    if(threads < 2){
+        for(size_t begin = 0; begin < size; begin += grain)
+            task.run(begin, size - begin > grain ? begin + grain : size);
+        return;
+    }
+    
+    parallel_job *j = new parallel_job;
+    j->task = &task;
+    j->size = size;
+    j->grain = grain;
+    j->chunks = chunks;
+    j->next = 0;
+    j->done = 0;
+    j->failed = 0;
+    j->refs = 1;
+    
+    thread_pool &pool = thread_pool::shared();
+    for(size_t i = 1; i < threads; ++i){
+        __sync_add_and_fetch(&j->refs, 1);
+        pool.execute(new parallel_helper(j));
+    }
+    try{
+        if(!j->work(true))
+            j->wait();
+    }
+    catch(...){
+        j->wait();
+        j->release();
+        throw;
+    }
+    const bool failed = j->failed;
+    j->release();
+    if(failed)
+        throw parallel_exception("exception in worker thread");
+}
+
+}//namespace bloom
@@ -0,0 +1,62 @@
+/* 
+ * Copyright © 2015 Sergei Khairulin <sergei.khairulin@gmail.com>. 
+ * All rights reserved.
+ *
+ * This file is part of Bloom++.
+ *
+ * Bloom++ is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Bloom++ is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Bloom++.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <bloom++/radix_sort.h>
+
+namespace bloom
+{
+
+void radix_sort_strings(string *data, size_t size, size_t depth)
+{
+    while(size > 16){
+        // median of three characters as pivot
+        size_t a = radix_char(data[0], depth);
+        size_t b = radix_char(data[size / 2], depth);
+        size_t c = radix_char(data[size - 1], depth);
+        const size_t pivot = a < b ? (b < c ? b : (a < c ? c : a)) :
+                                     (a < c ? a : (b < c ? c : b));
+        
+        // [0, lt) < pivot, [lt, i) == pivot, (gt, size) > pivot
+        size_t lt = 0, i = 0, gt = size;
+        while(i < gt){
+            const size_t ch = radix_char(data[i], depth);
+            if(ch < pivot)
+                data[lt++].swap(data[i++]);
+            else if(ch > pivot)
+                data[i].swap(data[--gt]);
+            else
+                ++i;
+        }
+        
+        radix_sort_strings(data, lt, depth);
+        radix_sort_strings(data + gt, size - gt, depth);
+        if(!pivot)return; // equal strings
+        data += lt;
+        size = gt - lt;
+        ++depth;
+    }
+    
+    for(size_t i = 1; i < size; ++i)
+        for(size_t j = i; j && radix_less(data[j], data[j - 1], depth); --j)
+            data[j].swap(data[j - 1]);
+}
+
+}//namespace bloom
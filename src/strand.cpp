@@ -0,0 +1,156 @@
+/* 
+ * Copyright © 2015 Sergei Khairulin <sergei.khairulin@gmail.com>. 
+ * All rights reserved.
+ *
+ * This file is part of Bloom++.
+ *
+ * Bloom++ is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Bloom++ is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Bloom++.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <sched.h>
+#include <string.h>
+#include <bloom++/strand.h>
+
+namespace bloom
+{
+
+namespace
+{
+
+__thread const strand *current_strand_ = 0;
+
+// tasks run by one runner before the worker is given back to the executor
+const size_t strand_batch = 64;
+
+} //namespace
+
+class strand::runner: public pool_task
+{
+public:
+    explicit runner(strand *s):s_(s){}
+    
+    virtual void run(){
+        s_->drain();
+    }
+    
+private:
+    strand *s_;
+};
+
+strand::strand(executor &ex):
+ex_(&ex),
+ring_(0),
+capacity_(0),
+head_(0),
+size_(0),
+bScheduled_(false)
+{
+}
+
+strand::~strand()
+{
+    for(;;){
+        {
+            spinlock::scoped_lock sl(lock_);
+            if(!bScheduled_)
+                break;
+        }
+        sched_yield();
+    }
+    delete [] ring_;
+}
+
+bool strand::running_in_this_thread() const
+{
+    return current_strand_ == this;
+}
+
+size_t strand::size() const
+{
+    spinlock::scoped_lock sl(lock_);
+    return size_;
+}
+
+void strand::execute(pool_task *task)
+{
+    {
+        spinlock::scoped_lock sl(lock_);
+        if(size_ == capacity_){
+            const size_t capacity = capacity_ ? capacity_ * 2 : 16;
+            pool_task **ring = new pool_task*[capacity];
+            // unwrapping of the old ring to the start of the new one
+            const size_t first = capacity_ - head_;
+            if(size_){
+                memcpy(ring, ring_ + head_, first * sizeof(pool_task*));
+                memcpy(ring + first, ring_, head_ * sizeof(pool_task*));
+            }
+            delete [] ring_;
+            ring_ = ring;
+            capacity_ = capacity;
+            head_ = 0;
+        }
+        ring_[(head_ + size_) & (capacity_ - 1)] = task;
+        ++size_;
+        if(bScheduled_)
+            return;
+        bScheduled_ = true;
+    }
+    ex_->execute(new runner(this));
+}
+
+pool_task *strand::pop()
+{
+    spinlock::scoped_lock sl(lock_);
+    if(!size_){
+        bScheduled_ = false;
+        return 0;
+    }
+    pool_task *task = ring_[head_];
+    head_ = (head_ + 1) & (capacity_ - 1);
+    --size_;
+    return task;
+}
+
+void strand::drain()
+{
+    const strand *prev = current_strand_;
+    current_strand_ = this;
+    for(size_t i = 0; i < strand_batch; ++i){
+        pool_task *task = pop();
+        if(!task){
+            current_strand_ = prev;
+            return;
+        }
+        try{
+            task->run();
+        }
+        catch(...){
+            // the strand must survive exceptions of raw tasks
+        }
+        delete task;
+    }
+    current_strand_ = prev;
+    {
+        spinlock::scoped_lock sl(lock_);
+        if(!size_){
+            bScheduled_ = false;
+            return;
+        }
+    }
+    // the remaining tasks go after the tasks queued to the executor
+    ex_->execute(new runner(this));
+}
+
+}//namespace bloom
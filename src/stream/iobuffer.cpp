@@ -188,6 +188,33 @@ size_t iobuffer::read(char *data, size_t size)
     return size;
 }
 
+size_t iobuffer::peek(const char *&data)
+{
+    while (blocks_.size())
+    {
+        ioblock *buf = blocks_.front().get();
+        if (buf->i_buf_Pos < buf->i_data_Size)
+        {
+            data = buf->data() + buf->i_buf_Pos;
+            return buf->i_data_Size - buf->i_buf_Pos;
+        }
+        if (blocks_.size() == 1)
+            break;
+        blocks_.pop_front();
+    }
+    data = 0;
+    return 0;
+}
+
+void iobuffer::consume(size_t size)
+{
+    if ((!blocks_.size()) || (!size))return;
+    ioblock *buf = blocks_.front().get();
+    buf->i_buf_Pos += size;
+    if (buf->i_buf_Pos > buf->i_data_Size)
+        buf->i_buf_Pos = buf->i_data_Size;
+}
+
 o_base &iobuffer::operator<<(i_base &i)
 {
     iobuffer *iobuf = dynamic_cast<iobuffer *> (&i);
@@ -268,9 +295,9 @@ string getStringValue(string name, string &buffer, unsigned char endSymbol)
     string value;
     iobuffer buf(buffer);
     istring str(buf);
+    string_ref elem;
     while (!str.empty())
     {
-        string elem;
         str.read_element(elem);
         if (elem == name)
         {
@@ -285,7 +312,9 @@ string getStringValue(string name, string &buffer, unsigned char endSymbol)
                         break;
                     }
                 }
-                str.read_string(endSymbol, value);
+                string_ref ref;
+                str.read_string(endSymbol, ref);
+                value = ref;
                 break;
             }
             else break;
@@ -299,9 +328,9 @@ int getIntValue(string name, string &buffer)
     int value = 0;
     iobuffer buf(buffer);
     istring str(buf);
+    string_ref elem;
     while (!str.empty())
     {
-        string elem;
         str.read_element(elem);
         if (elem == name)
         {
@@ -322,9 +351,9 @@ bool getBoolValue(string name, string &buffer)
     bool value = 0;
     iobuffer buf(buffer);
     istring str(buf);
+    string_ref elem;
     while (!str.empty())
     {
-        string elem;
         str.read_element(elem);
         if (elem == name)
         {
@@ -4,7 +4,11 @@
 
 #include <bloom++/stream/iostring.h>
 #include <bloom++/stream/iobuffer.h>
+#include <bloom++/_bits/number_format.h>
+#include <bloom++/_bits/string_search.h>
+#include <bloom++/string_builder.h>
 #include <stdio.h>
+#include <string.h>
 
 #ifdef STREAM_DEBUG
 #define __BLOOM_WITH_DEBUG
@@ -20,12 +24,17 @@ namespace stream
 unsigned char istring::get()
 {   
     prev_ch = curr_ch;
-    char ch;
+    char ch = 0;
     read((char *)&ch, sizeof(char));
     if (ch == 0x0d)
     {
-        read((char *)&ch, sizeof(char));
-        if (ch != 0x0a)
+        // looking ahead through the window keeps order of pushed back data
+        const char *data;
+        if (peek(data))
+        {
+            if (*data == 0x0a)consume(1);
+        }
+        else if (read((char *)&ch, sizeof(char)) && (ch != 0x0a))
             iob_.write(&ch, sizeof(char));
         line_num_++;
         curr_ch = '\n';
@@ -50,177 +59,114 @@ istring & istring::operator>>(string &elem)
 
 istring & istring::operator>>(char &value)
 {
-    int l_val;
-    bool minus;
-    string elem;
-
-    read_element(elem);
-    if (elem == "-")
-    {
-        minus = true;
-        read_element(elem);
-    }
-    else
-        minus = false;
-    l_val = atoi(elem.c_str());
-    //if (l_val > 127)return false;
-    value = (char) l_val;
-    if (minus)value = 0 - value;
-    return *this;
+    return read_number(value, false);
 }
 
 istring & istring::operator>>(unsigned char &value)
 {
-    int l_val;
-    string elem;
-
-    read_element(elem);
-    l_val = atoi(elem.c_str());
-    //if (l_val > 255)return false;
-    value = (unsigned char) l_val;
-    return *this;
+    return read_number(value, false);
 }
 
 istring & istring::operator>>(int &value)
 {
-    int l_val;
-    bool minus;
-    string elem;
-    
-    read_element(elem);
-    if (elem == "-")
-    {
-        minus = true;
-        read_element(elem);
-    }
-    else
-        minus = false;
-    l_val = atoi(elem.c_str());
-    value = (int) l_val;
-    if (minus)value = 0 - value;
-    return *this;
+    return read_number(value, false);
 }
 
 istring & istring::operator>>(unsigned int &value)
 {
-    int l_val;
-    string elem;
-    
-    read_element(elem);
-    l_val = atoi(elem.c_str());
-    value = (size_t) l_val;
-    return *this;
+    return read_number(value, false);
 }
 
 istring & istring::operator>>(short &value)
 {
-    int l_val;
-    bool minus;
-    string elem;
-    
-    read_element(elem);
-    if (elem == "-")
-    {
-        minus = true;
-        read_element(elem);
-    }
-    else
-        minus = false;
-    l_val = atoi(elem.c_str());
-    value = (short) l_val;
-    if (minus)value = 0 - value;
-    return *this;
+    return read_number(value, false);
 }
 
 istring & istring::operator>>(unsigned short &value)
 {
-    int l_val;
-    string elem;
-    
-    read_element(elem);
-    l_val = atoi(elem.c_str());
-    value = (unsigned short) l_val;
-    return *this;
+    return read_number(value, false);
 }
 
 istring & istring::operator>>(long &value)
 {
-    long l_val;
-    bool minus;
-    string elem;
-
-    read_element(elem);
-    if (elem == "-")
-    {
-        minus = true;
-        read_element(elem);
-    }
-    else
-        minus = false;
-    l_val = atol(elem.c_str());
-    value = l_val;
-    if (minus)value = 0 - value;
-    return *this;
+    return read_number(value, false);
 }
 
 istring & istring::operator>>(unsigned long &value)
 {
-    long l_val;
-    string elem;
+    return read_number(value, false);
+}
 
-    read_element(elem);
-    l_val = atol(elem.c_str());
-    value = (unsigned long)l_val;
-    return *this;
+istring & istring::operator>>(long long &value)
+{
+    return read_number(value, false);
 }
 
-istring & istring::operator>>(float &value)
+istring & istring::operator>>(unsigned long long &value)
 {
-    float l_val;
-    bool minus;
-    string elem;
+    return read_number(value, false);
+}
 
-    read_element(elem, true);
-    if (elem == "-")
-    {
-        minus = true;
-        read_element(elem);
-    }
-    else
-        minus = false;
-    l_val = atof(elem.c_str());
-    value = l_val;
-    if (minus)value = 0 - value;
-    return *this;
+istring & istring::operator>>(float &value)
+{
+    return read_number(value, true);
 }
 
 istring & istring::operator>>(double &value)
 {
-    double l_val;
-    bool minus;
-    string elem;
-
-    read_element(elem, true);
-    if (elem == "-")
-    {
-        minus = true;
-        read_element(elem);
-    }
-    else
-        minus = false;
-    l_val = strtod(elem.c_str(), 0);
-    value = l_val;
-    if (minus)value = 0 - value;
-    return *this;
+    return read_number(value, true);
 }
 
 istring & istring::operator>>(bool &value)
 {
-    string elem;
+    string_ref elem;
 
     read_element(elem);
-    if (elem == "true")value = true;
-    else value = false;
+    value = (elem == "true");
+    return *this;
+}
+
+/*
+ * The number is parsed in place if it's in the input iobuffer, else
+ * element by element (sign can be a separate element).
+ */
+template<class T>
+istring &istring::read_number(T &value, bool bNumberStr)
+{
+    const char *data;
+    size_t size = peek(data);
+    size_t i = skip_spaces(data, size);
+
+    if ((i < size) && (data[i] != '\r'))
+    {
+        const size_t n = number::parse(data + i, size - i, value, &status_);
+        if (n && (i + n < size))
+        {
+            // the number must be the whole element
+            const char ch = data[i + n];
+            if (check_literals(ch) && (ch != '\\') && (ch != '#') &&
+                (!bNumberStr || ch != '.'))
+            {
+                skip(data, i + n);
+                return *this;
+            }
+        }
+    }
+    skip(data, i);
+
+    string_ref elem;
+    read_element(elem, bNumberStr);
+    string_builder num;
+    if (elem == "-")
+    {
+        num << '-';
+        read_element(elem, bNumberStr);
+    }
+    num << elem;
+    const size_t n = number::parse(num.data(), num.size(), value, &status_);
+    if (!n)value = 0;
+    if ((n != num.size()) && (status_ == number::parse_ok))
+        status_ = number::parse_invalid;
     return *this;
 }
 
@@ -253,6 +199,12 @@ ostring &ostring::operator<<(const string &data)
     return *this;
 }
 
+ostring &ostring::operator<<(const string_ref &data)
+{
+    o_.write(data.data(), data.size()); // TODO: process return value
+    return *this;
+}
+
 ostring &ostring::operator<<(const char *data)
 {
     o_.write(data, strlen(data)); // TODO: process return value
@@ -261,81 +213,85 @@ ostring &ostring::operator<<(const char *data)
 
 ostring &ostring::operator <<(const char& ch)
 {
-    char str[5];
-    snprintf(str, 5, "%d", (int)ch);
-    *this<<(char *)str;
+    char str[number::buffer_size];
+    o_.write(str, number::itoa(ch, str));
     return *this;
 }
 
 ostring &ostring::operator <<(const unsigned char& ch)
 {
-    char str[5];
-    snprintf(str, 5, "%u", (size_t)ch);
-    *this<<(char *)str;
+    char str[number::buffer_size];
+    o_.write(str, number::utoa(ch, str));
     return *this;
 }
 
 ostring &ostring::operator <<(const int& data)
 {
-    char str[64];
-    snprintf(str, 64, "%d", data);
-    *this<<(char *)str;
+    char str[number::buffer_size];
+    o_.write(str, number::itoa(data, str));
     return *this;
 }
 
 ostring &ostring::operator <<(const unsigned int& data)
 {
-    char str[64];
-    snprintf(str, 64, "%u", data);
-    *this<<(char *)str;
+    char str[number::buffer_size];
+    o_.write(str, number::utoa(data, str));
     return *this;
 }
 
 ostring &ostring::operator <<(const short& data)
 {
-    char str[10];
-    snprintf(str, 10, "%d", data);
-    *this<<(char *)str;
+    char str[number::buffer_size];
+    o_.write(str, number::itoa(data, str));
     return *this;
 }
 
 ostring &ostring::operator <<(const unsigned short& data)
 {
-    char str[10];
-    snprintf(str, 10, "%u", data);
-    *this<<(char *)str;
+    char str[number::buffer_size];
+    o_.write(str, number::utoa(data, str));
     return *this;
 }
 
 ostring &ostring::operator <<(const long& data)
 {
-    char str[128];
-    snprintf(str, 128, "%d", data);
-    *this<<(char *)str;
+    char str[number::buffer_size];
+    o_.write(str, number::itoa(data, str));
     return *this;
 }
 
 ostring &ostring::operator <<(const unsigned long& data)
 {
-    char str[128];
-    snprintf(str, 128, "%u", data);
-    *this<<(char *)str;
+    char str[number::buffer_size];
+    o_.write(str, number::utoa(data, str));
+    return *this;
+}
+
+ostring &ostring::operator <<(const long long& data)
+{
+    char str[number::buffer_size];
+    o_.write(str, number::itoa(data, str));
+    return *this;
+}
+
+ostring &ostring::operator <<(const unsigned long long& data)
+{
+    char str[number::buffer_size];
+    o_.write(str, number::utoa(data, str));
     return *this;
 }
 
 ostring &ostring::operator <<(const double& data)
 {
-    char str[128];
-    snprintf(str, 128, "%f", data);
-    *this<<(char *)str;
+    char str[number::buffer_size];
+    o_.write(str, number::dtoa(data, str));
     return *this;
 }
 
 ostring &ostring::operator <<(const float& data)
 {
-    char str[128];
-    snprintf(str, 128, "%f", data);
-    *this<<(char *)str;
+    char str[number::buffer_size];
+    o_.write(str, number::ftoa(data, str));
     return *this;
 }
 
@@ -380,7 +336,134 @@ bool istring::operator --()
 }
  */
 
-bool istring::read_element(string &buf, bool bNumberStr)
+size_t istring::peek(const char *&data)
+{
+    // data pushed back to iob_ must be read first
+    if (iob_.iready())return iob_.peek(data);
+    return i_.peek(data);
+}
+
+void istring::consume(size_t size)
+{
+    if (iob_.iready())iob_.consume(size);
+    else i_.consume(size);
+}
+
+void istring::skip(const char *data, size_t size)
+{
+    if (!size)return;
+    consume(size);
+    prev_ch = (size > 1) ? data[size - 2] : curr_ch;
+    curr_ch = data[size - 1];
+}
+
+/*
+ * Pushing back of a character returned by get(), a line end is counted
+ * again when it's read.
+ */
+void istring::unget(char ch)
+{
+    iob_.write(&ch, sizeof(char));
+    if (ch == '\n')line_num_--;
+}
+
+size_t istring::count_lines(const char *data, size_t size)
+{
+    size_t lines = 0;
+    const char *end = data + size;
+    while ((data < end) &&
+           (data = search::find_first_of(data, end - data, "\r\n", 2)))
+    {
+        if ((*data == '\r') && (data + 1 < end) && (data[1] == '\n'))data++;
+        lines++;
+        data++;
+    }
+    return lines;
+}
+
+size_t istring::skip_spaces(const char *data, size_t size)
+{
+    size_t i = 0;
+    while (i < size)
+    {
+        char ch = data[i];
+        if (ch == ' ' || ch == '\\' || ch == '\t')
+        {
+            i++;
+            continue;
+        }
+        if (ch == '\n')
+        {
+            line_num_++;
+            i++;
+            continue;
+        }
+        if (ch == '\r')
+        {
+            if (i + 1 == size)break; // "\r\n" may be split between blocks
+            line_num_++;
+            i += (data[i + 1] == '\n') ? 2 : 1;
+            continue;
+        }
+        break;
+    }
+    return i;
+}
+
+bool istring::read_element(string &elem, bool bNumberStr)
+{
+    string_ref ref;
+    bool ret = read_element(ref, bNumberStr);
+    elem = ref;
+    return ret;
+}
+
+bool istring::read_element(string_ref &elem, bool bNumberStr)
+{
+    const char *data;
+    size_t size = peek(data);
+    size_t i = skip_spaces(data, size);
+
+    if ((i < size) && (data[i] != '\r'))
+    {
+        size_t start = i;
+        char ch = data[i];
+        if (check_literals(ch) && (ch != '#') && (!bNumberStr || ch != '.'))
+        {
+            if ((ch != '/') || ((i + 1 < size) && (data[i + 1] != '/') &&
+                (data[i + 1] != '*')))
+            {
+                elem = string_ref(data + start, 1);
+                skip(data, i + 1);
+                return true;
+            }
+        }
+        else {
+            if (ch == '#')i++;
+            for (; i < size; i++)
+            {
+                ch = data[i];
+                if (bNumberStr && ch == '.')continue;
+                if (check_literals(ch))break;
+            }
+            // the element may be continued in the next block
+            if ((i < size) && (data[i] != '\\'))
+            {
+                elem = string_ref(data + start, i - start);
+                skip(data, i);
+                return true;
+            }
+        }
+        i = start;
+    }
+
+    skip(data, i);
+    bool ret = read_element_chars(token_, bNumberStr);
+    elem = token_;
+    return ret;
+}
+
+bool istring::read_element_chars(string &buf, bool bNumberStr)
 {
     char ch, ch2;
     buf = "";
@@ -411,7 +494,7 @@ bool istring::read_element(string &buf, bool bNumberStr)
         {
             if (buf.length() > 0) //if already have elem in buf
             {
-                iob_.write(&ch, sizeof(char));
+                unget(ch);
             }
             else {
                 if (ch == '/') //verify comments
@@ -438,7 +521,7 @@ bool istring::read_element(string &buf, bool bNumberStr)
                         continue;
                     }
                     else {
-                        iob_.write(&ch2, sizeof(char));
+                        unget(ch2);
                     }
                 }
                 buf += ch;
@@ -457,7 +540,99 @@ bool istring::read_element(string &buf, bool bNumberStr)
 
 bool istring::read_string(char closeElem, string &str)
 {
-    str = "";
+    string_ref ref;
+    bool ret = read_string(closeElem, ref);
+    str = ref;
+    return ret;
+}
+
+bool istring::read_string(char closeElem, string_ref &str)
+{
+    const char *data;
+    size_t size;
+    bool copied = false;
+    token_ = "";
+    // '\r' is converted by get()
+    while ((closeElem != '\n') && (closeElem != '\r') && (size = peek(data)))
+    {
+        const char *p = (const char *)memchr(data, closeElem, size);
+        size_t n = p ? p - data : size;
+        if (search::find_first_of(data, n, "\r\000", 2))break;
+        line_num_ += count_lines(data, n);
+        if (p)
+        {
+            if (copied)
+            {
+                token_.append(data, n);
+                str = token_;
+            }
+            else str = string_ref(data, n);
+            skip(data, n + 1);
+            return true;
+        }
+        // the string is continued in the next block
+        token_.append(data, n);
+        copied = true;
+        skip(data, n);
+    }
+    bool ret = read_string_chars(closeElem, token_);
+    str = token_;
+    return ret;
+}
+
+bool istring::read_line_to(char closeElem, string &str)
+{
+    string_ref ref;
+    bool ret = read_line_to(closeElem, ref);
+    str = ref;
+    return ret;
+}
+
+bool istring::read_line_to(char closeElem, string_ref &str)
+{
+    const char *data;
+    size_t size;
+    bool copied = false;
+    const char set[4] = {closeElem, '\n', '\r', '\000'};
+    token_ = "";
+    while ((size = peek(data)))
+    {
+        const char *p = search::find_first_of(data, size, set, 4);
+        size_t n = p ? p - data : size;
+        char ch = p ? *p : 0;
+        // '\000' and "\r\n" split between blocks are left to get()
+        if (p && ((ch == closeElem) || (ch == '\n') ||
+                  ((ch == '\r') && (n + 1 < size))))
+        {
+            if (copied)
+            {
+                token_.append(data, n);
+                str = token_;
+            }
+            else str = string_ref(data, n);
+            if (ch == '\r')
+            {
+                line_num_++;
+                skip(data, (data[n + 1] == '\n') ? n + 2 : n + 1);
+                curr_ch = '\n';
+                return true;
+            }
+            if (ch == '\n')line_num_++;
+            skip(data, n + 1);
+            return true;
+        }
+        token_.append(data, n);
+        copied = true;
+        skip(data, n);
+        if (p)break;
+    }
+    bool ret = read_line_to_chars(closeElem, token_);
+    str = token_;
+    return ret;
+}
+
+bool istring::read_string_chars(char closeElem, string &str)
+{
     while (!empty())
     {
         char ch = get();
@@ -468,9 +643,8 @@ bool istring::read_string(char closeElem, string &str)
     return false;
 }
 
-bool istring::read_line_to(char closeElem, string &str)
+bool istring::read_line_to_chars(char closeElem, string &str)
 {
-    str = "";
     while (!empty())
     {
         char ch = get();
@@ -487,9 +661,9 @@ size_t istring::line()
     return line_num_;
 }
 
-bool istring::find_string_value(const string &name)
+bool istring::find_string_value(const string_ref &name)
 {
-    string elem;
+    string_ref elem;
     while (!empty())
     {
         read_element(elem);
@@ -510,16 +684,50 @@ bool istring::go_to(unsigned char ch)
 {
     while (!empty())
     {
+        const char *data;
+        size_t size;
+        if ((ch != '\n') && (ch != '\r') && (size = peek(data)))
+        {
+            const char *p = (const char *)memchr(data, ch, size);
+            size_t n = p ? p - data + 1 : size;
+            // "\r\n" may be split between blocks
+            if ((!p) && (data[n - 1] == '\r'))n--;
+            if (n)
+            {
+                line_num_ += count_lines(data, n);
+                skip(data, n);
+                if (p)return true;
+                continue;
+            }
+        }
         char el = get();
-        if (ch == el)return true;
+        if (ch == (unsigned char)el)return true;
     }
     return false;
 }
 
 void istring::next_line()
 {
-    char ch;
-    for (ch = get(); ch != '\n' && (!empty()); ch = get());
+    while (!empty())
+    {
+        const char *data;
+        size_t size = peek(data);
+        if (size)
+        {
+            const char *p = search::find_first_of(data, size, "\r\n", 2);
+            size_t n = p ? p - data : size;
+            if (p && ((*p == '\n') || (n + 1 < size)))
+            {
+                line_num_++;
+                skip(data, n + ((*p == '\r') && (data[n + 1] == '\n') ? 2 : 1));
+                curr_ch = '\n';
+                return;
+            }
+            skip(data, n);
+            if (!p)continue;
+        }
+        if (get() == '\n')return;
+    }
 }
 
 bool istring::check_literals(char ch)
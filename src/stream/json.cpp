@@ -19,26 +19,28 @@ json::json(jarray &ja) : o_json(ja)
 
 void json::out_str(const char *data, size_t size)
 {
-    char *d_to = (char *) memchr(data, '\"', size);
-    if (d_to)
+    const char *d_to;
+    while ((d_to = (const char *) memchr(data, '\"', size)))
     {
-        out_.write((char *) data, d_to - data);
-        out_ << "\\\"";
-        d_to++;
-        out_str(d_to, size - (d_to - data));
-    }
-    else
-    {
-        out_.write((char *) data, size);
+        out_.write(data, d_to - data);
+        out_.write("\\\"", 2);
+        size -= d_to - data + 1;
+        data = d_to + 1;
     }
+    out_.write(data, size);
 }
 
-void json::out(const string &name, const string &value)
+void json::out(const string_ref &name, const string &value)
 {
     out(name, value.c_str(), value.length());
 }
 
-void json::out(const string &name, const char *value)
+void json::out(const string_ref &name, const string_ref &value)
+{
+    out(name, value.data(), value.size());
+}
+
+void json::out(const string_ref &name, const char *value)
 {
     out(name, value, strlen(value));
 }
@@ -48,12 +50,12 @@ void json::out(size_t id, const char *value)
     out(id, value, strlen(value));
 }
 
-void json::out(const string &name, const char *value, size_t val_sz)
+void json::out(const string_ref &name, const char *value, size_t val_sz)
 {
     if (b_first_)b_first_ = false;
     else out_ << ",";
     out_ << "\"";
-    out_str(name.c_str(), name.length());
+    out_str(name);
     out_ << "\":";
     if ((!val_sz) || ((value[0] != '{')&&(value[0] != '[')))
     {
@@ -84,21 +86,21 @@ void json::out(size_t id, const char *value, size_t val_sz)
     }
 }
 
-void json::out(const string &name, i_base &buf)
+void json::out(const string_ref &name, i_base &buf)
 {
     if (b_first_)b_first_ = false;
     else out_ << ",";
     out_ << "\"";
-    out_str(name.c_str(), name.length());
+    out_str(name);
     out_ << "\":";
     out_ << buf;
 }
 
-void json::out_begin(const string &name){
+void json::out_begin(const string_ref &name){
         if (b_first_)b_first_ = false;
         else out_ << ",";
         out_ << "\"";
-        out_str(name.c_str(), name.length());
+        out_str(name);
         out_ << "\":";
 }
 
@@ -106,7 +108,7 @@ void json::out_begin(const string &name){
 // for dynamic::types
 //-------------------------
 /*
-void json::out(const string &name, dynamic::CObjectContainer *obj)
+void json::out(const string_ref &name, dynamic::CObjectContainer *obj)
 {
   if(b_first_)b_first_=false;
   else out_ << ",";
@@ -116,7 +118,7 @@ void json::out(const string &name, dynamic::CObjectContainer *obj)
   obj->toJson(out_);
 }
 
-void json::out(const string &name, dynamic::CValue &value)
+void json::out(const string_ref &name, dynamic::CValue &value)
 {
   if(b_first_)b_first_=false;
   else out_ << ",";
@@ -59,6 +59,18 @@ bool stringer::iready()
     return (ipos_ < str_.length());
 }
 
+size_t stringer::peek(const char *&data)
+{
+    data = str_.c_str() + ipos_;
+    return str_.length() - ipos_;
+}
+
+void stringer::consume(size_t size)
+{
+    size_t sz = str_.length() - ipos_;
+    ipos_ += (size < sz) ? size : sz;
+}
+
 } //namespace stream
 
 } //namespace bloom
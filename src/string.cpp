@@ -32,4 +32,9 @@ std::ostream& operator<< (std::ostream&o, const bloom::string& str){
     return o;
 }
 
+std::ostream& operator<< (std::ostream&o, const bloom::string_ref& str){
+    o.write(str.data(), str.size());
+    return o;
+}
+
 } //namespace bloom
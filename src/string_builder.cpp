@@ -0,0 +1,169 @@
+/* 
+ * Copyright © 2015 Sergei Khairulin <sergei.khairulin@gmail.com>. 
+ * All rights reserved.
+ *
+ * This file is part of Bloom++.
+ *
+ * Bloom++ is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Bloom++ is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Bloom++.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <new>
+#include <bloom++/string_builder.h>
+#include <bloom++/_bits/number_format.h>
+
+#ifndef va_copy
+#define va_copy __va_copy
+#endif
+
+namespace bloom
+{
+
+string_builder::string_builder():
+data_(local_),
+size_(0),
+capacity_(local_size)
+{
+}
+
+string_builder::string_builder(size_t capacity):
+data_(local_),
+size_(0),
+capacity_(local_size)
+{
+    reserve(capacity);
+}
+
+string_builder::~string_builder()
+{
+    if(data_ != local_)free(data_);
+}
+
+void string_builder::grow(size_t size)
+{
+    size_t capacity = capacity_ * 2;
+    if(capacity < size)capacity = size;
+    // + 1 for c_str()
+    char *data;
+    if(data_ == local_){
+        data = static_cast<char *>(malloc(capacity + 1));
+        if(data)memcpy(data, local_, size_);
+    }
+    else
+        data = static_cast<char *>(realloc(data_, capacity + 1));
+    if(!data)throw std::bad_alloc();
+    data_ = data;
+    capacity_ = capacity;
+}
+
+string_builder &string_builder::appendf(const char *format, ...)
+{
+    va_list args;
+    va_start(args, format);
+    vappendf(format, args);
+    va_end(args);
+    return *this;
+}
+
+string_builder &string_builder::vappendf(const char *format, va_list args)
+{
+    va_list args2;
+    va_copy(args2, args);
+    // the space for '\0' is always available (see grow())
+    int size = vsnprintf(data_ + size_, capacity_ - size_ + 1, format, args2);
+    va_end(args2);
+    if(size < 0)return *this;
+    if(size_ + size > capacity_){
+        grow(size_ + size);
+        va_copy(args2, args);
+        vsnprintf(data_ + size_, capacity_ - size_ + 1, format, args2);
+        va_end(args2);
+    }
+    size_ += size;
+    return *this;
+}
+
+bool string_builder::append_format(const char *&format)
+{
+    const char *p = format;
+    while(true){
+        const char *b = strpbrk(p, "{}");
+        if(!b){
+            size_t sz = strlen(p);
+            append(p, sz);
+            format = p + sz;
+            return false;
+        }
+        append(p, b - p);
+        if(b[0] == '{' && b[1] == '}'){
+            format = b + 2;
+            return true;
+        }
+        append(b[0]);
+        p = (b[1] == b[0]) ? b + 2 : b + 1;
+    }
+}
+
+string_builder &string_builder::append_unsigned(unsigned long long value)
+{
+    if(size_ + number::buffer_size > capacity_)grow(size_ + number::buffer_size);
+    size_ += number::utoa(value, data_ + size_);
+    return *this;
+}
+
+string_builder &string_builder::append_signed(long long value)
+{
+    if(size_ + number::buffer_size > capacity_)grow(size_ + number::buffer_size);
+    size_ += number::itoa(value, data_ + size_);
+    return *this;
+}
+
+string_builder &string_builder::operator<<(double value)
+{
+    if(size_ + number::buffer_size > capacity_)grow(size_ + number::buffer_size);
+    size_ += number::dtoa(value, data_ + size_);
+    return *this;
+}
+
+string_builder &string_builder::operator<<(float value)
+{
+    if(size_ + number::buffer_size > capacity_)grow(size_ + number::buffer_size);
+    size_ += number::ftoa(value, data_ + size_);
+    return *this;
+}
+
+string_builder &string_builder::operator<<(const void *ptr)
+{
+    return appendf("%p", ptr);
+}
+
+string formatf(const char *format, ...)
+{
+    va_list args;
+    va_start(args, format);
+    string str = vformatf(format, args);
+    va_end(args);
+    return str;
+}
+
+string vformatf(const char *format, va_list args)
+{
+    string_builder b;
+    b.vappendf(format, args);
+    return b.str();
+}
+
+} //namespace bloom
@@ -0,0 +1,468 @@
+/* 
+ * Copyright © 2015 Sergei Khairulin <sergei.khairulin@gmail.com>. 
+ * All rights reserved.
+ *
+ * This file is part of Bloom++.
+ *
+ * Bloom++ is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Bloom++ is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Bloom++.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <bloom++/_bits/string_search.h>
+#include <string.h>
+#include <stdint.h>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define BLOOM_SEARCH_X86
+#include <immintrin.h>
+#endif
+
+namespace bloom
+{
+
+namespace search
+{
+
+/// Needles longer than this are searched by find_long().
+static const size_t long_needle = 32;
+
+/// Sets longer than this are searched by lookup table.
+static const size_t small_set = 16;
+
+//-------------------------
+// generic
+//-------------------------
+
+static const char *rfind_generic(const char *s, size_t n, char c)
+{
+    while (n)
+    {
+        if (s[--n] == c)return s + n;
+    }
+    return 0;
+}
+
+static const char *find_generic(const char *s, size_t n, const char *needle, size_t m)
+{
+    const char *p = s;
+    const char *last = s + n - m;
+    while (p <= last)
+    {
+        p = static_cast<const char *>(memchr(p, needle[0], last - p + 1));
+        if (!p)return 0;
+        if (memcmp(p + 1, needle + 1, m - 1) == 0)return p;
+        p++;
+    }
+    return 0;
+}
+
+static void make_table(const char *set, size_t k, unsigned char *table)
+{
+    memset(table, 0, 256);
+    for (size_t i = 0; i < k; i++)
+        table[static_cast<unsigned char>(set[i])] = 1;
+}
+
+static const char *find_first_of_generic(const char *s, size_t n, const char *set, size_t k)
+{
+    unsigned char table[256];
+    make_table(set, k, table);
+    for (size_t i = 0; i < n; i++)
+    {
+        if (table[static_cast<unsigned char>(s[i])])return s + i;
+    }
+    return 0;
+}
+
+/*
+ * Two-Way algorithm (Crochemore, Perrin).
+ * Critical factorization: returns the start of the right half of needle,
+ * period of the right half is stored to *period.
+ */
+static size_t critical_factorization(const unsigned char *needle, size_t m, size_t *period)
+{
+    size_t max_suffix, max_suffix_rev;
+    size_t j, k, p;
+    unsigned char a, b;
+
+    // maximal suffix for '<'
+    max_suffix = static_cast<size_t>(-1);
+    j = 0;
+    k = p = 1;
+    while (j + k < m)
+    {
+        a = needle[j + k];
+        b = needle[max_suffix + k];
+        if (a < b)
+        {
+            j += k;
+            k = 1;
+            p = j - max_suffix;
+        }
+        else if (a == b)
+        {
+            if (k != p)k++;
+            else {
+                j += p;
+                k = 1;
+            }
+        }
+        else {
+            max_suffix = j++;
+            k = p = 1;
+        }
+    }
+    *period = p;
+
+    // maximal suffix for '>'
+    max_suffix_rev = static_cast<size_t>(-1);
+    j = 0;
+    k = p = 1;
+    while (j + k < m)
+    {
+        a = needle[j + k];
+        b = needle[max_suffix_rev + k];
+        if (b < a)
+        {
+            j += k;
+            k = 1;
+            p = j - max_suffix_rev;
+        }
+        else if (a == b)
+        {
+            if (k != p)k++;
+            else {
+                j += p;
+                k = 1;
+            }
+        }
+        else {
+            max_suffix_rev = j++;
+            k = p = 1;
+        }
+    }
+
+    if (max_suffix_rev + 1 < max_suffix + 1)
+        return max_suffix + 1;
+    *period = p;
+    return max_suffix_rev + 1;
+}
+
+static const char *two_way(const char *s, size_t n, const char *needle_, size_t m)
+{
+    const unsigned char *hay = reinterpret_cast<const unsigned char *>(s);
+    const unsigned char *needle = reinterpret_cast<const unsigned char *>(needle_);
+    size_t period;
+    size_t suffix = critical_factorization(needle, m, &period);
+    size_t i, j;
+
+    if (memcmp(needle, needle + period, suffix) == 0)
+    {
+        // periodic needle: remember matched prefix of the left half
+        size_t memory = 0;
+        j = 0;
+        while (j <= n - m)
+        {
+            i = (suffix < memory) ? memory : suffix;
+            while (i < m && needle[i] == hay[i + j])i++;
+            if (m <= i)
+            {
+                i = suffix - 1;
+                while (memory < i + 1 && needle[i] == hay[i + j])i--;
+                if (i + 1 < memory + 1)return s + j;
+                j += period;
+                memory = m - period;
+            }
+            else {
+                j += i - suffix + 1;
+                memory = 0;
+            }
+        }
+    }
+    else {
+        period = ((suffix < m - suffix) ? m - suffix : suffix) + 1;
+        j = 0;
+        while (j <= n - m)
+        {
+            i = suffix;
+            while (i < m && needle[i] == hay[i + j])i++;
+            if (m <= i)
+            {
+                i = suffix - 1;
+                while (i != static_cast<size_t>(-1) && needle[i] == hay[i + j])i--;
+                if (i == static_cast<size_t>(-1))return s + j;
+                j += period;
+            }
+            else
+                j += i - suffix + 1;
+        }
+    }
+    return 0;
+}
+
+/*
+ * Long needles: candidates by the first character (memchr), checked by
+ * the last one and then by memcmp. Switch to Two-Way if there are too
+ * many candidates, so the time stays linear.
+ */
+static const char *find_long(const char *s, size_t n, const char *needle, size_t m)
+{
+    const char *p = s;
+    const char *last = s + n - m;
+    size_t candidates = 0;
+    size_t compares = 0;
+    while (p <= last)
+    {
+        p = static_cast<const char *>(memchr(p, needle[0], last - p + 1));
+        if (!p)return 0;
+        if (p[m - 1] == needle[m - 1])
+        {
+            if (memcmp(p + 1, needle + 1, m - 2) == 0)return p;
+            if (++compares > 8 + (size_t)(p - s) / m)
+                return two_way(p, s + n - p, needle, m);
+        }
+        if (++candidates > 64 + (size_t)(p - s) / 8)
+            return two_way(p, s + n - p, needle, m);
+        p++;
+    }
+    return 0;
+}
+
+//-------------------------
+// SSE2 / AVX2
+//-------------------------
+
+#ifdef BLOOM_SEARCH_X86
+
+__attribute__((target("sse2")))
+static const char *rfind_sse2(const char *s, size_t n, char c)
+{
+    const __m128i v = _mm_set1_epi8(c);
+    while (n >= 16)
+    {
+        n -= 16;
+        __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i *>(s + n));
+        unsigned mask = _mm_movemask_epi8(_mm_cmpeq_epi8(b, v));
+        if (mask)return s + n + 31 - __builtin_clz(mask);
+    }
+    return rfind_generic(s, n, c);
+}
+
+/*
+ * Candidates are positions where both the first and the last characters
+ * of needle match, the rest is compared by memcmp (2 <= m <= long_needle).
+ */
+__attribute__((target("sse2")))
+static const char *find_sse2(const char *s, size_t n, const char *needle, size_t m)
+{
+    const __m128i first = _mm_set1_epi8(needle[0]);
+    const __m128i last = _mm_set1_epi8(needle[m - 1]);
+    size_t i = 0;
+    for (; i + m + 15 <= n; i += 16)
+    {
+        __m128i bf = _mm_loadu_si128(reinterpret_cast<const __m128i *>(s + i));
+        __m128i bl = _mm_loadu_si128(reinterpret_cast<const __m128i *>(s + i + m - 1));
+        unsigned mask = _mm_movemask_epi8(_mm_and_si128(_mm_cmpeq_epi8(bf, first),
+                                                        _mm_cmpeq_epi8(bl, last)));
+        while (mask)
+        {
+            unsigned bit = __builtin_ctz(mask);
+            if (memcmp(s + i + bit + 1, needle + 1, m - 2) == 0)return s + i + bit;
+            mask &= mask - 1;
+        }
+    }
+    if (n - i < m)return 0;
+    return find_generic(s + i, n - i, needle, m);
+}
+
+__attribute__((target("sse2")))
+static const char *find_first_of_sse2(const char *s, size_t n, const char *set, size_t k)
+{
+    if (k > small_set)return find_first_of_generic(s, n, set, k);
+    __m128i v[small_set];
+    for (size_t j = 0; j < k; j++)
+        v[j] = _mm_set1_epi8(set[j]);
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16)
+    {
+        __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i *>(s + i));
+        __m128i eq = _mm_cmpeq_epi8(b, v[0]);
+        for (size_t j = 1; j < k; j++)
+            eq = _mm_or_si128(eq, _mm_cmpeq_epi8(b, v[j]));
+        unsigned mask = _mm_movemask_epi8(eq);
+        if (mask)return s + i + __builtin_ctz(mask);
+    }
+    return find_first_of_generic(s + i, n - i, set, k);
+}
+
+__attribute__((target("avx2")))
+static const char *rfind_avx2(const char *s, size_t n, char c)
+{
+    const __m256i v = _mm256_set1_epi8(c);
+    while (n >= 32)
+    {
+        n -= 32;
+        __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(s + n));
+        unsigned mask = _mm256_movemask_epi8(_mm256_cmpeq_epi8(b, v));
+        if (mask)return s + n + 31 - __builtin_clz(mask);
+    }
+    return rfind_sse2(s, n, c);
+}
+
+__attribute__((target("avx2")))
+static const char *find_avx2(const char *s, size_t n, const char *needle, size_t m)
+{
+    const __m256i first = _mm256_set1_epi8(needle[0]);
+    const __m256i last = _mm256_set1_epi8(needle[m - 1]);
+    size_t i = 0;
+    for (; i + m + 31 <= n; i += 32)
+    {
+        __m256i bf = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(s + i));
+        __m256i bl = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(s + i + m - 1));
+        unsigned mask = _mm256_movemask_epi8(_mm256_and_si256(_mm256_cmpeq_epi8(bf, first),
+                                                              _mm256_cmpeq_epi8(bl, last)));
+        while (mask)
+        {
+            unsigned bit = __builtin_ctz(mask);
+            if (memcmp(s + i + bit + 1, needle + 1, m - 2) == 0)return s + i + bit;
+            mask &= mask - 1;
+        }
+    }
+    if (n - i < m)return 0;
+    return find_sse2(s + i, n - i, needle, m);
+}
+
+__attribute__((target("avx2")))
+static const char *find_first_of_avx2(const char *s, size_t n, const char *set, size_t k)
+{
+    if (k > small_set)return find_first_of_generic(s, n, set, k);
+    __m256i v[small_set];
+    for (size_t j = 0; j < k; j++)
+        v[j] = _mm256_set1_epi8(set[j]);
+    size_t i = 0;
+    for (; i + 32 <= n; i += 32)
+    {
+        __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(s + i));
+        __m256i eq = _mm256_cmpeq_epi8(b, v[0]);
+        for (size_t j = 1; j < k; j++)
+            eq = _mm256_or_si256(eq, _mm256_cmpeq_epi8(b, v[j]));
+        unsigned mask = _mm256_movemask_epi8(eq);
+        if (mask)return s + i + __builtin_ctz(mask);
+    }
+    return find_first_of_sse2(s + i, n - i, set, k);
+}
+
+#endif //BLOOM_SEARCH_X86
+
+//-------------------------
+// runtime dispatching
+//-------------------------
+
+struct impl
+{
+    const char *name;
+    const char *(*rfind)(const char *, size_t, char);
+    const char *(*find)(const char *, size_t, const char *, size_t);
+    const char *(*find_first_of)(const char *, size_t, const char *, size_t);
+};
+
+static const impl impl_generic = {"generic", rfind_generic, find_generic, find_first_of_generic};
+#ifdef BLOOM_SEARCH_X86
+static const impl impl_sse2 = {"sse2", rfind_sse2, find_sse2, find_first_of_sse2};
+static const impl impl_avx2 = {"avx2", rfind_avx2, find_avx2, find_first_of_avx2};
+#endif
+
+static const impl *select_impl()
+{
+#ifdef BLOOM_SEARCH_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2"))return &impl_avx2;
+    if (__builtin_cpu_supports("sse2"))return &impl_sse2;
+#endif
+    return &impl_generic;
+}
+
+// selected on the first call, concurrent first calls select the same
+static const impl *impl_ = 0;
+
+static inline const impl &get_impl()
+{
+    const impl *i = __atomic_load_n(&impl_, __ATOMIC_ACQUIRE);
+    if (!i){
+        i = select_impl();
+        __atomic_store_n(&impl_, i, __ATOMIC_RELEASE);
+    }
+    return *i;
+}
+
+//-------------------------
+
+const char *rfind(const char *s, size_t n, char c)
+{
+    return get_impl().rfind(s, n, c);
+}
+
+const char *find(const char *s, size_t n, const char *needle, size_t m)
+{
+    if (!m)return s;
+    if (m > n)return 0;
+    if (m == 1)return static_cast<const char *>(memchr(s, needle[0], n));
+    if (m > long_needle)return find_long(s, n, needle, m);
+    return get_impl().find(s, n, needle, m);
+}
+
+const char *rfind(const char *s, size_t n, const char *needle, size_t m)
+{
+    if (!m)return s + n;
+    if (m > n)return 0;
+    const impl &i = get_impl();
+    const char *p = s + n - m;
+    while (true)
+    {
+        p = i.rfind(s, p - s + 1, needle[0]);
+        if (!p)return 0;
+        if (memcmp(p + 1, needle + 1, m - 1) == 0)return p;
+        if (p == s)return 0;
+        p--;
+    }
+}
+
+const char *find_first_of(const char *s, size_t n, const char *set, size_t k)
+{
+    if (!k)return 0;
+    if (k == 1)return static_cast<const char *>(memchr(s, set[0], n));
+    return get_impl().find_first_of(s, n, set, k);
+}
+
+const char *find_last_of(const char *s, size_t n, const char *set, size_t k)
+{
+    if (!k)return 0;
+    if (k == 1)return get_impl().rfind(s, n, set[0]);
+    unsigned char table[256];
+    make_table(set, k, table);
+    while (n)
+    {
+        if (table[static_cast<unsigned char>(s[--n])])return s + n;
+    }
+    return 0;
+}
+
+const char *isa()
+{
+    return get_impl().name;
+}
+
+} //namespace search
+
+} //namespace bloom
@@ -0,0 +1,138 @@
+/* 
+ * Copyright © 2015 Sergei Khairulin <sergei.khairulin@gmail.com>. 
+ * All rights reserved.
+ *
+ * This file is part of Bloom++.
+ *
+ * Bloom++ is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Bloom++ is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Bloom++.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+#include <bloom++/thread_attributes.h>
+
+namespace bloom
+{
+
+thread_attributes::thread_attributes():
+ncpus_(0),
+bSpread_(false),
+stack_size_(0),
+priority_(0)
+{
+    name_[0] = 0;
+#ifdef __linux__
+    CPU_ZERO(&cpuset_);
+#endif
+}
+
+thread_attributes &thread_attributes::set_name(const char *name)
+{
+    strncpy(name_, name, sizeof(name_) - 1);
+    name_[sizeof(name_) - 1] = 0;
+    return *this;
+}
+
+thread_attributes &thread_attributes::add_cpu(int cpu)
+{
+#ifdef __linux__
+    if(cpu >= 0 && cpu < CPU_SETSIZE && !CPU_ISSET(cpu, &cpuset_)){
+        CPU_SET(cpu, &cpuset_);
+        ++ncpus_;
+    }
+#endif
+    return *this;
+}
+
+thread_attributes &thread_attributes::add_cpus(int first, int last)
+{
+    for(int cpu = first; cpu <= last; ++cpu)
+        add_cpu(cpu);
+    return *this;
+}
+
+thread_attributes &thread_attributes::set_spread(bool spread)
+{
+    bSpread_ = spread;
+    return *this;
+}
+
+thread_attributes &thread_attributes::set_stack_size(size_t size)
+{
+    stack_size_ = size;
+    return *this;
+}
+
+thread_attributes &thread_attributes::set_priority(int priority)
+{
+    priority_ = priority;
+    return *this;
+}
+
+thread_attributes thread_attributes::for_index(size_t index) const
+{
+    thread_attributes a(*this);
+    if(name_[0]){
+        char suffix[24];
+        int n = snprintf(suffix, sizeof(suffix), "-%lu", (unsigned long)index);
+        size_t len = strlen(name_);
+        if(len + n > sizeof(name_) - 1)
+            len = sizeof(name_) - 1 - n;
+        memcpy(a.name_ + len, suffix, n + 1);
+    }
+#ifdef __linux__
+    if(bSpread_ && ncpus_){
+        int k = index % ncpus_;
+        CPU_ZERO(&a.cpuset_);
+        a.ncpus_ = 1;
+        for(int cpu = 0; cpu < CPU_SETSIZE; ++cpu){
+            if(CPU_ISSET(cpu, &cpuset_) && !k--){
+                CPU_SET(cpu, &a.cpuset_);
+                break;
+            }
+        }
+    }
+#endif
+    a.bSpread_ = false;
+    return a;
+}
+
+void thread_attributes::init(pthread_attr_t &attr) const
+{
+    if(stack_size_)
+        pthread_attr_setstacksize(&attr, stack_size_);
+}
+
+int thread_attributes::apply(pthread_t thread) const
+{
+    int ret = 0, r;
+#ifdef __linux__
+    if(name_[0] && (r = pthread_setname_np(thread, name_)) && !ret)
+        ret = r;
+    if(ncpus_ && (r = pthread_setaffinity_np(thread, sizeof(cpuset_), &cpuset_)) && !ret)
+        ret = r;
+#endif
+    if(priority_){
+        sched_param param;
+        memset(&param, 0, sizeof(param));
+        param.sched_priority = priority_;
+        if((r = pthread_setschedparam(thread, SCHED_FIFO, &param)) && !ret)
+            ret = r;
+    }
+    return ret;
+}
+
+}//namespace bloom
@@ -0,0 +1,278 @@
+/* 
+ * Copyright © 2015 Sergei Khairulin <sergei.khairulin@gmail.com>. 
+ * All rights reserved.
+ *
+ * This file is part of Bloom++.
+ *
+ * Bloom++ is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Bloom++ is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Bloom++.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <unistd.h>
+#include <pthread.h>
+#include <sched.h>
+#include <bloom++/thread_pool.h>
+#include <bloom++/thread.h>
+#include <bloom++/_bits/ws_deque.h>
+
+namespace bloom
+{
+
+struct thread_pool::worker
+{
+    ws_deque<pool_task> deque_;
+    thread<thread_pool, worker*> thread_;
+    size_t index_;
+    unsigned int seed_;
+    
+    worker(thread_pool *pool, size_t index):
+    thread_(&thread_pool::run_worker, pool),
+    index_(index),
+    seed_(index * 2654435761u + 1)
+    {
+    }
+    
+    size_t next_random()
+    {
+        seed_ = seed_ * 1103515245u + 12345u;
+        return seed_ >> 8;
+    }
+};
+
+namespace
+{
+
+__thread thread_pool *current_pool_ = 0;
+__thread void *current_worker_ = 0; // thread_pool::worker
+
+pthread_once_t shared_once = PTHREAD_ONCE_INIT;
+thread_pool *shared_pool = 0;
+
+void create_shared_pool()
+{
+    // never destroyed, the workers live until the process exit
+    shared_pool = new thread_pool();
+}
+
+} //namespace
+
+thread_pool::thread_pool(size_t threads):
+workers_(0),
+size_(threads),
+queued_(0),
+sleepers_(0),
+reserved_(0),
+bStopping_(false)
+{
+    m_.set_name("thread_pool");
+    start(thread_attributes());
+}
+
+thread_pool::thread_pool(size_t threads, const thread_attributes &attr):
+workers_(0),
+size_(threads),
+queued_(0),
+sleepers_(0),
+reserved_(0),
+bStopping_(false)
+{
+    m_.set_name("thread_pool");
+    start(attr);
+}
+
+void thread_pool::start(const thread_attributes &attr)
+{
+    if(!size_){
+        long n = sysconf(_SC_NPROCESSORS_ONLN);
+        size_ = n > 0 ? n : 1;
+    }
+    workers_ = new worker*[size_];
+    for(size_t i = 0; i < size_; ++i){
+        workers_[i] = new worker(this, i);
+        workers_[i]->thread_.set_attributes(attr.for_index(i));
+    }
+    for(size_t i = 0; i < size_; ++i)
+        workers_[i]->thread_.start(workers_[i]);
+}
+
+thread_pool::~thread_pool()
+{
+    {
+        mutex::scoped_lock sl(m_);
+        bStopping_ = true;
+        cv_.notify_all();
+    }
+    for(size_t i = 0; i < size_; ++i)
+        workers_[i]->thread_.wait();
+    for(size_t i = 0; i < size_; ++i)
+        delete workers_[i];
+    delete [] workers_;
+}
+
+thread_pool *thread_pool::current()
+{
+    return current_pool_;
+}
+
+thread_pool &thread_pool::shared()
+{
+    pthread_once(&shared_once, create_shared_pool);
+    return *shared_pool;
+}
+
+void thread_pool::execute(pool_task *task)
+{
+    if(current_pool_ == this){
+        static_cast<worker*>(current_worker_)->deque_.push(task);
+        __sync_synchronize();
+        if(__atomic_load_n(&sleepers_, __ATOMIC_ACQUIRE)){
+            mutex::scoped_lock sl(m_);
+            cv_.notify_one();
+        }
+        return;
+    }
+    mutex::scoped_lock sl(m_);
+    queue_.push_back(task);
+    __sync_fetch_and_add(&queued_, 1);
+    if(sleepers_)
+        cv_.notify_one();
+}
+
+bool thread_pool::reserve(size_t n)
+{
+    size_t reserved = __atomic_load_n(&reserved_, __ATOMIC_RELAXED);
+    do{
+        if(reserved + n > size_)
+            return false;
+    }
+    while(!__atomic_compare_exchange_n(&reserved_, &reserved, reserved + n, false,
+                                       __ATOMIC_ACQ_REL, __ATOMIC_RELAXED));
+    return true;
+}
+
+void thread_pool::unreserve(size_t n)
+{
+    __sync_fetch_and_sub(&reserved_, n);
+}
+
+bool thread_pool::run_one()
+{
+    pool_task *task = find_task(current_pool_ == this ? static_cast<worker*>(current_worker_) : 0);
+    if(!task)
+        return false;
+    run_task(task);
+    return true;
+}
+
+bool thread_pool::run_own()
+{
+    if(current_pool_ != this)
+        return false;
+    pool_task *task = static_cast<worker*>(current_worker_)->deque_.pop();
+    if(!task)
+        return false;
+    run_task(task);
+    return true;
+}
+
+void thread_pool::run_task(pool_task *task)
+{
+    try{
+        task->run();
+    }
+    catch(...){
+        // the worker must survive exceptions of raw tasks
+    }
+    delete task;
+}
+
+pool_task *thread_pool::take_queued()
+{
+    if(!__atomic_load_n(&queued_, __ATOMIC_ACQUIRE))
+        return 0;
+    mutex::scoped_lock sl(m_);
+    if(!queue_.size())
+        return 0;
+    pool_task *task = queue_.front();
+    queue_.pop_front();
+    __sync_fetch_and_sub(&queued_, 1);
+    return task;
+}
+
+pool_task *thread_pool::find_task(worker *w)
+{
+    pool_task *task;
+    if(w && (task = w->deque_.pop()))
+        return task;
+    if((task = take_queued()))
+        return task;
+    if(size_ < 2 && w)
+        return 0;
+    // stealing from a random victim and the next ones
+    const size_t start = w ? w->next_random() : 0;
+    for(size_t i = 0; i < size_; ++i){
+        worker *victim = workers_[(start + i) % size_];
+        if(victim == w)
+            continue;
+        if((task = victim->deque_.steal()))
+            return task;
+    }
+    return 0;
+}
+
+bool thread_pool::has_tasks() const
+{
+    if(__atomic_load_n(&queued_, __ATOMIC_ACQUIRE))
+        return true;
+    for(size_t i = 0; i < size_; ++i)
+        if(!workers_[i]->deque_.empty())
+            return true;
+    return false;
+}
+
+void thread_pool::run_worker(worker *w)
+{
+    current_pool_ = this;
+    current_worker_ = w;
+    size_t idle = 0;
+    for(;;){
+        pool_task *task = find_task(w);
+        if(task){
+            run_task(task);
+            idle = 0;
+            continue;
+        }
+        if(++idle < 64){
+            sched_yield();
+            continue;
+        }
+        // sleepers_ is incremented before the last check: a producer either
+        // sees the sleeper or the sleeper sees the task
+        mutex::scoped_lock sl(m_);
+        __sync_fetch_and_add(&sleepers_, 1);
+        if(!has_tasks()){
+            if(bStopping_){
+                __sync_fetch_and_sub(&sleepers_, 1);
+                break;
+            }
+            cv_.wait(sl);
+        }
+        __sync_fetch_and_sub(&sleepers_, 1);
+        idle = 0;
+    }
+    current_worker_ = 0;
+    current_pool_ = 0;
+}
+
+}//namespace bloom
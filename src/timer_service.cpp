@@ -0,0 +1,470 @@
+/* 
+ * Copyright © 2015 Sergei Khairulin <sergei.khairulin@gmail.com>. 
+ * All rights reserved.
+ *
+ * This file is part of Bloom++.
+ *
+ * Bloom++ is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Bloom++ is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Bloom++.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <string.h>
+#include <unistd.h>
+#include <time.h>
+#ifdef LINUX
+#include <poll.h>
+#include <stdint.h>
+#include <sys/timerfd.h>
+#include <sys/eventfd.h>
+#endif
+#include <bloom++/timer_service.h>
+#include <bloom++/_bits/futex.h>
+
+namespace bloom
+{
+
+/// @cond
+struct timer_node
+{
+    timer_node *next;
+    timer_node **pprev; // 0 if not scheduled
+    // handler: 0 if free, fired one-shot timers keep it until the firing ends
+    unsigned long long expires;
+    unsigned long long period;
+    timer_handler *handler;
+    unsigned int index;
+    unsigned int gen;
+};
+/// @endcond
+
+namespace
+{
+
+__thread timer_handler *current_handler_ = 0;
+
+pthread_once_t shared_once = PTHREAD_ONCE_INIT;
+timer_service *shared_service = 0;
+
+void create_shared_service()
+{
+    // never destroyed, timers may be cancelled from static destructors
+    shared_service = new timer_service;
+}
+
+unsigned long long monotonic_ns()
+{
+    timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (unsigned long long)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+void fire(timer_handler *h)
+{
+    if(!h->cancelled()){
+        current_handler_ = h;
+        try{
+            h->fire();
+        }
+        catch(...){
+            // exceptions of handlers don't stop the service
+        }
+        current_handler_ = 0;
+    }
+    h->release();
+}
+
+class timer_task: public pool_task
+{
+public:
+    timer_task(timer_handler *h):h_(h){}
+    
+    void run()
+    {
+        fire(h_);
+    }
+    
+private:
+    timer_handler *h_;
+};
+
+} //namespace
+
+void timer_handler::add_ref()
+{
+    __sync_fetch_and_add(&refs_, 1);
+}
+
+void timer_handler::release()
+{
+    const int r = __sync_sub_and_fetch(&refs_, 1);
+    if(!(r & refs_mask))
+        delete this;
+    else if(r & waiting)
+        futex_wake_all(&refs_);
+}
+
+void timer_handler::wait_idle(int refs)
+{
+    __sync_fetch_and_or(&refs_, waiting);
+    int r;
+    while(((r = __atomic_load_n(&refs_, __ATOMIC_SEQ_CST)) & refs_mask) > refs)
+        futex_wait(&refs_, r);
+}
+
+timer_service::timer_service(long tick_ms, executor *ex, const thread_attributes &attr):
+tick_ms_(tick_ms),
+executor_(ex),
+m_("timer_service"),
+ticks_(0),
+start_ns_(monotonic_ns()),
+count_(0),
+chunks_(0),
+nchunks_(0),
+free_(0),
+timerfd_(-1),
+eventfd_(-1),
+bStopping_(false),
+firing_(0),
+thread_(&timer_service::run, this)
+{
+    if(tick_ms_ <= 0)
+        throw timer_service_exception("timer_service: tick must be positive");
+    memset(root_, 0, sizeof(root_));
+    memset(level_, 0, sizeof(level_));
+#ifdef LINUX
+    timerfd_ = timerfd_create(CLOCK_MONOTONIC, TFD_CLOEXEC);
+    eventfd_ = eventfd(0, EFD_CLOEXEC);
+    if(timerfd_ < 0 || eventfd_ < 0){
+        if(timerfd_ >= 0)close(timerfd_);
+        if(eventfd_ >= 0)close(eventfd_);
+        throw timer_service_exception("timer_service: timerfd/eventfd failed");
+    }
+#endif
+    thread_.set_attributes(attr);
+    if(thread_.start()){
+#ifdef LINUX
+        close(timerfd_);
+        close(eventfd_);
+#endif
+        throw timer_service_exception("timer_service: thread start failed");
+    }
+}
+
+timer_service::~timer_service()
+{
+    __atomic_store_n(&bStopping_, true, __ATOMIC_RELEASE);
+#ifdef LINUX
+    uint64_t one = 1;
+    if(write(eventfd_, &one, sizeof(one)) < 0){}
+#endif
+    thread_.wait();
+    for(size_t c = 0; c < nchunks_; ++c){
+        for(size_t i = 0; i < (1 << chunk_bits); ++i)
+            if(chunks_[c][i].handler)
+                chunks_[c][i].handler->release();
+        delete [] chunks_[c];
+    }
+    free(chunks_);
+#ifdef LINUX
+    close(timerfd_);
+    close(eventfd_);
+#endif
+}
+
+timer_service &timer_service::shared()
+{
+    pthread_once(&shared_once, create_shared_service);
+    return *shared_service;
+}
+
+timer_service::timer_id timer_service::schedule(timer_handler *h, long delay_ms, long period_ms)
+{
+    if(!h)
+        throw timer_service_exception("timer_service::schedule: null handler");
+    if(delay_ms < 0)
+        delay_ms = 0;
+    if(period_ms < 0)
+        period_ms = 0;
+    // rounding up: a timer never fires before its delay
+    const unsigned long long delay = (delay_ms + tick_ms_ - 1) / tick_ms_ + 1;
+    const unsigned long long period = period_ms ? (period_ms + tick_ms_ - 1) / tick_ms_ : 0;
+    
+    mutex::scoped_lock sl(m_);
+    timer_node *n = alloc_node();
+    const unsigned long long now = now_ticks();
+    if(!count_){
+        // the wheel is empty, skip the ticks passed while idle
+        ticks_ = now;
+        arm(true);
+    }
+    n->expires = now + delay;
+    n->period = period;
+    n->handler = h;
+    place(n);
+    ++count_;
+    return ((unsigned long long)n->gen << 32) | (n->index + 1);
+}
+
+bool timer_service::cancel(timer_id id, bool wait)
+{
+    // a handler doesn't wait for firings: its own one is running and
+    // others may be dispatched after it on the same thread
+    wait = wait && !current_handler_;
+    timer_handler *h;
+    bool scheduled;
+    {
+        mutex::scoped_lock sl(m_);
+        timer_node *n = node(id);
+        if(!n)
+            return false;
+        h = n->handler;
+        scheduled = n->pprev != 0;
+        if(scheduled){
+            if(n->next)
+                n->next->pprev = n->pprev;
+            *n->pprev = n->next;
+            free_node(n);
+            --count_;
+            h->cancel(); // dispatched firings are skipped
+        }
+        else{
+            // fired one-shot timer, the node holds a reference until
+            // the firing ends
+            if(!wait)
+                return false;
+            h->add_ref();
+        }
+    }
+    if(wait)
+        h->wait_idle(scheduled ? 1 : 2);
+    h->release();
+    return scheduled;
+}
+
+size_t timer_service::size()
+{
+    mutex::scoped_lock sl(m_);
+    return count_;
+}
+
+void timer_service::run()
+{
+#ifdef LINUX
+    pollfd fds[2];
+    fds[0].fd = timerfd_;
+    fds[0].events = POLLIN;
+    fds[1].fd = eventfd_;
+    fds[1].events = POLLIN;
+#endif
+    while(!__atomic_load_n(&bStopping_, __ATOMIC_ACQUIRE)){
+#ifdef LINUX
+        if(poll(fds, 2, -1) <= 0)
+            continue;
+        uint64_t v;
+        if(fds[1].revents & POLLIN)
+            if(read(eventfd_, &v, sizeof(v)) < 0){}
+        if(!(fds[0].revents & POLLIN))
+            continue;
+        if(read(timerfd_, &v, sizeof(v)) < 0)
+            continue;
+#else
+        usleep(tick_ms_ * 1000);
+#endif
+        {
+            mutex::scoped_lock sl(m_);
+            if(count_)
+                advance(now_ticks());
+        }
+        for(size_t i = 0; i < fired_.size(); ++i)
+            dispatch(fired_[i]);
+        fired_.clear();
+        reclaim();
+    }
+}
+
+void timer_service::reclaim()
+{
+    vector<timer_handler*> idle;
+    {
+        mutex::scoped_lock sl(m_);
+        timer_node **p = &firing_;
+        while(*p){
+            timer_node *n = *p;
+            if(n->handler->refs() > 1){
+                p = &n->next;
+                continue;
+            }
+            *p = n->next;
+            idle.push_back(n->handler);
+            free_node(n);
+        }
+        // ticking continues until dispatched firings end
+        if(!count_ && !firing_)
+            arm(false);
+    }
+    for(size_t i = 0; i < idle.size(); ++i)
+        idle[i]->release();
+}
+
+void timer_service::arm(bool on)
+{
+#ifdef LINUX
+    itimerspec its;
+    memset(&its, 0, sizeof(its));
+    if(on){
+        its.it_interval.tv_sec = tick_ms_ / 1000;
+        its.it_interval.tv_nsec = (tick_ms_ % 1000) * 1000000;
+        its.it_value = its.it_interval;
+    }
+    timerfd_settime(timerfd_, 0, &its, 0);
+#else
+    (void)on;
+#endif
+}
+
+unsigned long long timer_service::now_ticks()
+{
+    return (monotonic_ns() - start_ns_) / (tick_ms_ * 1000000ULL);
+}
+
+void timer_service::advance(unsigned long long target)
+{
+    while(ticks_ <= target){
+        const size_t index = ticks_ & (root_size - 1);
+        if(!index)
+            for(int l = 0; l < levels && !cascade(l); ++l);
+        timer_node *n = root_[index];
+        root_[index] = 0;
+        while(n){
+            timer_node *next = n->next;
+            n->pprev = 0;
+            expire(n);
+            n = next;
+        }
+        ++ticks_;
+        if(!count_){
+            ticks_ = target + 1;
+            break;
+        }
+    }
+}
+
+void timer_service::place(timer_node *n)
+{
+    unsigned long long e = n->expires < ticks_ ? ticks_ : n->expires;
+    const unsigned long long d = e - ticks_;
+    timer_node **head;
+    if(d < root_size)
+        head = &root_[e & (root_size - 1)];
+    else{
+        int l = 0;
+        while(l < levels - 1 && d >= 1ULL << (root_bits + (l + 1) * level_bits))
+            ++l;
+        if(d >= 1ULL << (root_bits + levels * level_bits))
+            // out of range, placed again by cascading
+            e = ticks_ + (1ULL << (root_bits + levels * level_bits)) - 1;
+        head = &level_[l][(e >> (root_bits + l * level_bits)) & (level_size - 1)];
+    }
+    n->next = *head;
+    if(n->next)
+        n->next->pprev = &n->next;
+    n->pprev = head;
+    *head = n;
+}
+
+size_t timer_service::cascade(int level)
+{
+    const size_t index = (ticks_ >> (root_bits + level * level_bits)) & (level_size - 1);
+    timer_node *n = level_[level][index];
+    level_[level][index] = 0;
+    while(n){
+        timer_node *next = n->next;
+        place(n);
+        n = next;
+    }
+    return index;
+}
+
+void timer_service::expire(timer_node *n)
+{
+    timer_handler *h = n->handler;
+    if(n->period){
+        n->expires += n->period;
+        if(n->expires <= ticks_)
+            n->expires = ticks_ + 1; // missed periods are skipped
+        place(n);
+        h->add_ref();
+    }
+    else{
+        n->next = firing_;
+        firing_ = n;
+        --count_;
+        h->add_ref();
+    }
+    fired_.push_back(h);
+}
+
+void timer_service::dispatch(timer_handler *h)
+{
+    if(executor_)
+        executor_->execute(new timer_task(h));
+    else
+        fire(h);
+}
+
+timer_node *timer_service::node(timer_id id)
+{
+    const size_t index = (size_t)(id & 0xffffffffULL) - 1;
+    if(!(id & 0xffffffffULL) || index >= (nchunks_ << chunk_bits))
+        return 0;
+    timer_node *n = &chunks_[index >> chunk_bits][index & ((1 << chunk_bits) - 1)];
+    if(n->gen != (unsigned int)(id >> 32) || !n->handler)
+        return 0;
+    return n;
+}
+
+timer_node *timer_service::alloc_node()
+{
+    if(!free_){
+        timer_node **chunks = (timer_node**)realloc(chunks_, (nchunks_ + 1) * sizeof(timer_node*));
+        if(!chunks)
+            throw timer_service_exception("timer_service: out of memory");
+        chunks_ = chunks;
+        timer_node *c = new timer_node[1 << chunk_bits];
+        chunks_[nchunks_] = c;
+        for(size_t i = 1 << chunk_bits; i--;){
+            c[i].pprev = 0;
+            c[i].handler = 0;
+            c[i].gen = 0;
+            c[i].index = (nchunks_ << chunk_bits) + i;
+            c[i].next = free_;
+            free_ = &c[i];
+        }
+        ++nchunks_;
+    }
+    timer_node *n = free_;
+    free_ = n->next;
+    return n;
+}
+
+void timer_service::free_node(timer_node *n)
+{
+    n->pprev = 0;
+    n->handler = 0;
+    ++n->gen; // invalidates the identifier
+    n->next = free_;
+    free_ = n;
+}
+
+} //namespace bloom
@@ -0,0 +1,140 @@
+/* 
+ * Copyright © 2015 Sergei Khairulin <sergei.khairulin@gmail.com>. 
+ * All rights reserved.
+ *
+ * This file is part of Bloom++.
+ *
+ * Bloom++ is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Bloom++ is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Bloom++.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+/*
+ * stream::istring: the same text read from blocks of every size gives
+ * the same elements and line numbers as the text read at once.
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <bloom++/stream/iostring.h>
+#include "test.h"
+
+using namespace bloom;
+
+namespace
+{
+
+/*
+ * Input with a peek() window of at most block bytes.
+ */
+class blocks: public stream::i_base
+{
+    const char *data_;
+    size_t size_;
+    size_t block_;
+    size_t pos_;
+public:
+    blocks(const char *data, size_t block):
+    data_(data), size_(strlen(data)), block_(block), pos_(0){}
+    
+    virtual size_t read(char *data, size_t size)
+    {
+        if(size > size_ - pos_)size = size_ - pos_;
+        memcpy(data, data_ + pos_, size);
+        pos_ += size;
+        return size;
+    }
+    
+    virtual stream::i_base &operator>>(stream::o_base &o)
+    {
+        pos_ += o.write(data_ + pos_, size_ - pos_);
+        return *this;
+    }
+    
+    virtual bool iready()
+    {
+        return pos_ < size_;
+    }
+    
+    virtual size_t peek(const char *&data)
+    {
+        data = data_ + pos_;
+        const size_t n = size_ - pos_;
+        return n < block_ ? n : block_;
+    }
+    
+    virtual void consume(size_t size)
+    {
+        pos_ += size;
+    }
+};
+
+const char text[] =
+    "alpha beta\r\n"
+    "  12 -7\n"
+    "\"str\nx\" // comment\n"
+    "next\r\n"
+    "3.5\n"
+    "/* a\r\nb */ end\n"
+    "key = value\r\n"
+    "skipped line\n"
+    "last";
+
+/*
+ * Reading of text, elements and line numbers after every step are
+ * appended to out.
+ */
+string read(size_t block)
+{
+    blocks in(text, block);
+    stream::istring is(in);
+    string out, s;
+    char num[32];
+    int i;
+    double d;
+    
+    #define STEP(v) out += v; snprintf(num, sizeof num, "@%u ", (unsigned)is.line()); out += num
+    is.read_element(s); STEP(s);
+    is.read_element(s); STEP(s);
+    is>>i; snprintf(num, sizeof num, "%d", i); STEP(num);
+    is>>i; snprintf(num, sizeof num, "%d", i); STEP(num);
+    is.read_element(s); STEP(s);
+    is.read_string('"', s); STEP(s);
+    is.read_element(s); STEP(s);
+    is>>d; snprintf(num, sizeof num, "%g", d); STEP(num);
+    is.read_element(s); STEP(s);
+    CHECK(is.find_string_value("key"));
+    STEP("key=");
+    is.read_element(s); STEP(s);
+    is.next_line(); STEP("");
+    is.next_line(); STEP("");
+    is.read_element(s); STEP(s);
+    #undef STEP
+    return out;
+}
+
+} //namespace
+
+int main()
+{
+    const string whole = read(sizeof text);
+    CHECK_STR(whole.c_str(), "alpha@1 beta@1 12@2 -7@2 \"@3 str\nx@4 next@5 "
+              "3.5@6 end@8 key=@9 value@9 @10 @11 last@11 ");
+    for(size_t block = 1; block < sizeof text; ++block){
+        const string part = read(block);
+        if(part != whole)
+            printf("block %u:\n", (unsigned)block);
+        CHECK_STR(part.c_str(), whole.c_str());
+    }
+    return test::result("iostring");
+}
@@ -0,0 +1,130 @@
+/* 
+ * Copyright © 2015 Sergei Khairulin <sergei.khairulin@gmail.com>. 
+ * All rights reserved.
+ *
+ * This file is part of Bloom++.
+ *
+ * Bloom++ is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Bloom++ is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Bloom++.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+/*
+ * number::dtoa()/ftoa(): fixed values and a random sample checked for
+ * round trip and shortest length against snprintf()/strtod().
+ */
+
+#include <stdlib.h>
+#include <stdint.h>
+#include <bloom++/_bits/number_format.h>
+#include "test.h"
+
+using namespace bloom;
+
+namespace
+{
+
+const char *dtoa(double v)
+{
+    static char buf[number::buffer_size + 1];
+    buf[number::dtoa(v, buf)] = 0;
+    return buf;
+}
+
+const char *ftoa(float v)
+{
+    static char buf[number::buffer_size + 1];
+    buf[number::ftoa(v, buf)] = 0;
+    return buf;
+}
+
+// significant digits of the mantissa without trailing zeros
+int digits(const char *s)
+{
+    int n = 0, last = 0;
+    bool lead = true;
+    for(; *s && *s != 'e'; ++s){
+        if(*s < '0' || *s > '9' || (lead && *s == '0'))
+            continue;
+        lead = false;
+        ++n;
+        if(*s != '0')
+            last = n;
+    }
+    return last ? last : 1;
+}
+
+int shortest(double v, bool single)
+{
+    for(int n = 1; n < 17; ++n){
+        char buf[40];
+        snprintf(buf, sizeof(buf), "%.*e", n - 1, v);
+        if(single ? strtof(buf, 0) == (float)v : strtod(buf, 0) == v)
+            return n;
+    }
+    return 17;
+}
+
+uint64_t random64()
+{
+    static uint64_t x = 88172645463325252ULL;
+    x ^= x << 13;
+    x ^= x >> 7;
+    x ^= x << 17;
+    return x;
+}
+
+} //namespace
+
+int main()
+{
+    CHECK_STR(dtoa(0.0), "0");
+    CHECK_STR(dtoa(-0.0), "-0");
+    CHECK_STR(dtoa(12.5), "12.5");
+    CHECK_STR(dtoa(0.1), "0.1");
+    CHECK_STR(dtoa(0.3), "0.3");
+    CHECK_STR(dtoa(1e30), "1e+30");
+    CHECK_STR(dtoa(1.5e-7), "1.5e-7");
+    CHECK_STR(dtoa(1e20), "100000000000000000000");
+    CHECK_STR(dtoa(1e21), "1e+21");
+    // Grisu2 gave 9.999999999999999e+22
+    CHECK_STR(dtoa(1e23), "1e+23");
+    CHECK_STR(dtoa(5e-324), "5e-324");
+    CHECK_STR(dtoa(1.7976931348623157e308), "1.7976931348623157e+308");
+    CHECK_STR(dtoa(2.2250738585072014e-308), "2.2250738585072014e-308");
+    CHECK_STR(dtoa(strtod("nan", 0)), "nan");
+    CHECK_STR(dtoa(-strtod("inf", 0)), "-inf");
+    CHECK_STR(ftoa(0.1f), "0.1");
+    CHECK_STR(ftoa(3.4028235e38f), "3.4028235e+38");
+    CHECK_STR(ftoa(1e-45f), "1e-45");
+
+    for(int i = 0; i < 200000; ++i){
+        union { uint64_t u; double d; } v;
+        v.u = random64();
+        if(v.d != v.d || v.d - v.d != 0)
+            continue;
+        const char *s = dtoa(v.d);
+        CHECK(strtod(s, 0) == v.d);
+        CHECK(digits(s) == shortest(v.d, false));
+    }
+    for(int i = 0; i < 200000; ++i){
+        union { uint32_t u; float f; } v;
+        v.u = (uint32_t)random64();
+        if(v.f != v.f || v.f - v.f != 0)
+            continue;
+        const char *s = ftoa(v.f);
+        CHECK(strtof(s, 0) == v.f);
+        CHECK(digits(s) == shortest(v.f, true));
+    }
+    return test::result("number_format");
+}
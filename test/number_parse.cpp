@@ -0,0 +1,88 @@
+/* 
+ * Copyright © 2015 Sergei Khairulin <sergei.khairulin@gmail.com>. 
+ * All rights reserved.
+ *
+ * This file is part of Bloom++.
+ *
+ * Bloom++ is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Bloom++ is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Bloom++.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+/*
+ * number::parse(): consumed characters, values and status of edge cases.
+ */
+
+#include <math.h>
+#include <bloom++/_bits/number_parse.h>
+#include "test.h"
+
+using namespace bloom;
+
+namespace
+{
+
+template<class T>
+size_t parse(const char *s, T &value, number::parse_status &status)
+{
+    return number::parse(s, strlen(s), value, &status);
+}
+
+} //namespace
+
+int main()
+{
+    number::parse_status st;
+    double d;
+    float f;
+    int i;
+    unsigned char uc;
+    
+    // exponent without digits isn't a part of number
+    d = -1;
+    CHECK(parse("1e", d, st) == 1 && d == 1 && st == number::parse_ok);
+    CHECK(parse("1e+", d, st) == 1 && d == 1 && st == number::parse_ok);
+    CHECK(parse("2.5E-x", d, st) == 3 && d == 2.5 && st == number::parse_ok);
+    CHECK(parse("1e5", d, st) == 3 && d == 1e5 && st == number::parse_ok);
+    
+    // underflow and overflow
+    CHECK(parse("1e-400", d, st) == 6 && d == 0 && st == number::parse_underflow);
+    CHECK(parse("-1e-400", d, st) == 7 && d == 0 && st == number::parse_underflow);
+    CHECK(parse("1e-50", f, st) == 5 && f == 0 && st == number::parse_underflow);
+    CHECK(parse("1e400", d, st) == 5 && isinf(d) && st == number::parse_overflow);
+    CHECK(parse("1e50", f, st) == 4 && isinf(f) && st == number::parse_overflow);
+    CHECK(parse("0e-400", d, st) == 6 && d == 0 && st == number::parse_ok);
+    CHECK(parse("0.000", d, st) == 5 && d == 0 && st == number::parse_ok);
+    // denormals are values
+    CHECK(parse("5e-324", d, st) == 6 && d > 0 && st == number::parse_ok);
+    CHECK(parse("2.2250738585072011e-308", d, st) == 23 && d > 0 && st == number::parse_ok);
+    
+    // correct rounding of long mantissas
+    CHECK(parse("0.1000000000000000055511151231257827", d, st) == 36 && d == 0.1);
+    CHECK(parse("9007199254740993", d, st) == 16 && d == 9007199254740992.0);
+    
+    // no number
+    d = 7;
+    CHECK(parse("e5", d, st) == 0 && d == 7 && st == number::parse_invalid);
+    CHECK(parse(".", d, st) == 0 && st == number::parse_invalid);
+    CHECK(parse("-", d, st) == 0 && st == number::parse_invalid);
+    
+    // integers
+    CHECK(parse("-42x", i, st) == 3 && i == -42 && st == number::parse_ok);
+    CHECK(parse("99999999999", i, st) == 11 && i == 2147483647 && st == number::parse_overflow);
+    CHECK(parse("-99999999999", i, st) == 12 && i == -2147483647 - 1 && st == number::parse_overflow);
+    CHECK(parse("256", uc, st) == 3 && uc == 255 && st == number::parse_overflow);
+    CHECK(parse("-1", uc, st) == 0 && st == number::parse_invalid);
+    
+    return test::result("number_parse");
+}
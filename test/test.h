@@ -0,0 +1,66 @@
+/* 
+ * Copyright © 2015 Sergei Khairulin <sergei.khairulin@gmail.com>. 
+ * All rights reserved.
+ *
+ * This file is part of Bloom++.
+ *
+ * Bloom++ is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Bloom++ is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with Bloom++.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#pragma once
+
+#include <stdio.h>
+#include <string.h>
+
+/*
+ * Helpers of the tests: checks print the failed expression and the
+ * program exits with the count of failures.
+ */
+namespace test
+{
+
+inline int &failures()
+{
+    static int n = 0;
+    return n;
+}
+
+inline void check(bool ok, const char *expr, const char *file, int line)
+{
+    if(ok)
+        return;
+    printf("%s:%d: check failed: %s\n", file, line, expr);
+    ++failures();
+}
+
+inline void check_str(const char *got, const char *expected,
+                      const char *file, int line)
+{
+    if(!strcmp(got, expected))
+        return;
+    printf("%s:%d: got \"%s\", expected \"%s\"\n", file, line, got, expected);
+    ++failures();
+}
+
+inline int result(const char *name)
+{
+    printf("%s: %s\n", name, failures() ? "FAILED" : "ok");
+    return failures() ? 1 : 0;
+}
+
+} //namespace test
+
+#define CHECK(expr) test::check((expr), #expr, __FILE__, __LINE__)
+#define CHECK_STR(got, expected) test::check_str((got), (expected), __FILE__, __LINE__)